@@ -3,6 +3,9 @@
 //
 
 #include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
 
 #include "../core-lib/include/EventQueue.h"
 #include "../core-lib/include/Event.h"
@@ -11,14 +14,27 @@
 #include "include/Grid.h"
 #include "include/GridBuilder.h"
 #include "include/TileManager.h"
+#include "include/FlowField.h"
 #include "../tank-lib/include/Bullet.h"
 #include "../bot-lib/include/BotController.h"
 #include "include/Eagle.h"
 #include "../core-lib/include/Clock.h"
+#include "../core-lib/include/Snapshot.h"
 
 
 Board::Board() : entityController_(std::make_unique<EntityController>()), grid_(std::make_unique<Grid>()) {
     botController = BotController::instance();
+    flowField_->rebuild(*grid_);
+    botController->setFlowField(flowField_);
+    botController->setBoard(this);
+}
+
+Board::~Board() {
+    // the controller might have been reinitialized since the board was created
+    BotController *controller = BotController::instance();
+    if (controller->getBoard() == this) {
+        controller->setBoard(nullptr);
+    }
 }
 
 void Board::setTankMoving(const std::shared_ptr<Tank> &target, bool isMoving) {
@@ -44,29 +60,27 @@ void Board::setTankDirection(const std::shared_ptr<Tank> &tank, Direction target
 }
 
 bool Board::snapTankToGrid(const std::shared_ptr<Tank> &target, bool snap_x, bool snap_y) {
-    float initial_x = target->getX();
-    float initial_y = target->getY();
-
-
-
+    sightBlockersValid_ = false;
+    FixedPoint::Value initial_x = target->getFixedX();
+    FixedPoint::Value initial_y = target->getFixedY();
 
     switch (target->getFacing())
     {
     case (Direction::North) :
         if (snap_y)
-        target->setY(std::ceil(target->getY()));
+        target->setFixedY(FixedPoint::snapUp(initial_y));
         break;
     case (Direction::East):
         if (snap_x)
-        target->setX(std::floor(target->getX()));
+        target->setFixedX(FixedPoint::snapDown(initial_x));
         break;
     case (Direction::South):
         if (snap_y)
-        target->setY(std::floor(target->getY()));
+        target->setFixedY(FixedPoint::snapDown(initial_y));
         break;
     case (Direction::West):
         if (snap_x)
-        target->setX(std::ceil(target->getX()));
+        target->setFixedX(FixedPoint::snapUp(initial_x));
         break;
 
 
@@ -74,14 +88,9 @@ bool Board::snapTankToGrid(const std::shared_ptr<Tank> &target, bool snap_x, boo
         break;
     }
 
-    // if (snap_x)
-    //     target->setX(std::round(target->getX()));
-    // if (snap_y)
-    //     target->setY(std::round(target->getY()));
-
     if (!validateEntityPosition(target)) {
-        target->setX(initial_x);
-        target->setY(initial_y);
+        target->setFixedX(initial_x);
+        target->setFixedY(initial_y);
 
         return false;
     }
@@ -95,6 +104,8 @@ void Board::setGrid(std::unique_ptr<Grid> grid) {
     grid_ = std::move(grid);
     botController->setSpawnpoints(grid_->getSpawnpoints());
     botController->setTypes(grid_->getTankTypes());
+    flowField_->rebuild(*grid_);
+    botController->setFlowField(flowField_);
 }
 
 void Board::deleteTile(unsigned int x, unsigned int y) {
@@ -102,22 +113,272 @@ void Board::deleteTile(unsigned int x, unsigned int y) {
     if (!TileManager::isTileDestructible(grid_->getTileAtPosition(x, y))) {
         return;
     }
+    bool flowFieldUpToDate = flowField_->getGridVersion() == grid_->getVersion();
     grid_->deleteTile(x, y);
+    if (flowFieldUpToDate) {
+        flowField_->openTile(*grid_, x, y);
+    } else {
+        flowField_->rebuild(*grid_);
+    }
+}
+
+void Board::setTickRate(unsigned int ticksPerSecond) {
+    movementIntegrator_.setStepScale(ReferenceTickRate, ticksPerSecond);
+    botController->setTickRate(ReferenceTickRate, ticksPerSecond);
 }
 
 void Board::moveAllEntities() {
-    for (const std::shared_ptr<Entity> &entity: *(entityController_->getAllEntities())) {
-        moveEntity(entity);
+    std::vector<std::shared_ptr<Entity>> &entities = *(entityController_->getAllEntities());
+    sightBlockersValid_ = false;
+
+    // integration pass
+    const std::vector<std::shared_ptr<Entity>> &moved = movementIntegrator_.advance(entities);
+    contacts_.clear();
+    if (moved.empty()) {
+        return;
+    }
+    for (const std::shared_ptr<Entity> &entity: moved) {
+        eventQueue_->registerEvent(std::make_unique<Event>(Event::EntityMoved, entity));
+    }
+
+    // movement of every entity during the tick (entities that didn't move stand still)
+    motions_.clear();
+    movedIndices_.clear();
+    for (std::size_t i = 0; i < entities.size(); i++) {
+        Sweep::Motion motion{Sweep::boxOf(*entities[i]), 0, 0};
+        if (entities[i]->isMoving()) {
+            FixedPoint::Value step = movementIntegrator_.getStep(*entities[i]);
+            motion.dx = MovementIntegrator::directionX[entities[i]->getFacing()] * step;
+            motion.dy = MovementIntegrator::directionY[entities[i]->getFacing()] * step;
+            motion.start.x -= motion.dx;
+            motion.start.y -= motion.dy;
+            movedIndices_.push_back(i);
+        }
+        motions_.push_back(motion);
+    }
+
+    // grid pass (entities are stopped at tiles here, so it has to run before the entity pass)
+    tileContacts_.resize(movedIndices_.size());
+    tileContactTimes_.resize(movedIndices_.size());
+    for (std::size_t k = 0; k < movedIndices_.size(); k++) {
+        const std::shared_ptr<Entity> &entity = entities[movedIndices_[k]];
+        Sweep::Motion &motion = motions_[movedIndices_[k]];
+
+        auto *bullet = dynamic_cast<Bullet *>(entity.get());
+        tileContacts_[k] = bullet != nullptr ? resolveBulletImpact(*bullet, motion)
+                                             : resolveTileImpact(entity, motion);
+
+        // part of the step made before stopping at the tile
+        std::int64_t step = std::abs(motion.dx) + std::abs(motion.dy);
+        motion.dx = entity->getFixedX() - motion.start.x;
+        motion.dy = entity->getFixedY() - motion.start.y;
+        std::int64_t travelled = std::abs(motion.dx) + std::abs(motion.dy);
+        tileContactTimes_[k] = step == 0 ? 0 : static_cast<FixedPoint::Value>(travelled * FixedPoint::One / step);
+    }
+
+    // entity pass
+    sweptBounds_.clear();
+    for (const Sweep::Motion &motion: motions_) {
+        sweptBounds_.push_back(Sweep::sweptBox(motion));
+    }
+    broadphase_.rebuild(entities, sweptBounds_);
+
+    // narrowphase - contacts of moved entities with tiles and with every entity they touch during the tick
+    pendingContacts_.clear();
+    for (std::size_t k = 0; k < movedIndices_.size(); k++) {
+        std::size_t idx = movedIndices_[k];
+        std::size_t first = pendingContacts_.size();
+
+        if (tileContacts_[k].has_value()) {
+            pendingContacts_.push_back({{entities[idx], std::nullopt, tileContacts_[k]->first,
+                                         tileContacts_[k]->second, tileContactTimes_[k]}, idx, NoEntity});
+        }
+
+        for (std::uint32_t candidate: broadphase_.findCandidates(sweptBounds_[idx])) {
+            // pairs of moved entities are found twice, keep the one found first
+            if (candidate == idx || (candidate < idx && entities[candidate]->isMoving())) {
+                continue;
+            }
+            std::optional<FixedPoint::Value> time = Sweep::timeOfImpact(motions_[idx], motions_[candidate]);
+            if (time.has_value()) {
+                pendingContacts_.push_back({{entities[idx], entities[candidate], 0, 0, time.value()}, idx, candidate});
+            }
+        }
+
+        // entity's contacts in the order they happen
+        std::stable_sort(pendingContacts_.begin() + static_cast<std::ptrdiff_t>(first), pendingContacts_.end(),
+                         [](const IndexedContact &a, const IndexedContact &b) {
+                             return a.contact.time < b.contact.time;
+                         });
+    }
+
+    discardContactsOfDestroyedBullets();
+
+    for (const IndexedContact &contact: pendingContacts_) {
+        contacts_.push_back(contact.contact);
+        eventQueue_->registerEvent(createCollisionEvent(contact.contact));
+    }
+}
+
+const std::vector<Board::Contact> &Board::getContacts() const {
+    return contacts_;
+}
+
+void Board::discardContactsOfDestroyedBullets() {
+    // a bullet is destroyed by the first thing it hits, so only it's earliest contact is kept
+    firstContacts_.assign(motions_.size(), NoEntity);
+    for (std::size_t i = 0; i < pendingContacts_.size(); i++) {
+        const IndexedContact &contact = pendingContacts_[i];
+        if (dynamic_cast<Bullet *>(contact.contact.entity.get()) != nullptr) {
+            keepEarlierContact(firstContacts_[contact.entity], i);
+        }
+        if (contact.other != NoEntity && dynamic_cast<Bullet *>(contact.contact.other->get()) != nullptr) {
+            keepEarlierContact(firstContacts_[contact.other], i);
+        }
+    }
+
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < pendingContacts_.size(); i++) {
+        const IndexedContact &contact = pendingContacts_[i];
+        bool discarded = (firstContacts_[contact.entity] != NoEntity && firstContacts_[contact.entity] != i) ||
+                         (contact.other != NoEntity && firstContacts_[contact.other] != NoEntity &&
+                          firstContacts_[contact.other] != i);
+        if (!discarded) {
+            pendingContacts_[kept++] = contact;
+        }
     }
+    pendingContacts_.resize(kept);
+}
+
+void Board::keepEarlierContact(std::size_t &current, std::size_t candidate) const {
+    if (current == NoEntity || pendingContacts_[candidate].contact.time < pendingContacts_[current].contact.time) {
+        current = candidate;
+    }
+}
+
+std::optional<Board::TileImpact> Board::findTileImpact(const Entity &entity, FixedPoint::Value position,
+                                                       FixedPoint::Value reach) {
+    return findTileImpact(*grid_, Sweep::boxOf(entity), entity.getFacing(), position, reach);
+}
+
+std::optional<Board::TileImpact> Board::findTileImpact(const Grid &grid, const Sweep::Box &box, Direction facing,
+                                                       FixedPoint::Value position, FixedPoint::Value reach) {
+    bool horizontal = facing == East || facing == West;
+    bool forwards = facing == East || facing == South;
+
+    // sizes along the axis of movement and across it
+    FixedPoint::Value length = horizontal ? box.sizeX : box.sizeY;
+    FixedPoint::Value side = horizontal ? box.y : box.x;
+    FixedPoint::Value width = horizontal ? box.sizeY : box.sizeX;
+    auto lineCount = static_cast<int>(horizontal ? grid.getSizeX() : grid.getSizeY());
+    auto laneCount = static_cast<int>(horizontal ? grid.getSizeY() : grid.getSizeX());
+
+    // lanes (rows or columns) covered by the entity
+    int firstLane = std::max(0, FixedPoint::floorToTile(side));
+    int lastLane = std::min(laneCount - 1, FixedPoint::ceilToTile(side + width) - 1);
+
+    // the first blocked tile line in the direction of movement, starting with the one containing entity's front,
+    // is the nearest one any of the lanes runs into (see Grid::getFreeRun)
+    int step = forwards ? 1 : -1;
+    int line = forwards ? FixedPoint::floorToTile(position + length - 1) : FixedPoint::floorToTile(position);
+    int blockedLine = line;
+    int blockedLane = std::max(0, std::min(firstLane, laneCount - 1));  // the closest lane, if leaving the grid
+    if (line >= 0 && line < lineCount) {
+        blockedLine = forwards ? lineCount : -1;
+        for (int lane = firstLane; lane <= lastLane; lane++) {
+            auto x = static_cast<unsigned int>(horizontal ? line : lane);
+            auto y = static_cast<unsigned int>(horizontal ? lane : line);
+            auto freeRun = static_cast<int>(grid.getFreeRun(x, y, facing));
+            int laneBlockedLine = grid.isTileCollidable(x, y) ? line : line + step * (freeRun + 1);
+            if (forwards ? laneBlockedLine < blockedLine : laneBlockedLine > blockedLine) {
+                blockedLine = laneBlockedLine;
+                blockedLane = lane;
+            }
+        }
+    }
+
+    // the front has to enter the line to hit it
+    bool entered = forwards ? std::int64_t{blockedLine} * FixedPoint::One < std::int64_t{position} + length + reach
+                            : std::int64_t{blockedLine + 1} * FixedPoint::One > std::int64_t{position} - reach;
+    if (entered) {
+        // never behind the starting position
+        FixedPoint::Value impact = forwards ? std::max(position, FixedPoint::fromTiles(blockedLine) + 1 - length)
+                                            : std::min(position, FixedPoint::fromTiles(blockedLine + 1) - 1);
+        auto tileLine = static_cast<unsigned int>(std::max(0, std::min(blockedLine, lineCount - 1)));
+        auto tileLane = static_cast<unsigned int>(blockedLane);
+        return TileImpact{impact, horizontal ? std::make_pair(tileLine, tileLane)
+                                             : std::make_pair(tileLane, tileLine)};
+    }
+
+    return std::nullopt;
+}
+
+void Board::computeBulletImpact(Bullet &bullet) {
+    bool horizontal = bullet.getFacing() == East || bullet.getFacing() == West;
+    FixedPoint::Value position = horizontal ? bullet.getFixedX() : bullet.getFixedY();
+
+    // the grid's edge always stops the bullet, so the impact is always found
+    FixedPoint::Value reach = FixedPoint::fromTiles(static_cast<std::int32_t>(
+            std::max(grid_->getSizeX(), grid_->getSizeY()) + 1));
+    bullet.setImpact(findTileImpact(bullet, position, reach)->position, grid_->getVersion());
+}
+
+std::optional<std::pair<unsigned int, unsigned int>> Board::resolveBulletImpact(Bullet &bullet,
+                                                                                const Sweep::Motion &motion) {
+    if (!bullet.isImpactValid(grid_->getVersion())) {
+        FixedPoint::Value x = bullet.getFixedX();
+        FixedPoint::Value y = bullet.getFixedY();
+        bullet.setFixedX(motion.start.x);
+        bullet.setFixedY(motion.start.y);
+        computeBulletImpact(bullet);
+        bullet.setFixedX(x);
+        bullet.setFixedY(y);
+    }
+
+    if (!bullet.hasReachedImpact()) {
+        return std::nullopt;
+    }
+
+    bullet.clampToImpact();
+
+    // bullet's front is now inside the tile that was hit
+    bool horizontal = bullet.getFacing() == East || bullet.getFacing() == West;
+    std::optional<TileImpact> impact = findTileImpact(bullet, horizontal ? bullet.getFixedX() : bullet.getFixedY(), 0);
+    if (!impact.has_value()) {
+        return tileOf(bullet);
+    }
+    return impact->tile;
+}
+
+std::optional<std::pair<unsigned int, unsigned int>> Board::resolveTileImpact(const std::shared_ptr<Entity> &entity,
+                                                                              const Sweep::Motion &motion) {
+    bool horizontal = entity->getFacing() == East || entity->getFacing() == West;
+    FixedPoint::Value position = horizontal ? motion.start.x : motion.start.y;
+    FixedPoint::Value reach = std::abs(motion.dx) + std::abs(motion.dy);
+
+    std::optional<TileImpact> impact = findTileImpact(*entity, position, reach);
+    if (impact.has_value()) {
+        if (horizontal) {
+            entity->setFixedX(impact->position);
+        } else {
+            entity->setFixedY(impact->position);
+        }
+        return impact->tile;
+    }
+
+    // tiles the entity overlapped before moving are not on it's way, but still collide with it
+    return findCollidingTile(entity);
 }
 
 bool Board::moveEntity(const std::shared_ptr<Entity> &target) {
     if (!target->move()) {
         return false;
     }
+    sightBlockersValid_ = false;
     eventQueue_->registerEvent(std::make_unique<Event>(Event::EntityMoved, target));
-    if (!validateEntityPosition(target)) {
-        eventQueue_->registerEvent(createCollisionEvent(target));
+    std::optional<Contact> contact = findContact(target);
+    if (contact.has_value()) {
+        eventQueue_->registerEvent(createCollisionEvent(contact.value()));
         return false;
     }
     return true;
@@ -132,6 +393,7 @@ bool Board::fireTank(const std::shared_ptr<Tank> &target) {
 
     std::shared_ptr<Entity> addedEntity = entityController_->addEntity(newBullet.value());
     eventQueue_->registerEvent(std::make_unique<Event>(Event::EntitySpawned, addedEntity));
+    computeBulletImpact(*newBullet.value());
 
     if (!validateEntityPosition(std::dynamic_pointer_cast<Entity>(newBullet.value()))) {
         eventQueue_->registerEvent(createCollisionEvent(target));
@@ -146,12 +408,14 @@ bool Board::spawnTank(unsigned int x, unsigned int y, Tank::TankType type, Direc
     }
 
     std::shared_ptr<Tank> newTank = entityController_->createTank(x, y, type, facing);
+    sightBlockersValid_ = false;
 
     std::shared_ptr<Entity> spawnedTank = entityController_->addEntity(newTank);
     eventQueue_->registerEvent(std::make_unique<Event>(Event::EntitySpawned, spawnedTank));
 
-    if (!validateEntityPosition(spawnedTank)) {
-        eventQueue_->registerEvent(createCollisionEvent(spawnedTank));
+    std::optional<Contact> contact = findContact(spawnedTank);
+    if (contact.has_value()) {
+        eventQueue_->registerEvent(createCollisionEvent(contact.value()));
         return false;
     }
     return true;
@@ -160,47 +424,86 @@ bool Board::spawnTank(unsigned int x, unsigned int y, Tank::TankType type, Direc
 bool Board::spawnPlayer(unsigned int x, unsigned int y, Direction facing) {
     std::shared_ptr<PlayerTank> newTank = std::dynamic_pointer_cast<PlayerTank>(
             entityController_->createTank(x, y, Tank::PlayerTank, facing));
+    sightBlockersValid_ = false;
 
     std::shared_ptr<Entity> spawnedTank = entityController_->addEntity(newTank);
     eventQueue_->registerEvent(std::make_unique<Event>(Event::PlayerSpawned, spawnedTank));
 
-    if (!validateEntityPosition(spawnedTank)) {
-        eventQueue_->registerEvent(createCollisionEvent(spawnedTank));
+    std::optional<Contact> contact = findContact(spawnedTank);
+    if (contact.has_value()) {
+        eventQueue_->registerEvent(createCollisionEvent(contact.value()));
         return false;
     }
     return true;
 }
 
 bool Board::validateEntityPosition(const std::shared_ptr<Entity> &target) {
-    if (target->getX() < 0 || target->getY() < 0) {
+    if (!validateTilePosition(target)) {
         return false;
     }
 
-    auto min_x = static_cast<unsigned int>(floorf(target->getX()));   // TODO USE DOUBLE
-    auto max_x = static_cast<unsigned int>(ceilf(target->getX() + target->getSizeX() - 1));
-    auto min_y = static_cast<unsigned int>(floorf(target->getY()));
-    auto max_y = static_cast<unsigned int>(ceilf(target->getY() + target->getSizeY() - 1));
+    if (entityController_->checkEntityCollisions(target)) {
+        return false;
+    }
+
+    return true;
+}
+
+bool Board::validateTilePosition(const std::shared_ptr<Entity> &target) {
+    return !findCollidingTile(target).has_value();
+}
+
+std::optional<std::pair<unsigned int, unsigned int>> Board::findCollidingTile(const std::shared_ptr<Entity> &target) {
+    if (target->getFixedX() < 0 || target->getFixedY() < 0) {
+        return tileOf(*target);
+    }
+
+    auto min_x = static_cast<unsigned int>(FixedPoint::floorToTile(target->getFixedX()));
+    auto max_x = static_cast<unsigned int>(
+            FixedPoint::ceilToTile(target->getFixedX() + target->getFixedSizeX() - FixedPoint::One));
+    auto min_y = static_cast<unsigned int>(FixedPoint::floorToTile(target->getFixedY()));
+    auto max_y = static_cast<unsigned int>(
+            FixedPoint::ceilToTile(target->getFixedY() + target->getFixedSizeY() - FixedPoint::One));
 
     try {
         for (unsigned int i = min_x; i <= max_x; i++)
             for (unsigned int j = min_y; j <= max_y; j++) {
-                TileType tile = grid_->getTileAtPosition(i, j);
-                if (tile != NullTile && TileManager::isTileCollidable(tile)) {
-                    return false;
+                if (grid_->isTileCollidable(i, j)) {
+                    return std::make_pair(i, j);
                 }
             }
     } catch (OutOfGridException &) {
-        return false;
+        return tileOf(*target);
     }
 
-    if (entityController_->checkEntityCollisions(target)) {
-        return false;
+    return std::nullopt;
+}
+
+std::pair<unsigned int, unsigned int> Board::tileOf(const Entity &entity) {
+    auto x = std::max(0, std::min(FixedPoint::floorToTile(entity.getFixedX()),
+                                  static_cast<int>(grid_->getSizeX()) - 1));
+    auto y = std::max(0, std::min(FixedPoint::floorToTile(entity.getFixedY()),
+                                  static_cast<int>(grid_->getSizeY()) - 1));
+    return {static_cast<unsigned int>(x), static_cast<unsigned int>(y)};
+}
+
+std::optional<Board::Contact> Board::findContact(const std::shared_ptr<Entity> &target) {
+    // the other entity takes precedence over tiles
+    std::optional<std::shared_ptr<Entity>> collidingEntity = entityController_->checkEntityCollisions(target);
+    if (collidingEntity.has_value()) {
+        return Contact{target, collidingEntity, 0, 0, 0};
     }
 
-    return true;
+    std::optional<std::pair<unsigned int, unsigned int>> tile = findCollidingTile(target);
+    if (tile.has_value()) {
+        return Contact{target, std::nullopt, tile->first, tile->second, 0};
+    }
+
+    return std::nullopt;
 }
 
 void Board::killAllEnemyEntities() {   // FIXME this should be in EntityController
+    sightBlockersValid_ = false;
     std::vector<std::shared_ptr<Entity>> *entityVector = entityController_->getAllEntities();
     for (auto iter = entityVector->rbegin(); iter != entityVector->rend(); iter++) {
         std::shared_ptr<Entity> entity = *iter;
@@ -228,6 +531,7 @@ void Board::removeEntity(std::shared_ptr<Entity> entity) {
     }
 
     entityController_->removeEntity(entity);
+    sightBlockersValid_ = false;
 
     if(entityController_->getAllEntities()->size()==1 && grid_->getTankTypes().empty()){
         eventQueue_->registerEvent(std::make_unique<Event>(Event::GameEnded));
@@ -236,6 +540,7 @@ void Board::removeEntity(std::shared_ptr<Entity> entity) {
 
 void Board::removeAllEntities() {
     entityController_->clear();
+    sightBlockersValid_ = false;
 }
 
 unsigned int Board::getSizeX() {
@@ -247,6 +552,18 @@ unsigned int Board::getSizeY() {
 }
 
 std::unique_ptr<Event> Board::createCollisionEvent(std::shared_ptr<Entity> entity) {
+    std::optional<Contact> contact = findContact(entity);
+    if (!contact.has_value()) {
+        std::pair<unsigned int, unsigned int> tile = tileOf(*entity);
+        contact = Contact{entity, std::nullopt, tile.first, tile.second, 0};
+    }
+    return createCollisionEvent(contact.value());
+}
+
+std::unique_ptr<Event> Board::createCollisionEvent(const Contact &contact) {
+    std::shared_ptr<Entity> entity = contact.entity;
+    const std::optional<std::shared_ptr<Entity>> &collidingEntity = contact.other;
+
     // wdym typechecking is a bad thing
 
     Event::CollisionMember member1;
@@ -278,14 +595,9 @@ std::unique_ptr<Event> Board::createCollisionEvent(std::shared_ptr<Entity> entit
     }
 
     // set member 2
-    std::optional<std::shared_ptr<Entity>> collidingEntity = entityController_->checkEntityCollisions(entity);
-
     if (!collidingEntity.has_value()) {
         // board
-        member2 = Event::BoardCollisionInfo{
-                static_cast<unsigned int>(entity->getX()),
-                static_cast<unsigned int>(entity->getY()),
-                grid_.get()};
+        member2 = Event::BoardCollisionInfo{contact.tileX, contact.tileY, grid_.get()};
 
     } else {
         entity = collidingEntity.value();
@@ -323,9 +635,116 @@ std::unique_ptr<Event> Board::createCollisionEvent(std::shared_ptr<Entity> entit
 
 void Board::loadLevel(unsigned int levelNum) {
     removeAllEntities();
-    setGrid(std::move(GridBuilder::buildLevel(levelNum)));
+    setGrid(levelPreloader_.take(levelNum));
+    levelNumber_ = levelNum;
     entityController_->addEntity(std::make_shared<Eagle>(grid_->getEagleLocation().first, grid_->getEagleLocation().second));
     eventQueue_->registerEvent(std::make_unique<Event>(Event::LevelLoaded, levelNum, grid_.get()));
+    levelPreloader_.preload(levelNum + 1);
+}
+
+void Board::saveState(SnapshotWriter &writer) const {
+    writer.write(static_cast<std::uint32_t>(levelNumber_));
+    grid_->saveState(writer);
+    entityController_->saveState(writer);
+}
+
+void Board::loadState(SnapshotReader &reader) {
+    auto levelNumber = reader.read<std::uint32_t>();
+    auto grid = std::make_unique<Grid>();
+    grid->loadState(reader);
+    // entities are only replaced once they have all been read
+    entityController_->loadState(reader, makeEagle);
+
+    grid_ = std::move(grid);
+    levelNumber_ = levelNumber;
+    flowField_->rebuild(*grid_);
+    botController->setFlowField(flowField_);
+    sightBlockersValid_ = false;
+
+    eventQueue_->registerEvent(std::make_unique<Event>(Event::LevelLoaded, levelNumber_, grid_.get()));
+    for (const std::shared_ptr<Entity> &entity: *entityController_->getAllEntities()) {
+        if (auto bullet = std::dynamic_pointer_cast<Bullet>(entity)) {
+            computeBulletImpact(*bullet);
+            eventQueue_->registerEvent(std::make_unique<Event>(Event::EntitySpawned, entity));
+        } else if (auto tank = std::dynamic_pointer_cast<Tank>(entity)) {
+            eventQueue_->registerEvent(std::make_unique<Event>(
+                    tank->getType() == Tank::PlayerTank ? Event::PlayerSpawned : Event::EntitySpawned, entity));
+        }
+    }
+}
+
+std::shared_ptr<Entity> Board::restoreEntity(const EntityController::EntityState &state,
+                                             const std::shared_ptr<Tank> &owner) {
+    std::shared_ptr<Entity> entity = entityController_->restoreEntity(state, makeEagle);
+    sightBlockersValid_ = false;
+    if (auto bullet = std::dynamic_pointer_cast<Bullet>(entity)) {
+        if (owner != nullptr) {
+            owner->subscribe(bullet.get());
+        }
+        computeBulletImpact(*bullet);
+        eventQueue_->registerEvent(std::make_unique<Event>(Event::EntitySpawned, entity));
+    } else if (state.kind <= Tank::ArmorTank) {
+        eventQueue_->registerEvent(std::make_unique<Event>(
+                state.kind == Tank::PlayerTank ? Event::PlayerSpawned : Event::EntitySpawned, entity));
+    }
+    return entity;
+}
+
+void Board::restoreEntityState(const std::shared_ptr<Entity> &entity, const EntityController::EntityState &state) {
+    bool rotated = entity->getFacing() != state.facing;
+    bool moved = entity->getFixedX() != state.x || entity->getFixedY() != state.y;
+    EntityController::applyState(*entity, state);
+    if (rotated) {
+        eventQueue_->registerEvent(std::make_unique<Event>(Event::TankRotated, entity));
+    }
+    if (moved) {
+        sightBlockersValid_ = false;
+        eventQueue_->registerEvent(std::make_unique<Event>(Event::EntityMoved, entity));
+    }
+}
+
+void Board::restoreTile(unsigned int x, unsigned int y, TileType tile) {
+    if (grid_->getTileAtPosition(x, y) == tile) {
+        return;
+    }
+    grid_->setTile(x, y, tile);
+    sightBlockersValid_ = false;
+}
+
+void Board::repairFlowField() {
+    if (flowField_->getGridVersion() != grid_->getVersion()) {
+        flowField_->rebuild(*grid_);
+    }
+}
+
+std::shared_ptr<Entity> Board::makeEagle(unsigned int x, unsigned int y) {
+    return std::make_shared<Eagle>(x, y);
+}
+
+LevelPreloader &Board::getLevelPreloader() {
+    return levelPreloader_;
+}
+
+unsigned int Board::getLevelNumber() const {
+    return levelNumber_;
+}
+
+std::size_t Board::applyLevelTiles(const LevelPack::Level &level) {
+    std::size_t changed = 0;
+    for (unsigned int x = 0; x < grid_->getSizeX(); x++) {
+        for (unsigned int y = 0; y < grid_->getSizeY(); y++) {
+            TileType tile = x < level.sizeX && y < level.sizeY ? level.getTile(x, y) : NullTile;
+            if (grid_->getTileAtPosition(x, y) != tile) {
+                grid_->setTile(x, y, tile);
+                changed++;
+            }
+        }
+    }
+    if (changed != 0) {
+        flowField_->rebuild(*grid_);
+        sightBlockersValid_ = false;
+    }
+    return changed;
 }
 
 std::shared_ptr<PlayerTank> Board::getPlayerTank() {
@@ -334,15 +753,137 @@ std::shared_ptr<PlayerTank> Board::getPlayerTank() {
 
 void Board::hitTank(std::shared_ptr<Tank> target, unsigned int damage) {
     entityController_->hitTank(target, damage);
+    sightBlockersValid_ = false;
     if(entityController_->getAllEntities()->size()==1 && grid_->getTankTypes().empty()){
         eventQueue_->registerEvent(std::make_unique<Event>(Event::GameEnded));
     }
 }
 
+const MovementIntegrator &Board::getMovementIntegrator() const {
+    return movementIntegrator_;
+}
+
 Grid *Board::getGrid() {
     return grid_.get();
 }
 
+EntityController *Board::getEntityController() {
+    return entityController_.get();
+}
+
+const FlowField *Board::getFlowField() const {
+    return flowField_.get();
+}
+
+bool Board::hasLineOfSight(const std::shared_ptr<Tank> &shooter, const std::shared_ptr<Entity> &target,
+                           Direction direction) {
+    updateSightBlockers();
+    return static_cast<const Board &>(*this).hasLineOfSight(shooter, target, direction);
+}
+
+bool Board::hasLineOfSight(const std::shared_ptr<Tank> &shooter, const std::shared_ptr<Entity> &target,
+                           Direction direction) const {
+    bool horizontal = direction == East || direction == West;
+    bool forwards = direction == East || direction == South;
+    Sweep::Box from = Sweep::boxOf(*shooter);
+    Sweep::Box to = Sweep::boxOf(*target);
+
+    // the bullet's lane, across the direction of the shot, has to cross the target
+    FixedPoint::Value laneSide = horizontal ? from.y + (from.sizeY - Tank::BulletSize) / 2
+                                            : from.x + (from.sizeX - Tank::BulletSize) / 2;
+    FixedPoint::Value targetSide = horizontal ? to.y : to.x;
+    FixedPoint::Value targetWidth = horizontal ? to.sizeY : to.sizeX;
+    if (targetSide >= laneSide + Tank::BulletSize || laneSide >= targetSide + targetWidth) {
+        return false;
+    }
+
+    // part of the lane between the shooter and the target, along the direction of the shot
+    FixedPoint::Value gapStart = forwards ? (horizontal ? from.x + from.sizeX : from.y + from.sizeY)
+                                          : (horizontal ? to.x + to.sizeX : to.y + to.sizeY);
+    FixedPoint::Value gapEnd = forwards ? (horizontal ? to.x : to.y) : (horizontal ? from.x : from.y);
+    if (gapEnd < gapStart) {
+        return false;  // the target is behind the shooter, or they overlap
+    }
+    if (gapEnd == gapStart) {
+        return true;
+    }
+
+    // tiles - every lane has to run freely from the tile next to the shooter through the whole gap
+    auto lineCount = static_cast<int>(horizontal ? grid_->getSizeX() : grid_->getSizeY());
+    auto laneCount = static_cast<int>(horizontal ? grid_->getSizeY() : grid_->getSizeX());
+    int firstLane = FixedPoint::floorToTile(laneSide);
+    int lastLane = FixedPoint::ceilToTile(laneSide + Tank::BulletSize) - 1;
+    int firstLine = FixedPoint::floorToTile(gapStart);
+    int lastLine = FixedPoint::ceilToTile(gapEnd) - 1;
+    if (firstLane < 0 || lastLane >= laneCount || firstLine < 0 || lastLine >= lineCount) {
+        return false;
+    }
+    int line = forwards ? firstLine : lastLine;
+    auto passedTiles = static_cast<unsigned int>(lastLine - firstLine);
+    for (int lane = firstLane; lane <= lastLane; lane++) {
+        auto x = static_cast<unsigned int>(horizontal ? line : lane);
+        auto y = static_cast<unsigned int>(horizontal ? lane : line);
+        if (grid_->isTileCollidable(x, y) || grid_->getFreeRun(x, y, direction) < passedTiles) {
+            return false;
+        }
+    }
+
+    // entities
+    Sweep::Box gap = horizontal ? Sweep::Box{gapStart, laneSide, gapEnd - gapStart, Tank::BulletSize}
+                                : Sweep::Box{laneSide, gapStart, Tank::BulletSize, gapEnd - gapStart};
+    bool blocked = sightBroadphase_.visitCandidates(gap, [&](std::uint32_t candidate) {
+        const std::shared_ptr<Entity> &blocker = sightBlockers_[candidate];
+        return blocker != shooter && blocker != target;
+    });
+    return !blocked;
+}
+
+std::optional<std::shared_ptr<Entity>> Board::findTargetInSight(const std::shared_ptr<Tank> &shooter,
+                                                                Direction direction) {
+    updateSightBlockers();
+    return static_cast<const Board &>(*this).findTargetInSight(shooter, direction);
+}
+
+std::optional<std::shared_ptr<Entity>> Board::findTargetInSight(const std::shared_ptr<Tank> &shooter,
+                                                                Direction direction) const {
+    const std::vector<std::shared_ptr<Entity>> &targets = shooter->getType() == Tank::PlayerTank ? playerTargets_
+                                                                                                : enemyTargets_;
+    for (const std::shared_ptr<Entity> &target: targets) {
+        if (hasLineOfSight(shooter, target, direction)) {
+            return target;
+        }
+    }
+    return std::nullopt;
+}
+
+void Board::updateSightBlockers() {
+    const std::vector<std::shared_ptr<Entity>> &entities = *(entityController_->getAllEntities());
+    // entities removed or added past the board are caught by their count
+    if (sightBlockersValid_ && sightEntityCount_ == entities.size()) {
+        return;
+    }
+
+    sightBlockers_.clear();
+    playerTargets_.clear();
+    enemyTargets_.clear();
+    for (const std::shared_ptr<Entity> &entity: entities) {
+        if (dynamic_cast<Bullet *>(entity.get()) != nullptr) {
+            continue;
+        }
+        sightBlockers_.push_back(entity);
+
+        auto *tank = dynamic_cast<Tank *>(entity.get());
+        if (tank != nullptr && tank->getType() != Tank::PlayerTank) {
+            playerTargets_.push_back(entity);
+        } else {
+            enemyTargets_.push_back(entity);  // the player tank or the eagle
+        }
+    }
+    sightBroadphase_.rebuild(sightBlockers_);
+    sightBlockersValid_ = true;
+    sightEntityCount_ = entities.size();
+}
+
 bool Board::spawnPlayer(Direction facing) {
-    spawnTank(grid_->getPlayerSpawnpoint().first, grid_->getPlayerSpawnpoint().second, Tank::PlayerTank, facing);
+    return spawnTank(grid_->getPlayerSpawnpoint().first, grid_->getPlayerSpawnpoint().second, Tank::PlayerTank, facing);
 }
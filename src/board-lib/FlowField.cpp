@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <functional>
+
+#include "include/FlowField.h"
+#include "include/Grid.h"
+
+namespace {
+    /**
+     * Unit steps in tiles, indexed by Direction
+     */
+    constexpr int stepX[4] = {0, -1, 0, 1};
+    constexpr int stepY[4] = {-1, 0, 1, 0};
+
+    constexpr Direction directions[4] = {North, West, South, East};
+}
+
+void FlowField::rebuild(const Grid &grid) {
+    sizeX_ = grid.getSizeX() - FootprintSize + 1;
+    sizeY_ = grid.getSizeY() - FootprintSize + 1;
+    costs_.assign(sizeX_ * sizeY_, Unreachable);
+    distances_.assign(sizeX_ * sizeY_, Unreachable);
+    queue_.clear();
+
+    for (unsigned int x = 0; x < sizeX_; x++)
+        for (unsigned int y = 0; y < sizeY_; y++) {
+            costs_[indexOf(x, y)] = computeCost(grid, x, y);
+        }
+
+    // goals are positions touching the eagle with a side
+    auto eagleX = static_cast<int>(grid.getEagleLocation().first);
+    auto eagleY = static_cast<int>(grid.getEagleLocation().second);
+    auto size = static_cast<int>(FootprintSize);
+    for (int x = eagleX - size; x <= eagleX + size; x++)
+        for (int y = eagleY - size; y <= eagleY + size; y++) {
+            bool touchingX = x == eagleX - size || x == eagleX + size;
+            bool touchingY = y == eagleY - size || y == eagleY + size;
+            if (x < 0 || y < 0 || x >= static_cast<int>(sizeX_) || y >= static_cast<int>(sizeY_) ||
+                touchingX == touchingY) {  // overlapping the eagle or touching it with a corner only
+                continue;
+            }
+            if (costs_[indexOf(x, y)] != Unreachable) {
+                relax(indexOf(x, y), 0);
+            }
+        }
+
+    propagate();
+    gridVersion_ = grid.getVersion();
+}
+
+void FlowField::openTile(const Grid &grid, unsigned int x, unsigned int y) {
+    // positions overlapping the tile, their costs can only go down
+    unsigned int minX = x >= FootprintSize - 1 ? x - (FootprintSize - 1) : 0;
+    unsigned int minY = y >= FootprintSize - 1 ? y - (FootprintSize - 1) : 0;
+    for (unsigned int i = minX; i <= x && i < sizeX_; i++)
+        for (unsigned int j = minY; j <= y && j < sizeY_; j++) {
+            std::uint16_t cost = computeCost(grid, i, j);
+            if (cost >= costs_[indexOf(i, j)]) {
+                continue;
+            }
+            costs_[indexOf(i, j)] = cost;
+
+            // neighbours reach the eagle through this position at a lower cost now
+            std::uint16_t distance = distances_[indexOf(i, j)];
+            if (distance == Unreachable) {
+                continue;
+            }
+            for (unsigned int direction = 0; direction < 4; direction++) {
+                int nx = static_cast<int>(i) - stepX[direction];
+                int ny = static_cast<int>(j) - stepY[direction];
+                if (nx >= 0 && ny >= 0 && nx < static_cast<int>(sizeX_) && ny < static_cast<int>(sizeY_) &&
+                    costs_[indexOf(nx, ny)] != Unreachable) {
+                    relax(indexOf(nx, ny), std::uint32_t{distance} + cost);
+                }
+            }
+        }
+
+    propagate();
+    gridVersion_ = grid.getVersion();
+}
+
+std::optional<Direction> FlowField::getDirection(unsigned int x, unsigned int y) const {
+    if (x >= sizeX_ || y >= sizeY_) {
+        return std::nullopt;
+    }
+    std::uint16_t distance = distances_[indexOf(x, y)];
+    if (distance == 0 || distance == Unreachable) {
+        return std::nullopt;
+    }
+
+    // the neighbour the distance was computed through
+    for (unsigned int direction = 0; direction < 4; direction++) {
+        int nx = static_cast<int>(x) + stepX[direction];
+        int ny = static_cast<int>(y) + stepY[direction];
+        if (nx < 0 || ny < 0 || nx >= static_cast<int>(sizeX_) || ny >= static_cast<int>(sizeY_)) {
+            continue;
+        }
+        unsigned int neighbour = indexOf(nx, ny);
+        if (costs_[neighbour] != Unreachable && distances_[neighbour] != Unreachable &&
+            distances_[neighbour] + costs_[neighbour] == distance) {
+            return directions[direction];
+        }
+    }
+    return std::nullopt;
+}
+
+std::uint16_t FlowField::getDistance(unsigned int x, unsigned int y) const {
+    if (x >= sizeX_ || y >= sizeY_) {
+        return Unreachable;
+    }
+    return distances_[indexOf(x, y)];
+}
+
+std::uint16_t FlowField::getCost(unsigned int x, unsigned int y) const {
+    if (x >= sizeX_ || y >= sizeY_) {
+        return Unreachable;
+    }
+    return costs_[indexOf(x, y)];
+}
+
+unsigned int FlowField::getGridVersion() const {
+    return gridVersion_;
+}
+
+std::uint16_t FlowField::computeCost(const Grid &grid, unsigned int x, unsigned int y) {
+    // the eagle can not be driven through
+    std::pair<unsigned int, unsigned int> eagle = grid.getEagleLocation();
+    if (x < eagle.first + FootprintSize && eagle.first < x + FootprintSize &&
+        y < eagle.second + FootprintSize && eagle.second < y + FootprintSize) {
+        return Unreachable;
+    }
+
+    std::uint16_t cost = 1;
+    for (unsigned int i = x; i < x + FootprintSize; i++)
+        for (unsigned int j = y; j < y + FootprintSize; j++) {
+            TileType tile = grid.getTileAtPosition(i, j);
+            if (tile == Bricks) {
+                cost = BrickCost;
+            } else if (grid.isTileCollidable(i, j)) {
+                return Unreachable;
+            }
+        }
+    return cost;
+}
+
+void FlowField::propagate() {
+    while (!queue_.empty()) {
+        std::pop_heap(queue_.begin(), queue_.end(), std::greater<>());
+        auto [distance, index] = queue_.back();
+        queue_.pop_back();
+        if (distance != distances_[index]) {
+            continue;  // stale entry, the position has been reached at a lower cost since
+        }
+
+        // positions next to this one reach the eagle through it
+        unsigned int x = index / sizeY_;
+        unsigned int y = index % sizeY_;
+        for (unsigned int direction = 0; direction < 4; direction++) {
+            int nx = static_cast<int>(x) + stepX[direction];
+            int ny = static_cast<int>(y) + stepY[direction];
+            if (nx >= 0 && ny >= 0 && nx < static_cast<int>(sizeX_) && ny < static_cast<int>(sizeY_) &&
+                costs_[indexOf(nx, ny)] != Unreachable) {
+                relax(indexOf(nx, ny), distance + costs_[index]);
+            }
+        }
+    }
+}
+
+void FlowField::relax(unsigned int index, std::uint32_t distance) {
+    if (distance >= distances_[index]) {
+        return;
+    }
+    distances_[index] = static_cast<std::uint16_t>(distance);
+    queue_.emplace_back(distance, index);
+    std::push_heap(queue_.begin(), queue_.end(), std::greater<>());
+}
+
+unsigned int FlowField::indexOf(unsigned int x, unsigned int y) const {
+    return x * sizeY_ + y;
+}
@@ -2,19 +2,40 @@
 // Created by tomek on 23.05.2022.
 //
 
+#include <array>
+#include <string>
+
 #include "include/Grid.h"
+#include "include/TileManager.h"
 #include "../core-lib/include/EventQueue.h"
 #include "../core-lib/include/Event.h"
+#include "../core-lib/include/Snapshot.h"
 
 const char *OutOfGridException::what() const noexcept {
     return "Given coords do not lie within map's boundaries";
 }
 
+std::atomic<unsigned int> Grid::lastVersion_{0};
+
+namespace {
+    /**
+     * Unit steps in tiles, indexed by Direction
+     */
+    constexpr int stepX[4] = {0, -1, 0, 1};
+    constexpr int stepY[4] = {-1, 0, 1, 0};
+
+    bool isInside(int x, int y) {
+        return x >= 0 && x <= 51 && y >= 0 && y <= 51;
+    }
+}
+
 Grid::Grid() {
     eventQueue_ = EventQueue<Event>::instance();
+    bumpVersion();
+    rebuildFreeRuns();
 }
 
-TileType Grid::getTileAtPosition(unsigned int x, unsigned int y) {
+TileType Grid::getTileAtPosition(unsigned int x, unsigned int y) const {
     if (x > 51 || y > 51) {
         throw OutOfGridException();
     }
@@ -38,7 +59,12 @@ void Grid::setTile(unsigned int x, unsigned int y, TileType newTile) {
         eventType = Event::TileChanged;
     }
 
+    bool wasCollidable = isTileCollidable(x, y);
     grid[x][y] = newTile;
+    if (wasCollidable != isTileCollidable(x, y)) {
+        updateFreeRuns(x, y);
+    }
+    bumpVersion();
     eventQueue_->registerEvent(std::make_unique<Event>(eventType, x, y, this));
 
 }
@@ -52,7 +78,12 @@ void Grid::deleteTile(unsigned int x, unsigned int y) {
         return;
     }
 
+    bool wasCollidable = isTileCollidable(x, y);
     grid[x][y] = NullTile;
+    if (wasCollidable) {
+        updateFreeRuns(x, y);
+    }
+    bumpVersion();
     eventQueue_->registerEvent(std::make_unique<Event>(Event::TileDeleted, x, y, this));
 
 }
@@ -81,3 +112,142 @@ const std::pair<unsigned int, unsigned int> &Grid::getEagleLocation() const {
     return eagleLocation;
 }
 
+unsigned int Grid::getVersion() const {
+    return version_;
+}
+
+void Grid::bumpVersion() {
+    version_ = ++lastVersion_;
+}
+
+bool Grid::isTileCollidable(unsigned int x, unsigned int y) const {
+    if (x > 51 || y > 51) {
+        throw OutOfGridException();
+    }
+
+    return grid[x][y] != NullTile && TileManager::isTileCollidable(grid[x][y]);
+}
+
+unsigned int Grid::getFreeRun(unsigned int x, unsigned int y, Direction direction) const {
+    if (x > 51 || y > 51) {
+        throw OutOfGridException();
+    }
+
+    return freeRuns_[direction][x][y];
+}
+
+void Grid::saveState(SnapshotWriter &writer) const {
+    writer.write(size_x);
+    writer.write(size_y);
+    std::uint8_t tiles[52][52];
+    for (unsigned int x = 0; x < 52; x++) {
+        for (unsigned int y = 0; y < 52; y++) {
+            tiles[x][y] = static_cast<std::uint8_t>(grid[x][y]);
+        }
+    }
+    writer.write(tiles);
+
+    writer.write(static_cast<std::uint32_t>(enemySpawnpoints.size()));
+    for (const auto &[x, y]: enemySpawnpoints) {
+        writer.write(x);
+        writer.write(y);
+    }
+    writer.write(playerSpawnpoint.first);
+    writer.write(playerSpawnpoint.second);
+    writer.write(eagleLocation.first);
+    writer.write(eagleLocation.second);
+
+    std::vector<std::uint8_t> types;
+    for (std::queue<Tank::TankType> remaining = tankTypes; !remaining.empty(); remaining.pop()) {
+        types.push_back(static_cast<std::uint8_t>(remaining.front()));
+    }
+    writer.writeVector(types);
+}
+
+void Grid::loadState(SnapshotReader &reader) {
+    auto sizeX = reader.read<unsigned int>();
+    auto sizeY = reader.read<unsigned int>();
+    auto tiles = reader.read<std::array<std::array<std::uint8_t, 52>, 52>>();
+    if (sizeX > 52 || sizeY > 52) {
+        throw InvalidSnapshot("Grid of " + std::to_string(sizeX) + "x" + std::to_string(sizeY) + " tiles");
+    }
+
+    auto spawnpointCount = reader.read<std::uint32_t>();
+    if (spawnpointCount > 52 * 52) {
+        throw InvalidSnapshot("Too many spawnpoints in a snapshot");
+    }
+    std::vector<std::pair<unsigned int, unsigned int>> spawnpoints(spawnpointCount);
+    for (auto &[x, y]: spawnpoints) {
+        x = reader.read<unsigned int>();
+        y = reader.read<unsigned int>();
+    }
+    std::pair<unsigned int, unsigned int> player;
+    player.first = reader.read<unsigned int>();
+    player.second = reader.read<unsigned int>();
+    std::pair<unsigned int, unsigned int> eagle;
+    eagle.first = reader.read<unsigned int>();
+    eagle.second = reader.read<unsigned int>();
+    std::vector<std::uint8_t> types = reader.readVector<std::uint8_t>(reader.getRemaining());
+
+    for (const auto &column: tiles) {
+        for (std::uint8_t tile: column) {
+            if (tile > Trees) {
+                throw InvalidSnapshot("Tile " + std::to_string(tile) + " in a snapshot");
+            }
+        }
+    }
+    for (std::uint8_t type: types) {
+        if (type > Tank::ArmorTank) {
+            throw InvalidSnapshot("Tank type " + std::to_string(type) + " in a snapshot");
+        }
+    }
+
+    size_x = sizeX;
+    size_y = sizeY;
+    for (unsigned int x = 0; x < 52; x++) {
+        for (unsigned int y = 0; y < 52; y++) {
+            grid[x][y] = static_cast<TileType>(tiles[x][y]);
+        }
+    }
+    enemySpawnpoints = std::move(spawnpoints);
+    playerSpawnpoint = player;
+    eagleLocation = eagle;
+    tankTypes = {};
+    for (std::uint8_t type: types) {
+        tankTypes.push(static_cast<Tank::TankType>(type));
+    }
+    bumpVersion();
+    rebuildFreeRuns();
+}
+
+void Grid::rebuildFreeRuns() {
+    for (unsigned int direction = 0; direction < 4; direction++) {
+        int dx = stepX[direction];
+        int dy = stepY[direction];
+        for (int lane = 0; lane <= 51; lane++) {
+            // start at the edge of the grid the direction points to and walk backwards
+            int x = dx == 0 ? lane : (dx > 0 ? 51 : 0);
+            int y = dy == 0 ? lane : (dy > 0 ? 51 : 0);
+            freeRuns_[direction][x][y] = 0;
+            for (x -= dx, y -= dy; isInside(x, y); x -= dx, y -= dy) {
+                freeRuns_[direction][x][y] = isTileCollidable(x + dx, y + dy)
+                                             ? 0 : freeRuns_[direction][x + dx][y + dy] + 1;
+            }
+        }
+    }
+}
+
+void Grid::updateFreeRuns(unsigned int x, unsigned int y) {
+    for (unsigned int direction = 0; direction < 4; direction++) {
+        int dx = stepX[direction];
+        int dy = stepY[direction];
+        // runs of tiles behind the changed one go through it, unless they are stopped by a collidable tile before
+        for (int i = static_cast<int>(x) - dx, j = static_cast<int>(y) - dy; isInside(i, j); i -= dx, j -= dy) {
+            freeRuns_[direction][i][j] = isTileCollidable(i + dx, j + dy)
+                                         ? 0 : freeRuns_[direction][i + dx][j + dy] + 1;
+            if (isTileCollidable(i, j)) {
+                break;
+            }
+        }
+    }
+}
@@ -2,86 +2,77 @@
 // Created by tomek on 26.05.2022.
 //
 
-#include <sstream>
-#include <string>
-#include <fstream>
 #include <algorithm>
-#include <map>
-#include <unistd.h>
 
 #include "include/GridBuilder.h"
 #include "include/Grid.h"
+#include "include/LevelRepository.h"
 #include "../tank-lib/include/Tank.h"
 
 std::unique_ptr<Grid> GridBuilder::buildLevel(unsigned int level) {
-    static std::map<char, TileType> charToTileMapping{
-            {'-', NullTile},
-            {'B', Bricks},
-            {'S', Steel},
-            {'T', Trees},
-            {'W', Water},
-            {'E', NullTile},
-            {'*', NullTile}
-    };
-
-    static std::map<char, Tank::TankType> charToTankMapping{
-            {'B', Tank::BasicTank},
-            {'F', Tank::FastTank},
-            {'P', Tank::PowerTank},
-            {'A', Tank::ArmorTank}
+    return LevelRepository::instance()->buildLevel(level);
+}
 
-    };
+std::unique_ptr<Grid> GridBuilder::buildLevel(const LevelPack::LevelView &level) {
+    auto newGrid = std::make_unique<Grid>();
+    unsigned int sizeX = std::min(level.getSizeX(), newGrid->getSizeX());
+    unsigned int sizeY = std::min(level.getSizeY(), newGrid->getSizeY());
+    for (unsigned int x = 0; x < sizeX; x++) {
+        level.decodeTiles(std::size_t{x} * level.getSizeY(), sizeY, newGrid->grid[x]);
+    }
 
-    std::string filename = "./levels/lvl" + std::to_string(level) +
-                           ".txt";  // FIXME THIS **WILL** CAUSE ERRORS AND SHOULD BE FIXED AS SOON AS POSSIBLE
-    std::ifstream file(filename);
-    std::string line;
+    std::vector<std::pair<unsigned int, unsigned int>> spawnpoints;
+    for (std::size_t i = 0; i < level.getSpawnpointCount(); i++) {
+        spawnpoints.push_back(level.getSpawnpoint(i));
+    }
+    placePoints(newGrid.get(), spawnpoints, level.getPlayerSpawnpoint(), level.getEagleLocation(),
+                level.getTankTypes());
+    newGrid->rebuildFreeRuns();
+    return newGrid;
+}
 
+std::unique_ptr<Grid> GridBuilder::buildLevel(const LevelPack::Level &level) {
     auto newGrid = std::make_unique<Grid>();
-    unsigned int maxWidth = newGrid->getSizeX();
-
-    if(std::getline(file, line)){
-        for(char c: line){
-            if(charToTankMapping.count(c) == 0){
-                continue;
-            }
-            newGrid->tankTypes.push(charToTankMapping[c]);
+    unsigned int sizeX = std::min(level.sizeX, newGrid->getSizeX());
+    unsigned int sizeY = std::min(level.sizeY, newGrid->getSizeY());
+    for (unsigned int x = 0; x < sizeX; x++) {
+        const std::uint8_t *column = level.tiles.data() + std::size_t{x} * level.sizeY;
+        for (unsigned int y = 0; y < sizeY; y++) {
+            newGrid->grid[x][y] = static_cast<TileType>(column[y]);
         }
     }
 
-    unsigned int lineIdx = 0;
-    while (std::getline(file, line)) {
-        unsigned int lineLength = line.length();
-        unsigned int endIndex = std::min(maxWidth, lineLength);
-        for (int i = 0; i < endIndex; ++i) {  // FIXME I am pretty sure this can be done with an iterator
-            switch (line[i]) {
-                case 'E': { // TODO add eagle
-                    newGrid->eagleLocation = std::make_pair(i, lineIdx);
-                    break;
-                }
-                case '*':{
-                    newGrid->enemySpawnpoints.emplace_back(std::make_pair(i, lineIdx));
-                    break;
-                }
-                case '+':{
-                    newGrid->playerSpawnpoint = std::make_pair(i, lineIdx);
-                    break;
-                }
-                default:{
-                }
-            }
-            if(charToTileMapping.count(line[i]) == 0){
-                continue;
-            }
-            newGrid->grid[i][lineIdx] = charToTileMapping[line[i]];
-            // i, lineIdx, charToTileMapping[line[i]]
+    placePoints(newGrid.get(), level.spawnpoints, level.playerSpawnpoint, level.eagleLocation, level.tankTypes);
+    newGrid->rebuildFreeRuns();
+    return newGrid;
+}
+
+void GridBuilder::placePoints(Grid *targetGrid, const std::vector<std::pair<unsigned int, unsigned int>> &spawnpoints,
+                              std::pair<unsigned int, unsigned int> playerSpawnpoint,
+                              std::pair<unsigned int, unsigned int> eagleLocation,
+                              const std::vector<Tank::TankType> &tankTypes) {
+    auto inside = [targetGrid](std::pair<unsigned int, unsigned int> point) {
+        return point.first < targetGrid->getSizeX() && point.second < targetGrid->getSizeY();
+    };
+
+    for (auto spawnpoint: spawnpoints) {
+        if (inside(spawnpoint)) {
+            targetGrid->enemySpawnpoints.push_back(spawnpoint);
         }
-        lineIdx++;
     }
-
-    return std::move(newGrid);
+    if (inside(playerSpawnpoint)) {
+        targetGrid->playerSpawnpoint = playerSpawnpoint;
+    }
+    if (inside(eagleLocation)) {
+        targetGrid->eagleLocation = eagleLocation;
+    }
+    for (Tank::TankType type: tankTypes) {
+        targetGrid->tankTypes.push(type);
+    }
 }
 
+InvalidLevelFile::InvalidLevelFile(std::string message) : what_message(std::move(message)) {}
+
 const char *InvalidLevelFile::what() const noexcept {
-    return "Invalid level file";
+    return what_message.c_str();
 }
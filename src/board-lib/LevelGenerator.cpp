@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <array>
+
+#include "include/LevelGenerator.h"
+#include "include/FlowField.h"
+#include "include/Grid.h"
+#include "include/GridBuilder.h"
+
+namespace {
+    constexpr unsigned int Footprint = FlowField::FootprintSize;
+
+    /**
+     * splitmix64, fast and good enough for drawing tiles
+     */
+    std::uint64_t next(std::uint64_t &state) {
+        std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * Tile of every random byte, so that each type is drawn with it's density
+     */
+    std::array<std::uint8_t, 256> tileTable(const LevelGenerator::Settings &settings) {
+        float densities[4] = {std::max(settings.bricks, 0.0f), std::max(settings.steel, 0.0f),
+                              std::max(settings.water, 0.0f), std::max(settings.trees, 0.0f)};
+        const TileType types[4] = {Bricks, Steel, Water, Trees};
+        float sum = densities[0] + densities[1] + densities[2] + densities[3];
+        float scale = sum > 1.0f ? 1.0f / sum : 1.0f;
+
+        std::array<std::uint8_t, 256> table{};
+        float bound = 0;
+        unsigned int value = 0;
+        for (int i = 0; i < 4; i++) {
+            bound += densities[i] * scale * 256;
+            for (; value < 256 && static_cast<float>(value) + 0.5f < bound; value++) {
+                table[value] = types[i];
+            }
+        }
+        return table;
+    }
+}
+
+LevelPack::Level LevelGenerator::generate(const Settings &settings, unsigned int number) {
+    LevelPack::Level level;
+    level.number = number;
+    level.sizeX = std::max(settings.sizeX, MinLevelSize);
+    level.sizeY = std::max(settings.sizeY, MinLevelSize);
+    std::uint64_t random = settings.seed;
+
+    // eight tiles per random number
+    std::array<std::uint8_t, 256> table = tileTable(settings);
+    level.tiles.resize(std::size_t{level.sizeX} * level.sizeY);
+    std::size_t count = level.tiles.size();
+    std::uint8_t *tiles = level.tiles.data();
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        std::uint64_t bits = next(random);
+        for (unsigned int k = 0; k < 8; k++) {
+            tiles[i + k] = table[(bits >> (8 * k)) & 0xff];
+        }
+    }
+    for (std::uint64_t bits = next(random); i < count; i++, bits >>= 8) {
+        tiles[i] = table[bits & 0xff];
+    }
+
+    level.eagleLocation = {level.sizeX / 2 - Footprint / 2, level.sizeY - Footprint};
+    level.playerSpawnpoint = {level.eagleLocation.first - 6, level.eagleLocation.second};
+    level.hasEagle = true;
+    level.hasPlayerSpawnpoint = true;
+    clearArea(level, level.playerSpawnpoint.first, level.playerSpawnpoint.second, 6 + Footprint, Footprint);
+    std::pair<unsigned int, unsigned int> target{level.eagleLocation.first, level.eagleLocation.second - Footprint};
+
+    unsigned int spawnpointCount = std::max(settings.spawnpointCount, 1u);
+    for (unsigned int s = 0; s < spawnpointCount; s++) {
+        unsigned int x = spawnpointCount == 1 ? (level.sizeX - Footprint) / 2
+                                              : (level.sizeX - Footprint) * s / (spawnpointCount - 1);
+        level.spawnpoints.emplace_back(x, 0);
+        carveCorridor(level, random, {x, 0}, target);
+    }
+
+    level.tankTypes.reserve(settings.tankCount);
+    for (std::size_t t = 0; t < settings.tankCount; t++) {
+        level.tankTypes.push_back(static_cast<Tank::TankType>(Tank::BasicTank + next(random) % 4));
+    }
+    return level;
+}
+
+std::unique_ptr<Grid> LevelGenerator::generateGrid(const Settings &settings) {
+    return GridBuilder::buildLevel(generate(settings));
+}
+
+void LevelGenerator::carveCorridor(LevelPack::Level &level, std::uint64_t &random,
+                                   std::pair<unsigned int, unsigned int> from,
+                                   std::pair<unsigned int, unsigned int> to) {
+    unsigned int x = from.first;
+    unsigned int y = from.second;
+    clearArea(level, x, y, Footprint, Footprint);
+    std::uint64_t bits = 0;
+    unsigned int bitsLeft = 0;
+    while (x != to.first || y != to.second) {
+        if (bitsLeft == 0) {
+            bits = next(random);
+            bitsLeft = 64;
+        }
+        bool down = (bits & 1) != 0;
+        bits >>= 1;
+        bitsLeft--;
+
+        if (y != to.second && (down || x == to.first)) {
+            y = y < to.second ? y + 1 : y - 1;
+        } else {
+            x = x < to.first ? x + 1 : x - 1;
+        }
+        clearArea(level, x, y, Footprint, Footprint);
+    }
+}
+
+void LevelGenerator::clearArea(LevelPack::Level &level, unsigned int x, unsigned int y, unsigned int width,
+                               unsigned int height) {
+    unsigned int endX = std::min(x + width, level.sizeX);
+    unsigned int endY = std::min(y + height, level.sizeY);
+    for (unsigned int i = x; i < endX; i++) {
+        std::uint8_t *column = level.tiles.data() + std::size_t{i} * level.sizeY;
+        std::fill(column + y, column + std::max(y, endY), NullTile);
+    }
+}
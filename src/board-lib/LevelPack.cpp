@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "include/LevelPack.h"
+#include "include/GridBuilder.h"
+
+namespace {
+    constexpr std::size_t PackHeaderSize = 4 * sizeof(std::uint32_t);
+    constexpr std::size_t EntrySize = 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+    /**
+     * Words of a level header
+     */
+    enum LevelField : std::size_t {
+        SizeX,
+        SizeY,
+        Encoding,
+        SpawnpointCount,
+        TankCount,
+        PlayerX,
+        PlayerY,
+        EagleX,
+        EagleY,
+        PointFlags,
+        LevelHeaderWords
+    };
+
+    enum PointFlag : std::uint32_t {
+        PlayerSpawnpointFlag = 1,
+        EagleFlag = 2
+    };
+
+    constexpr std::size_t LevelHeaderSize = LevelHeaderWords * sizeof(std::uint32_t);
+
+    std::uint64_t alignTo(std::uint64_t size, std::uint64_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    std::uint64_t tileBytes(std::uint64_t count, std::uint32_t encoding) {
+        return encoding == LevelPack::ByteTiles ? count : (count + 1) / 2;
+    }
+
+    std::uint64_t levelSize(std::uint64_t sizeX, std::uint64_t sizeY, std::uint32_t encoding,
+                            std::uint64_t spawnpoints, std::uint64_t tanks) {
+        return LevelHeaderSize + spawnpoints * 2 * sizeof(std::uint32_t) + alignTo(tanks, 4) +
+               tileBytes(sizeX * sizeY, encoding);
+    }
+
+    /**
+     * TileType of every stored value, NullTile for unknown ones
+     */
+    constexpr std::array<TileType, 256> TileTable = [] {
+        std::array<TileType, 256> table{};
+        for (TileType tile: {NullTile, Bricks, Steel, Water, Trees}) {
+            table[tile] = tile;
+        }
+        return table;
+    }();
+
+    /**
+     * Tiles of characters of text levels (unknown characters being NullTile)
+     */
+    constexpr std::array<TileType, 256> CharTiles = [] {
+        std::array<TileType, 256> table{};
+        table['B'] = Bricks;
+        table['S'] = Steel;
+        table['T'] = Trees;
+        table['W'] = Water;
+        return table;
+    }();
+
+    std::optional<Tank::TankType> tankOfChar(char c) {
+        switch (c) {
+            case 'B':
+                return Tank::BasicTank;
+            case 'F':
+                return Tank::FastTank;
+            case 'P':
+                return Tank::PowerTank;
+            case 'A':
+                return Tank::ArmorTank;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    char charOfTank(Tank::TankType type) {
+        switch (type) {
+            case Tank::FastTank:
+                return 'F';
+            case Tank::PowerTank:
+                return 'P';
+            case Tank::ArmorTank:
+                return 'A';
+            default:
+                return 'B';
+        }
+    }
+
+    bool isEnemyType(std::uint8_t type) {
+        return type >= Tank::BasicTank && type <= Tank::ArmorTank;
+    }
+}
+
+TileType LevelPack::Level::getTile(unsigned int x, unsigned int y) const {
+    if (x >= sizeX || y >= sizeY) {
+        throw OutOfGridException();
+    }
+    return static_cast<TileType>(tiles[std::size_t{x} * sizeY + y]);
+}
+
+LevelPack::LevelView::LevelView(unsigned int number, const std::uint32_t *header) : number_(number), header_(header) {
+    spawnpoints_ = header + LevelHeaderWords;
+    tankTypes_ = reinterpret_cast<const std::uint8_t *>(spawnpoints_ + 2 * std::size_t{header[SpawnpointCount]});
+    tiles_ = tankTypes_ + alignTo(header[TankCount], 4);
+}
+
+unsigned int LevelPack::LevelView::getNumber() const {
+    return number_;
+}
+
+unsigned int LevelPack::LevelView::getSizeX() const {
+    return header_[SizeX];
+}
+
+unsigned int LevelPack::LevelView::getSizeY() const {
+    return header_[SizeY];
+}
+
+LevelPack::TileEncoding LevelPack::LevelView::getEncoding() const {
+    return static_cast<TileEncoding>(header_[Encoding]);
+}
+
+TileType LevelPack::LevelView::getTile(unsigned int x, unsigned int y) const {
+    if (x >= getSizeX() || y >= getSizeY()) {
+        throw OutOfGridException();
+    }
+    TileType tile;
+    decodeTiles(std::size_t{x} * getSizeY() + y, 1, &tile);
+    return tile;
+}
+
+void LevelPack::LevelView::decodeTiles(std::size_t first, std::size_t count, TileType *tiles) const {
+    if (getEncoding() == ByteTiles) {
+        const std::uint8_t *source = tiles_ + first;
+        for (std::size_t i = 0; i < count; i++) {
+            tiles[i] = TileTable[source[i]];
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t index = first + i;
+        std::uint8_t pair = tiles_[index / 2];
+        tiles[i] = TileTable[index % 2 == 0 ? pair & 0x0f : pair >> 4];
+    }
+}
+
+std::size_t LevelPack::LevelView::getSpawnpointCount() const {
+    return header_[SpawnpointCount];
+}
+
+std::pair<unsigned int, unsigned int> LevelPack::LevelView::getSpawnpoint(std::size_t index) const {
+    return {spawnpoints_[2 * index], spawnpoints_[2 * index + 1]};
+}
+
+std::pair<unsigned int, unsigned int> LevelPack::LevelView::getPlayerSpawnpoint() const {
+    return {header_[PlayerX], header_[PlayerY]};
+}
+
+std::pair<unsigned int, unsigned int> LevelPack::LevelView::getEagleLocation() const {
+    return {header_[EagleX], header_[EagleY]};
+}
+
+bool LevelPack::LevelView::hasPlayerSpawnpoint() const {
+    return (header_[PointFlags] & PlayerSpawnpointFlag) != 0;
+}
+
+bool LevelPack::LevelView::hasEagle() const {
+    return (header_[PointFlags] & EagleFlag) != 0;
+}
+
+std::vector<Tank::TankType> LevelPack::LevelView::getTankTypes() const {
+    std::vector<Tank::TankType> types;
+    for (std::size_t i = 0; i < header_[TankCount]; i++) {
+        if (isEnemyType(tankTypes_[i])) {
+            types.push_back(static_cast<Tank::TankType>(tankTypes_[i]));
+        }
+    }
+    return types;
+}
+
+LevelPack::Level LevelPack::LevelView::toLevel() const {
+    Level level;
+    level.number = number_;
+    level.sizeX = getSizeX();
+    level.sizeY = getSizeY();
+    std::vector<TileType> tiles(std::size_t{level.sizeX} * level.sizeY);
+    decodeTiles(0, tiles.size(), tiles.data());
+    level.tiles.assign(tiles.begin(), tiles.end());
+    for (std::size_t i = 0; i < getSpawnpointCount(); i++) {
+        level.spawnpoints.push_back(getSpawnpoint(i));
+    }
+    level.playerSpawnpoint = getPlayerSpawnpoint();
+    level.eagleLocation = getEagleLocation();
+    level.hasPlayerSpawnpoint = hasPlayerSpawnpoint();
+    level.hasEagle = hasEagle();
+    level.tankTypes = getTankTypes();
+    return level;
+}
+
+LevelPack::LevelPack(const std::uint8_t *data, std::size_t size) : data_(data), size_(size) {}
+
+LevelPack::~LevelPack() {
+    munmap(const_cast<std::uint8_t *>(data_), size_);
+}
+
+std::unique_ptr<LevelPack> LevelPack::open(const std::string &filename) {
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(descriptor, &info) != 0 || static_cast<std::size_t>(info.st_size) < PackHeaderSize) {
+        ::close(descriptor);
+        throw InvalidLevelFile(filename + ": not a level pack");
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (data == MAP_FAILED) {
+        throw InvalidLevelFile(filename + ": could not be mapped");
+    }
+    // unmapped by the destructor if the pack turns out to be invalid
+    std::unique_ptr<LevelPack> pack(new LevelPack(static_cast<const std::uint8_t *>(data), size));
+
+    const auto *header = static_cast<const std::uint32_t *>(data);
+    if (header[0] != Magic || header[1] != FileVersion) {
+        throw InvalidLevelFile(filename + ": not a level pack");
+    }
+    std::uint32_t count = header[2];
+    if ((size - PackHeaderSize) / EntrySize < count) {
+        throw InvalidLevelFile(filename + ": the directory is cut short");
+    }
+
+    std::unordered_set<std::uint32_t> numbers;
+    for (std::size_t i = 0; i < count; i++) {
+        const std::uint8_t *entry = pack->data_ + PackHeaderSize + i * EntrySize;
+        std::uint32_t number;
+        std::uint64_t offset;
+        std::uint64_t bytes;
+        std::memcpy(&number, entry, sizeof(number));
+        std::memcpy(&offset, entry + 2 * sizeof(std::uint32_t), sizeof(offset));
+        std::memcpy(&bytes, entry + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t), sizeof(bytes));
+        std::string name = filename + ": level " + std::to_string(number);
+        if (!numbers.insert(number).second) {
+            throw InvalidLevelFile(name + " is in the pack twice");
+        }
+        if (offset % 8 != 0 || offset > size || bytes > size - offset || bytes < LevelHeaderSize) {
+            throw InvalidLevelFile(name + " lies outside of the file");
+        }
+
+        const auto *level = reinterpret_cast<const std::uint32_t *>(pack->data_ + offset);
+        if (level[SizeX] == 0 || level[SizeX] > MaxLevelSize || level[SizeY] == 0 || level[SizeY] > MaxLevelSize ||
+            (level[Encoding] != ByteTiles && level[Encoding] != PackedTiles)) {
+            throw InvalidLevelFile(name + " has a wrong size or tile encoding");
+        }
+        if (levelSize(level[SizeX], level[SizeY], level[Encoding], level[SpawnpointCount], level[TankCount]) > bytes) {
+            throw InvalidLevelFile(name + " is cut short");
+        }
+
+        LevelView view(number, level);
+        auto inside = [&view](std::pair<unsigned int, unsigned int> point) {
+            return point.first < view.getSizeX() && point.second < view.getSizeY();
+        };
+        bool valid = inside(view.getPlayerSpawnpoint()) && inside(view.getEagleLocation());
+        for (std::size_t s = 0; s < view.getSpawnpointCount(); s++) {
+            valid = valid && inside(view.getSpawnpoint(s));
+        }
+        if (!valid) {
+            throw InvalidLevelFile(name + " has points off the grid");
+        }
+        pack->levels_.push_back(view);
+    }
+    return pack;
+}
+
+bool LevelPack::save(const std::string &filename, const std::vector<Level> &levels, TileEncoding encoding) {
+    std::unordered_set<unsigned int> numbers;
+    for (const Level &level: levels) {
+        if (level.tiles.size() != std::size_t{level.sizeX} * level.sizeY || !numbers.insert(level.number).second) {
+            return false;
+        }
+    }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    auto write = [&file](const void *source, std::size_t bytes) {
+        file.write(static_cast<const char *>(source), static_cast<std::streamsize>(bytes));
+    };
+    auto pad = [&file](std::uint64_t bytes) {
+        static const char zeros[8] = {};
+        file.write(zeros, static_cast<std::streamsize>(bytes));
+    };
+
+    std::uint32_t header[4] = {Magic, FileVersion, static_cast<std::uint32_t>(levels.size()), 0};
+    write(header, sizeof(header));
+    std::uint64_t offset = alignTo(PackHeaderSize + levels.size() * EntrySize, 8);
+    for (const Level &level: levels) {
+        std::uint32_t number[2] = {level.number, 0};
+        std::uint64_t bytes = levelSize(level.sizeX, level.sizeY, encoding, level.spawnpoints.size(),
+                                        level.tankTypes.size());
+        write(number, sizeof(number));
+        write(&offset, sizeof(offset));
+        write(&bytes, sizeof(bytes));
+        offset += alignTo(bytes, 8);
+    }
+    pad(alignTo(PackHeaderSize + levels.size() * EntrySize, 8) - (PackHeaderSize + levels.size() * EntrySize));
+
+    std::vector<std::uint8_t> packed;
+    for (const Level &level: levels) {
+        std::uint32_t levelHeader[LevelHeaderWords] = {
+                level.sizeX, level.sizeY, encoding,
+                static_cast<std::uint32_t>(level.spawnpoints.size()),
+                static_cast<std::uint32_t>(level.tankTypes.size()),
+                level.playerSpawnpoint.first, level.playerSpawnpoint.second,
+                level.eagleLocation.first, level.eagleLocation.second,
+                (level.hasPlayerSpawnpoint ? PlayerSpawnpointFlag : 0u) | (level.hasEagle ? EagleFlag : 0u)
+        };
+        write(levelHeader, sizeof(levelHeader));
+        for (auto [x, y]: level.spawnpoints) {
+            std::uint32_t point[2] = {x, y};
+            write(point, sizeof(point));
+        }
+        for (Tank::TankType type: level.tankTypes) {
+            auto value = static_cast<std::uint8_t>(type);
+            write(&value, sizeof(value));
+        }
+        pad(alignTo(level.tankTypes.size(), 4) - level.tankTypes.size());
+
+        if (encoding == ByteTiles) {
+            write(level.tiles.data(), level.tiles.size());
+        } else {
+            packed.assign(tileBytes(level.tiles.size(), PackedTiles), 0);
+            for (std::size_t i = 0; i < level.tiles.size(); i++) {
+                packed[i / 2] |= static_cast<std::uint8_t>((level.tiles[i] & 0x0f) << (i % 2 == 0 ? 0 : 4));
+            }
+            write(packed.data(), packed.size());
+        }
+        std::uint64_t bytes = levelSize(level.sizeX, level.sizeY, encoding, level.spawnpoints.size(),
+                                        level.tankTypes.size());
+        pad(alignTo(bytes, 8) - bytes);
+    }
+    return static_cast<bool>(file);
+}
+
+LevelPack::Level LevelPack::parseText(std::istream &input, unsigned int number) {
+    Level level;
+    level.number = number;
+
+    std::string line;
+    if (std::getline(input, line)) {
+        for (char c: line) {
+            std::optional<Tank::TankType> type = tankOfChar(c);
+            if (type.has_value()) {
+                level.tankTypes.push_back(type.value());
+            }
+        }
+    }
+
+    std::vector<std::string> rows;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        level.sizeX = std::max(level.sizeX, static_cast<unsigned int>(line.size()));
+        rows.push_back(std::move(line));
+    }
+    while (!rows.empty() && rows.back().empty()) {
+        rows.pop_back();
+    }
+    level.sizeY = static_cast<unsigned int>(rows.size());
+
+    level.tiles.assign(std::size_t{level.sizeX} * level.sizeY, NullTile);
+    for (unsigned int y = 0; y < level.sizeY; y++) {
+        const std::string &row = rows[y];
+        for (unsigned int x = 0; x < row.size(); x++) {
+            char c = row[x];
+            level.tiles[std::size_t{x} * level.sizeY + y] = CharTiles[static_cast<unsigned char>(c)];
+            switch (c) {
+                case 'E':
+                    level.eagleLocation = {x, y};
+                    level.hasEagle = true;
+                    break;
+                case '*':
+                    level.spawnpoints.emplace_back(x, y);
+                    break;
+                case '+':
+                    level.playerSpawnpoint = {x, y};
+                    level.hasPlayerSpawnpoint = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return level;
+}
+
+void LevelPack::writeText(std::ostream &output, const Level &level) {
+    std::string line;
+    for (Tank::TankType type: level.tankTypes) {
+        line += charOfTank(type);
+    }
+    output << line << '\n';
+
+    std::vector<std::string> rows(level.sizeY, std::string(level.sizeX, '-'));
+    for (unsigned int x = 0; x < level.sizeX; x++) {
+        for (unsigned int y = 0; y < level.sizeY; y++) {
+            TileType tile = TileTable[level.tiles[std::size_t{x} * level.sizeY + y]];
+            rows[y][x] = "-BSWT"[tile];
+        }
+    }
+    auto mark = [&rows, &level](std::pair<unsigned int, unsigned int> point, char c) {
+        if (point.first < level.sizeX && point.second < level.sizeY) {
+            rows[point.second][point.first] = c;
+        }
+    };
+    for (std::pair<unsigned int, unsigned int> spawnpoint: level.spawnpoints) {
+        mark(spawnpoint, '*');
+    }
+    if (level.hasPlayerSpawnpoint) {
+        mark(level.playerSpawnpoint, '+');
+    }
+    if (level.hasEagle) {
+        mark(level.eagleLocation, 'E');
+    }
+    for (const std::string &row: rows) {
+        output << row << '\n';
+    }
+}
+
+std::size_t LevelPack::getLevelCount() const {
+    return levels_.size();
+}
+
+LevelPack::LevelView LevelPack::getLevelAt(std::size_t index) const {
+    return levels_.at(index);
+}
+
+std::optional<LevelPack::LevelView> LevelPack::findLevel(unsigned int number) const {
+    auto level = std::find_if(levels_.begin(), levels_.end(), [number](const LevelView &view) {
+        return view.getNumber() == number;
+    });
+    if (level == levels_.end()) {
+        return std::nullopt;
+    }
+    return *level;
+}
@@ -0,0 +1,110 @@
+#include "include/LevelPreloader.h"
+#include "include/Grid.h"
+#include "include/GridBuilder.h"
+
+LevelPreloader::LevelPreloader(Builder builder) : builder_(std::move(builder)) {
+    if (!builder_) {
+        builder_ = [](unsigned int level) { return GridBuilder::buildLevel(level); };
+    }
+}
+
+LevelPreloader::~LevelPreloader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    requested_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void LevelPreloader::preload(unsigned int level) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (level_ == level) {
+            return;
+        }
+        level_ = level;
+        grid_.reset();
+        generation_++;
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&LevelPreloader::workerLoop, this);
+        }
+    }
+    requested_.notify_all();
+}
+
+void LevelPreloader::invalidate(unsigned int level) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (level_ != level) {
+            return;
+        }
+        grid_.reset();
+        generation_++;
+    }
+    requested_.notify_all();
+}
+
+std::unique_ptr<Grid> LevelPreloader::take(unsigned int level) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        built_.wait(lock, [this, level]() { return level_ != level || grid_ != nullptr; });
+        if (level_ == level) {
+            hits_++;
+            level_.reset();
+            return std::move(grid_);
+        }
+        misses_++;
+    }
+    return builder_(level);
+}
+
+bool LevelPreloader::isReady(unsigned int level) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return level_ == level && grid_ != nullptr;
+}
+
+unsigned int LevelPreloader::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+unsigned int LevelPreloader::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void LevelPreloader::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        requested_.wait(lock, [this]() { return stopping_ || (level_.has_value() && grid_ == nullptr && !building_); });
+        if (stopping_) {
+            return;
+        }
+
+        unsigned int level = level_.value();
+        std::uint64_t generation = generation_;
+        building_ = true;
+        lock.unlock();
+        std::unique_ptr<Grid> grid;
+        try {
+            grid = builder_(level);
+        } catch (...) {
+            // left for take to build again
+        }
+        lock.lock();
+        building_ = false;
+
+        // the level might have been dropped, replaced or changed while it was built
+        if (level_ == level && generation_ == generation) {
+            if (grid != nullptr) {
+                grid_ = std::move(grid);
+            } else {
+                level_.reset();
+            }
+        }
+        built_.notify_all();
+    }
+}
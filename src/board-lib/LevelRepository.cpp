@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+
+#include "include/LevelRepository.h"
+#include "include/Grid.h"
+#include "include/GridBuilder.h"
+#include "../core-lib/include/SingletonExceptions.h"
+
+namespace {
+    constexpr std::uint64_t FnvOffset = 14695981039346656037ull;
+    constexpr std::uint64_t FnvPrime = 1099511628211ull;
+
+    void hashByte(std::uint64_t &hash, std::uint8_t byte) {
+        hash = (hash ^ byte) * FnvPrime;
+    }
+
+    /**
+     * Hashes the bytes of a value, lowest first, so hashes do not depend on the byte order of the machine
+     */
+    void hashValue(std::uint64_t &hash, std::uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            hashByte(hash, static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    }
+}
+
+std::unique_ptr<LevelRepository> LevelRepository::self_ = nullptr;
+
+LevelRepository::LevelRepository(const std::vector<std::string> &directories, bool validating)
+        : validating_(validating) {
+    for (const std::string &directory: directories) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error)) {
+            continue;
+        }
+        std::vector<std::filesystem::path> packs;
+        std::vector<std::filesystem::path> texts;
+        for (const std::filesystem::directory_entry &file: std::filesystem::directory_iterator(directory, error)) {
+            if (!file.is_regular_file(error)) {
+                continue;
+            }
+            if (file.path().extension() == ".pack") {
+                packs.push_back(file.path());
+            } else if (file.path().extension() == ".txt") {
+                texts.push_back(file.path());
+            }
+        }
+        std::sort(packs.begin(), packs.end());
+        std::sort(texts.begin(), texts.end());
+
+        for (const std::filesystem::path &path: packs) {
+            std::unique_ptr<LevelPack> pack = LevelPack::open(path.string());
+            if (pack == nullptr) {
+                continue;
+            }
+            for (std::size_t i = 0; i < pack->getLevelCount(); i++) {
+                LevelPack::LevelView view = pack->getLevelAt(i);
+                Entry entry;
+                entry.number = view.getNumber();
+                entry.name = "lvl" + std::to_string(view.getNumber());
+                entry.path = path.string();
+                entry.packed = true;
+                addLevel(std::move(entry), view.toLevel(), view);
+            }
+            packs_.push_back(std::move(pack));
+        }
+
+        for (const std::filesystem::path &path: texts) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                continue;
+            }
+            Entry entry;
+            entry.name = path.stem().string();
+            entry.number = levelNumberOf(entry.name);
+            entry.path = path.string();
+            LevelPack::Level level = LevelPack::parseText(file, entry.number.value_or(0));
+            addLevel(std::move(entry), level, std::nullopt);
+        }
+    }
+    sortEntries();
+}
+
+void LevelRepository::sortEntries() {
+    // numbered levels first, then by name
+    std::vector<std::size_t> order(entries_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        const Entry &first = entries_[a];
+        const Entry &second = entries_[b];
+        if (first.number.has_value() != second.number.has_value()) {
+            return first.number.has_value();
+        }
+        if (first.number != second.number) {
+            return first.number < second.number;
+        }
+        return first.name < second.name;
+    });
+    std::vector<Entry> entries;
+    std::vector<std::optional<LevelPack::LevelView>> views;
+    byNumber_.clear();
+    byName_.clear();
+    for (std::size_t index: order) {
+        if (entries_[index].number.has_value()) {
+            byNumber_[entries_[index].number.value()] = entries.size();
+        }
+        byName_[entries_[index].name] = entries.size();
+        entries.push_back(std::move(entries_[index]));
+        views.push_back(views_[index]);
+    }
+    entries_ = std::move(entries);
+    views_ = std::move(views);
+}
+
+void LevelRepository::addLevel(Entry entry, const LevelPack::Level &level, std::optional<LevelPack::LevelView> view) {
+    if ((entry.number.has_value() && byNumber_.count(entry.number.value()) != 0) || byName_.count(entry.name) != 0) {
+        return;
+    }
+    entry.sizeX = level.sizeX;
+    entry.sizeY = level.sizeY;
+    entry.tankCount = level.tankTypes.size();
+    entry.hash = hashLevel(level);
+    entry.problems = LevelValidator::validate(level).problems;
+
+    if (entry.number.has_value()) {
+        byNumber_[entry.number.value()] = entries_.size();
+    }
+    byName_[entry.name] = entries_.size();
+    entries_.push_back(std::move(entry));
+    views_.push_back(view);
+}
+
+void LevelRepository::overrideLevel(const std::string &name, const std::string &path,
+                                    const LevelPack::Level &level) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Entry entry;
+    entry.name = name;
+    entry.number = levelNumberOf(name);
+    entry.path = path;
+
+    // the level can shadow a level with the same name, and another one with the same number (lvl03 and lvl3)
+    std::vector<std::size_t> replaced;
+    auto byName = byName_.find(name);
+    if (byName != byName_.end()) {
+        replaced.push_back(byName->second);
+    }
+    auto byNumber = entry.number.has_value() ? byNumber_.find(entry.number.value()) : byNumber_.end();
+    if (byNumber != byNumber_.end() && (replaced.empty() || replaced[0] != byNumber->second)) {
+        replaced.push_back(byNumber->second);
+    }
+    std::sort(replaced.rbegin(), replaced.rend());
+    for (std::size_t index: replaced) {
+        entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(index));
+        views_.erase(views_.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+
+    byNumber_.clear();
+    byName_.clear();
+    addLevel(std::move(entry), level, std::nullopt);
+    sortEntries();
+}
+
+bool LevelRepository::isValidating() const {
+    return validating_;
+}
+
+void LevelRepository::initialize(const std::vector<std::string> &directories, bool validating) {
+    self_ = std::unique_ptr<LevelRepository>(new LevelRepository(directories, validating));
+}
+
+LevelRepository *LevelRepository::instance() {
+    if (!self_) {
+        throw SingletonNotInitializedException();
+    }
+
+    return self_.get();
+}
+
+const std::vector<LevelRepository::Entry> &LevelRepository::getEntries() const {
+    return entries_;
+}
+
+const LevelRepository::Entry *LevelRepository::findLevel(unsigned int number) const {
+    auto found = byNumber_.find(number);
+    return found == byNumber_.end() ? nullptr : &entries_[found->second];
+}
+
+const LevelRepository::Entry *LevelRepository::findLevel(const std::string &name) const {
+    auto found = byName_.find(name);
+    return found == byName_.end() ? nullptr : &entries_[found->second];
+}
+
+std::vector<const LevelRepository::Entry *> LevelRepository::getShard(std::size_t shard, std::size_t shardCount) const {
+    std::vector<const Entry *> entries;
+    if (shardCount == 0) {
+        return entries;
+    }
+    for (std::size_t i = shard; i < entries_.size(); i += shardCount) {
+        entries.push_back(&entries_[i]);
+    }
+    return entries;
+}
+
+LevelPack::Level LevelRepository::readLevel(const Entry &entry) const {
+    std::size_t index = &entry - entries_.data();
+    if (views_[index].has_value()) {
+        return views_[index]->toLevel();
+    }
+
+    std::ifstream file(entry.path);
+    if (!file.is_open()) {
+        throw InvalidLevelFile(entry.path + ": could not be read");
+    }
+    return LevelPack::parseText(file, entry.number.value_or(0));
+}
+
+std::unique_ptr<Grid> LevelRepository::buildLevel(unsigned int number) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const Entry *entry = findLevel(number);
+    if (entry == nullptr) {
+        throw InvalidLevelFile("There is no level " + std::to_string(number));
+    }
+    return buildLevel(*entry);
+}
+
+std::unique_ptr<Grid> LevelRepository::buildLevel(const std::string &name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const Entry *entry = findLevel(name);
+    if (entry == nullptr) {
+        throw InvalidLevelFile("There is no level named " + name);
+    }
+    return buildLevel(*entry);
+}
+
+std::unique_ptr<Grid> LevelRepository::buildLevel(const Entry &entry) const {
+    std::size_t index = &entry - entries_.data();
+    if (views_[index].has_value()) {
+        // packs do not change while they are mapped, so problems found when indexing them still hold
+        LevelValidator::Report report{entry.problems};
+        if (validating_ && !report.isValid()) {
+            throw InvalidLevelFile(entry.path + ": " + entry.name + ": " + report.describe());
+        }
+        return GridBuilder::buildLevel(views_[index].value());
+    }
+
+    LevelPack::Level level = readLevel(entry);
+    if (validating_) {
+        LevelValidator::Report report = LevelValidator::validate(level);
+        if (!report.isValid()) {
+            throw InvalidLevelFile(entry.path + ": " + report.describe());
+        }
+    }
+    return GridBuilder::buildLevel(level);
+}
+
+std::optional<unsigned int> LevelRepository::levelNumberOf(const std::string &name) {
+    if (name.size() <= 3 || name.size() > 12 || name.compare(0, 3, "lvl") != 0 ||
+        !std::all_of(name.begin() + 3, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return std::nullopt;
+    }
+    return static_cast<unsigned int>(std::stoul(name.substr(3)));
+}
+
+std::uint64_t LevelRepository::hashLevel(const LevelPack::Level &level) {
+    std::uint64_t hash = FnvOffset;
+    hashValue(hash, level.sizeX);
+    hashValue(hash, level.sizeY);
+    for (std::uint8_t tile: level.tiles) {
+        hashByte(hash, tile);
+    }
+    hashValue(hash, static_cast<std::uint32_t>(level.spawnpoints.size()));
+    for (std::pair<unsigned int, unsigned int> spawnpoint: level.spawnpoints) {
+        hashValue(hash, spawnpoint.first);
+        hashValue(hash, spawnpoint.second);
+    }
+    hashValue(hash, level.playerSpawnpoint.first);
+    hashValue(hash, level.playerSpawnpoint.second);
+    hashValue(hash, level.eagleLocation.first);
+    hashValue(hash, level.eagleLocation.second);
+    for (Tank::TankType type: level.tankTypes) {
+        hashByte(hash, static_cast<std::uint8_t>(type));
+    }
+    return hash;
+}
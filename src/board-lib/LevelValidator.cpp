@@ -0,0 +1,463 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include "include/LevelValidator.h"
+#include "include/FlowField.h"
+#include "include/TileManager.h"
+
+namespace {
+    constexpr unsigned int Footprint = FlowField::FootprintSize;
+
+    /**
+     * Whether a stored tile value stops tanks for good
+     */
+    const std::array<bool, 256> BlockingTiles = [] {
+        std::array<bool, 256> table{};
+        for (unsigned int value = 0; value < 256; value++) {
+            auto tile = static_cast<TileType>(value);
+            table[value] = TileManager::isTileCollidable(tile) && !TileManager::isTileDestructible(tile);
+        }
+        return table;
+    }();
+
+    /**
+     * Stored values of tiles stopping tanks for good
+     */
+    const std::vector<std::uint8_t> BlockingValues = [] {
+        std::vector<std::uint8_t> values;
+        for (unsigned int value = 0; value < 256; value++) {
+            if (BlockingTiles[value]) {
+                values.push_back(static_cast<std::uint8_t>(value));
+            }
+        }
+        return values;
+    }();
+
+    /**
+     * Finds tiles stopping tanks among eight tiles at once
+     * @param tiles Eight tiles, the first one in the lowest byte
+     * @return A bit for each tile, the first one lowest
+     */
+    std::uint64_t blockingBytes(std::uint64_t tiles) {
+        constexpr std::uint64_t Low = 0x7f7f7f7f7f7f7f7full;
+        std::uint64_t found = 0;
+        for (std::uint8_t value: BlockingValues) {
+            // the highest bit of every byte equal to the value
+            std::uint64_t difference = tiles ^ (value * 0x0101010101010101ull);
+            found |= ~(((difference & Low) + Low) | difference | Low);
+        }
+        // gathers the highest bits of the bytes into the highest byte
+        return ((found >> 7) * 0x0102040810204080ull) >> 56;
+    }
+
+    /**
+     * A bit for every position of a level: line x holds positions (x, 0) to (x, sizeY - 1), 64 to a word
+     */
+    struct Positions {
+        Positions(unsigned int sizeX, unsigned int sizeY)
+                : lineCount(sizeX), lineWords((sizeY + 63) / 64), words(std::size_t{sizeX} * lineWords, 0) {}
+
+        std::uint64_t *line(std::size_t x) {
+            return words.data() + x * lineWords;
+        }
+
+        [[nodiscard]] const std::uint64_t *line(std::size_t x) const {
+            return words.data() + x * lineWords;
+        }
+
+        [[nodiscard]] bool test(unsigned int x, unsigned int y) const {
+            return (line(x)[y / 64] >> (y % 64) & 1) != 0;
+        }
+
+        void set(unsigned int x, unsigned int y) {
+            line(x)[y / 64] |= std::uint64_t{1} << (y % 64);
+        }
+
+        void reset(unsigned int x, unsigned int y) {
+            line(x)[y / 64] &= ~(std::uint64_t{1} << (y % 64));
+        }
+
+        std::size_t lineCount;
+        std::size_t lineWords;
+        std::vector<std::uint64_t> words;
+    };
+
+    /**
+     * Positions of the level free for a tank, not counting the eagle
+     */
+    Positions freePositions(const LevelPack::Level &level) {
+        Positions free(level.sizeX, level.sizeY);
+        std::size_t words = free.lineWords;
+        if (level.sizeX < Footprint || level.sizeY < Footprint) {
+            return free;
+        }
+
+        // positions where the tank's column of tiles is free, with the tank not sticking out of the bottom
+        std::vector<std::uint64_t> blocked(words + 1, 0);
+        std::vector<std::uint64_t> inside(words, 0);
+        for (unsigned int y = 0; y + Footprint <= level.sizeY; y++) {
+            inside[y / 64] |= std::uint64_t{1} << (y % 64);
+        }
+        for (unsigned int x = 0; x < level.sizeX; x++) {
+            const std::uint8_t *column = level.tiles.data() + std::size_t{x} * level.sizeY;
+            for (std::size_t w = 0; w < words; w++) {
+                std::size_t first = w * 64;
+                std::size_t count = std::min<std::size_t>(64, level.sizeY - first);
+                std::uint64_t bits = 0;
+                std::size_t k = 0;
+                if constexpr (std::endian::native == std::endian::little) {
+                    for (; k + 8 <= count; k += 8) {
+                        std::uint64_t tiles;
+                        std::memcpy(&tiles, column + first + k, sizeof(tiles));
+                        bits |= blockingBytes(tiles) << k;
+                    }
+                }
+                for (; k < count; k++) {
+                    bits |= std::uint64_t{BlockingTiles[column[first + k]]} << k;
+                }
+                blocked[w] = bits;
+            }
+            std::uint64_t *line = free.line(x);
+            for (std::size_t w = 0; w < words; w++) {
+                std::uint64_t covered = blocked[w];
+                for (unsigned int k = 1; k < Footprint; k++) {
+                    covered |= blocked[w] >> k | blocked[w + 1] << (64 - k);
+                }
+                line[w] = ~covered & inside[w];
+            }
+        }
+
+        // and where the next columns under the tank are free too
+        for (unsigned int x = 0; x < level.sizeX; x++) {
+            std::uint64_t *line = free.line(x);
+            for (unsigned int k = 1; k < Footprint; k++) {
+                if (x + k >= level.sizeX) {
+                    std::fill(line, line + words, 0);
+                    break;
+                }
+                const std::uint64_t *next = free.line(x + k);
+                for (std::size_t w = 0; w < words; w++) {
+                    line[w] &= next[w];
+                }
+            }
+        }
+        return free;
+    }
+
+    /**
+     * A range of words of a line, empty when first > last
+     */
+    struct Words {
+        std::size_t first;
+        std::size_t last;
+
+        void add(Words other) {
+            if (first > last) {
+                *this = other;
+            } else {
+                first = std::min(first, other.first);
+                last = std::max(last, other.last);
+            }
+        }
+    };
+
+    constexpr Words NoWords{SIZE_MAX, 0};
+
+    /**
+     * Fills the runs of free positions of a line that hold newly reached positions. Words without them are skipped,
+     * unless a run goes on into them
+     * @param entered Newly reached positions, already set in reached
+     * @param changed Words with newly reached positions
+     * @return Words that may have changed
+     */
+    Words fillLine(std::uint64_t *reached, const std::uint64_t *free, const std::uint64_t *entered, std::size_t words,
+                   Words changed) {
+        Words filled = changed;
+
+        // upwards: adding reached positions to free ones carries through the rest of their runs, clearing it
+        std::uint64_t carry = 0;
+        for (std::size_t w = changed.first; w < words && (w <= changed.last || carry != 0); w++) {
+            if (entered[w] == 0 && carry == 0) {
+                continue;
+            }
+            std::uint64_t sum = free[w] + reached[w];
+            std::uint64_t carryOut = sum < free[w];
+            sum += carry;
+            carryOut |= sum < carry;
+            reached[w] |= free[w] & ~sum;
+            carry = carryOut;
+            filled.last = std::max(filled.last, w);
+        }
+
+        // downwards, by doubling shifts
+        std::uint64_t carried = 0;
+        for (std::size_t w = changed.last + 1; w-- > 0 && (w >= changed.first || carried != 0);) {
+            if (entered[w] == 0 && carried == 0) {
+                continue;
+            }
+            std::uint64_t bits = reached[w] | (free[w] & carried);
+            std::uint64_t open = free[w];
+            for (unsigned int shift = 1; shift < 64; shift *= 2) {
+                bits |= open & (bits >> shift);
+                open &= open >> shift;
+            }
+            reached[w] = bits;
+            carried = (bits & 1) << 63;
+            filled.first = std::min(filled.first, w);
+        }
+        return filled;
+    }
+
+    /**
+     * Spreads reached positions over free ones, until no more can be reached
+     * @param reached Output argument!
+     * @param first Output argument! First line with reached positions
+     * @param last Output argument! Last line with reached positions
+     */
+    void flood(Positions &reached, const Positions &free, std::size_t &first, std::size_t &last) {
+        // words of each line changed since the lines after and before it took reached positions from it
+        std::vector<Words> changedForNext(reached.lineCount, NoWords);
+        std::vector<Words> changedForPrevious(reached.lineCount, NoWords);
+
+        std::vector<std::uint64_t> entered(reached.lineWords, 0);
+
+        // moves reached positions of a line to the free positions of another one next to it
+        auto spread = [&](std::size_t to, std::size_t from, Words &changed) {
+            if (changed.first > changed.last) {
+                return false;
+            }
+            std::uint64_t *target = reached.line(to);
+            const std::uint64_t *source = reached.line(from);
+            const std::uint64_t *open = free.line(to);
+            Words enteredWords = NoWords;
+            for (std::size_t w = changed.first; w <= changed.last; w++) {
+                entered[w] = source[w] & open[w] & ~target[w];
+                if (entered[w] != 0) {
+                    target[w] |= entered[w];
+                    enteredWords.first = std::min(enteredWords.first, w);
+                    enteredWords.last = w;
+                }
+            }
+            if (enteredWords.first > enteredWords.last) {
+                changed = NoWords;
+                return false;
+            }
+            Words filled = fillLine(target, open, entered.data(), reached.lineWords, enteredWords);
+            std::fill(entered.begin() + changed.first, entered.begin() + changed.last + 1, 0);
+            changed = NoWords;
+            changedForNext[to].add(filled);
+            changedForPrevious[to].add(filled);
+            return true;
+        };
+
+        for (std::size_t x = first; x <= last; x++) {
+            Words filled = fillLine(reached.line(x), free.line(x), reached.line(x), reached.lineWords,
+                                    {0, reached.lineWords - 1});
+            changedForNext[x] = filled;
+            changedForPrevious[x] = filled;
+        }
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (std::size_t x = first + 1; x < reached.lineCount; x++) {
+                bool spreadTo = spread(x, x - 1, changedForNext[x - 1]);
+                changed = changed || spreadTo;
+                if (x > last) {
+                    if (!spreadTo) {
+                        break;
+                    }
+                    last = x;
+                }
+            }
+            for (std::size_t x = last; x-- > 0;) {
+                bool spreadTo = spread(x, x + 1, changedForPrevious[x + 1]);
+                changed = changed || spreadTo;
+                if (x < first) {
+                    if (!spreadTo) {
+                        break;
+                    }
+                    first = x;
+                }
+            }
+        }
+    }
+
+    std::size_t countPositions(const Positions &positions) {
+        std::size_t count = 0;
+        for (std::uint64_t word: positions.words) {
+            count += std::popcount(word);
+        }
+        return count;
+    }
+
+    bool overlap(std::pair<unsigned int, unsigned int> a, std::pair<unsigned int, unsigned int> b) {
+        return a.first < b.first + Footprint && b.first < a.first + Footprint && a.second < b.second + Footprint &&
+               b.second < a.second + Footprint;
+    }
+
+    /**
+     * Checks if a tank-sized square at a point fits the level without standing on collidable tiles
+     */
+    bool fits(const LevelPack::Level &level, std::pair<unsigned int, unsigned int> point) {
+        auto [x, y] = point;
+        if (x >= level.sizeX || y >= level.sizeY || level.sizeX - x < Footprint || level.sizeY - y < Footprint) {
+            return false;
+        }
+        for (unsigned int i = x; i < x + Footprint; i++) {
+            for (unsigned int j = y; j < y + Footprint; j++) {
+                if (TileManager::isTileCollidable(level.getTile(i, j))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+bool LevelValidator::Problem::isError() const {
+    return type != IsolatedRegion;
+}
+
+std::string LevelValidator::Problem::describe() const {
+    std::string point = "(" + std::to_string(location.first) + ", " + std::to_string(location.second) + ")";
+    switch (type) {
+        case MissingPlayerSpawnpoint:
+            return "there is no player spawnpoint";
+        case MissingEagle:
+            return "there is no eagle";
+        case MissingSpawnpoints:
+            return "there are enemy tanks but no spawnpoints";
+        case EagleBlocked:
+            return "the eagle at " + point + " does not fit the level";
+        case SpawnpointBlocked:
+            return "a tank does not fit the spawnpoint at " + point;
+        case PlayerSpawnpointBlocked:
+            return "a tank does not fit the player spawnpoint at " + point;
+        case SpawnpointUnreachable:
+            return "the eagle cannot be reached from the spawnpoint at " + point;
+        case PlayerSpawnpointUnreachable:
+            return "the eagle cannot be reached from the player spawnpoint at " + point;
+        case SpawnpointsOverlap:
+            return "tanks spawned at " + point + " would overlap";
+        case IsolatedRegion:
+            return "the eagle cannot be reached from the region at " + point;
+    }
+    return "unknown problem";
+}
+
+bool LevelValidator::Report::isValid() const {
+    return std::none_of(problems.begin(), problems.end(), [](const Problem &problem) { return problem.isError(); });
+}
+
+std::string LevelValidator::Report::describe() const {
+    std::string description;
+    for (bool errors: {true, false}) {
+        for (const Problem &problem: problems) {
+            if (problem.isError() == errors) {
+                description += (description.empty() ? "" : "; ") + problem.describe();
+            }
+        }
+    }
+    return description;
+}
+
+LevelValidator::Report LevelValidator::validate(const LevelPack::Level &level) {
+    Report report;
+    auto problem = [&report](ProblemType type, std::pair<unsigned int, unsigned int> location = {0, 0}) {
+        report.problems.push_back({type, location});
+    };
+
+    if (!level.hasPlayerSpawnpoint) {
+        problem(MissingPlayerSpawnpoint);
+    }
+    if (!level.hasEagle) {
+        problem(MissingEagle);
+    }
+    if (level.spawnpoints.empty() && !level.tankTypes.empty()) {
+        problem(MissingSpawnpoints);
+    }
+    if (level.hasEagle && !fits(level, level.eagleLocation)) {
+        problem(EagleBlocked, level.eagleLocation);
+    }
+    if (level.hasPlayerSpawnpoint && !fits(level, level.playerSpawnpoint)) {
+        problem(PlayerSpawnpointBlocked, level.playerSpawnpoint);
+    }
+    for (std::size_t i = 0; i < level.spawnpoints.size(); i++) {
+        std::pair<unsigned int, unsigned int> spawnpoint = level.spawnpoints[i];
+        if (!fits(level, spawnpoint)) {
+            problem(SpawnpointBlocked, spawnpoint);
+        }
+        bool overlaps = (level.hasEagle && overlap(spawnpoint, level.eagleLocation)) ||
+                        (level.hasPlayerSpawnpoint && overlap(spawnpoint, level.playerSpawnpoint));
+        for (std::size_t j = 0; j < level.spawnpoints.size() && !overlaps; j++) {
+            overlaps = j != i && overlap(spawnpoint, level.spawnpoints[j]);
+        }
+        if (overlaps) {
+            problem(SpawnpointsOverlap, spawnpoint);
+        }
+    }
+
+    Positions free = freePositions(level);
+    Positions reached(level.sizeX, level.sizeY);
+    auto [eagleX, eagleY] = level.eagleLocation;
+    if (level.hasEagle && eagleX < level.sizeX && eagleY < level.sizeY) {
+        // positions overlapping the eagle are taken, the ones touching it reach it
+        for (unsigned int x = eagleX - std::min(eagleX, Footprint); x <= eagleX + Footprint && x < level.sizeX; x++) {
+            for (unsigned int y = eagleY - std::min(eagleY, Footprint);
+                 y <= eagleY + Footprint && y < level.sizeY; y++) {
+                if (overlap({x, y}, level.eagleLocation)) {
+                    free.reset(x, y);
+                } else if (free.test(x, y)) {
+                    reached.set(x, y);
+                }
+            }
+        }
+        std::size_t first = eagleX - std::min(eagleX, Footprint);
+        std::size_t last = std::min(eagleX + Footprint, level.sizeX - 1);
+        flood(reached, free, first, last);
+    }
+
+    auto reachable = [&level, &free, &reached](std::pair<unsigned int, unsigned int> point) {
+        return point.first >= level.sizeX || point.second >= level.sizeY || !free.test(point.first, point.second) ||
+               reached.test(point.first, point.second);
+    };
+    if (level.hasEagle && level.hasPlayerSpawnpoint && !reachable(level.playerSpawnpoint)) {
+        problem(PlayerSpawnpointUnreachable, level.playerSpawnpoint);
+    }
+    for (std::pair<unsigned int, unsigned int> spawnpoint: level.spawnpoints) {
+        if (level.hasEagle && !reachable(spawnpoint)) {
+            problem(SpawnpointUnreachable, spawnpoint);
+        }
+    }
+
+    // free positions left are isolated, each region is flooded on it's own
+    for (std::size_t w = 0; w < free.words.size(); w++) {
+        free.words[w] &= ~reached.words[w];
+    }
+    report.reachablePositions = countPositions(reached);
+    report.isolatedPositions = countPositions(free);
+    std::fill(reached.words.begin(), reached.words.end(), 0);
+    std::size_t regions = 0;
+    for (std::size_t w = 0; w < free.words.size() && regions < MaxReportedRegions; w++) {
+        while (free.words[w] != 0 && regions < MaxReportedRegions) {
+            std::size_t x = w / free.lineWords;
+            std::size_t y = (w % free.lineWords) * 64 + std::countr_zero(free.words[w]);
+            reached.set(x, y);
+            std::size_t first = x;
+            std::size_t last = x;
+            flood(reached, free, first, last);
+            for (std::size_t line = first; line <= last; line++) {
+                for (std::size_t word = 0; word < free.lineWords; word++) {
+                    free.line(line)[word] &= ~reached.line(line)[word];
+                    reached.line(line)[word] = 0;
+                }
+            }
+            problem(IsolatedRegion, {static_cast<unsigned int>(x), static_cast<unsigned int>(y)});
+            regions++;
+        }
+    }
+    return report;
+}
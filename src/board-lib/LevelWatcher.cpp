@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <fstream>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "../core-lib/include/Event.h"
+#include "include/LevelWatcher.h"
+#include "include/Board.h"
+#include "include/LevelRepository.h"
+
+LevelWatcher::LevelWatcher(const std::vector<std::string> &directories) {
+    inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_ < 0) {
+        return;
+    }
+    for (const std::string &directory: directories) {
+        int watch = inotify_add_watch(inotify_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch >= 0) {
+            watches_.emplace_back(watch, directory);
+        }
+    }
+    if (watches_.empty() || pipe(stopPipe_) != 0) {
+        close(inotify_);
+        inotify_ = -1;
+        watches_.clear();
+        return;
+    }
+    thread_ = std::thread(&LevelWatcher::watchLoop, this);
+}
+
+LevelWatcher::~LevelWatcher() {
+    if (thread_.joinable()) {
+        char stop = 0;
+        (void) write(stopPipe_[1], &stop, 1);
+        thread_.join();
+    }
+    for (int descriptor: {inotify_, stopPipe_[0], stopPipe_[1]}) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+}
+
+bool LevelWatcher::isWatching() const {
+    return thread_.joinable();
+}
+
+std::vector<LevelWatcher::Change> LevelWatcher::takeChanges() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Change> changes;
+    changes.swap(changes_);
+    return changes;
+}
+
+std::size_t LevelWatcher::applyChanges(Board &board) {
+    LevelRepository *repository = LevelRepository::instance();
+    std::size_t changed = 0;
+    for (Change &change: takeChanges()) {
+        if (repository->isValidating() && !change.report.isValid()) {
+            refused_.push_back(std::move(change));
+            continue;
+        }
+        repository->overrideLevel(change.name, change.path, change.level);
+        if (!change.number.has_value()) {
+            continue;
+        }
+        if (change.number.value() == board.getLevelNumber()) {
+            changed += board.applyLevelTiles(change.level);
+        }
+        board.getLevelPreloader().invalidate(change.number.value());
+    }
+    return changed;
+}
+
+std::vector<LevelWatcher::Change> LevelWatcher::takeRefused() {
+    std::vector<Change> refused;
+    refused.swap(refused_);
+    return refused;
+}
+
+void LevelWatcher::watchLoop() {
+    // aligned like struct inotify_event, as events are read straight from it
+    alignas(inotify_event) char buffer[4096];
+    pollfd descriptors[2] = {{inotify_, POLLIN, 0}, {stopPipe_[0], POLLIN, 0}};
+    while (true) {
+        if (poll(descriptors, 2, -1) < 0) {
+            continue;
+        }
+        if (descriptors[1].revents != 0) {
+            return;
+        }
+
+        ssize_t length;
+        while ((length = read(inotify_, buffer, sizeof(buffer))) > 0) {
+            for (char *position = buffer; position < buffer + length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(position);
+                position += sizeof(inotify_event) + event->len;
+                if (event->len == 0) {
+                    continue;
+                }
+                auto watch = std::find_if(watches_.begin(), watches_.end(),
+                                          [event](const std::pair<int, std::string> &entry) {
+                                              return entry.first == event->wd;
+                                          });
+                if (watch != watches_.end()) {
+                    readLevel(watch->second, event->name);
+                }
+            }
+        }
+    }
+}
+
+void LevelWatcher::readLevel(const std::string &directory, const std::string &file) {
+    if (file.size() <= 4 || file.compare(file.size() - 4, 4, ".txt") != 0) {
+        return;
+    }
+    std::ifstream input(directory + "/" + file);
+    if (!input.is_open()) {
+        return;
+    }
+    Change change;
+    change.name = file.substr(0, file.size() - 4);
+    change.number = LevelRepository::levelNumberOf(change.name);
+    change.path = directory + "/" + file;
+    change.level = LevelPack::parseText(input, change.number.value_or(0));
+    change.report = LevelValidator::validate(change.level);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto older = std::find_if(changes_.begin(), changes_.end(),
+                              [&change](const Change &other) { return other.name == change.name; });
+    if (older != changes_.end()) {
+        *older = std::move(change);
+    } else {
+        changes_.push_back(std::move(change));
+    }
+}
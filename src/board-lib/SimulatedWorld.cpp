@@ -0,0 +1,438 @@
+#include <algorithm>
+
+#include "include/SimulatedWorld.h"
+#include "include/Board.h"
+#include "include/Eagle.h"
+#include "include/Grid.h"
+#include "include/TileManager.h"
+#include "../tank-lib/include/Bullet.h"
+#include "../tank-lib/include/EntityController.h"
+#include "../tank-lib/include/MovementIntegrator.h"
+#include "../tank-lib/include/Tank.h"
+
+class SimulatedWorld::ForkedGrid : public Grid {
+public:
+    /**
+     * Copies a grid. Versions of forked grids are always 0, which is never the version of a real grid
+     */
+    explicit ForkedGrid(const Grid &grid) : Grid(grid) {
+        version_ = 0;
+    }
+
+    void copyFrom(const Grid &grid) {
+        Grid::operator=(grid);
+        version_ = 0;
+    }
+
+    /**
+     * Deletes a tile without queueing events
+     */
+    void clearTile(unsigned int x, unsigned int y) {
+        bool wasCollidable = isTileCollidable(x, y);
+        grid[x][y] = NullTile;
+        if (wasCollidable) {
+            updateFreeRuns(x, y);
+        }
+    }
+};
+
+namespace {
+    /**
+     * Removes all entities, keeping the memory
+     */
+    void clearEntities(SimulatedWorld::Entities &entities) {
+        entities.x.clear();
+        entities.y.clear();
+        entities.sizeX.clear();
+        entities.sizeY.clear();
+        entities.step.clear();
+        entities.bulletStep.clear();
+        entities.facing.clear();
+        entities.kind.clear();
+        entities.moving.clear();
+        entities.alive.clear();
+        entities.lives.clear();
+        entities.link.clear();
+    }
+}
+
+SimulatedWorld::SimulatedWorld() = default;
+
+SimulatedWorld::~SimulatedWorld() = default;
+
+void SimulatedWorld::capture(Board &board) {
+    clearEntities(entities_);
+    indices_.clear();
+    grid_ = board.getGrid();
+    ownsGrid_ = false;
+
+    const MovementIntegrator &integrator = board.getMovementIntegrator();
+    std::vector<std::shared_ptr<Entity>> &all = *board.getEntityController()->getAllEntities();
+    std::vector<std::pair<std::uint32_t, Tank *>> tanks;
+    for (const std::shared_ptr<Entity> &entity: all) {
+        Kind kind;
+        unsigned int lives = 1;
+        FixedPoint::Value bulletStep = 0;
+        if (auto *tank = dynamic_cast<Tank *>(entity.get())) {
+            kind = tank->getType() == Tank::PlayerTank ? PlayerTank : EnemyTank;
+            lives = tank->getLives();
+            bulletStep = integrator.getStep(FixedPoint::fromFloat(tank->getBulletSpeed()));
+            tanks.emplace_back(static_cast<std::uint32_t>(size()), tank);
+        } else if (auto *bullet = dynamic_cast<Bullet *>(entity.get())) {
+            kind = bullet->isFriendly() ? FriendlyBullet : EnemyBullet;
+        } else if (dynamic_cast<::Eagle *>(entity.get()) != nullptr) {
+            kind = Eagle;
+        } else {
+            continue;
+        }
+
+        indices_[entity.get()] = static_cast<std::uint32_t>(size());
+        entities_.x.push_back(entity->getFixedX());
+        entities_.y.push_back(entity->getFixedY());
+        entities_.sizeX.push_back(entity->getFixedSizeX());
+        entities_.sizeY.push_back(entity->getFixedSizeY());
+        entities_.step.push_back(integrator.getStep(*entity));
+        entities_.bulletStep.push_back(bulletStep);
+        entities_.facing.push_back(entity->getFacing());
+        entities_.kind.push_back(kind);
+        entities_.moving.push_back(entity->isMoving());
+        entities_.alive.push_back(1);
+        entities_.lives.push_back(lives);
+        entities_.link.push_back(None);
+    }
+
+    for (auto [index, tank]: tanks) {
+        std::optional<Bullet *> bullet = tank->getBullet();
+        std::optional<std::uint32_t> bulletIndex = bullet.has_value() ? indexOf(bullet.value()) : std::nullopt;
+        if (bulletIndex.has_value()) {
+            entities_.link[index] = bulletIndex.value();
+            entities_.link[bulletIndex.value()] = index;
+        }
+    }
+}
+
+std::optional<std::uint32_t> SimulatedWorld::indexOf(const Entity *entity) const {
+    auto index = indices_.find(entity);
+    if (index == indices_.end()) {
+        return std::nullopt;
+    }
+    return index->second;
+}
+
+void SimulatedWorld::copyFrom(const SimulatedWorld &source) {
+    if (&source == this) {
+        return;
+    }
+    // assigning vectors reuses their memory
+    entities_ = source.entities_;
+    indices_.clear();
+    grid_ = source.grid_;
+    ownsGrid_ = false;
+}
+
+void SimulatedWorld::fork(const SimulatedWorld &source, std::uint32_t focus, FixedPoint::Value radius) {
+    clearEntities(entities_);
+    indices_.clear();
+    grid_ = source.grid_;
+    ownsGrid_ = false;
+
+    remap_.assign(source.size(), None);
+    Sweep::Box area = source.boxOf(focus);
+    area = {area.x - radius, area.y - radius, area.sizeX + 2 * radius, area.sizeY + 2 * radius};
+    remap_[focus] = 0;
+    append(source, focus);
+    for (std::uint32_t i = 0; i < source.size(); i++) {
+        Kind kind = source.entities_.kind[i];
+        if (i == focus || !source.entities_.alive[i] ||
+            (kind != PlayerTank && kind != Eagle && !Sweep::overlaps(area, source.boxOf(i)))) {
+            continue;
+        }
+        remap_[i] = static_cast<std::uint32_t>(size());
+        append(source, i);
+    }
+
+    // links to entities left out are dropped
+    for (std::uint32_t &link: entities_.link) {
+        if (link != None) {
+            link = remap_[link];
+        }
+    }
+}
+
+void SimulatedWorld::append(const SimulatedWorld &source, std::uint32_t index) {
+    const Entities &from = source.entities_;
+    entities_.x.push_back(from.x[index]);
+    entities_.y.push_back(from.y[index]);
+    entities_.sizeX.push_back(from.sizeX[index]);
+    entities_.sizeY.push_back(from.sizeY[index]);
+    entities_.step.push_back(from.step[index]);
+    entities_.bulletStep.push_back(from.bulletStep[index]);
+    entities_.facing.push_back(from.facing[index]);
+    entities_.kind.push_back(from.kind[index]);
+    entities_.moving.push_back(from.moving[index]);
+    entities_.alive.push_back(from.alive[index]);
+    entities_.lives.push_back(from.lives[index]);
+    entities_.link.push_back(from.link[index]);
+}
+
+void SimulatedWorld::setMoving(std::uint32_t tank, bool moving) {
+    entities_.moving[tank] = moving && entities_.alive[tank];
+}
+
+bool SimulatedWorld::rotate(std::uint32_t tank, Direction direction) {
+    auto facing = static_cast<Direction>(entities_.facing[tank]);
+    if (!entities_.alive[tank] || facing == direction) {
+        return entities_.alive[tank];
+    }
+
+    // turning by 90 degrees snaps the tank to the grid, like Board::snapTankToGrid
+    if ((facing + 2) % 4 != direction) {
+        FixedPoint::Value x = entities_.x[tank];
+        FixedPoint::Value y = entities_.y[tank];
+        switch (facing) {
+            case North:
+                entities_.y[tank] = FixedPoint::snapUp(y);
+                break;
+            case East:
+                entities_.x[tank] = FixedPoint::snapDown(x);
+                break;
+            case South:
+                entities_.y[tank] = FixedPoint::snapDown(y);
+                break;
+            case West:
+                entities_.x[tank] = FixedPoint::snapUp(x);
+                break;
+        }
+
+        Sweep::Box box = boxOf(tank);
+        bool blocked = box.x < 0 || box.y < 0 ||
+                       FixedPoint::ceilToTile(box.x + box.sizeX) > static_cast<int>(grid_->getSizeX()) ||
+                       FixedPoint::ceilToTile(box.y + box.sizeY) > static_cast<int>(grid_->getSizeY());
+        for (int i = FixedPoint::floorToTile(box.x); !blocked && i < FixedPoint::ceilToTile(box.x + box.sizeX); i++)
+            for (int j = FixedPoint::floorToTile(box.y); !blocked && j < FixedPoint::ceilToTile(box.y + box.sizeY); j++) {
+                blocked = grid_->isTileCollidable(i, j);
+            }
+        if (blocked) {
+            entities_.x[tank] = x;
+            entities_.y[tank] = y;
+            return false;
+        }
+    }
+
+    entities_.facing[tank] = direction;
+    return true;
+}
+
+std::optional<std::uint32_t> SimulatedWorld::fire(std::uint32_t tank) {
+    Kind kind = entities_.kind[tank];
+    if (!entities_.alive[tank] || (kind != PlayerTank && kind != EnemyTank) || entities_.link[tank] != None) {
+        return std::nullopt;
+    }
+
+    // in front of the tank, like Tank::createBullet
+    FixedPoint::Value x = entities_.x[tank];
+    FixedPoint::Value y = entities_.y[tank];
+    FixedPoint::Value sizeX = entities_.sizeX[tank];
+    FixedPoint::Value sizeY = entities_.sizeY[tank];
+    FixedPoint::Value bulletSize = Tank::BulletSize;
+    FixedPoint::Value bulletX = x;
+    FixedPoint::Value bulletY = y;
+    switch (static_cast<Direction>(entities_.facing[tank])) {
+        case North:
+            bulletX = x + (sizeX - bulletSize) / 2;
+            bulletY = y - bulletSize;
+            break;
+        case East:
+            bulletX = x + sizeX;
+            bulletY = y + (sizeY - bulletSize) / 2;
+            break;
+        case South:
+            bulletX = x + (sizeX - bulletSize) / 2;
+            bulletY = y + sizeY;
+            break;
+        case West:
+            bulletX = x - bulletSize;
+            bulletY = y + (sizeY - bulletSize) / 2;
+            break;
+    }
+
+    auto bullet = static_cast<std::uint32_t>(size());
+    entities_.x.push_back(bulletX);
+    entities_.y.push_back(bulletY);
+    entities_.sizeX.push_back(bulletSize);
+    entities_.sizeY.push_back(bulletSize);
+    entities_.step.push_back(entities_.bulletStep[tank]);
+    entities_.bulletStep.push_back(0);
+    entities_.facing.push_back(entities_.facing[tank]);
+    entities_.kind.push_back(kind == PlayerTank ? FriendlyBullet : EnemyBullet);
+    entities_.moving.push_back(1);
+    entities_.alive.push_back(1);
+    entities_.lives.push_back(1);
+    entities_.link.push_back(tank);
+    entities_.link[tank] = bullet;
+    return bullet;
+}
+
+void SimulatedWorld::step() {
+    std::size_t count = size();
+    steps_.resize(count);
+    motions_.resize(count);
+    moved_.clear();
+    for (std::uint32_t i = 0; i < count; i++) {
+        bool moving = entities_.alive[i] && entities_.moving[i] && entities_.step[i] > 0;
+        steps_[i] = moving ? entities_.step[i] : 0;
+        motions_[i] = {boxOf(i), 0, 0};
+        if (moving) {
+            moved_.push_back(i);
+        }
+    }
+    if (moved_.empty()) {
+        return;
+    }
+
+    // integration pass, entities standing still are moved by 0
+    MovementIntegrator::integrate(entities_.x.data(), entities_.y.data(), steps_.data(), entities_.facing.data(),
+                                  count);
+
+    // grid pass
+    tileHits_.assign(count, std::nullopt);
+    for (std::uint32_t i: moved_) {
+        Sweep::Motion &motion = motions_[i];
+        auto facing = static_cast<Direction>(entities_.facing[i]);
+        bool horizontal = facing == East || facing == West;
+        std::optional<Board::TileImpact> impact = Board::findTileImpact(
+                *grid_, motion.start, facing, horizontal ? motion.start.x : motion.start.y, steps_[i]);
+        if (impact.has_value()) {
+            (horizontal ? entities_.x[i] : entities_.y[i]) = impact->position;
+            tileHits_[i] = impact->tile;
+            if (!isBullet(i)) {
+                entities_.moving[i] = 0;
+            }
+        }
+        motion.dx = entities_.x[i] - motion.start.x;
+        motion.dy = entities_.y[i] - motion.start.y;
+    }
+
+    // entity pass, every pair is checked once (worlds are small, so there is no broadphase)
+    contacts_.clear();
+    for (std::uint32_t a: moved_) {
+        for (std::uint32_t b = 0; b < count; b++) {
+            if (b == a || !entities_.alive[b] || (b < a && steps_[b] > 0) ||
+                entities_.link[a] == b || (isBullet(a) && isBullet(b))) {
+                continue;
+            }
+            std::optional<FixedPoint::Value> time = Sweep::timeOfImpact(motions_[a], motions_[b]);
+            if (time.has_value()) {
+                contacts_.push_back({time.value(), a, b});
+            }
+        }
+    }
+    std::stable_sort(contacts_.begin(), contacts_.end(), [](const Contact &a, const Contact &b) {
+        return a.time < b.time;
+    });
+    for (const Contact &contact: contacts_) {
+        resolve(contact);
+    }
+
+    // bullets that did not hit anything on their way hit the grid
+    for (std::uint32_t i: moved_) {
+        if (isBullet(i) && entities_.alive[i] && tileHits_[i].has_value()) {
+            destroyTiles(i, tileHits_[i].value());
+            kill(i);
+        }
+    }
+}
+
+void SimulatedWorld::resolve(const Contact &contact) {
+    std::uint32_t a = contact.first;
+    std::uint32_t b = contact.second;
+    if (!entities_.alive[a] || !entities_.alive[b]) {
+        return;
+    }
+
+    if (isBullet(a) || isBullet(b)) {
+        std::uint32_t bullet = isBullet(a) ? a : b;
+        std::uint32_t other = isBullet(a) ? b : a;
+        Kind hit = entities_.kind[other];
+        bool friendly = entities_.kind[bullet] == FriendlyBullet;
+        if (hit == Eagle || (friendly && hit == EnemyTank) || (!friendly && hit == PlayerTank)) {
+            entities_.lives[other] = entities_.lives[other] > 0 ? entities_.lives[other] - 1 : 0;
+            if (hit == Eagle || entities_.lives[other] == 0) {
+                kill(other);
+            }
+        }
+        kill(bullet);
+        return;
+    }
+
+    // tanks running into each other (or into the eagle) go back and stop
+    for (std::uint32_t tank: {a, b}) {
+        if (steps_[tank] > 0) {
+            entities_.x[tank] = motions_[tank].start.x;
+            entities_.y[tank] = motions_[tank].start.y;
+            entities_.moving[tank] = 0;
+        }
+    }
+}
+
+void SimulatedWorld::destroyTiles(std::uint32_t bullet, std::pair<unsigned int, unsigned int> tile) {
+    bool vertical = entities_.facing[bullet] % 2 == 0;
+    auto sizeX = static_cast<int>(grid_->getSizeX());
+    auto sizeY = static_cast<int>(grid_->getSizeY());
+    for (int offset = -1; offset <= 2; offset++) {
+        int x = static_cast<int>(tile.first) + (vertical ? offset : 0);
+        int y = static_cast<int>(tile.second) + (vertical ? 0 : offset);
+        if (x < 0 || y < 0 || x >= sizeX || y >= sizeY || grid_->getTileAtPosition(x, y) == NullTile ||
+            !TileManager::isTileDestructible(grid_->getTileAtPosition(x, y))) {
+            continue;
+        }
+        writableGrid().clearTile(x, y);
+    }
+}
+
+void SimulatedWorld::kill(std::uint32_t index) {
+    entities_.alive[index] = 0;
+    entities_.moving[index] = 0;
+    std::uint32_t link = entities_.link[index];
+    if (link != None && entities_.link[link] == index) {
+        entities_.link[link] = None;
+    }
+    entities_.link[index] = None;
+}
+
+SimulatedWorld::ForkedGrid &SimulatedWorld::writableGrid() {
+    if (!ownsGrid_) {
+        if (ownGrid_ == nullptr) {
+            ownGrid_ = std::make_unique<ForkedGrid>(*grid_);
+        } else if (grid_ != ownGrid_.get()) {
+            ownGrid_->copyFrom(*grid_);
+        }
+        grid_ = ownGrid_.get();
+        ownsGrid_ = true;
+    }
+    return *ownGrid_;
+}
+
+bool SimulatedWorld::isBullet(std::uint32_t index) const {
+    return entities_.kind[index] == FriendlyBullet || entities_.kind[index] == EnemyBullet;
+}
+
+Sweep::Box SimulatedWorld::boxOf(std::uint32_t index) const {
+    return {entities_.x[index], entities_.y[index], entities_.sizeX[index], entities_.sizeY[index]};
+}
+
+const SimulatedWorld::Entities &SimulatedWorld::getEntities() const {
+    return entities_;
+}
+
+std::size_t SimulatedWorld::size() const {
+    return entities_.x.size();
+}
+
+const Grid &SimulatedWorld::getGrid() const {
+    return *grid_;
+}
+
+bool SimulatedWorld::ownsGrid() const {
+    return ownsGrid_;
+}
@@ -6,16 +6,28 @@
 #define PROI_PROJEKT_BOARD_H
 
 #include <memory>
+#include <vector>
+#include <optional>
+#include <limits>
+#include <utility>
 
 #include "../../core-lib/include/EventQueue.h"
 #include "../../tank-lib/include/Tank.h"
 #include "../../tank-lib/include/EntityController.h"
+#include "../../tank-lib/include/MovementIntegrator.h"
+#include "../../tank-lib/include/Broadphase.h"
+#include "../../tank-lib/include/Sweep.h"
 #include "Grid.h"
+#include "FlowField.h"
+#include "LevelPack.h"
+#include "LevelPreloader.h"
 
 class Event;
 
 class Grid;
 class EntityController;
+class SnapshotReader;
+class SnapshotWriter;
 
 enum Direction: unsigned int;
 
@@ -26,8 +38,60 @@ enum Direction: unsigned int;
  */
 class Board {
 public:
+    /**
+     * Tick rate entities' speeds are defined for
+     */
+    static constexpr unsigned int ReferenceTickRate = 60;
+
+    /**
+     * \brief A collision found while moving entities
+     */
+    struct Contact {
+        /**
+         * The moving entity
+         */
+        std::shared_ptr<Entity> entity;
+
+        /**
+         * The entity it collides with, or std::nullopt for a collision with the board
+         */
+        std::optional<std::shared_ptr<Entity>> other;
+
+        /**
+         * Coords of the tile that was hit (only meaningful for collisions with the board)
+         */
+        unsigned int tileX;
+        unsigned int tileY;
+
+        /**
+         * Fraction of the tick (in fixed-point units) at which the collision happened
+         */
+        FixedPoint::Value time;
+    };
+
+    /**
+     * A coord at which an entity hits a tile, and the tile that was hit
+     */
+    struct TileImpact {
+        FixedPoint::Value position;
+        std::pair<unsigned int, unsigned int> tile;
+    };
+
     Board();
 
+    /**
+     * Detaches the board from BotController
+     */
+    ~Board();
+
+    /**
+     * Sets the tick rate at which the board is updated. Entities are moved by proportionally larger steps at lower
+     * tick rates, so that their speeds per second stay the same (see MovementIntegrator::setStepScale). Bot spawn and
+     * decision cooldowns are scaled the same way (see BotController::setTickRate)
+     * @param ticksPerSecond Tick rate, ReferenceTickRate by default
+     */
+    void setTickRate(unsigned int ticksPerSecond);
+
     /**
      * Sets tank's moving flag to a given value
      * @param target Target tank
@@ -48,12 +112,29 @@ public:
 
     /**
      * Attempt to move all entities on the board (tanks will move only if moving flag is set)
-     * Detects collisions and queues events if one happens (does not correct colliding entity's position)
+     * Detects collisions and queues events if one happens
+     *
+     * Runs in batched passes: all moving entities are advanced first (see MovementIntegrator), then every moved
+     * entity is checked against the grid, and finally a single narrowphase pass builds a list of contacts from
+     * Broadphase candidates (see Sweep), from which collision events are created. Collision detection is continuous,
+     * so entities can not pass through tiles or each other regardless of their step length:
+     * - an entity that would move past the first collidable tile on it's way is stopped one fixed-point unit inside it
+     * - every pair of entities touching during the tick is reported once, in the order the contacts happen
+     * - a bullet is destroyed by the first thing it hits, so only it's earliest contact is reported
+     *
+     * Bullets are not checked against the grid tile by tile - they collide once they reach their precomputed impact,
+     * which is recomputed only after the grid has changed
      *
      * Possibly queues multiple instances of Event::EntityMoved and Event::EntityEntityCollision or Event::EntityGridCollision
      * */
     void moveAllEntities();
 
+    /**
+     * Returns contacts found during the last call to moveAllEntities
+     * @return Contacts, ordered by moving entity and then by time
+     */
+    const std::vector<Contact>& getContacts() const;
+
     /**
      * Attempts to move an entity by it's speed per tick value.
      * Detects collisions and queues events if one happens (does not correct colliding entity's position)
@@ -102,7 +183,7 @@ public:
     bool spawnPlayer(unsigned int x, unsigned int y, Direction facing = North);
 
     /**
-     * Sets board's grid to a given one. Loads enemy spawnpoints and types to BotController
+     * Sets board's grid to a given one. Loads enemy spawnpoints, types and the flow field to BotController
      * This function should only be used after removing all entities from the board in order to prevent overlaps
      *
      * Does not queue events (yet...)
@@ -112,6 +193,7 @@ public:
 
     /**
      * Deletes a tile at the given coords. If tile was a NullTile or was not destructible, does nothing
+     * Repairs the flow field bots use to find their way to the eagle
      *
      * Possibly queues Event::TileDeleted
      * @param x Tile's X coord
@@ -165,11 +247,91 @@ public:
     /**
      * Removes all entities from the board and loads a new grid from GridBuilder
      *
+     * The grid is taken from the level preloader, then the next level is preloaded while this one is played
+     *
      * Possibly queues multiple instances of Event::EntityRemoved and a single instance of Event::LevelLoaded
      * @param levelNum
      */
     void loadLevel(unsigned int levelNum);
 
+    /**
+     * Writes the number of the level, the grid and all entities to a snapshot (see GameSnapshot)
+     * @param writer Snapshot being written
+     */
+    void saveState(SnapshotWriter &writer) const;
+
+    /**
+     * Replaces the grid and all entities with the ones read from a snapshot, written by saveState.
+     * Rebuilds the flow field, but does not touch spawnpoints and tank types of BotController, which are restored
+     * by BotController::loadState. The next level is not preloaded
+     *
+     * Queues multiple instances of Event::EntityRemoved, a single instance of Event::LevelLoaded, and
+     * Event::EntitySpawned or Event::PlayerSpawned for every restored tank and bullet
+     * @param reader Snapshot being read
+     * @throws InvalidSnapshot if the snapshot is broken, the board is left as it was then
+     */
+    void loadState(SnapshotReader &reader);
+
+    /**
+     * Creates an entity of a state and adds it to the board, for rewinding it (see RewindBuffer)
+     *
+     * Queues Event::EntitySpawned or Event::PlayerSpawned, nothing for entities other than tanks and bullets (the eagle)
+     * @param state State of the entity
+     * @param owner Tank that fired the bullet, if the entity is a bullet fired by a tank still on the board
+     * @return The entity
+     */
+    std::shared_ptr<Entity> restoreEntity(const EntityController::EntityState &state,
+                                          const std::shared_ptr<Tank> &owner = nullptr);
+
+    /**
+     * Sets the position and the other changing fields of an entity to a state, for rewinding the board
+     * (see EntityController::applyState)
+     *
+     * Possibly queues Event::EntityMoved and Event::TankRotated
+     * @param entity An entity on the board
+     * @param state State of the entity
+     */
+    void restoreEntityState(const std::shared_ptr<Entity> &entity, const EntityController::EntityState &state);
+
+    /**
+     * Sets a tile, even if the tile it replaces is not destructible, for rewinding the board.
+     * The flow field is not repaired, ::repairFlowField() should be called once all tiles are restored
+     *
+     * Possibly queues Event::TilePlaced, Event::TileChanged or Event::TileDeleted
+     * @param x Tile's X coord
+     * @param y Tile's Y coord
+     * @param tile The tile
+     */
+    void restoreTile(unsigned int x, unsigned int y, TileType tile);
+
+    /**
+     * Rebuilds the flow field bots use to find their way to the eagle, if the grid changed since it was built
+     */
+    void repairFlowField();
+
+    /**
+     * Returns the preloader levels are loaded from
+     * @return
+     */
+    LevelPreloader &getLevelPreloader();
+
+    /**
+     * Returns the number of the level loaded last
+     * @return Level number, 0 if no level was loaded
+     */
+    [[nodiscard]] unsigned int getLevelNumber() const;
+
+    /**
+     * Changes tiles of the grid to the tiles of a level, leaving entities, spawnpoints and tank types as they are.
+     * Tiles outside of the level become NullTiles, parts of the level outside of the grid are left out
+     * Repairs the flow field bots use to find their way to the eagle
+     *
+     * Queues Event::TilePlaced, Event::TileChanged or Event::TileDeleted for every tile that changed
+     * @param level The level
+     * @return Number of tiles that changed
+     */
+    std::size_t applyLevelTiles(const LevelPack::Level &level);
+
     /**
      * Returns pointer on the player tank object
      * @return Player Tank pointer
@@ -201,7 +363,91 @@ public:
      */
     Grid* getGrid();
 
+    /**
+     * Returns the flow field leading bots towards the eagle, shared with BotController
+     * @return Flow field pointer
+     */
+    const FlowField* getFlowField() const;
+
+    /**
+     * Checks whether a bullet fired by a tank in a given direction would hit a target
+     *
+     * The bullet's lane (as wide as a bullet, in the middle of the tank's side) has to cross the target, and the part
+     * of the lane between the tank and the target has to be clear of collidable tiles (checked with Grid::getFreeRun)
+     * and of other tanks or the eagle (found with a broadphase, rebuilt only after entities have changed)
+     * @param shooter Tank that would fire
+     * @param target Entity to hit
+     * @param direction Direction of the shot, not necessarily the one the tank is facing
+     * @return Whether the target is in sight
+     */
+    bool hasLineOfSight(const std::shared_ptr<Tank>& shooter, const std::shared_ptr<Entity>& target,
+                        Direction direction);
+
+    /**
+     * Same as above, but does not update the broadphase, so updateSightBlockers has to be called after entities
+     * change. Can be called from many threads at once
+     */
+    [[nodiscard]] bool hasLineOfSight(const std::shared_ptr<Tank>& shooter, const std::shared_ptr<Entity>& target,
+                                      Direction direction) const;
+
+    /**
+     * Finds an entity a tank should shoot at in a given direction: the player tank or the eagle for enemy tanks, and
+     * enemy tanks for the player
+     * @param shooter Tank that would fire
+     * @param direction Direction of the shot
+     * @return A target in sight (see hasLineOfSight), or std::nullopt if there is none
+     */
+    std::optional<std::shared_ptr<Entity>> findTargetInSight(const std::shared_ptr<Tank>& shooter,
+                                                             Direction direction);
+
+    /**
+     * Same as above, but does not update the broadphase (see the const overload of hasLineOfSight)
+     */
+    [[nodiscard]] std::optional<std::shared_ptr<Entity>> findTargetInSight(const std::shared_ptr<Tank>& shooter,
+                                                                           Direction direction) const;
+
+    /**
+     * Rebuilds the broadphase used by line of sight queries from entities that stop bullets (all but bullets), and the
+     * lists of targets of the player and of enemy tanks, if entities have changed since the last rebuild
+     */
+    void updateSightBlockers();
+
+    /**
+     * Returns the integrator used to move entities, scaled to board's tick rate
+     * @return
+     */
+    [[nodiscard]] const MovementIntegrator &getMovementIntegrator() const;
+
+    /**
+     * Finds the coord at which a box moving forwards would hit the first collidable tile of a grid (or leave it)
+     *
+     * The returned coord is one fixed-point unit inside the tile that was hit, so that box's position is still
+     * detected as colliding with the tile. Shared by the board and simulations forked from it (see SimulatedWorld)
+     * @param grid The grid
+     * @param box The moving box, only it's size and position across the axis of movement are used
+     * @param facing Direction of movement
+     * @param position Box's starting X coord (when moving horizontally) or Y coord (when moving vertically)
+     * @param reach Maximum distance to check
+     * @return Box's coord at impact and the tile that was hit, or std::nullopt if there is no impact in reach
+     */
+    static std::optional<TileImpact> findTileImpact(const Grid &grid, const Sweep::Box &box, Direction facing,
+                                                    FixedPoint::Value position, FixedPoint::Value reach);
+
 protected:
+    /**
+     * Contact along with indices of both entities in EntityController's entity list
+     */
+    struct IndexedContact {
+        Contact contact;
+        std::size_t entity;
+        std::size_t other;
+    };
+
+    /**
+     * Index used in place of the other entity in contacts with the board
+     */
+    static constexpr std::size_t NoEntity = std::numeric_limits<std::size_t>::max();
+
     /**
      * Checks if an entity overlaps with any other entity, tile, or is placed out of grid
      *
@@ -211,6 +457,94 @@ protected:
      */
     bool validateEntityPosition(const std::shared_ptr<Entity>& target);
 
+    /**
+     * Checks if an entity overlaps with any collidable tile or is placed out of grid. Does not check other entities
+     *
+     * Does not queue events.
+     * @param target Entity to check
+     * @return True if no collisions detected, false if position is invalid
+     */
+    bool validateTilePosition(const std::shared_ptr<Entity>& target);
+
+    /**
+     * Finds a collidable tile an entity overlaps with
+     *
+     * Does not queue events.
+     * @param target Entity to check
+     * @return Coords of the tile, or coords of the nearest tile if the entity is placed out of grid, or std::nullopt
+     * if no collisions detected
+     */
+    std::optional<std::pair<unsigned int, unsigned int>> findCollidingTile(const std::shared_ptr<Entity>& target);
+
+    /**
+     * Returns coords of the tile containing entity's top left corner, clamped to the grid
+     * @param entity An entity
+     * @return Tile coords
+     */
+    std::pair<unsigned int, unsigned int> tileOf(const Entity &entity);
+
+    /**
+     * Checks if an entity overlaps with any other entity, tile, or is placed out of grid, in a single scan
+     * Other entities are checked first
+     *
+     * Does not queue events.
+     * @param target Entity to check
+     * @return The contact found (with time 0), or std::nullopt if no collisions detected
+     */
+    std::optional<Contact> findContact(const std::shared_ptr<Entity>& target);
+
+    /**
+     * Finds the coord at which an entity moving forwards would hit the first collidable tile (or leave the grid)
+     *
+     * The returned coord is one fixed-point unit inside the tile that was hit, so that entity's position is still
+     * detected as colliding with the tile
+     * @param entity A moving entity
+     * @param position Entity's starting X coord (when moving horizontally) or Y coord (when moving vertically)
+     * @param reach Maximum distance to check
+     * @return Entity's coord at impact and the tile that was hit, or std::nullopt if there is no impact in reach
+     */
+    std::optional<TileImpact> findTileImpact(const Entity &entity, FixedPoint::Value position,
+                                                    FixedPoint::Value reach);
+
+    /**
+     * Computes the coord at which a bullet will hit the first collidable tile on it's way (or leave the grid), and
+     * stores it in the bullet along with the current grid version
+     * @param bullet Bullet to compute the impact for
+     */
+    void computeBulletImpact(Bullet &bullet);
+
+    /**
+     * Checks whether a bullet moved in the current tick has reached it's impact, stopping it at the impact if so
+     * The impact is recomputed first (from bullet's position before the move) if the grid has changed since
+     * @param bullet Bullet to check
+     * @param motion Bullet's movement in the current tick
+     * @return Coords of the tile the bullet collides with, or std::nullopt if there is no collision
+     */
+    std::optional<std::pair<unsigned int, unsigned int>> resolveBulletImpact(Bullet &bullet,
+                                                                             const Sweep::Motion &motion);
+
+    /**
+     * Stops an entity moved in the current tick at the first collidable tile it would move past
+     * @param entity Entity to check
+     * @param motion Entity's movement in the current tick
+     * @return Coords of the tile the entity collides with, or std::nullopt if there is no collision
+     */
+    std::optional<std::pair<unsigned int, unsigned int>> resolveTileImpact(const std::shared_ptr<Entity> &entity,
+                                                                           const Sweep::Motion &motion);
+
+    /**
+     * Removes contacts of bullets that happen after the bullet has already hit something
+     * Contacts are kept in order otherwise
+     */
+    void discardContactsOfDestroyedBullets();
+
+    /**
+     * Replaces current contact index with the candidate, if the candidate contact happens earlier
+     * @param current Index of the earliest contact so far, or NoEntity
+     * @param candidate Index of a contact
+     */
+    void keepEarlierContact(std::size_t &current, std::size_t candidate) const;
+
     /**
      * Builds an Event::Collision event for a given entity, should be called after detecting a collision
      * This function assumes the collision did happen. Calling the function when there was no collision will result in undefined behavior (usually creating some kind of Entity-Board collision event)
@@ -219,6 +553,21 @@ protected:
      */
     std::unique_ptr<Event> createCollisionEvent(std::shared_ptr<Entity> entity);
 
+    /**
+     * Builds an Event::Collision event from a contact
+     * @param contact A contact
+     * @return A collision event wrapped in a unique_ptr
+     */
+    std::unique_ptr<Event> createCollisionEvent(const Contact &contact);
+
+    /**
+     * Creates entities other than tanks and bullets restored from snapshots, which can only be the eagle
+     * @param x Tile's X coord
+     * @param y Tile's Y coord
+     * @return The eagle
+     */
+    static std::shared_ptr<Entity> makeEagle(unsigned int x, unsigned int y);
+
     std::unique_ptr<Grid> grid_;
     std::unique_ptr<EntityController> entityController_;
 
@@ -226,6 +575,33 @@ protected:
 
     BotController* botController;
 
+    std::shared_ptr<FlowField> flowField_ = std::make_shared<FlowField>();
+
+    LevelPreloader levelPreloader_;
+    unsigned int levelNumber_ = 0;
+
+    MovementIntegrator movementIntegrator_;
+    Broadphase broadphase_;
+    std::vector<std::optional<std::pair<unsigned int, unsigned int>>> tileContacts_;
+    std::vector<FixedPoint::Value> tileContactTimes_;
+    std::vector<Sweep::Motion> motions_;
+    std::vector<Sweep::Box> sweptBounds_;
+    std::vector<std::size_t> movedIndices_;
+    std::vector<IndexedContact> pendingContacts_;
+    std::vector<std::size_t> firstContacts_;
+    std::vector<Contact> contacts_;
+
+    /**
+     * Entities that stop bullets, and a broadphase built from them for line of sight queries. Entities are not
+     * watched, so every method of the board that adds, removes or moves them clears sightBlockersValid_
+     */
+    std::vector<std::shared_ptr<Entity>> sightBlockers_;
+    std::vector<std::shared_ptr<Entity>> playerTargets_;
+    std::vector<std::shared_ptr<Entity>> enemyTargets_;
+    Broadphase sightBroadphase_;
+    bool sightBlockersValid_ = false;
+    std::size_t sightEntityCount_ = 0;
+
 
 };
 
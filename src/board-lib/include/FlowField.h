@@ -0,0 +1,128 @@
+#ifndef PROI_PROJEKT_FLOWFIELD_H
+#define PROI_PROJEKT_FLOWFIELD_H
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "../../tank-lib/include/Entity.h"
+
+class Grid;
+
+/**
+ * \brief Shared distance map leading tanks towards the eagle
+ *
+ * Stores the cost of reaching the eagle from every position a tank (4x4 tiles) can take on the grid, so that every bot
+ * can read the direction of it's next move in constant time, instead of searching for a path on it's own.
+ *
+ * Positions are identified by the coords of tank's top left tile. Positions overlapping steel tiles, the eagle, or
+ * sticking out of the grid can not be taken. Positions overlapping bricks can be taken after shooting the bricks
+ * down, so entering them costs BrickCost instead of 1.
+ *
+ * The map is computed once per level (rebuild) with Dijkstra's algorithm. Destroying bricks only lowers costs, so the
+ * map is repaired incrementally after a tile is deleted (openTile), visiting only positions that got closer to the
+ * eagle.
+ */
+class FlowField {
+public:
+    /**
+     * Size of a tank in tiles
+     */
+    static constexpr unsigned int FootprintSize = 4;
+
+    /**
+     * Cost of entering a position that overlaps bricks
+     */
+    static constexpr std::uint16_t BrickCost = 8;
+
+    /**
+     * Cost of positions that can not be taken, and distance from positions the eagle can not be reached from
+     */
+    static constexpr std::uint16_t Unreachable = UINT16_MAX;
+
+    /**
+     * Recomputes the whole map for a grid
+     * @param grid Grid to compute the map for, it's eagle location is used as the goal
+     */
+    void rebuild(const Grid &grid);
+
+    /**
+     * Repairs the map after a tile has been deleted from the grid
+     * The map has to be up to date with the grid from before the tile was deleted, otherwise rebuild should be used
+     * @param grid Grid the tile was deleted from
+     * @param x Tile's X coord
+     * @param y Tile's Y coord
+     */
+    void openTile(const Grid &grid, unsigned int x, unsigned int y);
+
+    /**
+     * Returns the direction in which a tank should move to get closer to the eagle
+     * @param x X coord of tank's top left tile
+     * @param y Y coord of tank's top left tile
+     * @return Direction of the next move, or std::nullopt if the tank is already next to the eagle, can not reach it,
+     * or the position is out of the map
+     */
+    [[nodiscard]] std::optional<Direction> getDirection(unsigned int x, unsigned int y) const;
+
+    /**
+     * Returns the cost of reaching the eagle from a given position
+     * @param x X coord of tank's top left tile
+     * @param y Y coord of tank's top left tile
+     * @return The cost, or Unreachable
+     */
+    [[nodiscard]] std::uint16_t getDistance(unsigned int x, unsigned int y) const;
+
+    /**
+     * Returns the cost of entering a given position
+     * @param x X coord of tank's top left tile
+     * @param y Y coord of tank's top left tile
+     * @return 1 for free positions, BrickCost for positions overlapping bricks, or Unreachable
+     */
+    [[nodiscard]] std::uint16_t getCost(unsigned int x, unsigned int y) const;
+
+    /**
+     * Returns version of the grid the map is up to date with
+     * @return Grid version (see Grid::getVersion)
+     */
+    [[nodiscard]] unsigned int getGridVersion() const;
+
+    /**
+     * Computes the cost of entering a position from the tiles it overlaps (see getCost)
+     * Shared with other path searches, so that they use the same rules as the flow field
+     * @param grid A grid
+     * @param x X coord of tank's top left tile
+     * @param y Y coord of tank's top left tile
+     * @return 1 for free positions, BrickCost for positions overlapping bricks, or Unreachable
+     */
+    static std::uint16_t computeCost(const Grid &grid, unsigned int x, unsigned int y);
+
+protected:
+
+    /**
+     * Runs Dijkstra's algorithm from positions in the queue, lowering distances only
+     */
+    void propagate();
+
+    /**
+     * Lowers the distance of a position and queues it, if the new distance is lower
+     */
+    void relax(unsigned int index, std::uint32_t distance);
+
+    [[nodiscard]] unsigned int indexOf(unsigned int x, unsigned int y) const;
+
+    unsigned int sizeX_ = 0;
+    unsigned int sizeY_ = 0;
+    std::vector<std::uint16_t> costs_;
+    std::vector<std::uint16_t> distances_;
+
+    /**
+     * Min-heap of (distance, position index) pairs
+     */
+    std::vector<std::pair<std::uint32_t, unsigned int>> queue_;
+
+    unsigned int gridVersion_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_FLOWFIELD_H
@@ -5,9 +5,11 @@
 #ifndef PROI_PROJEKT_GRID_H
 #define PROI_PROJEKT_GRID_H
 
+#include <atomic>
 #include <exception>
 #include <vector>
 #include <queue>
+#include <cstdint>
 
 #include "../../tank-lib/include/Tank.h"
 
@@ -18,6 +20,10 @@ class EventQueue;
 
 class GridBuilder;
 
+class SnapshotReader;
+
+class SnapshotWriter;
+
 
 /**
  * Enum representing different tile types
@@ -55,7 +61,7 @@ public:
      * @param y Y coord
      * @return A TileType value
      */
-    TileType getTileAtPosition(unsigned int x, unsigned int y);
+    [[nodiscard]] TileType getTileAtPosition(unsigned int x, unsigned int y) const;
 
     /**
      * Places a tile of a given type at given coords. Calls deleteTile when trying to place a NullTile
@@ -104,6 +110,48 @@ public:
 
     [[nodiscard]] const std::pair<unsigned int, unsigned int> &getEagleLocation() const;
 
+    /**
+     * Returns grid's version, which changes every time a tile is placed, changed or deleted
+     * Versions are unique across all Grid instances, so data computed for one grid is never valid for another
+     * @return Grid's version
+     */
+    [[nodiscard]] unsigned int getVersion() const;
+
+    /**
+     * Checks if the tile at given coords collides with tanks and bullets
+     * @param x X coord
+     * @param y Y coord
+     * @return True if the tile is collidable
+     */
+    [[nodiscard]] bool isTileCollidable(unsigned int x, unsigned int y) const;
+
+    /**
+     * Returns the number of tiles that can be passed when going from the given tile in the given direction, before
+     * reaching a collidable tile or the edge of the grid. The starting tile itself is not counted
+     *
+     * Answered in constant time from tables that are updated whenever a tile changes
+     * @param x X coord
+     * @param y Y coord
+     * @param direction Direction to go in
+     * @return Number of free tiles
+     */
+    [[nodiscard]] unsigned int getFreeRun(unsigned int x, unsigned int y, Direction direction) const;
+
+    /**
+     * Writes tiles, spawnpoints, the eagle location and tank types to a snapshot (see GameSnapshot)
+     * @param writer
+     */
+    void saveState(SnapshotWriter &writer) const;
+
+    /**
+     * Replaces the whole grid with one written by saveState. The grid gets a new version
+     *
+     * Does not queue events
+     * @param reader
+     * @throws InvalidSnapshot if the state is cut short or holds tiles or tank types that do not exist
+     */
+    void loadState(SnapshotReader &reader);
+
     friend class GridBuilder;
 
 protected:
@@ -117,6 +165,36 @@ protected:
     std::queue<Tank::TankType> tankTypes;
 
     EventQueue<Event> *eventQueue_;
+
+    unsigned int version_;
+
+    /**
+     * Free run lengths for every tile, indexed by direction, X and Y (see getFreeRun)
+     */
+    std::uint8_t freeRuns_[4][52][52] = {};
+
+    /**
+     * Assigns a new, globally unique version to the grid
+     */
+    void bumpVersion();
+
+    /**
+     * Recomputes all free run tables, should be called after filling the grid directly
+     */
+    void rebuildFreeRuns();
+
+    /**
+     * Updates free run tables after the tile at given coords became collidable or stopped being collidable
+     * Only the tiles in front of which the changed tile lies (up to the nearest collidable tile) are updated
+     * @param x X coord
+     * @param y Y coord
+     */
+    void updateFreeRuns(unsigned int x, unsigned int y);
+
+    /**
+     * Atomic, as grids can be built on other threads (see LevelPreloader)
+     */
+    static std::atomic<unsigned int> lastVersion_;
 };
 
 
@@ -6,6 +6,9 @@
 #define PROI_PROJEKT_GRIDBUILDER_H
 
 #include <memory>
+#include <string>
+
+#include "LevelPack.h"
 
 class Grid;
 
@@ -13,6 +16,8 @@ enum TileType: unsigned int;
 
 class InvalidLevelFile : public std::exception{
 public:
+    explicit InvalidLevelFile(std::string message = "Invalid level file");
+
     const char* what() const noexcept override;
 
 private:
@@ -26,8 +31,8 @@ private:
 class GridBuilder {
 public:
     /**
-     * Loads a level from file ./levels/lvl<N>.txt, where N is level number. First line in file is reserved for
-     * for enemy tank type sequence, coded as shown:
+     * Loads a level from LevelRepository, which finds it in a level pack or in a file lvl<N>.txt, where N is level
+     * number. First line in file is reserved for for enemy tank type sequence, coded as shown:
      *  - 'B' - basic tank
      *  - 'F' - fast tank
      *  - 'P' - power tank
@@ -43,13 +48,40 @@ public:
      *  - '+' - player spawn point
      *  - any other char - NullTile
      *
-     * // FIXME ADJUST THE PATH IF NOT WORKING
-     * @param level The level to be loaded. ./levels/lvl<level>.txt will be checked
-     * @return A grid constructed with the file. If file was not loaded, the grid will be filled with NullTiles
+     * @param level The level to be loaded
+     * @return A grid constructed with the file
+     * @throws InvalidLevelFile if the repository does not have the level, it's file can no longer be read or it has
+     * errors (see LevelValidator)
+     * @throws SingletonNotInitializedException if LevelRepository was not initialized
      */
     static std::unique_ptr<Grid> buildLevel(unsigned int level);
 
+    /**
+     * Builds a grid from a level of a level pack. Parts of the level that do not fit the grid are left out
+     * @param level The level
+     * @return
+     */
+    static std::unique_ptr<Grid> buildLevel(const LevelPack::LevelView &level);
+
+    /**
+     * Builds a grid from a level read from a text file. Parts of the level that do not fit the grid are left out
+     * @param level The level
+     * @return
+     */
+    static std::unique_ptr<Grid> buildLevel(const LevelPack::Level &level);
+
 private:
+    /**
+     * Supporting function for buildLevel.
+     * Sets spawnpoints, the eagle location and the enemy tank sequence of a grid, leaving out points that do not lie
+     * within the grid
+     * @param targetGrid Output argument!
+     */
+    static void placePoints(Grid *targetGrid, const std::vector<std::pair<unsigned int, unsigned int>> &spawnpoints,
+                            std::pair<unsigned int, unsigned int> playerSpawnpoint,
+                            std::pair<unsigned int, unsigned int> eagleLocation,
+                            const std::vector<Tank::TankType> &tankTypes);
+
     /**
      * Supporting function for BuildLevel.
      * Places a chunk of tiles of a given type on a grid.
@@ -0,0 +1,88 @@
+#ifndef PROI_PROJEKT_LEVELGENERATOR_H
+#define PROI_PROJEKT_LEVELGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "LevelPack.h"
+
+class Grid;
+
+/**
+ * \brief Generates random levels of any size, for stress testing and benchmarks
+ *
+ * Tiles are drawn at random with given densities. Enemy spawnpoints are spread along the top edge of the level, the
+ * eagle stands in the middle of the bottom edge, with the player spawnpoint to it's left. A corridor as wide as a tank
+ * is then carved from every spawnpoint to the eagle, wandering down and sideways at random, so that the eagle can be
+ * reached from every spawnpoint without crossing bricks, steel or water.
+ *
+ * The same settings always give the same level. Class does not provide a constructor and all of it's methods are
+ * static, like GridBuilder.
+ */
+class LevelGenerator {
+public:
+    /**
+     * Smallest size of a level side, fitting the eagle and the player spawnpoint next to it
+     */
+    static constexpr unsigned int MinLevelSize = 16;
+
+    struct Settings {
+        unsigned int sizeX = 52;
+        unsigned int sizeY = 52;
+        std::uint64_t seed = 0;
+
+        /**
+         * Fractions of tiles of each type, before corridors are carved. Scaled down if they add up to more than 1
+         */
+        float bricks = 0.3f;
+        float steel = 0.05f;
+        float water = 0.05f;
+        float trees = 0.1f;
+
+        unsigned int spawnpointCount = 3;
+
+        /**
+         * Length of the enemy tank sequence, tank types are drawn at random
+         */
+        std::size_t tankCount = 20;
+    };
+
+    /**
+     * Generates a level, sides shorter than MinLevelSize are extended to it
+     * @param settings
+     * @param number Number of the level
+     * @return
+     */
+    static LevelPack::Level generate(const Settings &settings, unsigned int number = 0);
+
+    /**
+     * Generates a level and builds a grid from it (see GridBuilder::buildLevel), so levels larger than the grid are
+     * cut
+     * @param settings
+     * @return
+     */
+    static std::unique_ptr<Grid> generateGrid(const Settings &settings);
+
+private:
+    /**
+     * Supporting function for generate.
+     * Carves a corridor for a tank from a position to a target, moving one tile at a time
+     * @param level Output argument!
+     */
+    static void carveCorridor(LevelPack::Level &level, std::uint64_t &random,
+                              std::pair<unsigned int, unsigned int> from, std::pair<unsigned int, unsigned int> to);
+
+    /**
+     * Supporting function for generate.
+     * Replaces a rectangle of tiles with NullTiles, the parts of it outside of the level are left out
+     * @param level Output argument!
+     */
+    static void clearArea(LevelPack::Level &level, unsigned int x, unsigned int y, unsigned int width,
+                          unsigned int height);
+
+    LevelGenerator() = default;
+};
+
+
+#endif //PROI_PROJEKT_LEVELGENERATOR_H
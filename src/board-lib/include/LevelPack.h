@@ -0,0 +1,203 @@
+#ifndef PROI_PROJEKT_LEVELPACK_H
+#define PROI_PROJEKT_LEVELPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Grid.h"
+
+/**
+ * \brief A file holding many precompiled levels, memory-mapped and read without parsing
+ *
+ * Packs are binary files, in the byte order of the machine, made of blocks aligned to 8 bytes:
+ *  - header: uint32 Magic, uint32 FileVersion, uint32 number of levels N, uint32 0
+ *  - directory: N entries of uint32 level number, uint32 0, uint64 offset and uint64 size of the level in the file
+ *  - levels, each one made of:
+ *    - uint32 sizeX, sizeY, TileEncoding, number of spawnpoints S, number of tanks T, player spawnpoint X and Y,
+ *      eagle location X and Y, flags of the points the level marks (1 for the player spawnpoint, 2 for the eagle)
+ *    - S pairs of uint32 spawnpoint X and Y
+ *    - T uint8 Tank::TankType values, padded with zeros to 4 bytes
+ *    - tiles, column after column (tile (x, y) is tile number x * sizeY + y), a byte or half a byte each
+ *
+ * Levels are checked once, when the pack is opened. Tiles are then decoded straight from the mapped file, unknown tile
+ * values being read as NullTile.
+ */
+class LevelPack {
+public:
+    /**
+     * "TLVP"
+     */
+    static constexpr std::uint32_t Magic = 0x50564c54;
+    static constexpr std::uint32_t FileVersion = 1;
+
+    /**
+     * Largest size of a level side
+     */
+    static constexpr std::uint32_t MaxLevelSize = 65536;
+
+    enum TileEncoding : std::uint32_t {
+        /**
+         * A byte per tile
+         */
+        ByteTiles = 1,
+
+        /**
+         * Half a byte per tile, the lower half first
+         */
+        PackedTiles = 2
+    };
+
+    /**
+     * A level held in memory, as read from a text file (see GridBuilder::buildLevel)
+     */
+    struct Level {
+        unsigned int number = 0;
+        unsigned int sizeX = 0;
+        unsigned int sizeY = 0;
+
+        /**
+         * TileType values, column after column
+         */
+        std::vector<std::uint8_t> tiles;
+        std::vector<std::pair<unsigned int, unsigned int>> spawnpoints;
+        std::pair<unsigned int, unsigned int> playerSpawnpoint{0, 0};
+        std::pair<unsigned int, unsigned int> eagleLocation{0, 0};
+
+        /**
+         * Whether the level marks the points, as points it does not mark are left at (0, 0)
+         */
+        bool hasPlayerSpawnpoint = false;
+        bool hasEagle = false;
+
+        std::vector<Tank::TankType> tankTypes;
+
+        [[nodiscard]] TileType getTile(unsigned int x, unsigned int y) const;
+    };
+
+    /**
+     * A level inside of a mapped pack, valid as long as the pack is
+     */
+    class LevelView {
+    public:
+        [[nodiscard]] unsigned int getNumber() const;
+
+        [[nodiscard]] unsigned int getSizeX() const;
+
+        [[nodiscard]] unsigned int getSizeY() const;
+
+        [[nodiscard]] TileEncoding getEncoding() const;
+
+        [[nodiscard]] TileType getTile(unsigned int x, unsigned int y) const;
+
+        /**
+         * Decodes a run of tiles
+         * @param first Number of the first tile (x * sizeY + y)
+         * @param count Number of tiles
+         * @param tiles Set to the tiles
+         */
+        void decodeTiles(std::size_t first, std::size_t count, TileType *tiles) const;
+
+        [[nodiscard]] std::size_t getSpawnpointCount() const;
+
+        [[nodiscard]] std::pair<unsigned int, unsigned int> getSpawnpoint(std::size_t index) const;
+
+        [[nodiscard]] std::pair<unsigned int, unsigned int> getPlayerSpawnpoint() const;
+
+        [[nodiscard]] std::pair<unsigned int, unsigned int> getEagleLocation() const;
+
+        [[nodiscard]] bool hasPlayerSpawnpoint() const;
+
+        [[nodiscard]] bool hasEagle() const;
+
+        /**
+         * Returns the tank types of the level, skipping values that are not enemy types
+         */
+        [[nodiscard]] std::vector<Tank::TankType> getTankTypes() const;
+
+        /**
+         * Decodes the whole level
+         * @return
+         */
+        [[nodiscard]] Level toLevel() const;
+
+    private:
+        friend class LevelPack;
+
+        LevelView(unsigned int number, const std::uint32_t *header);
+
+        unsigned int number_;
+        const std::uint32_t *header_;
+        const std::uint32_t *spawnpoints_;
+        const std::uint8_t *tankTypes_;
+        const std::uint8_t *tiles_;
+    };
+
+    LevelPack(const LevelPack &) = delete;
+
+    LevelPack &operator=(const LevelPack &) = delete;
+
+    ~LevelPack();
+
+    /**
+     * Maps a pack into memory and checks it's levels
+     * @param filename Path to the pack
+     * @return The pack, or nullptr if the file could not be opened
+     * @throws InvalidLevelFile
+     */
+    static std::unique_ptr<LevelPack> open(const std::string &filename);
+
+    /**
+     * Writes levels to a pack
+     * @param filename Path to the pack
+     * @param levels The levels, with distinct numbers
+     * @param encoding How tiles are stored
+     * @return Whether the file was written
+     */
+    static bool save(const std::string &filename, const std::vector<Level> &levels, TileEncoding encoding = ByteTiles);
+
+    /**
+     * Reads a level in the text format of GridBuilder::buildLevel. The level is as wide as it's longest line and as
+     * high as the number of lines (not counting empty lines at the end)
+     * @param input The text
+     * @param number Number of the level
+     * @return
+     */
+    static Level parseText(std::istream &input, unsigned int number);
+
+    /**
+     * Writes a level in the text format read by parseText
+     * @param output The text
+     * @param level The level
+     */
+    static void writeText(std::ostream &output, const Level &level);
+
+    [[nodiscard]] std::size_t getLevelCount() const;
+
+    /**
+     * Returns a level by it's position in the pack
+     */
+    [[nodiscard]] LevelView getLevelAt(std::size_t index) const;
+
+    /**
+     * Finds a level by it's number
+     * @return The level, or std::nullopt if the pack does not have it
+     */
+    [[nodiscard]] std::optional<LevelView> findLevel(unsigned int number) const;
+
+protected:
+    LevelPack(const std::uint8_t *data, std::size_t size);
+
+    const std::uint8_t *data_;
+    std::size_t size_;
+    std::vector<LevelView> levels_;
+};
+
+
+#endif //PROI_PROJEKT_LEVELPACK_H
@@ -0,0 +1,115 @@
+#ifndef PROI_PROJEKT_LEVELPRELOADER_H
+#define PROI_PROJEKT_LEVELPRELOADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+class Grid;
+
+/**
+ * \brief Builds the next level on a background thread while the current one is played
+ *
+ * A level asked for with preload is built on the preloader's thread (started with the first preload), so that taking
+ * it when the level starts only hands over the ready grid. Only one level is kept: preloading another one drops the
+ * previous one. Taking a level that was not preloaded builds it on the calling thread.
+ *
+ * Building a grid queues no events, so the builder is the only code run on the preloader's thread. A level that fails
+ * to build in the background is built again by take, so that errors are thrown on the calling thread.
+ */
+class LevelPreloader {
+public:
+    /**
+     * Builds a grid of a level, called on the preloader's thread
+     */
+    using Builder = std::function<std::unique_ptr<Grid>(unsigned int)>;
+
+    /**
+     * @param builder Builds grids of levels, GridBuilder::buildLevel by default
+     */
+    explicit LevelPreloader(Builder builder = nullptr);
+
+    LevelPreloader(const LevelPreloader &other) = delete;
+
+    LevelPreloader &operator=(const LevelPreloader &other) = delete;
+
+    /**
+     * Waits for the level being built and stops the thread
+     */
+    ~LevelPreloader();
+
+    /**
+     * Starts building a level in the background. Does nothing if the level is already built or being built
+     * @param level Number of the level
+     */
+    void preload(unsigned int level);
+
+    /**
+     * Builds a level again, if it is the one preloaded, as it's file has changed. Does nothing for other levels
+     * @param level Number of the level
+     */
+    void invalidate(unsigned int level);
+
+    /**
+     * Hands over the grid of a level. Waits if the level is still being built, builds it on the calling thread if it
+     * was not preloaded
+     * @param level Number of the level
+     * @return The grid
+     */
+    std::unique_ptr<Grid> take(unsigned int level);
+
+    /**
+     * Checks if a level has been built and can be taken without waiting
+     * @param level Number of the level
+     * @return
+     */
+    [[nodiscard]] bool isReady(unsigned int level) const;
+
+    /**
+     * Returns the number of levels taken after being preloaded
+     * @return
+     */
+    [[nodiscard]] unsigned int getHits() const;
+
+    /**
+     * Returns the number of levels built on the calling thread by take
+     * @return
+     */
+    [[nodiscard]] unsigned int getMisses() const;
+
+protected:
+    /**
+     * Builds requested levels until the preloader is stopped
+     */
+    void workerLoop();
+
+    Builder builder_;
+    std::thread worker_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable requested_;
+    std::condition_variable built_;
+    bool stopping_ = false;
+
+    /**
+     * The level preloaded last, it's grid once built, and whether it is being built right now
+     */
+    std::optional<unsigned int> level_;
+    std::unique_ptr<Grid> grid_;
+    bool building_ = false;
+
+    /**
+     * Changed whenever the grid being built becomes stale, so that it is dropped once built
+     */
+    std::uint64_t generation_ = 0;
+
+    unsigned int hits_ = 0;
+    unsigned int misses_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_LEVELPRELOADER_H
@@ -0,0 +1,228 @@
+#ifndef PROI_PROJEKT_LEVELREPOSITORY_H
+#define PROI_PROJEKT_LEVELREPOSITORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LevelPack.h"
+#include "LevelValidator.h"
+
+class Grid;
+
+/**
+ * \brief Index of all levels available to the game
+ *
+ * Level directories are scanned once, when the repository is initialized. Every level found is read and described by
+ * an Entry, so levels can be listed, and split between workers, without touching the filesystem again.
+ *
+ * A directory can hold:
+ *  - level packs (*.pack, see LevelPack), mapped for as long as the repository exists
+ *  - text levels (*.txt, see GridBuilder::buildLevel), read again whenever they are loaded. Files named lvl<N>.txt are
+ *  level N, other files can only be loaded by name
+ *
+ * When many files have a level with the same number or name, the first one found is used: directories are searched
+ * in the order given, packs before text files, files in the order of their names.
+ *
+ * Every level is checked with LevelValidator when it is found, and text levels again whenever they are loaded, so
+ * broken levels are refused before they are played.
+ *
+ * Repository must be initialized before using it with ::initialize, and then it can be accessed with ::instance().
+ * After that, it is only changed by ::overrideLevel, when a level file is edited while the game runs (see
+ * LevelWatcher). Levels can be built by their number or name from many threads at once, also while a level is
+ * overridden; entries should only be used on the thread levels are overridden on.
+ */
+class LevelRepository {
+public:
+    /**
+     * Directory the game looks for levels in
+     */
+    static constexpr const char *DefaultDirectory = "./levels";
+
+    /**
+     * Description of a level
+     */
+    struct Entry {
+        /**
+         * Number of the level, or std::nullopt if the level can only be loaded by name
+         */
+        std::optional<unsigned int> number;
+
+        /**
+         * Name of the level: the name of it's text file without the extension, or lvl<N> for levels of packs
+         */
+        std::string name;
+
+        /**
+         * Path to the file holding the level
+         */
+        std::string path;
+
+        /**
+         * Whether the level comes from a pack
+         */
+        bool packed = false;
+
+        unsigned int sizeX = 0;
+        unsigned int sizeY = 0;
+        std::size_t tankCount = 0;
+
+        /**
+         * Hash of the level's contents (see hashLevel), the same for a text level and the same level in a pack
+         */
+        std::uint64_t hash = 0;
+
+        /**
+         * Problems found in the level when it was indexed (see LevelValidator)
+         */
+        std::vector<LevelValidator::Problem> problems;
+    };
+
+    LevelRepository(const LevelRepository &) = delete;
+
+    LevelRepository &operator=(const LevelRepository &) = delete;
+
+    /**
+     * Scans level directories and replaces the repository's instance. Directories that do not exist are skipped
+     * @param directories Directories to scan, in the order of priority
+     * @param validating Whether levels with errors are refused when they are built. Problems are listed in the
+     * entries either way
+     * @throws InvalidLevelFile if a pack in one of the directories is broken
+     */
+    static void initialize(const std::vector<std::string> &directories, bool validating = true);
+
+    /**
+     * Accesses repository's instance
+     * @return A pointer to repository's instance
+     * @throws SingletonNotInitializedException
+     */
+    static LevelRepository *instance();
+
+    /**
+     * Returns all levels, numbered ones first, in the order of their numbers, then the others in the order of names
+     * @return
+     */
+    [[nodiscard]] const std::vector<Entry> &getEntries() const;
+
+    /**
+     * Finds a level by it's number
+     * @return The level, or nullptr if there is none
+     */
+    [[nodiscard]] const Entry *findLevel(unsigned int number) const;
+
+    /**
+     * Finds a level by it's name
+     * @return The level, or nullptr if there is none
+     */
+    [[nodiscard]] const Entry *findLevel(const std::string &name) const;
+
+    /**
+     * Returns a part of all levels, so that shards 0 to shardCount - 1 hold every level once
+     * @param shard Number of the shard
+     * @param shardCount Number of shards
+     * @return Every shardCount-th entry, starting with entry number shard
+     */
+    [[nodiscard]] std::vector<const Entry *> getShard(std::size_t shard, std::size_t shardCount) const;
+
+    /**
+     * Reads a whole level, without clamping it to the size of the grid
+     * @param entry One of the repository's entries
+     * @return
+     * @throws InvalidLevelFile if the text file of the level can no longer be read
+     */
+    [[nodiscard]] LevelPack::Level readLevel(const Entry &entry) const;
+
+    /**
+     * Builds a grid of a level
+     * @param number Number of the level
+     * @return
+     * @throws InvalidLevelFile if there is no such level, it's file can no longer be read or it has errors
+     */
+    [[nodiscard]] std::unique_ptr<Grid> buildLevel(unsigned int number) const;
+
+    /**
+     * Builds a grid of a level
+     * @param name Name of the level
+     * @return
+     * @throws InvalidLevelFile if there is no such level, it's file can no longer be read or it has errors
+     */
+    [[nodiscard]] std::unique_ptr<Grid> buildLevel(const std::string &name) const;
+
+    /**
+     * Builds a grid of a level
+     * @param entry One of the repository's entries
+     * @return
+     * @throws InvalidLevelFile if the text file of the level can no longer be read, or the level has errors
+     */
+    [[nodiscard]] std::unique_ptr<Grid> buildLevel(const Entry &entry) const;
+
+    /**
+     * Makes a text level the level of it's name (and of it's number, for lvl<N>), in place of the level found when the
+     * repository was scanned, even if that one came from a pack. Entries are sorted again, so pointers to them are
+     * no longer valid
+     * @param name File name without the extension
+     * @param path Path to the text file, read again whenever the level is loaded
+     * @param level The level read from the file
+     */
+    void overrideLevel(const std::string &name, const std::string &path, const LevelPack::Level &level);
+
+    /**
+     * Checks if levels with errors are refused when they are built
+     * @return
+     */
+    [[nodiscard]] bool isValidating() const;
+
+    /**
+     * Returns the number of a level from the name of it's text file
+     * @param name File name without the extension
+     * @return N for lvl<N>, std::nullopt for other names
+     */
+    static std::optional<unsigned int> levelNumberOf(const std::string &name);
+
+    /**
+     * Computes a 64-bit FNV-1a hash of a level's size, tiles, points and tank types
+     * @param level
+     * @return
+     */
+    static std::uint64_t hashLevel(const LevelPack::Level &level);
+
+private:
+    LevelRepository(const std::vector<std::string> &directories, bool validating);
+
+    /**
+     * Adds a level, unless a level with the same number or name has already been found
+     */
+    void addLevel(Entry entry, const LevelPack::Level &level, std::optional<LevelPack::LevelView> view);
+
+    /**
+     * Sorts entries, numbered ones first, and indexes them by their numbers and names
+     */
+    void sortEntries();
+
+    std::vector<std::unique_ptr<LevelPack>> packs_;
+    std::vector<Entry> entries_;
+
+    /**
+     * Levels of packs, indexed like entries_
+     */
+    std::vector<std::optional<LevelPack::LevelView>> views_;
+
+    std::unordered_map<unsigned int, std::size_t> byNumber_;
+    std::unordered_map<std::string, std::size_t> byName_;
+    bool validating_;
+
+    /**
+     * Held shared while levels are built by their number or name, and exclusively while a level is overridden
+     */
+    mutable std::shared_mutex mutex_;
+
+    static std::unique_ptr<LevelRepository> self_;
+};
+
+
+#endif //PROI_PROJEKT_LEVELREPOSITORY_H
@@ -0,0 +1,130 @@
+#ifndef PROI_PROJEKT_LEVELVALIDATOR_H
+#define PROI_PROJEKT_LEVELVALIDATOR_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "LevelPack.h"
+
+/**
+ * \brief Finds mistakes in levels before they are played
+ *
+ * Tanks are 4x4 tiles (see FlowField::FootprintSize), so a position of a tank, it's top-left tile, is free when none
+ * of the tiles under the tank are collidable and indestructible (steel), and the tank does not overlap the eagle.
+ * Bricks can be shot through, so they do not cut paths. Positions are kept as bitsets, a line of bits for every column
+ * of the level, which lets a flood fill spread over 64 positions with a few word operations:
+ *  - along a column, a whole run of free positions is filled at once, by adding the reached positions to the free ones
+ *  (carries run from a reached position to the end of it's run) and by shifts in the other direction
+ *  - between columns, reached positions are ANDed with the free positions of the neighbouring column
+ * Columns are swept forwards and backwards until nothing changes, and a line only takes the words of it's neighbour
+ * that changed since it last looked at them. A 52x52 level is checked in microseconds, so every level is checked when
+ * it is loaded.
+ *
+ * Class does not provide a constructor and all of it's methods are static, like GridBuilder.
+ */
+class LevelValidator {
+public:
+    /**
+     * Most isolated regions described by a report, the positions of all of them are counted anyway
+     */
+    static constexpr std::size_t MaxReportedRegions = 8;
+
+    enum ProblemType {
+        /**
+         * The level has no '+'
+         */
+        MissingPlayerSpawnpoint,
+
+        /**
+         * The level has no 'E'
+         */
+        MissingEagle,
+
+        /**
+         * The level has enemy tanks, but no '*' to spawn them at
+         */
+        MissingSpawnpoints,
+
+        /**
+         * The eagle sticks out of the level or stands on collidable tiles
+         */
+        EagleBlocked,
+
+        /**
+         * A tank spawned at the point would stick out of the level or stand on collidable tiles
+         */
+        SpawnpointBlocked,
+        PlayerSpawnpointBlocked,
+
+        /**
+         * No path leads from the point to the eagle, even when shooting through bricks
+         */
+        SpawnpointUnreachable,
+        PlayerSpawnpointUnreachable,
+
+        /**
+         * Tanks spawned at the point would overlap the eagle or a tank spawned at another point
+         */
+        SpawnpointsOverlap,
+
+        /**
+         * Free positions from which the eagle cannot be reached. Not an error, as no tank has to get there
+         */
+        IsolatedRegion
+    };
+
+    struct Problem {
+        ProblemType type;
+
+        /**
+         * The point with the problem, or the first position of the region
+         */
+        std::pair<unsigned int, unsigned int> location{0, 0};
+
+        /**
+         * @return Whether the level cannot be played with the problem
+         */
+        [[nodiscard]] bool isError() const;
+
+        [[nodiscard]] std::string describe() const;
+    };
+
+    struct Report {
+        std::vector<Problem> problems;
+
+        /**
+         * Number of free positions from which the eagle can be reached
+         */
+        std::size_t reachablePositions = 0;
+
+        /**
+         * Number of free positions from which the eagle cannot be reached
+         */
+        std::size_t isolatedPositions = 0;
+
+        /**
+         * @return Whether none of the problems is an error
+         */
+        [[nodiscard]] bool isValid() const;
+
+        /**
+         * Describes the errors, and the other problems after them
+         */
+        [[nodiscard]] std::string describe() const;
+    };
+
+    /**
+     * Checks a whole level
+     * @param level
+     * @return
+     */
+    static Report validate(const LevelPack::Level &level);
+
+private:
+    LevelValidator() = default;
+};
+
+
+#endif //PROI_PROJEKT_LEVELVALIDATOR_H
@@ -0,0 +1,135 @@
+#ifndef PROI_PROJEKT_LEVELWATCHER_H
+#define PROI_PROJEKT_LEVELWATCHER_H
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LevelPack.h"
+#include "LevelValidator.h"
+
+class Board;
+
+/**
+ * \brief Reloads text levels while the game runs, for tuning maps without restarting it
+ *
+ * Level directories are watched with inotify on a background thread. Text levels (*.txt) that are written or moved
+ * into a directory are parsed and validated on that thread, and wait until the game applies them with applyChanges.
+ * Changed levels replace the levels of LevelRepository (even levels of packs), so they are also used when loaded
+ * later. The level being played is changed tile by tile (see Board::applyLevelTiles), so only tiles that changed queue
+ * events and entities are left where they are.
+ *
+ * Meant for development only. If inotify is not available, nothing is watched.
+ */
+class LevelWatcher {
+public:
+    /**
+     * A level whose file has changed
+     */
+    struct Change {
+        /**
+         * Name of the file without the extension
+         */
+        std::string name;
+
+        /**
+         * Number of the level, or std::nullopt if it's file is not named lvl<N>.txt
+         */
+        std::optional<unsigned int> number;
+
+        /**
+         * Path to the file
+         */
+        std::string path;
+        LevelPack::Level level;
+
+        /**
+         * Problems found in the level by LevelValidator
+         */
+        LevelValidator::Report report;
+    };
+
+    /**
+     * Starts watching
+     * @param directories Directories to watch
+     */
+    explicit LevelWatcher(const std::vector<std::string> &directories);
+
+    LevelWatcher(const LevelWatcher &other) = delete;
+
+    LevelWatcher &operator=(const LevelWatcher &other) = delete;
+
+    /**
+     * Stops watching and joins the thread
+     */
+    ~LevelWatcher();
+
+    /**
+     * Checks if any directory is watched
+     * @return
+     */
+    [[nodiscard]] bool isWatching() const;
+
+    /**
+     * Returns levels changed since the last call, the last version of each
+     * @return
+     */
+    std::vector<Change> takeChanges();
+
+    /**
+     * Applies changed levels to LevelRepository and to a board: the tiles of the level being played are changed, and
+     * levels preloaded by the board are built again. Levels with errors are refused if the repository validates
+     * levels, and are left as they were (see ::takeRefused()). Should be called on the thread the board is used on
+     *
+     * Possibly queues Event::TilePlaced, Event::TileChanged and Event::TileDeleted
+     * @param board The board
+     * @return Number of tiles that changed
+     * @throws SingletonNotInitializedException if LevelRepository was not initialized
+     */
+    std::size_t applyChanges(Board &board);
+
+    /**
+     * Returns levels refused by ::applyChanges() since the last call, so their problems can be reported
+     * @return
+     */
+    std::vector<Change> takeRefused();
+
+protected:
+    /**
+     * Waits for inotify events and parses changed levels, until the watcher is stopped
+     */
+    void watchLoop();
+
+    /**
+     * Parses a level and replaces an older change of the same file
+     */
+    void readLevel(const std::string &directory, const std::string &file);
+
+    int inotify_ = -1;
+
+    /**
+     * Pipe written to when the watcher is stopped, wakes up the thread
+     */
+    int stopPipe_[2] = {-1, -1};
+
+    /**
+     * Watched directories, with their inotify watch descriptors
+     */
+    std::vector<std::pair<int, std::string>> watches_;
+
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::vector<Change> changes_;
+
+    /**
+     * Only used on the thread changes are applied on
+     */
+    std::vector<Change> refused_;
+};
+
+
+#endif //PROI_PROJEKT_LEVELWATCHER_H
@@ -0,0 +1,226 @@
+#ifndef PROI_PROJEKT_SIMULATEDWORLD_H
+#define PROI_PROJEKT_SIMULATEDWORLD_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../tank-lib/include/FixedPoint.h"
+#include "../../tank-lib/include/Sweep.h"
+
+class Board;
+class Entity;
+class Grid;
+
+/**
+ * \brief Lightweight copy of the board state that can be simulated ahead, without touching the board
+ *
+ * Entities are stored in flat arrays (one element per entity) and moved with MovementIntegrator::integrate, stopped
+ * at tiles with Board::findTileImpact and checked against each other with Sweep, so simulations move like the board
+ * does. Collisions are then resolved with simplified game rules:
+ * - tanks stop at tiles, and go back to where they were at the beginning of the tick when they run into other tanks
+ *   or the eagle
+ * - a bullet is destroyed by the first thing it hits (other bullets do not stop it), taking a life of a tank of the
+ *   other side, destroying the eagle, or destroying destructible tiles where it hit the grid
+ *
+ * The root world is captured from a board once (capture), and can be forked many times (fork, copyFrom). The grid is
+ * copied on write: worlds read the grid of the world they were forked from, until one of their bullets destroys a
+ * tile. Forking reuses memory of the world that is forked into, so a world kept around for many forks stops
+ * allocating once it has warmed up. The world a fork was made from must outlive it and must not change while it
+ * exists.
+ *
+ * Simulations queue no events. Dead entities are kept (with alive cleared), so indices of entities never change.
+ */
+class SimulatedWorld {
+public:
+    enum Kind : std::uint8_t {
+        PlayerTank,
+        EnemyTank,
+        FriendlyBullet,
+        EnemyBullet,
+        Eagle
+    };
+
+    /**
+     * Index used when an entity is not linked to any other
+     */
+    static constexpr std::uint32_t None = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * Entities, one element of every array per entity
+     */
+    struct Entities {
+        std::vector<FixedPoint::Value> x;
+        std::vector<FixedPoint::Value> y;
+        std::vector<FixedPoint::Value> sizeX;
+        std::vector<FixedPoint::Value> sizeY;
+
+        /**
+         * Distance moved in a tick, already scaled to board's tick rate
+         */
+        std::vector<FixedPoint::Value> step;
+
+        /**
+         * Step of bullets fired by tanks
+         */
+        std::vector<FixedPoint::Value> bulletStep;
+        std::vector<unsigned int> facing;
+        std::vector<Kind> kind;
+        std::vector<std::uint8_t> moving;
+        std::vector<std::uint8_t> alive;
+        std::vector<unsigned int> lives;
+
+        /**
+         * Tank's live bullet, or bullet's tank (None if there is none)
+         */
+        std::vector<std::uint32_t> link;
+    };
+
+    SimulatedWorld();
+
+    ~SimulatedWorld();
+
+    SimulatedWorld(const SimulatedWorld &) = delete;
+
+    SimulatedWorld &operator=(const SimulatedWorld &) = delete;
+
+    /**
+     * Captures tanks, bullets and the eagle from a board. The board's grid is read, not copied, so the board must not
+     * change while the world (or any world forked from it) is in use
+     * @param board The board
+     */
+    void capture(Board &board);
+
+    /**
+     * Returns the index of a captured entity
+     * @param entity An entity of the captured board
+     * @return The index, or std::nullopt if the entity was not captured
+     */
+    [[nodiscard]] std::optional<std::uint32_t> indexOf(const Entity *entity) const;
+
+    /**
+     * Makes the world a copy of another one
+     * @param source The world to copy
+     */
+    void copyFrom(const SimulatedWorld &source);
+
+    /**
+     * Makes the world a copy of the part of another one around an entity: the entity itself (at index 0), the player,
+     * the eagle, and entities closer to it than a given distance
+     * @param source The world to copy
+     * @param focus Index of the entity in source
+     * @param radius The distance between bounding boxes, in fixed-point units
+     */
+    void fork(const SimulatedWorld &source, std::uint32_t focus, FixedPoint::Value radius);
+
+    /**
+     * Starts or stops a tank
+     */
+    void setMoving(std::uint32_t tank, bool moving);
+
+    /**
+     * Turns a tank like Board::setTankDirection does (snapping it to the grid, unless it turns back), if it does not
+     * run into a collidable tile by doing so
+     * @param tank Index of the tank
+     * @param direction New direction
+     * @return Whether the tank turned
+     */
+    bool rotate(std::uint32_t tank, Direction direction);
+
+    /**
+     * Fires a bullet from a tank, unless the tank already has one
+     * @param tank Index of the tank
+     * @return Index of the new bullet, or std::nullopt if none was fired
+     */
+    std::optional<std::uint32_t> fire(std::uint32_t tank);
+
+    /**
+     * Moves the world by a single tick
+     */
+    void step();
+
+    [[nodiscard]] const Entities &getEntities() const;
+
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Returns the grid, with tiles destroyed in the simulation
+     */
+    [[nodiscard]] const Grid &getGrid() const;
+
+    /**
+     * Returns whether the world has it's own copy of the grid
+     */
+    [[nodiscard]] bool ownsGrid() const;
+
+protected:
+    /**
+     * A copy of a grid that can be changed without queueing events (defined in SimulatedWorld.cpp)
+     */
+    class ForkedGrid;
+
+    /**
+     * Contact of two entities during a tick
+     */
+    struct Contact {
+        FixedPoint::Value time;
+        std::uint32_t first;
+        std::uint32_t second;
+    };
+
+    /**
+     * Appends an entity copied from another world
+     */
+    void append(const SimulatedWorld &source, std::uint32_t index);
+
+    /**
+     * Returns a grid that can be changed, copying the grid on the first write
+     */
+    ForkedGrid &writableGrid();
+
+    /**
+     * Destroys destructible tiles hit by a bullet, like the game does: the tile that was hit and the tiles next to it
+     * across bullet's way (one before, two after)
+     */
+    void destroyTiles(std::uint32_t bullet, std::pair<unsigned int, unsigned int> tile);
+
+    /**
+     * Resolves a contact of two entities
+     */
+    void resolve(const Contact &contact);
+
+    /**
+     * Destroys an entity, unlinking a bullet from it's tank
+     */
+    void kill(std::uint32_t index);
+
+    [[nodiscard]] bool isBullet(std::uint32_t index) const;
+
+    [[nodiscard]] Sweep::Box boxOf(std::uint32_t index) const;
+
+    Entities entities_;
+
+    const Grid *grid_ = nullptr;
+    std::unique_ptr<ForkedGrid> ownGrid_;
+    bool ownsGrid_ = false;
+
+    /**
+     * Captured entities and their indices (only in captured worlds)
+     */
+    std::unordered_map<const Entity *, std::uint32_t> indices_;
+
+    // scratch space of step and fork
+    std::vector<FixedPoint::Value> steps_;
+    std::vector<Sweep::Motion> motions_;
+    std::vector<std::uint32_t> moved_;
+    std::vector<std::optional<std::pair<unsigned int, unsigned int>>> tileHits_;
+    std::vector<Contact> contacts_;
+    std::vector<std::uint32_t> remap_;
+};
+
+
+#endif //PROI_PROJEKT_SIMULATEDWORLD_H
@@ -4,6 +4,7 @@
 
 #include <optional>
 #include <memory>
+#include <queue>
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/catch_all.hpp"
@@ -19,6 +20,7 @@
 #include "../../core-lib/include/EventQueue.h"
 #include "../../core-lib/include/Clock.h"
 
+#include "../../bot-lib/include/Bot.h"
 #include "../../bot-lib/include/BotController.h"
 
 namespace {  // anonymous namespace to force internal linkage
@@ -52,6 +54,10 @@ namespace {  // anonymous namespace to force internal linkage
             std::unique_ptr<Event> testCreateCollisionEvent(std::shared_ptr<Entity> entity) {
                 return std::move(createCollisionEvent(entity));
             }
+
+            std::shared_ptr<Entity> addEntity(std::shared_ptr<Entity> entity) {
+                return entityController_->addEntity(entity);
+            }
         };
 
         std::shared_ptr<Tank>
@@ -87,6 +93,52 @@ namespace {  // anonymous namespace to force internal linkage
             return EventQueue<Event>::instance()->pop()->info.tileInfo.grid;
         }
 
+        /**
+         * What happens during seconds of a match
+         */
+        struct Outcome {
+            FixedPoint::Value playerX;
+            unsigned int spawnDecisions;
+            unsigned int decisionCooldown;
+        };
+
+        /**
+         * Plays 10 seconds at a tick rate: a player moves for the first second, while bots are spawned
+         */
+        Outcome playSeconds(unsigned int ticksPerSecond) {
+            Clock::initialize(ticksPerSecond);
+            BotController::initialize(4, 240);
+            BotController::instance()->subscribe(Clock::instance());
+            BotController::instance()->setSpawnpoints({{2, 2}});
+            BotController::instance()->setTypes(std::queue<Tank::TankType>({Tank::BasicTank, Tank::BasicTank,
+                                                                            Tank::BasicTank}));
+            BotController::instance()->setCounting(true);
+            TestBoard board{};
+            board.setTickRate(ticksPerSecond);
+            board.spawnPlayer(4, 40, East);
+            board.setTankMoving(board.getPlayerTank(), true);
+            board.spawnTank(30, 2, Tank::BasicTank);
+            EventQueue<Event> *eventQueue = getEmptyEventQueue();
+
+            Outcome outcome{0, 0, 0};
+            outcome.decisionCooldown = std::dynamic_pointer_cast<Bot>(board.getLastEntity())->getDecisionCooldown();
+            for (unsigned int tick = 1; tick <= 10 * ticksPerSecond; tick++) {
+                Clock::instance()->tick();
+                board.moveAllEntities();
+                if (tick == ticksPerSecond) {
+                    outcome.playerX = board.getPlayerTank()->getFixedX();
+                    board.setTankMoving(board.getPlayerTank(), false);
+                }
+                while (!eventQueue->isEmpty()) {
+                    if (eventQueue->pop()->type == Event::BotSpawnDecision) {
+                        outcome.spawnDecisions++;
+                    }
+                }
+            }
+            BotController::instance()->setCounting(false);
+            return outcome;
+        }
+
         void initSingletons(){
             Clock::initialize(60);
             BotController::initialize(4, 240);
@@ -253,10 +305,10 @@ SCENARIO("Rotating tanks an fractional coords") {
             THEN("Tank should not be snapped to grid") {
                 REQUIRE(tank1->getFacing() == South);
                 REQUIRE(tank1->getX() == 5);
-                REQUIRE(tank1->getY() == 17.8f);
+                REQUIRE(tank1->getFixedY() == FixedPoint::fromFloat(17.8f));
 
                 REQUIRE(tank2->getFacing() == East);
-                REQUIRE(tank2->getX() == 9.2f);
+                REQUIRE(tank2->getFixedX() == FixedPoint::fromFloat(9.2f));
                 REQUIRE(tank2->getY() == 8);
 
                 AND_THEN("Only TankRotated events should be created") {
@@ -281,7 +333,7 @@ SCENARIO("Rotating tanks an fractional coords") {
             THEN("Tank's attrs should not change") {
                 REQUIRE(tank1->getFacing() == North);
                 REQUIRE(tank1->getX() == 5);
-                REQUIRE(tank1->getY() == 17.8f);
+                REQUIRE(tank1->getFixedY() == FixedPoint::fromFloat(17.8f));
 
                 AND_THEN("No events should be created") {
                     REQUIRE(eventQueue->isEmpty());
@@ -296,7 +348,7 @@ SCENARIO("Rotating tanks an fractional coords") {
             board.setTankDirection(tank1, West);
             THEN("Tank should not be rotated, nor snapped to grid") {
                 REQUIRE(tank1->getX() == 5);
-                REQUIRE(tank1->getY() == 17.8f);
+                REQUIRE(tank1->getFixedY() == FixedPoint::fromFloat(17.8f));
                 REQUIRE(tank1->getFacing() == North);
 
                 AND_THEN("No events should be created") {
@@ -489,6 +541,391 @@ SCENARIO("Moving a single entity") {
     }
 }
 
+SCENARIO("Moving all entities at once") {
+    helper::initSingletons();
+    GIVEN("A board with some tanks and a bullet") {
+        helper::TestBoard board{};
+
+        std::shared_ptr<Tank> tank = helper::placeTank(&board, 4, 8, Tank::PlayerTank);
+        board.setTankMoving(tank, true);
+        std::shared_ptr<Tank> stationaryTank = helper::placeTank(&board, 20, 22, Tank::PowerTank);
+        std::shared_ptr<Tank> blockedTank = helper::placeTank(&board, 40, 10, Tank::BasicTank, West);
+        board.setTankMoving(blockedTank, true);
+        helper::placeTile(&board, 39, 11, Steel);
+        std::shared_ptr<Bullet> bullet = helper::fireBullet(&board, stationaryTank).value();
+
+        float initialBulletY = bullet->getY();
+
+        auto eventQueue = helper::getEmptyEventQueue();
+
+        WHEN("Calling the moveAllEntities() method") {
+            board.moveAllEntities();
+
+            THEN("Bullets and tanks with moving flag set should be moved, but not past tiles") {
+                REQUIRE(tank->getY() == 8 - tank->getSpeed());
+                REQUIRE(stationaryTank->getY() == 22);
+                REQUIRE(blockedTank->getFixedX() == FixedPoint::fromTiles(40) - 1);
+                REQUIRE(bullet->getY() == initialBulletY - bullet->getSpeed());
+
+                AND_THEN("Moves should be reported first, followed by collisions") {
+                    REQUIRE(eventQueue->size() == 4);
+
+                    auto event = eventQueue->pop();
+                    REQUIRE(event->type == Event::EntityMoved);
+                    REQUIRE(event->info.entityInfo.entity == tank);
+
+                    event = eventQueue->pop();
+                    REQUIRE(event->type == Event::EntityMoved);
+                    REQUIRE(event->info.entityInfo.entity == blockedTank);
+
+                    event = eventQueue->pop();
+                    REQUIRE(event->type == Event::EntityMoved);
+                    REQUIRE(event->info.entityInfo.entity == bullet);
+
+                    event = eventQueue->pop();
+                    REQUIRE(event->type == Event::Collision);
+                    REQUIRE(std::get<Event::EnemyTankCollisionInfo>(event->info.collisionInfo.member1).enemyTank ==
+                            blockedTank);
+                    REQUIRE(std::holds_alternative<Event::BoardCollisionInfo>(event->info.collisionInfo.member2));
+                    auto tileInfo = std::get<Event::BoardCollisionInfo>(event->info.collisionInfo.member2);
+                    REQUIRE(tileInfo.tile_x == 39);
+                    REQUIRE(tileInfo.tile_y == 11);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Bullets hitting tiles along their flight path") {
+    helper::initSingletons();
+    GIVEN("A board with a single brick tile and a very fast bullet flying towards it") {
+        helper::TestBoard board{};
+
+        helper::placeTile(&board, 15, 20, Bricks);
+        auto bullet = std::make_shared<Bullet>(10.25, 20.25, East, 3, Bullet::Enemy);
+        board.addEntity(bullet);
+
+        auto eventQueue = helper::getEmptyEventQueue();
+
+        WHEN("Moving the bullet until it would fly past the tile") {
+            board.moveAllEntities();
+
+            THEN("The bullet should not collide in the first tick") {
+                REQUIRE(bullet->getX() == 13.25f);
+                REQUIRE(eventQueue->size() == 1);
+                eventQueue->clear();
+
+                AND_THEN("It should be stopped right inside the tile and collide in the second tick") {
+                    board.moveAllEntities();
+
+                    REQUIRE(bullet->getFixedX() + bullet->getFixedSizeX() == FixedPoint::fromTiles(15) + 1);
+                    REQUIRE(board.testValidateEntityPosition(bullet) == false);
+
+                    REQUIRE(eventQueue->size() == 2);
+                    REQUIRE(eventQueue->pop()->type == Event::EntityMoved);
+                    auto event = eventQueue->pop();
+                    REQUIRE(event->type == Event::Collision);
+                    REQUIRE(std::holds_alternative<Event::BoardCollisionInfo>(event->info.collisionInfo.member2));
+                    auto tileInfo = std::get<Event::BoardCollisionInfo>(event->info.collisionInfo.member2);
+                    REQUIRE(tileInfo.tile_x == 15);
+                    REQUIRE(tileInfo.tile_y == 20);
+                }
+            }
+        }
+
+        WHEN("The tile is destroyed while the bullet is flying") {
+            board.moveAllEntities();
+            board.getGrid()->deleteTile(15, 20);
+            eventQueue->clear();
+
+            board.moveAllEntities();
+
+            THEN("The bullet should keep flying") {
+                REQUIRE(bullet->getX() == 16.25f);
+                REQUIRE(eventQueue->size() == 1);
+                REQUIRE(eventQueue->pop()->type == Event::EntityMoved);
+            }
+        }
+
+        WHEN("Moving the bullet towards the edge of the map") {
+            board.getGrid()->deleteTile(15, 20);
+            for (int i = 0; i < 20; i++) {
+                board.moveAllEntities();
+            }
+
+            THEN("It should be stopped just outside of the map") {
+                REQUIRE(bullet->getFixedX() + bullet->getFixedSizeX() == FixedPoint::fromTiles(52) + 1);
+                REQUIRE_FALSE(board.testValidateEntityPosition(bullet));
+                eventQueue->clear();
+            }
+        }
+    }
+}
+
+SCENARIO("Moving entities at a lower tick rate") {
+    helper::initSingletons();
+    GIVEN("A board updated 20 times per second") {
+        helper::TestBoard board{};
+        board.setTickRate(20);
+
+        auto eventQueue = helper::getEmptyEventQueue();
+
+        WHEN("Moving a tank") {
+            std::shared_ptr<Tank> tank = helper::placeTank(&board, 10, 10, Tank::FastTank, East);
+            board.setTankMoving(tank, true);
+            eventQueue->clear();
+
+            board.moveAllEntities();
+
+            THEN("It should be moved by three times it's speed") {
+                REQUIRE(tank->getFixedX() == FixedPoint::fromTiles(10) + 3 * tank->getFixedSpeed());
+                REQUIRE(eventQueue->size() == 1);
+                eventQueue->clear();
+            }
+        }
+
+        WHEN("Two fast bullets fly past each other within a single tick") {
+            auto bullet1 = std::make_shared<Bullet>(10, 20.25, East, 0.7, Bullet::Friendly);
+            auto bullet2 = std::make_shared<Bullet>(12, 20.25, West, 0.7, Bullet::Enemy);
+            board.addEntity(bullet1);
+            board.addEntity(bullet2);
+
+            board.moveAllEntities();
+
+            THEN("Their collision should still be detected, and reported only once") {
+                REQUIRE(bullet1->getX() > bullet2->getX() + bullet2->getSizeX());
+
+                REQUIRE(eventQueue->size() == 3);
+                eventQueue->pop();
+                eventQueue->pop();
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::Collision);
+                REQUIRE(std::get<Event::FriendlyBulletCollisionInfo>(event->info.collisionInfo.member1).friendlyBullet ==
+                        bullet1);
+                REQUIRE(std::get<Event::EnemyBulletCollisionInfo>(event->info.collisionInfo.member2).enemyBullet ==
+                        bullet2);
+                eventQueue->clear();
+            }
+        }
+
+        WHEN("A bullet could hit multiple tanks within a single tick") {
+            std::shared_ptr<Tank> farTank = helper::placeTank(&board, 15, 20, Tank::BasicTank);
+            std::shared_ptr<Tank> nearTank = helper::placeTank(&board, 12, 24, Tank::BasicTank);
+            auto bullet = std::make_shared<Bullet>(10.5, 23.8, East, 3, Bullet::Friendly);
+            board.addEntity(bullet);
+            eventQueue->clear();
+
+            board.moveAllEntities();
+
+            THEN("It should collide with the one it touches first") {
+                REQUIRE(eventQueue->size() == 2);
+                eventQueue->pop();
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::Collision);
+                REQUIRE(std::get<Event::EnemyTankCollisionInfo>(event->info.collisionInfo.member2).enemyTank ==
+                        nearTank);
+            }
+        }
+    }
+}
+
+SCENARIO("Playing at different tick rates") {
+    GIVEN("The same match played at 60 and 20 ticks per second") {
+        helper::Outcome reference = helper::playSeconds(60);
+        helper::Outcome slower = helper::playSeconds(20);
+        helper::initSingletons();
+
+        THEN("Tanks should move as far in a second") {
+            REQUIRE(slower.playerX == reference.playerX);
+            REQUIRE(reference.playerX > FixedPoint::fromTiles(4));
+        }
+
+        THEN("Bots should be spawned as often") {
+            REQUIRE(reference.spawnDecisions == 2);
+            REQUIRE(slower.spawnDecisions == reference.spawnDecisions);
+        }
+
+        THEN("Bots should make decisions as often") {
+            REQUIRE(reference.decisionCooldown == BotController::DefaultDecisionCooldown);
+            REQUIRE(slower.decisionCooldown * 3 == reference.decisionCooldown);
+        }
+    }
+}
+
+SCENARIO("Building the contact list") {
+    helper::initSingletons();
+    GIVEN("A board with a moving tank and two stationary tanks right in front of it") {
+        helper::TestBoard board{};
+
+        std::shared_ptr<Tank> tank = helper::placeTank(&board, 10, 10, Tank::BasicTank, East);
+        std::shared_ptr<Tank> upperTank = helper::placeTank(&board, 14, 7, Tank::BasicTank);
+        std::shared_ptr<Tank> lowerTank = helper::placeTank(&board, 14, 11, Tank::BasicTank);
+        board.setTankMoving(tank, true);
+
+        auto eventQueue = helper::getEmptyEventQueue();
+
+        WHEN("Moving the tank into both of them at once") {
+            board.moveAllEntities();
+
+            THEN("Both contacts should be reported") {
+                const std::vector<Board::Contact> &contacts = board.getContacts();
+                REQUIRE(contacts.size() == 2);
+                REQUIRE(contacts[0].entity == tank);
+                REQUIRE(contacts[0].other.value() == upperTank);
+                REQUIRE(contacts[1].entity == tank);
+                REQUIRE(contacts[1].other.value() == lowerTank);
+
+                AND_THEN("A collision event should be created for each of them") {
+                    REQUIRE(eventQueue->size() == 3);
+                    REQUIRE(eventQueue->pop()->type == Event::EntityMoved);
+                    REQUIRE(eventQueue->pop()->type == Event::Collision);
+                    REQUIRE(eventQueue->pop()->type == Event::Collision);
+                }
+            }
+        }
+
+        WHEN("Moving the tank away from them") {
+            board.setTankDirection(tank, West);
+            eventQueue->clear();
+            board.moveAllEntities();
+
+            THEN("The contact list should be empty") {
+                REQUIRE(board.getContacts().empty());
+                REQUIRE(eventQueue->size() == 1);
+                eventQueue->clear();
+            }
+        }
+    }
+}
+
+SCENARIO("Checking line of sight") {
+    helper::initSingletons();
+    GIVEN("A board with a bot facing the player") {
+        helper::TestBoard board{};
+
+        std::shared_ptr<Tank> bot = helper::placeTank(&board, 10, 10, Tank::BasicTank, East);
+        std::shared_ptr<Tank> player = helper::placeTank(&board, 30, 10, Tank::PlayerTank, West);
+
+        auto eventQueue = helper::getEmptyEventQueue();
+
+        WHEN("Nothing stands between them") {
+            THEN("They should see each other, but only in the right direction") {
+                REQUIRE(board.hasLineOfSight(bot, player, East));
+                REQUIRE_FALSE(board.hasLineOfSight(bot, player, West));
+                REQUIRE_FALSE(board.hasLineOfSight(bot, player, North));
+                REQUIRE(board.hasLineOfSight(player, bot, West));
+
+                REQUIRE(board.findTargetInSight(bot, East) == player);
+                REQUIRE_FALSE(board.findTargetInSight(bot, South).has_value());
+                REQUIRE(board.findTargetInSight(player, West) == bot);
+            }
+        }
+
+        WHEN("A brick tile is placed in the bullet's lane") {
+            helper::placeTile(&board, 20, 12, Bricks);
+
+            THEN("The player should be out of sight") {
+                REQUIRE_FALSE(board.hasLineOfSight(bot, player, East));
+                REQUIRE_FALSE(board.findTargetInSight(bot, East).has_value());
+
+                AND_WHEN("The tile is destroyed") {
+                    board.deleteTile(20, 12);
+                    eventQueue->clear();
+
+                    THEN("The player should be in sight again") {
+                        REQUIRE(board.hasLineOfSight(bot, player, East));
+                    }
+                }
+            }
+        }
+
+        WHEN("Tiles are placed next to the lane, or are not collidable") {
+            helper::placeTile(&board, 20, 10, Bricks);
+            helper::placeTile(&board, 21, 13, Steel);
+            helper::placeTile(&board, 22, 12, Water);
+
+            THEN("The player should still be in sight") {
+                REQUIRE(board.hasLineOfSight(bot, player, East));
+            }
+        }
+
+        WHEN("Another tank stands in the lane") {
+            std::shared_ptr<Tank> blocker = helper::placeTank(&board, 20, 9, Tank::BasicTank);
+
+            THEN("The player should be out of sight") {
+                REQUIRE_FALSE(board.hasLineOfSight(bot, player, East));
+
+                AND_WHEN("The tank is removed") {
+                    board.removeEntity(blocker);
+                    eventQueue->clear();
+
+                    THEN("The player should be in sight again") {
+                        REQUIRE(board.hasLineOfSight(bot, player, East));
+                    }
+                }
+
+                AND_WHEN("The tank moves out of the lane") {
+                    blocker->setFacing(North);
+                    board.setTankMoving(blocker, true);
+                    for (int i = 0; i < 60; i++) {
+                        board.moveAllEntities();
+                    }
+                    eventQueue->clear();
+
+                    THEN("The player should be in sight again") {
+                        REQUIRE(blocker->getY() + blocker->getSizeY() <= 11.8f);
+                        REQUIRE(board.hasLineOfSight(bot, player, East));
+                    }
+                }
+            }
+        }
+
+        WHEN("The player stands beside the lane") {
+            player->setFixedY(FixedPoint::fromTiles(13));
+
+            THEN("It should be out of sight") {
+                REQUIRE_FALSE(board.hasLineOfSight(bot, player, East));
+
+                AND_WHEN("Only the edge of the player crosses the lane") {
+                    player->setFixedY(FixedPoint::fromTiles(12));
+
+                    THEN("It should be in sight") {
+                        REQUIRE(board.hasLineOfSight(bot, player, East));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Benchmarking line of sight queries", "[.][benchmark]") {
+    helper::initSingletons();
+    GIVEN("A board with bricks, a player and many bots") {
+        helper::TestBoard board{};
+        for (unsigned int x = 2; x < 50; x += 6) {
+            for (unsigned int y = 2; y < 50; y += 9) {
+                helper::placeTile(&board, x, y, Bricks);
+            }
+        }
+        std::shared_ptr<Tank> player = helper::placeTank(&board, 24, 40, Tank::PlayerTank);
+        std::vector<std::shared_ptr<Tank>> bots;
+        for (unsigned int i = 0; i < 20; i++) {
+            bots.push_back(helper::placeTank(&board, 4 + (i % 5) * 9, 4 + (i / 5) * 9, Tank::BasicTank));
+        }
+        helper::getEmptyEventQueue();
+
+        THEN("Bots should be able to look for targets in every direction many times per tick") {
+            BENCHMARK("100k target searches") {
+                unsigned int found = 0;
+                for (unsigned int i = 0; i < 100000; i++) {
+                    found += board.findTargetInSight(bots[i % bots.size()], static_cast<Direction>(i % 4)).has_value();
+                }
+                return found;
+            };
+        }
+    }
+}
+
 SCENARIO("Removing all enemy tanks from the board") {
     helper::initSingletons();
     GIVEN("A board with some tanks and bullets") {
@@ -0,0 +1,171 @@
+#include <algorithm>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/FlowField.h"
+#include "../include/Grid.h"
+
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Event.h"
+
+namespace {  // anonymous namespace to force internal linkage
+    namespace helper {
+        class TestGrid : public Grid {
+        public:
+            explicit TestGrid(unsigned int eagleX = 24, unsigned int eagleY = 48) {
+                eagleLocation = {eagleX, eagleY};
+            }
+
+            void fillRow(unsigned int y, unsigned int fromX, unsigned int toX, TileType tile) {
+                for (unsigned int x = fromX; x <= toX; x++) {
+                    setTile(x, y, tile);
+                }
+                EventQueue<Event>::instance()->clear();
+            }
+        };
+
+        /**
+         * Follows the field from a given position, returns the number of steps and the range of X coords visited
+         */
+        struct Walk {
+            unsigned int steps;
+            unsigned int minX;
+            unsigned int maxX;
+        };
+
+        Walk walk(const FlowField &flowField, unsigned int x, unsigned int y) {
+            static constexpr int stepX[4] = {0, -1, 0, 1};
+            static constexpr int stepY[4] = {-1, 0, 1, 0};
+
+            Walk result{0, x, x};
+            for (std::optional<Direction> direction = flowField.getDirection(x, y); direction.has_value();
+                 direction = flowField.getDirection(x, y)) {
+                x += stepX[direction.value()];
+                y += stepY[direction.value()];
+                result.steps++;
+                result.minX = std::min(result.minX, x);
+                result.maxX = std::max(result.maxX, x);
+            }
+            REQUIRE(flowField.getDistance(x, y) == 0);
+            return result;
+        }
+
+        bool sameDistances(const FlowField &a, const FlowField &b) {
+            for (unsigned int x = 0; x < 49; x++)
+                for (unsigned int y = 0; y < 49; y++) {
+                    if (a.getDistance(x, y) != b.getDistance(x, y)) {
+                        return false;
+                    }
+                }
+            return true;
+        }
+    }
+}
+
+SCENARIO("Computing the flow field") {
+    GIVEN("An empty grid with the eagle at the bottom") {
+        helper::TestGrid grid{};
+        FlowField flowField{};
+        flowField.rebuild(grid);
+
+        THEN("Tanks should be led straight towards the eagle") {
+            REQUIRE(flowField.getGridVersion() == grid.getVersion());
+            REQUIRE(flowField.getDistance(24, 0) == 44);
+            REQUIRE(flowField.getDirection(24, 0) == South);
+            REQUIRE(flowField.getDirection(0, 48) == East);
+            REQUIRE(flowField.getDirection(40, 48) == West);
+        }
+
+        THEN("Positions next to the eagle should be the goal") {
+            REQUIRE(flowField.getDistance(24, 44) == 0);
+            REQUIRE(flowField.getDistance(20, 46) == 0);
+            REQUIRE_FALSE(flowField.getDirection(24, 44).has_value());
+        }
+
+        THEN("Positions overlapping the eagle or out of the grid should not be reachable") {
+            REQUIRE(flowField.getCost(22, 46) == FlowField::Unreachable);
+            REQUIRE(flowField.getDistance(22, 46) == FlowField::Unreachable);
+            REQUIRE(flowField.getCost(49, 0) == FlowField::Unreachable);
+            REQUIRE_FALSE(flowField.getDirection(49, 0).has_value());
+        }
+    }
+
+    GIVEN("A grid with a steel wall in front of the eagle") {
+        helper::TestGrid grid{};
+        grid.fillRow(30, 10, 40, Steel);
+        FlowField flowField{};
+        flowField.rebuild(grid);
+
+        THEN("Tanks should be led around the wall, the shorter way") {
+            REQUIRE(flowField.getCost(24, 27) == FlowField::Unreachable);
+            REQUIRE(flowField.getDirection(41, 27) == South);
+
+            helper::Walk fromMiddle = helper::walk(flowField, 24, 20);
+            REQUIRE(fromMiddle.steps == flowField.getDistance(24, 20));
+            REQUIRE(fromMiddle.maxX == 41);
+
+            helper::Walk fromLeft = helper::walk(flowField, 12, 20);
+            REQUIRE(fromLeft.minX == 6);
+        }
+    }
+
+    GIVEN("A grid with a brick wall across the whole grid") {
+        helper::TestGrid grid{};
+        grid.fillRow(30, 0, 51, Bricks);
+        FlowField flowField{};
+        flowField.rebuild(grid);
+
+        THEN("Tanks should be led through the bricks") {
+            REQUIRE(flowField.getCost(24, 27) == FlowField::BrickCost);
+            REQUIRE(flowField.getDistance(24, 20) == 20 + 4 * FlowField::BrickCost);
+            REQUIRE(flowField.getDirection(24, 20) == South);
+        }
+
+        WHEN("Bricks are shot down") {
+            for (unsigned int x = 24; x < 28; x++) {
+                grid.deleteTile(x, 30);
+                flowField.openTile(grid, x, 30);
+            }
+            EventQueue<Event>::instance()->clear();
+
+            THEN("The field should be repaired to lead through the gap") {
+                REQUIRE(flowField.getGridVersion() == grid.getVersion());
+                REQUIRE(flowField.getCost(24, 27) == 1);
+                REQUIRE(flowField.getDistance(24, 20) == 24);
+                REQUIRE(helper::walk(flowField, 24, 20).steps == 24);
+
+                AND_THEN("It should be the same as if it was computed from scratch") {
+                    FlowField rebuilt{};
+                    rebuilt.rebuild(grid);
+                    REQUIRE(helper::sameDistances(flowField, rebuilt));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Benchmarking flow field queries", "[.][benchmark]") {
+    GIVEN("A grid with some walls") {
+        helper::TestGrid grid{};
+        grid.fillRow(20, 0, 40, Bricks);
+        grid.fillRow(30, 10, 51, Steel);
+        FlowField flowField{};
+        flowField.rebuild(grid);
+
+        THEN("Directions for hundreds of bots should be read in well under a millisecond") {
+            BENCHMARK("500 bot directions") {
+                unsigned int sum = 0;
+                for (unsigned int i = 0; i < 500; i++) {
+                    sum += flowField.getDirection(i % 49, (i * 7) % 49).value_or(North);
+                }
+                return sum;
+            };
+
+            BENCHMARK("Rebuilding the flow field") {
+                flowField.rebuild(grid);
+                return flowField.getDistance(0, 0);
+            };
+        }
+    }
+}
@@ -14,6 +14,35 @@ namespace helper {
 
     class TestGrid : public Grid {
     };
+
+    /**
+     * Computes a free run by scanning the grid tile by tile
+     */
+    unsigned int scanFreeRun(Grid &grid, unsigned int x, unsigned int y, Direction direction) {
+        static constexpr int stepX[4] = {0, -1, 0, 1};
+        static constexpr int stepY[4] = {-1, 0, 1, 0};
+
+        unsigned int run = 0;
+        int i = static_cast<int>(x) + stepX[direction];
+        int j = static_cast<int>(y) + stepY[direction];
+        while (i >= 0 && i < grid.getSizeX() && j >= 0 && j < grid.getSizeY() && !grid.isTileCollidable(i, j)) {
+            run++;
+            i += stepX[direction];
+            j += stepY[direction];
+        }
+        return run;
+    }
+
+    bool freeRunsMatchScan(Grid &grid) {
+        for (unsigned int x = 0; x < grid.getSizeX(); x++)
+            for (unsigned int y = 0; y < grid.getSizeY(); y++)
+                for (Direction direction: {North, West, South, East}) {
+                    if (grid.getFreeRun(x, y, direction) != scanFreeRun(grid, x, y, direction)) {
+                        return false;
+                    }
+                }
+        return true;
+    }
 }
 
 SCENARIO("Checking grid's contents") {
@@ -140,4 +169,96 @@ SCENARIO("Setting grid's contents") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Querying free runs") {
+    EventQueue<Event> *eventQueue = EventQueue<Event>::instance();
+    GIVEN("An empty grid") {
+        helper::TestGrid testGrid{};
+
+        THEN("Free runs should reach the edges of the grid") {
+            REQUIRE(testGrid.getFreeRun(10, 20, North) == 20);
+            REQUIRE(testGrid.getFreeRun(10, 20, South) == 31);
+            REQUIRE(testGrid.getFreeRun(10, 20, West) == 10);
+            REQUIRE(testGrid.getFreeRun(10, 20, East) == 41);
+            REQUIRE(testGrid.getFreeRun(0, 0, North) == 0);
+            REQUIRE_THROWS_AS(testGrid.getFreeRun(52, 0, North), OutOfGridException);
+        }
+    }
+
+    GIVEN("A grid with some tiles") {
+        helper::TestGrid testGrid{};
+        testGrid.setTile(10, 25, Bricks);
+        testGrid.setTile(10, 15, Steel);
+        testGrid.setTile(20, 20, Water);
+        testGrid.setTile(5, 20, Trees);
+        eventQueue->clear();
+
+        THEN("Only collidable tiles should stop the runs") {
+            REQUIRE(testGrid.getFreeRun(10, 20, North) == 4);
+            REQUIRE(testGrid.getFreeRun(10, 20, South) == 4);
+            REQUIRE(testGrid.getFreeRun(10, 20, West) == 10);
+            REQUIRE(testGrid.getFreeRun(10, 20, East) == 41);
+            REQUIRE(testGrid.getFreeRun(10, 15, South) == 9);
+            REQUIRE(helper::freeRunsMatchScan(testGrid));
+        }
+
+        WHEN("Deleting a tile") {
+            testGrid.deleteTile(10, 25);
+            eventQueue->clear();
+
+            THEN("Runs going through it should be extended") {
+                REQUIRE(testGrid.getFreeRun(10, 20, South) == 31);
+                REQUIRE(testGrid.getFreeRun(10, 15, South) == 36);
+                REQUIRE(helper::freeRunsMatchScan(testGrid));
+            }
+        }
+
+        WHEN("Replacing a collidable tile with a non-collidable one and placing new tiles") {
+            testGrid.setTile(10, 15, Trees);
+            testGrid.setTile(10, 18, Steel);
+            testGrid.setTile(0, 20, Bricks);
+            testGrid.setTile(51, 20, Bricks);
+            eventQueue->clear();
+
+            THEN("The tables should stay the same as if they were computed from scratch") {
+                REQUIRE(testGrid.getFreeRun(10, 20, North) == 1);
+                REQUIRE(testGrid.getFreeRun(10, 17, North) == 17);
+                REQUIRE(testGrid.getFreeRun(10, 20, West) == 9);
+                REQUIRE(testGrid.getFreeRun(10, 20, East) == 40);
+                REQUIRE(helper::freeRunsMatchScan(testGrid));
+            }
+        }
+    }
+}
+
+SCENARIO("Benchmarking free run queries", "[.][benchmark]") {
+    GIVEN("A grid with a pattern of tiles") {
+        helper::TestGrid testGrid{};
+        for (unsigned int x = 0; x < 52; x += 7)
+            for (unsigned int y = 0; y < 52; y += 5) {
+                testGrid.setTile(x, y, (x + y) % 2 == 0 ? Bricks : Steel);
+            }
+        EventQueue<Event>::instance()->clear();
+
+        THEN("Free run tables should answer 1M queries faster than scanning the grid") {
+            constexpr unsigned int queries = 1000000;
+
+            BENCHMARK("1M free run table queries") {
+                unsigned int sum = 0;
+                for (unsigned int i = 0; i < queries; i++) {
+                    sum += testGrid.getFreeRun(i % 52, (i / 52) % 52, static_cast<Direction>(i % 4));
+                }
+                return sum;
+            };
+
+            BENCHMARK("1M brute-force scans") {
+                unsigned int sum = 0;
+                for (unsigned int i = 0; i < queries; i++) {
+                    sum += helper::scanFreeRun(testGrid, i % 52, (i / 52) % 52, static_cast<Direction>(i % 4));
+                }
+                return sum;
+            };
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <deque>
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/FlowField.h"
+#include "../include/Grid.h"
+#include "../include/LevelGenerator.h"
+#include "../include/LevelPack.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+
+namespace {
+    namespace helper {
+        /**
+         * Checks if a tank can stand at a position without touching bricks, steel, water or the eagle
+         */
+        bool isFree(const LevelPack::Level &level, unsigned int x, unsigned int y) {
+            unsigned int size = FlowField::FootprintSize;
+            if (x + size > level.sizeX || y + size > level.sizeY) {
+                return false;
+            }
+            std::pair<unsigned int, unsigned int> eagle = level.eagleLocation;
+            if (x < eagle.first + size && eagle.first < x + size && y < eagle.second + size && eagle.second < y + size) {
+                return false;
+            }
+            for (unsigned int i = x; i < x + size; i++) {
+                for (unsigned int j = y; j < y + size; j++) {
+                    TileType tile = level.getTile(i, j);
+                    if (tile == Bricks || tile == Steel || tile == Water) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Checks if a tank can drive from a position to one touching the eagle over free positions
+         */
+        bool reachesEagle(const LevelPack::Level &level, std::pair<unsigned int, unsigned int> from) {
+            unsigned int size = FlowField::FootprintSize;
+            std::vector<bool> visited(std::size_t{level.sizeX} * level.sizeY, false);
+            std::deque<std::pair<unsigned int, unsigned int>> queue{from};
+            visited[std::size_t{from.first} * level.sizeY + from.second] = true;
+            while (!queue.empty()) {
+                auto [x, y] = queue.front();
+                queue.pop_front();
+                std::pair<unsigned int, unsigned int> eagle = level.eagleLocation;
+                if (x + size >= eagle.first && x <= eagle.first + size && y + size >= eagle.second &&
+                    y <= eagle.second + size) {
+                    return true;
+                }
+                const int steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                for (const int *step: steps) {
+                    unsigned int nextX = x + step[0];
+                    unsigned int nextY = y + step[1];
+                    if (nextX < level.sizeX && nextY < level.sizeY &&
+                        !visited[std::size_t{nextX} * level.sizeY + nextY] && isFree(level, nextX, nextY)) {
+                        visited[std::size_t{nextX} * level.sizeY + nextY] = true;
+                        queue.emplace_back(nextX, nextY);
+                    }
+                }
+            }
+            return false;
+        }
+
+        double fractionOf(const LevelPack::Level &level, TileType type) {
+            std::size_t count = std::count(level.tiles.begin(), level.tiles.end(), type);
+            return static_cast<double>(count) / static_cast<double>(level.tiles.size());
+        }
+    }
+}
+
+SCENARIO("Generating levels") {
+    GIVEN("Settings of a large level") {
+        LevelGenerator::Settings settings;
+        settings.sizeX = 300;
+        settings.sizeY = 200;
+        settings.seed = 42;
+        settings.spawnpointCount = 5;
+        settings.tankCount = 1000;
+
+        WHEN("A level is generated") {
+            LevelPack::Level level = LevelGenerator::generate(settings, 7);
+
+            THEN("It should have the size, the points and the tanks asked for") {
+                REQUIRE(level.number == 7);
+                REQUIRE(level.sizeX == 300);
+                REQUIRE(level.sizeY == 200);
+                REQUIRE(level.tiles.size() == 300 * 200);
+                REQUIRE(level.spawnpoints.size() == 5);
+                REQUIRE(level.tankTypes.size() == 1000);
+                for (Tank::TankType type: level.tankTypes) {
+                    REQUIRE(type != Tank::PlayerTank);
+                }
+            }
+
+            THEN("Tiles should be drawn with their densities") {
+                REQUIRE(helper::fractionOf(level, Bricks) > 0.2);
+                REQUIRE(helper::fractionOf(level, Bricks) < 0.32);
+                REQUIRE(helper::fractionOf(level, Steel) > 0.03);
+                REQUIRE(helper::fractionOf(level, Steel) < 0.07);
+                REQUIRE(helper::fractionOf(level, Trees) > 0.07);
+                REQUIRE(helper::fractionOf(level, Trees) < 0.12);
+            }
+
+            THEN("The eagle should be reachable from every spawnpoint") {
+                REQUIRE(helper::isFree(level, level.playerSpawnpoint.first, level.playerSpawnpoint.second));
+                for (std::pair<unsigned int, unsigned int> spawnpoint: level.spawnpoints) {
+                    REQUIRE(helper::isFree(level, spawnpoint.first, spawnpoint.second));
+                    REQUIRE(helper::reachesEagle(level, spawnpoint));
+                }
+            }
+
+            THEN("The same seed should give the same level, and another seed another one") {
+                REQUIRE(LevelGenerator::generate(settings, 7).tiles == level.tiles);
+                settings.seed = 43;
+                REQUIRE(LevelGenerator::generate(settings, 7).tiles != level.tiles);
+            }
+
+            THEN("It should be read back the same from text") {
+                std::stringstream text;
+                LevelPack::writeText(text, level);
+                LevelPack::Level read = LevelPack::parseText(text, 7);
+                REQUIRE(read.tiles == level.tiles);
+                REQUIRE(read.spawnpoints.size() == level.spawnpoints.size());
+                REQUIRE(read.eagleLocation == level.eagleLocation);
+                REQUIRE(read.playerSpawnpoint == level.playerSpawnpoint);
+                REQUIRE(read.tankTypes == level.tankTypes);
+            }
+        }
+    }
+
+    GIVEN("Settings with densities adding up to more than 1") {
+        LevelGenerator::Settings settings;
+        settings.bricks = 1.0f;
+        settings.steel = 1.0f;
+        settings.water = 0.0f;
+        settings.trees = 0.0f;
+
+        WHEN("A level and a grid are generated") {
+            LevelPack::Level level = LevelGenerator::generate(settings);
+            std::unique_ptr<Grid> grid = LevelGenerator::generateGrid(settings);
+            FlowField flowField;
+            flowField.rebuild(*grid);
+
+            THEN("The eagle should still be reachable, without shooting bricks") {
+                REQUIRE(helper::fractionOf(level, NullTile) < 0.5);
+                for (std::pair<unsigned int, unsigned int> spawnpoint: level.spawnpoints) {
+                    REQUIRE(helper::reachesEagle(level, spawnpoint));
+                }
+                for (std::pair<unsigned int, unsigned int> spawnpoint: grid->getSpawnpoints()) {
+                    REQUIRE(flowField.getDistance(spawnpoint.first, spawnpoint.second) != FlowField::Unreachable);
+                }
+                REQUIRE(grid->getEagleLocation() == std::make_pair(24u, 48u));
+                REQUIRE(EventQueue<Event>::instance()->isEmpty());
+            }
+        }
+    }
+}
+
+SCENARIO("Benchmarking level generation", "[.][benchmark]") {
+    GIVEN("Settings of a 52x52 and a 4096x4096 level") {
+        LevelGenerator::Settings small;
+        LevelGenerator::Settings large;
+        large.sizeX = 4096;
+        large.sizeY = 4096;
+        large.spawnpointCount = 16;
+        large.tankCount = 100000;
+
+        BENCHMARK("Generating a 52x52 grid") {
+            return LevelGenerator::generateGrid(small);
+        };
+
+        BENCHMARK("Generating a 4096x4096 level") {
+            return LevelGenerator::generate(large).tiles.size();
+        };
+    }
+}
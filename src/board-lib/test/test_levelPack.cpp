@@ -0,0 +1,252 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Grid.h"
+#include "../include/GridBuilder.h"
+#include "../include/LevelPack.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+
+namespace {
+    namespace helper {
+        /**
+         * 8x6, with every kind of tile and point
+         */
+        const char *const SmallLevel =
+                "BFPAXB\n"
+                "BBSS----\n"
+                "-T--W--*\n"
+                "+-------\n"
+                "---E----\n"
+                "*------S\r\n"
+                "WWWWTTTT\n"
+                "\n";
+
+        /**
+         * A level of bricks and steel in a pattern, with spawnpoints in the corners
+         */
+        std::string patternLevel(unsigned int size) {
+            std::string text = "BBFA\n";
+            for (unsigned int y = 0; y < size; y++) {
+                for (unsigned int x = 0; x < size; x++) {
+                    if ((x == 0 || x == size - 1) && y == 0) {
+                        text += '*';
+                    } else if (x == size / 2 && y == size - 1) {
+                        text += 'E';
+                    } else {
+                        text += "-BS-T-W--"[(x * 7 + y * 3) % 9];
+                    }
+                }
+                text += '\n';
+            }
+            return text;
+        }
+
+        LevelPack::Level parse(const std::string &text, unsigned int number) {
+            std::istringstream input(text);
+            return LevelPack::parseText(input, number);
+        }
+
+        void requireSameGrids(const Grid &a, const Grid &b) {
+            for (unsigned int x = 0; x < a.getSizeX(); x++) {
+                for (unsigned int y = 0; y < a.getSizeY(); y++) {
+                    REQUIRE(a.getTileAtPosition(x, y) == b.getTileAtPosition(x, y));
+                    REQUIRE(a.getFreeRun(x, y, East) == b.getFreeRun(x, y, East));
+                }
+            }
+            REQUIRE(a.getSpawnpoints() == b.getSpawnpoints());
+            REQUIRE(a.getPlayerSpawnpoint() == b.getPlayerSpawnpoint());
+            REQUIRE(a.getEagleLocation() == b.getEagleLocation());
+            REQUIRE(a.getTankTypes() == b.getTankTypes());
+        }
+    }
+}
+
+SCENARIO("Reading text levels") {
+    GIVEN("A small text level") {
+        LevelPack::Level level = helper::parse(helper::SmallLevel, 3);
+
+        THEN("It's size should come from it's lines, without the empty line at the end") {
+            REQUIRE(level.number == 3);
+            REQUIRE(level.sizeX == 8);
+            REQUIRE(level.sizeY == 6);
+        }
+
+        THEN("Tiles, points and tank types should be read") {
+            REQUIRE(level.getTile(0, 0) == Bricks);
+            REQUIRE(level.getTile(2, 0) == Steel);
+            REQUIRE(level.getTile(1, 1) == Trees);
+            REQUIRE(level.getTile(4, 1) == Water);
+            REQUIRE(level.getTile(7, 4) == Steel);
+            REQUIRE(level.getTile(3, 3) == NullTile);
+            REQUIRE(level.eagleLocation == std::make_pair(3u, 3u));
+            REQUIRE(level.playerSpawnpoint == std::make_pair(0u, 2u));
+            REQUIRE(level.spawnpoints == std::vector<std::pair<unsigned int, unsigned int>>{{7, 1}, {0, 4}});
+            REQUIRE(level.tankTypes == std::vector<Tank::TankType>{Tank::BasicTank, Tank::FastTank, Tank::PowerTank,
+                                                                   Tank::ArmorTank, Tank::BasicTank});
+            REQUIRE_THROWS_AS(level.getTile(8, 0), OutOfGridException);
+        }
+    }
+}
+
+SCENARIO("Saving and opening level packs") {
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_level_packs";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path path = directory / "levels.pack";
+
+    GIVEN("A small level and a level of the size of the grid") {
+        std::vector<LevelPack::Level> levels{helper::parse(helper::SmallLevel, 3),
+                                             helper::parse(helper::patternLevel(52), 1)};
+
+        WHEN("They are saved to packs with both tile encodings, and the packs are opened") {
+            std::vector<std::unique_ptr<LevelPack>> packs;
+            for (LevelPack::TileEncoding encoding: {LevelPack::ByteTiles, LevelPack::PackedTiles}) {
+                std::filesystem::path encoded = directory / ("levels" + std::to_string(encoding) + ".pack");
+                REQUIRE(LevelPack::save(encoded.string(), levels, encoding));
+                packs.push_back(LevelPack::open(encoded.string()));
+                REQUIRE(packs.back() != nullptr);
+                REQUIRE(packs.back()->getLevelAt(0).getEncoding() == encoding);
+            }
+
+            THEN("Levels should be found by their numbers") {
+                for (const std::unique_ptr<LevelPack> &pack: packs) {
+                    REQUIRE(pack->getLevelCount() == 2);
+                    REQUIRE(pack->findLevel(3).has_value());
+                    REQUIRE(pack->findLevel(1).has_value());
+                    REQUIRE_FALSE(pack->findLevel(2).has_value());
+                    REQUIRE(pack->getLevelAt(0).getNumber() == 3);
+                }
+            }
+
+            THEN("Levels should read like they were saved") {
+                for (const std::unique_ptr<LevelPack> &pack: packs) {
+                    LevelPack::LevelView small = pack->findLevel(3).value();
+                    REQUIRE(small.getSizeX() == 8);
+                    REQUIRE(small.getSizeY() == 6);
+                    for (unsigned int x = 0; x < 8; x++) {
+                        for (unsigned int y = 0; y < 6; y++) {
+                            REQUIRE(small.getTile(x, y) == levels[0].getTile(x, y));
+                        }
+                    }
+                    REQUIRE(small.getSpawnpointCount() == 2);
+                    REQUIRE(small.getSpawnpoint(1) == std::make_pair(0u, 4u));
+                    REQUIRE(small.getPlayerSpawnpoint() == std::make_pair(0u, 2u));
+                    REQUIRE(small.getEagleLocation() == std::make_pair(3u, 3u));
+                    REQUIRE(small.getTankTypes() == levels[0].tankTypes);
+                }
+            }
+
+            THEN("Grids built from the packs should be the same as grids built from text") {
+                std::unique_ptr<Grid> fromText = GridBuilder::buildLevel(levels[1]);
+                for (const std::unique_ptr<LevelPack> &pack: packs) {
+                    std::unique_ptr<Grid> fromPack = GridBuilder::buildLevel(pack->findLevel(1).value());
+                    helper::requireSameGrids(*fromPack, *fromText);
+                }
+                REQUIRE(fromText->getSpawnpoints().size() == 2);
+                REQUIRE(fromText->getEagleLocation() == std::make_pair(26u, 51u));
+                REQUIRE(EventQueue<Event>::instance()->isEmpty());
+            }
+        }
+
+        WHEN("Two levels have the same number") {
+            levels[0].number = 1;
+
+            THEN("The pack should not be saved") {
+                REQUIRE_FALSE(LevelPack::save(path.string(), levels));
+            }
+        }
+    }
+
+    GIVEN("A level larger than the grid") {
+        std::vector<LevelPack::Level> levels{helper::parse(helper::patternLevel(60), 1)};
+        REQUIRE(LevelPack::save(path.string(), levels, LevelPack::PackedTiles));
+        std::unique_ptr<LevelPack> pack = LevelPack::open(path.string());
+
+        WHEN("A grid is built from it") {
+            std::unique_ptr<Grid> grid = GridBuilder::buildLevel(pack->findLevel(1).value());
+
+            THEN("Only the part that fits should be loaded") {
+                REQUIRE(grid->getTileAtPosition(51, 51) == levels[0].getTile(51, 51));
+                REQUIRE(grid->getTileAtPosition(13, 50) == levels[0].getTile(13, 50));
+                REQUIRE(grid->getSpawnpoints() == std::vector<std::pair<unsigned int, unsigned int>>{{0, 0}});
+                REQUIRE(grid->getEagleLocation() == std::make_pair(0u, 0u));
+            }
+        }
+    }
+
+    GIVEN("Broken packs") {
+        std::vector<LevelPack::Level> levels{helper::parse(helper::SmallLevel, 3)};
+        REQUIRE(LevelPack::save(path.string(), levels));
+
+        WHEN("A pack is cut short") {
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+
+            THEN("Opening it should fail") {
+                REQUIRE_THROWS_AS(LevelPack::open(path.string()), InvalidLevelFile);
+            }
+        }
+
+        WHEN("A file is not a pack") {
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << "Not a level pack at all";
+
+            THEN("Opening it should fail") {
+                REQUIRE_THROWS_AS(LevelPack::open(path.string()), InvalidLevelFile);
+            }
+        }
+
+        WHEN("A pack does not exist") {
+            std::filesystem::remove(path);
+
+            THEN("No pack should be opened") {
+                REQUIRE(LevelPack::open(path.string()) == nullptr);
+            }
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+SCENARIO("Benchmarking level loading", "[.][benchmark]") {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_bench_level_packs";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path path = directory / "levels.pack";
+
+    GIVEN("A 52x52 level, as text and in a pack") {
+        std::string text = helper::patternLevel(52);
+        REQUIRE(LevelPack::save(path.string(), {helper::parse(text, 1)}));
+        std::unique_ptr<LevelPack> pack = LevelPack::open(path.string());
+
+        BENCHMARK("Building a 52x52 grid from text") {
+            return GridBuilder::buildLevel(helper::parse(text, 1));
+        };
+
+        BENCHMARK("Building a 52x52 grid from a mapped pack") {
+            return GridBuilder::buildLevel(pack->findLevel(1).value());
+        };
+        EventQueue<Event>::instance()->clear();
+    }
+
+    GIVEN("A 4096x4096 level, as text and in a pack") {
+        std::string text = helper::patternLevel(4096);
+        REQUIRE(LevelPack::save(path.string(), {helper::parse(text, 1)}, LevelPack::PackedTiles));
+        std::vector<TileType> tiles(std::size_t{4096} * 4096);
+
+        BENCHMARK("Parsing a 4096x4096 level from text") {
+            return helper::parse(text, 1).tiles.size();
+        };
+
+        BENCHMARK("Mapping and decoding a 4096x4096 level from a pack") {
+            std::unique_ptr<LevelPack> pack = LevelPack::open(path.string());
+            pack->getLevelAt(0).decodeTiles(0, tiles.size(), tiles.data());
+            return tiles.back();
+        };
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,163 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Board.h"
+#include "../include/Grid.h"
+#include "../include/GridBuilder.h"
+#include "../include/LevelPreloader.h"
+#include "../include/LevelRepository.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Clock.h"
+
+#include "../../bot-lib/include/BotController.h"
+
+namespace {
+    namespace helper {
+        /**
+         * Builds empty grids, remembering the thread of the last build. Level 13 fails to build, levels are not
+         * built while the builder is held
+         */
+        struct TestBuilder {
+            std::atomic<unsigned int> builds{0};
+            std::atomic<bool> held{false};
+            std::thread::id lastThread;
+
+            LevelPreloader::Builder get() {
+                return [this](unsigned int level) {
+                    while (held) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    builds++;
+                    lastThread = std::this_thread::get_id();
+                    if (level == 13) {
+                        throw std::runtime_error("Unlucky level");
+                    }
+                    return std::make_unique<Grid>();
+                };
+            }
+        };
+
+        void waitUntilReady(const LevelPreloader &preloader, unsigned int level) {
+            for (int i = 0; i < 1000 && !preloader.isReady(level); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+}
+
+SCENARIO("Preloading levels") {
+    GIVEN("A preloader") {
+        helper::TestBuilder builder;
+        LevelPreloader preloader(builder.get());
+
+        WHEN("A level is preloaded and taken") {
+            preloader.preload(2);
+            helper::waitUntilReady(preloader, 2);
+            REQUIRE(preloader.isReady(2));
+            std::unique_ptr<Grid> grid = preloader.take(2);
+
+            THEN("It should be built once, in the background") {
+                REQUIRE(grid != nullptr);
+                REQUIRE(builder.builds == 1);
+                REQUIRE(builder.lastThread != std::this_thread::get_id());
+                REQUIRE(preloader.getHits() == 1);
+                REQUIRE(preloader.getMisses() == 0);
+                REQUIRE_FALSE(preloader.isReady(2));
+            }
+        }
+
+        WHEN("A level that was not preloaded is taken") {
+            std::unique_ptr<Grid> grid = preloader.take(3);
+
+            THEN("It should be built on the calling thread") {
+                REQUIRE(grid != nullptr);
+                REQUIRE(builder.lastThread == std::this_thread::get_id());
+                REQUIRE(preloader.getMisses() == 1);
+            }
+        }
+
+        WHEN("Another level is preloaded before the first one is taken") {
+            preloader.preload(2);
+            preloader.preload(3);
+            std::unique_ptr<Grid> third = preloader.take(3);
+            std::unique_ptr<Grid> second = preloader.take(2);
+
+            THEN("Only the last level should be handed over") {
+                REQUIRE(third != nullptr);
+                REQUIRE(second != nullptr);
+                REQUIRE(preloader.getHits() == 1);
+                REQUIRE(preloader.getMisses() == 1);
+            }
+        }
+
+        WHEN("A level is taken while it is being built") {
+            builder.held = true;
+            preloader.preload(4);
+            REQUIRE_FALSE(preloader.isReady(4));
+            std::thread release([&builder]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                builder.held = false;
+            });
+            std::unique_ptr<Grid> grid = preloader.take(4);
+            release.join();
+
+            THEN("The build should be waited for, not started again") {
+                REQUIRE(grid != nullptr);
+                REQUIRE(builder.builds == 1);
+                REQUIRE(preloader.getHits() == 1);
+            }
+        }
+
+        WHEN("A level fails to build in the background") {
+            preloader.preload(13);
+
+            THEN("Taking it should throw on the calling thread") {
+                REQUIRE_THROWS_AS(preloader.take(13), std::runtime_error);
+                REQUIRE(builder.lastThread == std::this_thread::get_id());
+                REQUIRE(preloader.getMisses() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Loading preloaded levels on the board") {
+    Clock::initialize(60);
+    BotController::initialize(4, 240);
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_preloaded_levels";
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "lvl1.txt") << "BB\nSS\n";
+    std::ofstream(directory / "lvl2.txt") << "FF\nBB\n";
+    LevelRepository::initialize({directory.string()}, false);
+
+    GIVEN("A board") {
+        Board board;
+
+        WHEN("Two levels are loaded one after another") {
+            board.loadLevel(1);
+            helper::waitUntilReady(board.getLevelPreloader(), 2);
+            unsigned int firstVersion = board.getGrid()->getVersion();
+            board.loadLevel(2);
+
+            THEN("The second one should have been preloaded while the first one was played") {
+                REQUIRE(board.getLevelPreloader().getMisses() == 1);
+                REQUIRE(board.getLevelPreloader().getHits() == 1);
+                REQUIRE(board.getGrid()->getVersion() != firstVersion);
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 0) == Bricks);
+                REQUIRE_FALSE(EventQueue<Event>::instance()->isEmpty());
+            }
+        }
+    }
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::remove_all(directory);
+}
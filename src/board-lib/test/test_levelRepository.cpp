@@ -0,0 +1,135 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Grid.h"
+#include "../include/GridBuilder.h"
+#include "../include/LevelPack.h"
+#include "../include/LevelRepository.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+
+namespace {
+    namespace helper {
+        const char *const FirstLevel =
+                "BBFA\n"
+                "*--*\n"
+                "-BS-\n"
+                "+-E-\n";
+
+        const char *const SecondLevel =
+                "PP\n"
+                "SSSSS\n"
+                "*---E\n";
+
+        const char *const ThirdLevel =
+                "A\n"
+                "W*\n"
+                "TE\n";
+
+        LevelPack::Level parse(const std::string &text, unsigned int number) {
+            std::istringstream input(text);
+            return LevelPack::parseText(input, number);
+        }
+
+        void write(const std::filesystem::path &path, const std::string &text) {
+            std::ofstream(path, std::ios::trunc) << text;
+        }
+    }
+}
+
+SCENARIO("Indexing level directories") {
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "tanks_test_level_repository";
+    std::filesystem::remove_all(root);
+    std::filesystem::path packed = root / "packed";
+    std::filesystem::path texts = root / "texts";
+    std::filesystem::create_directories(packed);
+    std::filesystem::create_directories(texts);
+
+    GIVEN("A directory with a pack of levels 1 and 3, and a directory with text levels 1, 2 and a named one") {
+        REQUIRE(LevelPack::save((packed / "campaign.pack").string(),
+                                {helper::parse(helper::FirstLevel, 1), helper::parse(helper::ThirdLevel, 3)}));
+        helper::write(texts / "lvl1.txt", helper::SecondLevel);
+        helper::write(texts / "lvl2.txt", helper::SecondLevel);
+        helper::write(texts / "custom.txt", helper::FirstLevel);
+        helper::write(texts / "notes.md", "Not a level");
+        LevelRepository::initialize({packed.string(), (root / "missing").string(), texts.string()}, false);
+        LevelRepository *repository = LevelRepository::instance();
+
+        THEN("Every level should be indexed once, numbered levels first") {
+            const std::vector<LevelRepository::Entry> &entries = repository->getEntries();
+            REQUIRE(entries.size() == 4);
+            REQUIRE(entries[0].number == 1u);
+            REQUIRE(entries[1].number == 2u);
+            REQUIRE(entries[2].number == 3u);
+            REQUIRE_FALSE(entries[3].number.has_value());
+            REQUIRE(entries[3].name == "custom");
+        }
+
+        THEN("Levels from earlier directories should shadow later ones") {
+            const LevelRepository::Entry *first = repository->findLevel(1);
+            REQUIRE(first != nullptr);
+            REQUIRE(first->packed);
+            REQUIRE(first->name == "lvl1");
+            REQUIRE(first->sizeX == 4);
+            REQUIRE(first->sizeY == 3);
+            REQUIRE(first->tankCount == 4);
+        }
+
+        THEN("The same level should have the same hash, in a pack or not") {
+            REQUIRE(repository->findLevel(1)->hash == repository->findLevel("custom")->hash);
+            REQUIRE(repository->findLevel(1)->hash != repository->findLevel(2)->hash);
+            REQUIRE(repository->findLevel(2)->hash ==
+                    LevelRepository::hashLevel(helper::parse(helper::SecondLevel, 2)));
+        }
+
+        THEN("Levels should be built by number and by name") {
+            REQUIRE(GridBuilder::buildLevel(2)->getTileAtPosition(4, 0) == Steel);
+            REQUIRE(repository->buildLevel(3)->getTileAtPosition(0, 0) == Water);
+            REQUIRE(repository->buildLevel("custom")->getTileAtPosition(2, 1) == Steel);
+            REQUIRE(repository->readLevel(*repository->findLevel(3)).tiles.size() == 4);
+            EventQueue<Event>::instance()->clear();
+        }
+
+        THEN("Levels that do not exist should not be built") {
+            REQUIRE(repository->findLevel(4) == nullptr);
+            REQUIRE_THROWS_AS(repository->buildLevel(4), InvalidLevelFile);
+            REQUIRE_THROWS_AS(repository->buildLevel("notes"), InvalidLevelFile);
+        }
+
+        THEN("Shards should hold every level once") {
+            std::vector<const LevelRepository::Entry *> even = repository->getShard(0, 2);
+            std::vector<const LevelRepository::Entry *> odd = repository->getShard(1, 2);
+            REQUIRE(even.size() == 2);
+            REQUIRE(odd.size() == 2);
+            REQUIRE(even[0]->number == 1u);
+            REQUIRE(odd[0]->number == 2u);
+            REQUIRE(even[1]->number == 3u);
+            REQUIRE(odd[1]->name == "custom");
+        }
+
+        WHEN("A text level is removed after the directories were scanned") {
+            std::filesystem::remove(texts / "lvl2.txt");
+
+            THEN("Building it should fail") {
+                REQUIRE(repository->findLevel(2) != nullptr);
+                REQUIRE_THROWS_AS(repository->buildLevel(2), InvalidLevelFile);
+            }
+        }
+    }
+
+    GIVEN("A directory with a broken pack") {
+        helper::write(packed / "broken.pack", "Not a level pack at all");
+
+        THEN("The repository should not be initialized") {
+            REQUIRE_THROWS_AS(LevelRepository::initialize({packed.string()}), InvalidLevelFile);
+        }
+    }
+
+    std::filesystem::remove_all(root);
+}
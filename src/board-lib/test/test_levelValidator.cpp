@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/FlowField.h"
+#include "../include/Grid.h"
+#include "../include/GridBuilder.h"
+#include "../include/LevelGenerator.h"
+#include "../include/LevelPack.h"
+#include "../include/LevelRepository.h"
+#include "../include/LevelValidator.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+
+namespace {
+    namespace helper {
+        /**
+         * 16x12, with a wall of bricks between the spawnpoints and the eagle
+         */
+        const char *const Level =
+                "BBFA\n"
+                "*-------*-------\n"
+                "----------------\n"
+                "----------------\n"
+                "----------------\n"
+                "BBBBBBBBBBBBBBBB\n"
+                "----------------\n"
+                "----------------\n"
+                "----------------\n"
+                "+-----E---------\n"
+                "----------------\n"
+                "----------------\n"
+                "----------------\n";
+
+        LevelPack::Level parse(std::string text) {
+            std::istringstream input(text);
+            return LevelPack::parseText(input, 1);
+        }
+
+        /**
+         * The level with a row replaced
+         */
+        LevelPack::Level parseWithRow(std::size_t row, const std::string &replacement) {
+            std::string text = Level;
+            std::size_t start = 0;
+            for (std::size_t i = 0; i <= row; i++) {
+                start = text.find('\n', start) + 1;
+            }
+            text.replace(start, replacement.size(), replacement);
+            return parse(text);
+        }
+
+        bool hasProblem(const LevelValidator::Report &report, LevelValidator::ProblemType type,
+                        std::pair<unsigned int, unsigned int> location) {
+            return std::any_of(report.problems.begin(), report.problems.end(),
+                               [type, location](const LevelValidator::Problem &problem) {
+                                   return problem.type == type && problem.location == location;
+                               });
+        }
+
+        /**
+         * Counts free positions the eagle can be reached from, one position at a time
+         */
+        std::size_t countReachablePositions(const LevelPack::Level &level) {
+            unsigned int size = FlowField::FootprintSize;
+            auto [eagleX, eagleY] = level.eagleLocation;
+            auto overlapsEagle = [&](unsigned int x, unsigned int y) {
+                return x < eagleX + size && eagleX < x + size && y < eagleY + size && eagleY < y + size;
+            };
+            auto isFree = [&](unsigned int x, unsigned int y) {
+                if (x + size > level.sizeX || y + size > level.sizeY || overlapsEagle(x, y)) {
+                    return false;
+                }
+                for (unsigned int i = x; i < x + size; i++) {
+                    for (unsigned int j = y; j < y + size; j++) {
+                        if (level.getTile(i, j) == Steel) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            };
+
+            std::vector<bool> visited(std::size_t{level.sizeX} * level.sizeY, false);
+            std::deque<std::pair<unsigned int, unsigned int>> queue;
+            for (unsigned int x = 0; x < level.sizeX; x++) {
+                for (unsigned int y = 0; y < level.sizeY; y++) {
+                    if (x + size >= eagleX && x <= eagleX + size && y + size >= eagleY && y <= eagleY + size &&
+                        isFree(x, y)) {
+                        visited[std::size_t{x} * level.sizeY + y] = true;
+                        queue.emplace_back(x, y);
+                    }
+                }
+            }
+            std::size_t count = 0;
+            while (!queue.empty()) {
+                auto [x, y] = queue.front();
+                queue.pop_front();
+                count++;
+                const int steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                for (const int *step: steps) {
+                    unsigned int nextX = x + step[0];
+                    unsigned int nextY = y + step[1];
+                    if (nextX < level.sizeX && nextY < level.sizeY &&
+                        !visited[std::size_t{nextX} * level.sizeY + nextY] && isFree(nextX, nextY)) {
+                        visited[std::size_t{nextX} * level.sizeY + nextY] = true;
+                        queue.emplace_back(nextX, nextY);
+                    }
+                }
+            }
+            return count;
+        }
+    }
+}
+
+SCENARIO("Validating levels") {
+    GIVEN("A correct level") {
+        LevelPack::Level level = helper::parse(helper::Level);
+
+        THEN("It should have no problems, as tanks can shoot through bricks") {
+            LevelValidator::Report report = LevelValidator::validate(level);
+            REQUIRE(report.isValid());
+            REQUIRE(report.problems.empty());
+            REQUIRE(report.describe().empty());
+            REQUIRE(report.reachablePositions == helper::countReachablePositions(level));
+            REQUIRE(report.isolatedPositions == 0);
+        }
+    }
+
+    GIVEN("A level without the player spawnpoint and the eagle") {
+        LevelPack::Level level = helper::parseWithRow(8, "-------------");
+
+        THEN("Both should be reported missing") {
+            LevelValidator::Report report = LevelValidator::validate(level);
+            REQUIRE_FALSE(report.isValid());
+            REQUIRE(helper::hasProblem(report, LevelValidator::MissingPlayerSpawnpoint, {0, 0}));
+            REQUIRE(helper::hasProblem(report, LevelValidator::MissingEagle, {0, 0}));
+            REQUIRE(report.describe().find("there is no player spawnpoint") != std::string::npos);
+        }
+
+        WHEN("It goes through a pack") {
+            std::filesystem::path path = std::filesystem::temp_directory_path() / "tanks_test_validated.pack";
+            level.number = 2;
+            REQUIRE(LevelPack::save(path.string(), {level, helper::parse(helper::Level)}));
+            std::unique_ptr<LevelPack> pack = LevelPack::open(path.string());
+
+            THEN("Which points are marked should be kept") {
+                REQUIRE_FALSE(pack->getLevelAt(0).hasPlayerSpawnpoint());
+                REQUIRE_FALSE(pack->getLevelAt(0).toLevel().hasEagle);
+                REQUIRE(pack->getLevelAt(1).hasPlayerSpawnpoint());
+                REQUIRE(pack->getLevelAt(1).hasEagle());
+            }
+            pack.reset();
+            std::filesystem::remove(path);
+        }
+    }
+
+    GIVEN("A level with spawnpoints in steel, overlapping each other and tanks with nowhere to spawn") {
+        LevelPack::Level blocked = helper::parseWithRow(0, "*-S-");
+        LevelPack::Level overlapping = helper::parseWithRow(0, "*-*-");
+        LevelPack::Level empty = helper::parseWithRow(0, "---------");
+
+        THEN("The spawnpoints should be reported") {
+            LevelValidator::Report report = LevelValidator::validate(blocked);
+            REQUIRE(helper::hasProblem(report, LevelValidator::SpawnpointBlocked, {0, 0}));
+            REQUIRE_FALSE(helper::hasProblem(report, LevelValidator::SpawnpointUnreachable, {0, 0}));
+            REQUIRE_FALSE(helper::hasProblem(report, LevelValidator::SpawnpointBlocked, {8, 0}));
+
+            report = LevelValidator::validate(overlapping);
+            REQUIRE(helper::hasProblem(report, LevelValidator::SpawnpointsOverlap, {0, 0}));
+            REQUIRE(helper::hasProblem(report, LevelValidator::SpawnpointsOverlap, {2, 0}));
+            REQUIRE_FALSE(helper::hasProblem(report, LevelValidator::SpawnpointsOverlap, {8, 0}));
+
+            REQUIRE(helper::hasProblem(LevelValidator::validate(empty), LevelValidator::MissingSpawnpoints, {0, 0}));
+        }
+    }
+
+    GIVEN("A level with the bricks changed to steel") {
+        LevelPack::Level level = helper::parseWithRow(4, "SSSSSSSSSSSSSSSS");
+
+        THEN("The spawnpoints should be unreachable, in an isolated region") {
+            LevelValidator::Report report = LevelValidator::validate(level);
+            REQUIRE_FALSE(report.isValid());
+            REQUIRE(helper::hasProblem(report, LevelValidator::SpawnpointUnreachable, {0, 0}));
+            REQUIRE(helper::hasProblem(report, LevelValidator::SpawnpointUnreachable, {8, 0}));
+            REQUIRE_FALSE(helper::hasProblem(report, LevelValidator::PlayerSpawnpointUnreachable, {0, 8}));
+            REQUIRE(helper::hasProblem(report, LevelValidator::IsolatedRegion, {0, 0}));
+            REQUIRE(report.isolatedPositions == 13);
+            REQUIRE(report.reachablePositions == helper::countReachablePositions(level));
+        }
+
+        WHEN("A gap as wide as a tank is left in the steel") {
+            level = helper::parseWithRow(4, "SSSSSSSSSSSS----");
+
+            THEN("The level should be correct again") {
+                REQUIRE(LevelValidator::validate(level).isValid());
+            }
+        }
+    }
+
+    GIVEN("Random levels with a lot of steel, wider and higher than a word of positions") {
+        LevelGenerator::Settings settings;
+        settings.sizeX = 150;
+        settings.sizeY = 130;
+        settings.steel = 0.12f;
+
+        THEN("Flooding words of positions should reach the positions that a search one at a time does") {
+            for (std::uint64_t seed = 0; seed < 8; seed++) {
+                settings.seed = seed;
+                LevelPack::Level level = LevelGenerator::generate(settings);
+                LevelValidator::Report report = LevelValidator::validate(level);
+                REQUIRE(report.isValid());
+                REQUIRE(report.reachablePositions == helper::countReachablePositions(level));
+                REQUIRE(report.isolatedPositions > 0);
+                REQUIRE(std::count_if(report.problems.begin(), report.problems.end(),
+                                      [](const LevelValidator::Problem &problem) {
+                                          return problem.type == LevelValidator::IsolatedRegion;
+                                      }) == LevelValidator::MaxReportedRegions);
+            }
+        }
+    }
+}
+
+SCENARIO("Refusing broken levels when loading them") {
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_validated_levels";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "lvl1.txt") << helper::Level;
+    std::ofstream(directory / "lvl2.txt") << "BB\nSS\n";
+
+    GIVEN("A repository with a correct and a broken level") {
+        LevelRepository::initialize({directory.string()});
+        LevelRepository *repository = LevelRepository::instance();
+
+        THEN("Problems should be listed in the entries") {
+            REQUIRE(repository->findLevel(1)->problems.empty());
+            REQUIRE_FALSE(repository->findLevel(2)->problems.empty());
+        }
+
+        THEN("Only the correct one should be built") {
+            REQUIRE(GridBuilder::buildLevel(1)->getEagleLocation() == std::make_pair(6u, 8u));
+            REQUIRE_THROWS_AS(GridBuilder::buildLevel(2), InvalidLevelFile);
+        }
+
+        WHEN("The correct level is broken after it was indexed") {
+            std::ofstream(directory / "lvl1.txt", std::ios::trunc) << "BB\n*---\n";
+
+            THEN("It should be refused when it is loaded") {
+                REQUIRE_THROWS_AS(GridBuilder::buildLevel(1), InvalidLevelFile);
+            }
+        }
+    }
+
+    GIVEN("A repository that does not validate levels") {
+        LevelRepository::initialize({directory.string()}, false);
+
+        THEN("Broken levels should still be built") {
+            REQUIRE(GridBuilder::buildLevel(2)->getTileAtPosition(0, 0) == Steel);
+        }
+    }
+
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::remove_all(directory);
+}
+
+SCENARIO("Benchmarking level validation", "[.][benchmark]") {
+    GIVEN("A 52x52 and a 4096x4096 level") {
+        LevelGenerator::Settings small;
+        LevelGenerator::Settings large;
+        large.sizeX = 4096;
+        large.sizeY = 4096;
+        large.spawnpointCount = 16;
+        LevelPack::Level smallLevel = LevelGenerator::generate(small);
+        LevelPack::Level largeLevel = LevelGenerator::generate(large);
+
+        BENCHMARK("Validating a 52x52 level") {
+            return LevelValidator::validate(smallLevel).reachablePositions;
+        };
+
+        BENCHMARK("Validating a 4096x4096 level") {
+            return LevelValidator::validate(largeLevel).reachablePositions;
+        };
+    }
+}
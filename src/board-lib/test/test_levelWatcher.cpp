@@ -0,0 +1,217 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Board.h"
+#include "../include/Grid.h"
+#include "../include/LevelPack.h"
+#include "../include/LevelRepository.h"
+#include "../include/LevelWatcher.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Clock.h"
+
+#include "../../bot-lib/include/BotController.h"
+
+namespace {
+    namespace helper {
+        const char *const Level =
+                "BB\n"
+                "BBSS\n"
+                "--W-\n"
+                "+--T\n";
+
+        /**
+         * Level with bricks removed at (0, 0), steel changed to water at (3, 0) and trees placed at (0, 1)
+         */
+        const char *const TunedLevel =
+                "BB\n"
+                "-BSW\n"
+                "T-W-\n"
+                "+--T\n";
+
+        LevelPack::Level parse(const std::string &text) {
+            std::istringstream input(text);
+            return LevelPack::parseText(input, 1);
+        }
+
+        void write(const std::filesystem::path &path, const std::string &text) {
+            std::ofstream(path, std::ios::trunc) << text;
+        }
+
+        /**
+         * Counts queued tile events and clears the queue
+         */
+        unsigned int countTileEvents() {
+            unsigned int count = 0;
+            auto eventQueue = EventQueue<Event>::instance();
+            while (!eventQueue->isEmpty()) {
+                Event::EventType type = eventQueue->pop()->type;
+                if (type == Event::TilePlaced || type == Event::TileChanged || type == Event::TileDeleted) {
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        std::vector<LevelWatcher::Change> waitForChanges(LevelWatcher &watcher) {
+            std::vector<LevelWatcher::Change> changes;
+            for (int i = 0; i < 2000 && changes.empty(); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                changes = watcher.takeChanges();
+            }
+            return changes;
+        }
+    }
+}
+
+SCENARIO("Applying changed level tiles to the board") {
+    Clock::initialize(60);
+    BotController::initialize(4, 240);
+    EventQueue<Event>::instance()->clear();
+
+    GIVEN("A board with a tank and the tiles of a level") {
+        Board board;
+        board.applyLevelTiles(helper::parse(helper::Level));
+        auto tank = std::make_shared<BasicTank>(10, 10, East);
+        board.getEntityController()->addEntity(std::shared_ptr<Entity>(tank));
+        EventQueue<Event>::instance()->clear();
+
+        WHEN("Tiles of a tuned version of the level are applied") {
+            std::size_t changed = board.applyLevelTiles(helper::parse(helper::TunedLevel));
+
+            THEN("Only changed tiles should queue events") {
+                REQUIRE(changed == 3);
+                REQUIRE(helper::countTileEvents() == 3);
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 0) == NullTile);
+                REQUIRE(board.getGrid()->getTileAtPosition(3, 0) == Water);
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 1) == Trees);
+                REQUIRE(board.getGrid()->getTileAtPosition(2, 0) == Steel);
+            }
+
+            THEN("Entities should be left on the board") {
+                REQUIRE(board.getEntityController()->getAllEntities()->size() == 1);
+                REQUIRE(tank->getX() == 10);
+            }
+        }
+
+        WHEN("The same tiles are applied again") {
+            THEN("Nothing should change") {
+                REQUIRE(board.applyLevelTiles(helper::parse(helper::Level)) == 0);
+                REQUIRE(EventQueue<Event>::instance()->isEmpty());
+            }
+        }
+    }
+    EventQueue<Event>::instance()->clear();
+}
+
+SCENARIO("Watching level files") {
+    Clock::initialize(60);
+    BotController::initialize(4, 240);
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_watched_levels";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    helper::write(directory / "lvl1.txt", helper::Level);
+
+    GIVEN("A watched level directory") {
+        LevelWatcher watcher({directory.string()});
+        REQUIRE(watcher.isWatching());
+
+        WHEN("Files are written to it") {
+            helper::write(directory / "notes.md", "Not a level");
+            helper::write(directory / "lvl1.txt", helper::TunedLevel);
+            std::vector<LevelWatcher::Change> changes = helper::waitForChanges(watcher);
+
+            THEN("Text levels should be parsed in the background") {
+                REQUIRE(changes.size() == 1);
+                REQUIRE(changes[0].name == "lvl1");
+                REQUIRE(changes[0].number == 1u);
+                REQUIRE(changes[0].level.getTile(3, 0) == Water);
+            }
+        }
+
+        WHEN("The level being played is changed") {
+            LevelRepository::initialize({directory.string()}, false);
+            Board board;
+            board.loadLevel(1);
+            board.spawnPlayer();
+            EventQueue<Event>::instance()->clear();
+
+            helper::write(directory / "lvl1.txt", helper::TunedLevel);
+            std::size_t changed = 0;
+            for (int i = 0; i < 2000 && changed == 0; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                changed = watcher.applyChanges(board);
+            }
+
+            THEN("It should be changed on the board without reloading it") {
+                REQUIRE(changed == 3);
+                REQUIRE(helper::countTileEvents() == 3);
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 1) == Trees);
+                REQUIRE(board.getPlayerTank() != nullptr);
+            }
+
+            THEN("The next level should be loaded from the changed file") {
+                board.loadLevel(1);
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 1) == Trees);
+            }
+        }
+
+        WHEN("A level played from a pack is changed") {
+            REQUIRE(LevelPack::save((directory / "campaign.pack").string(), {helper::parse(helper::Level)}));
+            LevelRepository::initialize({directory.string()}, false);
+            REQUIRE(LevelRepository::instance()->findLevel(1)->packed);
+            Board board;
+            board.loadLevel(1);
+            EventQueue<Event>::instance()->clear();
+
+            helper::write(directory / "lvl1.txt", helper::TunedLevel);
+            std::size_t changed = 0;
+            for (int i = 0; i < 2000 && changed == 0; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                changed = watcher.applyChanges(board);
+            }
+            helper::countTileEvents();
+
+            THEN("The changed file should be used instead of the pack") {
+                REQUIRE(changed == 3);
+                const LevelRepository::Entry *entry = LevelRepository::instance()->findLevel(1);
+                REQUIRE_FALSE(entry->packed);
+                REQUIRE(entry->path == (directory / "lvl1.txt").string());
+                REQUIRE(LevelRepository::instance()->getEntries().size() == 1);
+                board.loadLevel(1);
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 1) == Trees);
+            }
+        }
+
+        WHEN("A broken level is written while levels are validated") {
+            LevelRepository::initialize({directory.string()});
+            Board board;
+            helper::write(directory / "lvl2.txt", "BB\nSS\n");
+            std::vector<LevelWatcher::Change> refused;
+            for (int i = 0; i < 2000 && refused.empty(); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                watcher.applyChanges(board);
+                refused = watcher.takeRefused();
+            }
+
+            THEN("It should be refused, and reported with it's problems") {
+                REQUIRE(refused.size() == 1);
+                REQUIRE(refused[0].name == "lvl2");
+                REQUIRE_FALSE(refused[0].report.isValid());
+                REQUIRE(LevelRepository::instance()->findLevel(2) == nullptr);
+            }
+        }
+    }
+
+    EventQueue<Event>::instance()->clear();
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,201 @@
+#include <memory>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Board.h"
+#include "../include/Eagle.h"
+#include "../include/Grid.h"
+#include "../include/SimulatedWorld.h"
+
+#include "../../tank-lib/include/EntityController.h"
+#include "../../tank-lib/include/Tank.h"
+
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Clock.h"
+
+#include "../../bot-lib/include/BotController.h"
+
+namespace {
+    namespace helper {
+        class TestBoard : public Board {
+        public:
+            TestBoard(): Board() {};
+
+            template<typename T>
+            std::shared_ptr<T> add(std::shared_ptr<T> entity) {
+                entityController_->addEntity(std::shared_ptr<Entity>(entity));
+                return entity;
+            }
+        };
+
+        void initSingletons() {
+            Clock::initialize(60);
+            BotController::initialize(4, 240);
+        }
+
+        /**
+         * Places a vertical wall of tiles, 4 tiles high
+         */
+        void placeWall(Board &board, unsigned int x, unsigned int y, TileType type) {
+            for (unsigned int i = 0; i < 4; i++) {
+                board.getGrid()->setTile(x, y + i, type);
+            }
+            EventQueue<Event>::instance()->clear();
+        }
+
+        /**
+         * Steps the world until the entity dies, at most a number of ticks
+         */
+        void stepWhileAlive(SimulatedWorld &world, std::uint32_t entity, unsigned int ticks) {
+            for (unsigned int i = 0; i < ticks && world.getEntities().alive[entity]; i++) {
+                world.step();
+            }
+        }
+    }
+}
+
+SCENARIO("Simulating the board ahead") {
+    helper::initSingletons();
+    GIVEN("A board with moving tanks, one of them driving into a wall") {
+        auto eventQueue = EventQueue<Event>::instance();
+        helper::TestBoard board{};
+        helper::placeWall(board, 20, 10, Steel);
+        auto blocked = board.add(std::make_shared<BasicTank>(10.5f, 10, East));
+        auto free = board.add(std::make_shared<BasicTank>(30, 40.25f, North));
+        board.setTankMoving(blocked, true);
+        board.setTankMoving(free, true);
+        eventQueue->clear();
+
+        SimulatedWorld world;
+        world.capture(board);
+        REQUIRE(world.size() == 2);
+        std::uint32_t blockedIndex = world.indexOf(blocked.get()).value();
+        std::uint32_t freeIndex = world.indexOf(free.get()).value();
+
+        WHEN("The world and the board are moved by the same number of ticks") {
+            for (int i = 0; i < 80; i++) {
+                world.step();
+            }
+            for (int i = 0; i < 80; i++) {
+                board.moveAllEntities();
+            }
+            eventQueue->clear();
+
+            THEN("Tanks should be in the same places") {
+                const SimulatedWorld::Entities &entities = world.getEntities();
+                REQUIRE(entities.x[blockedIndex] == blocked->getFixedX());
+                REQUIRE(entities.x[blockedIndex] + entities.sizeX[blockedIndex] == FixedPoint::fromTiles(20) + 1);
+                REQUIRE(entities.y[freeIndex] == free->getFixedY());
+                REQUIRE(entities.y[freeIndex] < FixedPoint::fromTiles(40));
+            }
+
+            THEN("The board should be left as it was") {
+                REQUIRE(eventQueue->isEmpty());
+                REQUIRE(world.ownsGrid() == false);
+            }
+        }
+
+        WHEN("A tank turns into the wall") {
+            bool turned = world.rotate(freeIndex, West);
+
+            THEN("It should turn, as there is no wall next to it") {
+                REQUIRE(turned);
+                REQUIRE(world.getEntities().facing[freeIndex] == West);
+            }
+        }
+    }
+}
+
+SCENARIO("Forking simulated worlds") {
+    helper::initSingletons();
+    GIVEN("A board with a brick wall in front of a tank") {
+        auto eventQueue = EventQueue<Event>::instance();
+        helper::TestBoard board{};
+        helper::placeWall(board, 20, 10, Bricks);
+        auto tank = board.add(std::make_shared<BasicTank>(10, 10, East));
+        eventQueue->clear();
+
+        SimulatedWorld root;
+        root.capture(board);
+        std::uint32_t tankIndex = root.indexOf(tank.get()).value();
+
+        WHEN("The tank fires in one fork") {
+            SimulatedWorld firing;
+            SimulatedWorld other;
+            firing.copyFrom(root);
+            other.copyFrom(root);
+            std::optional<std::uint32_t> bullet = firing.fire(tankIndex);
+            REQUIRE(bullet.has_value());
+            REQUIRE_FALSE(firing.fire(tankIndex).has_value());
+            helper::stepWhileAlive(firing, bullet.value(), 60);
+
+            THEN("The bullet should destroy bricks in the fork only") {
+                REQUIRE_FALSE(firing.getEntities().alive[bullet.value()]);
+                REQUIRE(firing.getEntities().link[tankIndex] == SimulatedWorld::None);
+                REQUIRE(firing.ownsGrid());
+                REQUIRE(firing.getGrid().getTileAtPosition(20, 11) == NullTile);
+                REQUIRE(firing.getGrid().getTileAtPosition(20, 12) == NullTile);
+                REQUIRE(board.getGrid()->getTileAtPosition(20, 11) == Bricks);
+                REQUIRE(&root.getGrid() == board.getGrid());
+                REQUIRE(&other.getGrid() == board.getGrid());
+                REQUIRE(eventQueue->isEmpty());
+            }
+
+            AND_WHEN("The fork is reused for another fork") {
+                firing.copyFrom(root);
+
+                THEN("It should see the bricks again") {
+                    REQUIRE_FALSE(firing.ownsGrid());
+                    REQUIRE(firing.getGrid().getTileAtPosition(20, 11) == Bricks);
+                    REQUIRE(firing.size() == root.size());
+                }
+            }
+        }
+    }
+
+    GIVEN("A board with the player, the eagle, and enemy tanks near and far from each other") {
+        auto eventQueue = EventQueue<Event>::instance();
+        helper::TestBoard board{};
+        auto focus = board.add(std::make_shared<BasicTank>(0, 0, South));
+        auto near = board.add(std::make_shared<BasicTank>(10, 0, South));
+        auto far = board.add(std::make_shared<BasicTank>(40, 0, South));
+        auto player = board.add(std::make_shared<PlayerTank>(40, 40, North));
+        board.add(std::make_shared<Eagle>(24, 48));
+        eventQueue->clear();
+
+        SimulatedWorld root;
+        root.capture(board);
+        REQUIRE(root.size() == 5);
+
+        WHEN("The world is forked around a tank") {
+            SimulatedWorld fork;
+            fork.fork(root, root.indexOf(focus.get()).value(), FixedPoint::fromTiles(8));
+
+            THEN("Far tanks should be left out, but not the player and the eagle") {
+                const SimulatedWorld::Entities &entities = fork.getEntities();
+                REQUIRE(fork.size() == 4);
+                REQUIRE(entities.x[0] == focus->getFixedX());
+                REQUIRE(entities.x[1] == near->getFixedX());
+                REQUIRE(entities.kind[2] == SimulatedWorld::PlayerTank);
+                REQUIRE(entities.kind[3] == SimulatedWorld::Eagle);
+            }
+        }
+
+        WHEN("An enemy tank shoots the player") {
+            std::uint32_t shooter = root.indexOf(far.get()).value();
+            std::uint32_t target = root.indexOf(player.get()).value();
+            unsigned int lives = root.getEntities().lives[target];
+            std::uint32_t bullet = root.fire(shooter).value();
+            helper::stepWhileAlive(root, bullet, 200);
+
+            THEN("The player should lose a life") {
+                REQUIRE(root.getEntities().lives[target] == lives - 1);
+                REQUIRE_FALSE(root.getEntities().alive[bullet]);
+                REQUIRE(root.getEntities().link[shooter] == SimulatedWorld::None);
+                REQUIRE(player->getLives() == lives);
+            }
+        }
+    }
+}
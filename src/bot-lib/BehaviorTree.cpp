@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "include/BehaviorTree.h"
+
+InvalidBehaviorTreeFile::InvalidBehaviorTreeFile(std::string message) : what_message(std::move(message)) {}
+
+const char *InvalidBehaviorTreeFile::what() const noexcept {
+    return what_message.c_str();
+}
+
+unsigned int BehaviorTree::Executor::getLeafCost(unsigned int) const {
+    return 1;
+}
+
+std::shared_ptr<const BehaviorTree> BehaviorTree::parse(std::istream &input,
+                                                        const std::vector<std::string> &knownLeaves) {
+    static const std::map<std::string, NodeType> nodeTypes{
+            {"sequence",  Sequence},
+            {"selector",  Selector},
+            {"inverter",  Inverter},
+            {"succeeder", Succeeder},
+            {"chance",    Chance}
+    };
+
+    std::shared_ptr<BehaviorTree> tree(new BehaviorTree());
+    std::vector<unsigned int> depths;
+    std::vector<unsigned int> lineNumbers;
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        std::size_t indent = line.find_first_not_of(' ');
+        if (indent == std::string::npos || line[indent] == '#' || line[indent] == '\r') {
+            continue;
+        }
+        auto error = [lineNumber](const std::string &message) {
+            return InvalidBehaviorTreeFile("Line " + std::to_string(lineNumber) + ": " + message);
+        };
+
+        if (indent % 2 != 0) {
+            throw error("indentation must be a multiple of two spaces");
+        }
+        auto depth = static_cast<unsigned int>(indent / 2);
+        if (depths.empty() ? depth != 0 : depth > depths.back() + 1) {
+            throw error("node is indented too deep");
+        }
+        if (!depths.empty() && depth == 0) {
+            throw error("a tree can only have one root");
+        }
+
+        std::istringstream words(line);
+        std::string name;
+        words >> name;
+        Node node{Leaf, 0, 0, 1};
+        auto leaf = std::find(knownLeaves.begin(), knownLeaves.end(), name);
+        if (nodeTypes.count(name) != 0) {
+            node.type = nodeTypes.at(name);
+        } else if (leaf != knownLeaves.end()) {
+            node.leaf = static_cast<unsigned int>(leaf - knownLeaves.begin());
+        } else {
+            throw error("unknown node '" + name + "'");
+        }
+
+        if (node.type == Chance && (!(words >> node.param) || node.param > 100)) {
+            throw error("chance needs a percentage between 0 and 100");
+        }
+        std::string extra;
+        if (words >> extra) {
+            throw error("unexpected '" + extra + "'");
+        }
+
+        tree->nodes_.push_back(node);
+        depths.push_back(depth);
+        lineNumbers.push_back(lineNumber);
+    }
+
+    if (tree->nodes_.empty()) {
+        throw InvalidBehaviorTreeFile("A tree needs at least one node");
+    }
+
+    for (unsigned int i = 0; i < tree->nodes_.size(); i++) {
+        Node &node = tree->nodes_[i];
+        unsigned int children = 0;
+        unsigned int end = i + 1;
+        for (; end < tree->nodes_.size() && depths[end] > depths[i]; end++) {
+            children += depths[end] == depths[i] + 1;
+        }
+        node.size = end - i;
+
+        bool valid;
+        switch (node.type) {
+            case Sequence:
+            case Selector:
+                valid = children > 0;
+                break;
+            case Leaf:
+                valid = children == 0;
+                break;
+            default:
+                valid = children == 1;
+        }
+        if (!valid) {
+            throw InvalidBehaviorTreeFile("Line " + std::to_string(lineNumbers[i]) + ": wrong number of children");
+        }
+    }
+    return tree;
+}
+
+std::shared_ptr<const BehaviorTree> BehaviorTree::load(const std::string &filename,
+                                                       const std::vector<std::string> &knownLeaves) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    try {
+        return parse(file, knownLeaves);
+    } catch (const InvalidBehaviorTreeFile &e) {
+        throw InvalidBehaviorTreeFile(filename + ": " + e.what());
+    }
+}
+
+BehaviorTree::Status BehaviorTree::tick(State &state, Executor &executor, unsigned int &budget) const {
+    if (state.tree != this || state.memory.size() != nodes_.size()) {
+        state = State{};
+        state.tree = this;
+        state.memory.assign(nodes_.size(), 0);
+    }
+    state.yielded = false;
+    return tickNode(0, state, executor, budget);
+}
+
+BehaviorTree::Status BehaviorTree::tickNode(unsigned int index, State &state, Executor &executor,
+                                            unsigned int &budget) const {
+    const Node &node = nodes_[index];
+    unsigned int cost = node.type == Leaf ? executor.getLeafCost(node.leaf) : 1;
+    if (budget < cost) {
+        state.yielded = true;
+        return Running;
+    }
+    budget -= cost;
+
+    unsigned int &memory = state.memory[index];
+    unsigned int end = index + node.size;
+    switch (node.type) {
+        case Sequence: {
+            // skip children that have already succeeded
+            unsigned int child = index + 1;
+            for (unsigned int position = 1; position < memory; position++) {
+                child += nodes_[child].size;
+            }
+            for (unsigned int position = std::max(memory, 1u); child < end; position++) {
+                Status status = tickNode(child, state, executor, budget);
+                if (status == Running) {
+                    memory = position;
+                    return Running;
+                }
+                if (status == Failure) {
+                    memory = 0;
+                    return Failure;
+                }
+                child += nodes_[child].size;
+            }
+            memory = 0;
+            return Success;
+        }
+        case Selector: {
+            unsigned int child = index + 1;
+            for (unsigned int position = 1; child < end; position++) {
+                Status status = tickNode(child, state, executor, budget);
+                if (status == Failure) {
+                    child += nodes_[child].size;
+                    continue;
+                }
+                if (state.yielded) {
+                    // the child was not finished, tick it again next time
+                    return Running;
+                }
+
+                // a different child took over, the one that was running is interrupted
+                if (memory != 0 && memory != position) {
+                    unsigned int running = index + 1;
+                    for (unsigned int i = 1; i < memory; i++) {
+                        running += nodes_[running].size;
+                    }
+                    resetSubtree(running, state);
+                }
+                memory = status == Running ? position : 0;
+                return status;
+            }
+            memory = 0;
+            return Failure;
+        }
+        case Chance: {
+            if (memory == 0 && executor.roll() % 100 >= node.param) {
+                return Failure;
+            }
+            Status status = tickNode(index + 1, state, executor, budget);
+            memory = status == Running;
+            return status;
+        }
+        case Inverter: {
+            Status status = tickNode(index + 1, state, executor, budget);
+            return status == Running ? Running : (status == Success ? Failure : Success);
+        }
+        case Succeeder: {
+            Status status = tickNode(index + 1, state, executor, budget);
+            return status == Running ? Running : Success;
+        }
+        case Leaf:
+            return executor.runLeaf(node.leaf, state);
+    }
+    return Failure;
+}
+
+void BehaviorTree::resetSubtree(unsigned int index, State &state) const {
+    std::fill(state.memory.begin() + index, state.memory.begin() + index + nodes_[index].size, 0);
+}
+
+const std::vector<BehaviorTree::Node> &BehaviorTree::getNodes() const {
+    return nodes_;
+}
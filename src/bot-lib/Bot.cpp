@@ -4,14 +4,14 @@
 
 #include "include/Bot.h"
 #include "include/BotController.h"
-#include "../core-lib/include/EventQueue.h"
-#include "../core-lib/include/Event.h"
 #include "../core-lib/include/Clock.h"
 
+unsigned int Bot::nextBotId_ = 0;
+
 Bot::Bot(float x, float y, float sizeX, float sizeY, float speed, Direction facing) :
         Entity(x, y, sizeX, sizeY, speed, facing),
         botController(BotController::instance()),
-        maxDecisionCooldown(12),
+        maxDecisionCooldown(BotController::instance()->getDecisionCooldown()),
         decisionCooldown(maxDecisionCooldown) {
     botController->registerBot();
     subscribe(Clock::instance());
@@ -30,6 +30,21 @@ void Bot::notify(SimplePublisher *pub) {
 }
 
 void Bot::requestDecision() {
-    EventQueue<Event>::instance()->registerEvent(std::make_unique<Event>(Event::BotDecisionRequest,
-                                                                         shared_from_this()));
-}
\ No newline at end of file
+    BotController::instance()->requestDecision(shared_from_this());
+}
+
+unsigned int Bot::getBotId() const {
+    return botId_;
+}
+
+BehaviorTree::State &Bot::getTreeState() {
+    return treeState_;
+}
+
+unsigned int Bot::getDecisionCooldown() const {
+    return decisionCooldown;
+}
+
+void Bot::setDecisionCooldown(unsigned int cooldown) {
+    decisionCooldown = cooldown;
+}
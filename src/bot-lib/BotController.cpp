@@ -4,18 +4,119 @@
 
 #include <algorithm>
 #include <random>
+#include <sstream>
+#include <unordered_set>
 
 #include "include/BotController.h"
 #include "include/Bot.h"
+#include "include/ScriptScheduler.h"
 #include "../core-lib/include/Clock.h"
 #include "../core-lib/include/SingletonExceptions.h"
+#include "../core-lib/include/Snapshot.h"
+#include "../core-lib/include/WorkerPool.h"
+#include "../board-lib/include/FlowField.h"
+#include "../board-lib/include/Board.h"
+#include "../tank-lib/include/FixedPoint.h"
+
+namespace {
+    /**
+     * Directions are ordered anticlockwise, North, West, South, East
+     */
+    Direction turnedLeft(Direction facing) {
+        return static_cast<Direction>((facing + 1) % 4);
+    }
+
+    Direction turnedRight(Direction facing) {
+        return static_cast<Direction>((facing + 3) % 4);
+    }
+}
 
 const char *NoSpawnpointException::what() const noexcept {
     return "At least one spawnpoint is needed to spawn a bot";
 }
 
-BotController::BotController(unsigned int n_maxRegisteredBots, unsigned int n_spawnCooldown) : maxSpawnCooldown(
+const std::vector<std::string> BotController::Leaves{
+        "target_in_sight",
+        "aim",
+        "follow_flow_field",
+        "hunt_player",
+        "move_forward",
+        "turn_left",
+        "turn_right",
+        "fire",
+        "random"
+};
+
+const char *const BotController::DefaultTree =
+        "selector\n"
+        "  aim\n"
+        "  follow_flow_field\n"
+        "  random\n";
+
+class BotController::TreeExecutor : public BehaviorTree::Executor {
+public:
+    TreeExecutor(const BotController &controller, const std::shared_ptr<Bot> &bot, unsigned int roll) :
+            controller_(controller), bot_(bot), roll_(roll) {}
+
+    BehaviorTree::Status runLeaf(unsigned int leaf, BehaviorTree::State &state) override {
+        // one decision per phase, further actions wait for the next one
+        if (leaf != TargetInSight && decision.has_value()) {
+            return BehaviorTree::Running;
+        }
+
+        Direction facing = bot_->getFacing();
+        switch (static_cast<TreeLeaf>(leaf)) {
+            case TargetInSight:
+                return controller_.aimAtTarget(bot_).has_value() ? BehaviorTree::Success : BehaviorTree::Failure;
+            case Aim:
+                decision = controller_.aimAtTarget(bot_);
+                break;
+            case FollowFlowField:
+                decision = controller_.followFlowField(bot_);
+                break;
+            case HuntPlayer:
+                return controller_.huntPlayer(bot_, state, decision);
+            case MoveForward:
+                decision = Decision{bot_, Decision::Move, facing};
+                break;
+            case TurnLeft:
+                decision = Decision{bot_, Decision::Rotate, turnedLeft(facing)};
+                break;
+            case TurnRight:
+                decision = Decision{bot_, Decision::Rotate, turnedRight(facing)};
+                break;
+            case Fire:
+                decision = Decision{bot_, Decision::Fire, facing};
+                break;
+            case RandomAction:
+                decision = controller_.makeRandomDecision(bot_, roll());
+                break;
+        }
+        return decision.has_value() ? BehaviorTree::Success : BehaviorTree::Failure;
+    }
+
+    [[nodiscard]] unsigned int getLeafCost(unsigned int leaf) const override {
+        // looking around means up to four line of sight queries
+        return leaf == TargetInSight || leaf == Aim ? 4 : 1;
+    }
+
+    unsigned int roll() override {
+        roll_ = roll_ * 1103515245u + 12345u;
+        return roll_ >> 8;
+    }
+
+    std::optional<Decision> decision;
+
+private:
+    const BotController &controller_;
+    const std::shared_ptr<Bot> &bot_;
+    unsigned int roll_;
+};
+
+BotController::BotController(unsigned int n_maxRegisteredBots, unsigned int n_spawnCooldown) : referenceSpawnCooldown_(
         n_spawnCooldown),
+                                                                                               maxSpawnCooldown(
+                                                                                                       n_spawnCooldown),
                                                                                                spawnCooldown(
                                                                                                        maxSpawnCooldown),
                                                                                                maxRegisteredBots_(
@@ -23,9 +124,424 @@ BotController::BotController(unsigned int n_maxRegisteredBots, unsigned int n_sp
                                                                                                registeredBots_(0),
                                                                                                eventQueue_(
                                                                                                        EventQueue<Event>::instance()) {
+    std::istringstream defaultTree(DefaultTree);
+    defaultTree_ = BehaviorTree::parse(defaultTree, Leaves);
+    scriptScheduler_ = std::make_unique<ScriptScheduler>();
+    planner_ = std::make_unique<LookaheadPlanner>();
+    planner_->setRolloutBudget(DefaultLookaheadBudget);
 };
 
+BotController::~BotController() = default;
+
 void BotController::makeBotDecision(const std::shared_ptr<Bot>& bot) {
+    if (board_ != nullptr) {
+        board_->updateSightBlockers();
+    }
+    exchangePaths(bot);
+    std::optional<Decision> decision = decide(bot, static_cast<unsigned int>(std::rand()), MaxBudgetPerBot);
+    exchangePaths(bot);
+    if (decision.has_value()) {
+        queueDecision(decision.value());
+    }
+}
+
+void BotController::requestDecision(const std::shared_ptr<Bot> &bot) {
+    dueBots_.push_back(bot);
+}
+
+std::size_t BotController::getDueBotCount() const {
+    return dueBots_.size();
+}
+
+void BotController::makeDueDecisions() {
+    // the board may keep removed entities alive until it's sight blockers are updated
+    if (board_ != nullptr) {
+        board_->updateSightBlockers();
+    }
+
+    if (counting) {
+        scriptScheduler_->update(*this);
+    }
+
+    // bots deferred from the last phase go first, in the order they were deferred, bots running scripts are skipped
+    batch_.clear();
+    std::unordered_set<unsigned int> deferredIds;
+    for (const std::weak_ptr<Bot> &deferredBot: deferredBots_) {
+        std::shared_ptr<Bot> bot = deferredBot.lock();
+        if (bot != nullptr && !scriptScheduler_->hasScript(bot->getBotId())) {
+            deferredIds.insert(bot->getBotId());
+            batch_.push_back(std::move(bot));
+        }
+    }
+    std::size_t deferredCount = batch_.size();
+    for (const std::weak_ptr<Bot> &dueBot: dueBots_) {
+        std::shared_ptr<Bot> bot = dueBot.lock();
+        if (bot != nullptr && deferredIds.count(bot->getBotId()) == 0 &&
+            !scriptScheduler_->hasScript(bot->getBotId())) {
+            batch_.push_back(std::move(bot));
+        }
+    }
+    dueBots_.clear();
+    deferredBots_.clear();
+    decisions_.clear();
+    std::sort(batch_.begin() + static_cast<std::ptrdiff_t>(deferredCount), batch_.end(),
+              [](const std::shared_ptr<Bot> &a, const std::shared_ptr<Bot> &b) {
+                  return a->getBotId() < b->getBotId();
+              });
+
+    // decisions requested while the game is not running are dropped
+    if (!counting || batch_.empty()) {
+        batch_.clear();
+        return;
+    }
+
+    // every bot gets an equal share of the budget, bots that do not fit are deferred
+    std::size_t admitted = batch_.size();
+    unsigned int share = MaxBudgetPerBot;
+    if (decisionBudget_ != 0) {
+        share = static_cast<unsigned int>(std::clamp<std::size_t>(decisionBudget_ / batch_.size(), MinBudgetPerBot,
+                                                                  MaxBudgetPerBot));
+        admitted = std::clamp<std::size_t>(decisionBudget_ / share, 1, batch_.size());
+    }
+
+    for (std::size_t i = 0; i < admitted; i++) {
+        exchangePaths(batch_[i]);
+    }
+
+    // the world is not modified until all decisions are made, so they can be made in parallel
+    rolls_.resize(admitted);
+    for (unsigned int &roll: rolls_) {
+        roll = random_();
+    }
+    results_.assign(admitted, std::nullopt);
+    preparePolicyBatches(admitted);
+
+    if (workerPool_ != nullptr) {
+        workerPool_->parallelFor(admitted, MinBotsPerChunk, [this, share](std::size_t begin, std::size_t end) {
+            decideRange(begin, end, share);
+        });
+    } else {
+        decideRange(0, admitted, share);
+    }
+    evaluatePolicyBatches();
+    planLookahead(share);
+
+    for (std::size_t i = 0; i < batch_.size(); i++) {
+        if (i >= admitted) {
+            deferredBots_.push_back(batch_[i]);
+            continue;
+        }
+        exchangePaths(batch_[i]);
+        if (results_[i].has_value()) {
+            decisions_.push_back(results_[i].value());
+            applyDecision(results_[i].value());
+        } else if (batch_[i]->getTreeState().yielded) {
+            deferredBots_.push_back(batch_[i]);
+        }
+    }
+    batch_.clear();
+}
+
+const std::vector<BotController::Decision> &BotController::getLastDecisions() const {
+    return decisions_;
+}
+
+void BotController::setDecisionThreads(unsigned int threads) {
+    if (threads <= 1) {
+        workerPool_.reset();
+    } else if (workerPool_ == nullptr || workerPool_->getThreadCount() != threads) {
+        workerPool_ = std::make_unique<WorkerPool>(threads);
+    }
+}
+
+void BotController::decideRange(std::size_t begin, std::size_t end, unsigned int budget) {
+    for (std::size_t i = begin; i < end; i++) {
+        auto [batch, row] = policyRows_[i];
+        if (batch == TreeBatch) {
+            results_[i] = decide(batch_[i], rolls_[i], budget);
+        } else if (batch != LookaheadBatch) {
+            PolicyBatch &policyBatch = policyBatches_[batch];
+            buildObservation(batch_[i], policyBatch.inputs.data() + row * policyBatch.policy->getInputStride());
+        }
+    }
+}
+
+void BotController::preparePolicyBatches(std::size_t admitted) {
+    policyRows_.assign(admitted, {TreeBatch, 0});
+    for (PolicyBatch &batch: policyBatches_) {
+        batch.members.clear();
+    }
+
+    // simulations need the board
+    lookaheadMembers_.clear();
+    if (board_ != nullptr && !lookaheadTypes_.empty()) {
+        for (std::size_t i = 0; i < admitted; i++) {
+            std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(batch_[i]);
+            if (tank != nullptr && lookaheadTypes_.count(tank->getType()) != 0) {
+                policyRows_[i] = {LookaheadBatch, lookaheadMembers_.size()};
+                lookaheadMembers_.push_back(i);
+            }
+        }
+    }
+    if (policies_.empty()) {
+        return;
+    }
+
+    observedPlayer_.reset();
+    observedEagle_ = {0, 0};
+    if (board_ != nullptr) {
+        std::shared_ptr<PlayerTank> player = board_->getPlayerTank();
+        if (player != nullptr) {
+            observedPlayer_ = positionOf(*player);
+        }
+        observedEagle_ = board_->getGrid()->getEagleLocation();
+    }
+
+    for (std::size_t i = 0; i < admitted; i++) {
+        std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(batch_[i]);
+        auto policy = tank != nullptr ? policies_.find(tank->getType()) : policies_.end();
+        if (policy == policies_.end() || policyRows_[i].first == LookaheadBatch) {
+            continue;
+        }
+        auto batch = std::find_if(policyBatches_.begin(), policyBatches_.end(), [&policy](const PolicyBatch &b) {
+            return b.policy == policy->second.get();
+        });
+        if (batch == policyBatches_.end()) {
+            batch = policyBatches_.insert(policyBatches_.end(), PolicyBatch{policy->second.get(), {}, {}, {}, {}});
+        }
+        policyRows_[i] = {static_cast<int>(batch - policyBatches_.begin()), batch->members.size()};
+        batch->members.push_back(i);
+    }
+
+    for (PolicyBatch &batch: policyBatches_) {
+        batch.inputs.assign(batch.members.size() * batch.policy->getInputStride(), 0.0f);
+        batch.outputs.resize(batch.members.size() * batch.policy->getOutputStride());
+    }
+}
+
+void BotController::evaluatePolicyBatches() {
+    for (PolicyBatch &batch: policyBatches_) {
+        if (batch.members.empty()) {
+            continue;
+        }
+        batch.policy->evaluate(batch.inputs.data(), batch.members.size(), batch.outputs.data(), batch.workspace);
+        for (std::size_t row = 0; row < batch.members.size(); row++) {
+            std::size_t i = batch.members[row];
+            results_[i] = policyDecision(batch_[i], batch.outputs.data() + row * batch.policy->getOutputStride());
+        }
+    }
+}
+
+void BotController::planLookahead(unsigned int budget) {
+    static_assert(static_cast<std::size_t>(LookaheadPlanner::ActionCount) ==
+                  static_cast<std::size_t>(PolicyActionCount), "planned actions are PolicyActions");
+    if (lookaheadMembers_.empty()) {
+        return;
+    }
+
+    planner_->capture(*board_, flowField_.get());
+    lookaheadBots_.clear();
+    for (std::size_t i: lookaheadMembers_) {
+        lookaheadBots_.push_back(std::dynamic_pointer_cast<Tank>(batch_[i]).get());
+    }
+    planner_->plan(lookaheadBots_, workerPool_.get(), lookaheadScores_);
+
+    for (std::size_t member = 0; member < lookaheadMembers_.size(); member++) {
+        std::size_t i = lookaheadMembers_[member];
+        const LookaheadPlanner::Scores &scores = lookaheadScores_[member];
+        if (*std::max_element(scores.begin(), scores.end()) > LookaheadPlanner::NotScored) {
+            results_[i] = policyDecision(batch_[i], scores.data());
+        } else {
+            results_[i] = decide(batch_[i], rolls_[i], budget);
+        }
+    }
+}
+
+void BotController::buildObservation(const std::shared_ptr<Bot> &bot, float *observation) const {
+    constexpr int Half = static_cast<int>(ObservationWindow) / 2;
+    constexpr int Step = 2;
+    constexpr float Size = 52.0f;
+
+    // the window is centered on the middle of the tank
+    PathService::Position position = positionOf(*bot);
+    int centerX = static_cast<int>(position.first) + 2;
+    int centerY = static_cast<int>(position.second) + 2;
+    Grid *grid = board_ != nullptr ? board_->getGrid() : nullptr;
+    for (int row = 0; row < static_cast<int>(ObservationWindow); row++) {
+        for (int column = 0; column < static_cast<int>(ObservationWindow); column++) {
+            int x = centerX + (column - Half) * Step;
+            int y = centerY + (row - Half) * Step;
+            float value = 1.0f;
+            if (grid != nullptr && x >= 0 && y >= 0 && x < 52 && y < 52) {
+                TileType tile = grid->getTileAtPosition(x, y);
+                value = tile == Bricks ? 0.5f : (tile == Steel || tile == Water ? 1.0f : 0.0f);
+            }
+            *observation++ = value;
+        }
+    }
+
+    for (Direction direction: {North, West, South, East}) {
+        *observation++ = bot->getFacing() == direction ? 1.0f : 0.0f;
+    }
+
+    *observation++ = observedPlayer_.has_value() ? 1.0f : 0.0f;
+    *observation++ = observedPlayer_.has_value() ?
+                     (static_cast<float>(observedPlayer_->first) - static_cast<float>(position.first)) / Size : 0.0f;
+    *observation++ = observedPlayer_.has_value() ?
+                     (static_cast<float>(observedPlayer_->second) - static_cast<float>(position.second)) / Size : 0.0f;
+    *observation++ = (static_cast<float>(observedEagle_.first) - static_cast<float>(position.first)) / Size;
+    *observation = (static_cast<float>(observedEagle_.second) - static_cast<float>(position.second)) / Size;
+}
+
+BotController::Decision BotController::policyDecision(const std::shared_ptr<Bot> &bot, const float *scores) {
+    unsigned int best = 0;
+    for (unsigned int action = 1; action < PolicyActionCount; action++) {
+        if (scores[action] > scores[best]) {
+            best = action;
+        }
+    }
+
+    Direction facing = bot->getFacing();
+    switch (static_cast<PolicyAction>(best)) {
+        case PolicyFire:
+            return {bot, Decision::Fire, facing};
+        case PolicyRotateNorth:
+        case PolicyRotateWest:
+        case PolicyRotateSouth:
+        case PolicyRotateEast: {
+            auto direction = static_cast<Direction>(best - PolicyRotateNorth);
+            if (direction != facing) {
+                return {bot, Decision::Rotate, direction};
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return {bot, Decision::Move, facing};
+}
+
+std::optional<BotController::Decision> BotController::decide(const std::shared_ptr<Bot> &bot, unsigned int roll,
+                                                           unsigned int budget) const {
+    const BehaviorTree *tree = defaultTree_.get();
+    std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(bot);
+    if (tank != nullptr) {
+        auto typeTree = trees_.find(tank->getType());
+        if (typeTree != trees_.end()) {
+            tree = typeTree->second.get();
+        }
+    }
+
+    TreeExecutor executor(*this, bot, roll);
+    tree->tick(bot->getTreeState(), executor, budget);
+    return executor.decision;
+}
+
+std::optional<BotController::Decision> BotController::followFlowField(const std::shared_ptr<Bot> &bot) const {
+    if (flowField_ == nullptr) {
+        return std::nullopt;
+    }
+
+    // tile the bot is (mostly) standing on
+    auto [x, y] = positionOf(*bot);
+    std::optional<Direction> direction = flowField_->getDirection(x, y);
+    if (!direction.has_value()) {
+        return std::nullopt;
+    }
+
+    if (bot->getFacing() != direction.value()) {
+        return Decision{bot, Decision::Rotate, direction.value()};
+    }
+
+    // bricks on the way have to be shot down first
+    static constexpr int stepX[4] = {0, -1, 0, 1};
+    static constexpr int stepY[4] = {-1, 0, 1, 0};
+    if (flowField_->getCost(x + stepX[direction.value()], y + stepY[direction.value()]) > 1) {
+        return Decision{bot, Decision::Fire, bot->getFacing()};
+    }
+
+    return Decision{bot, Decision::Move, bot->getFacing()};
+}
+
+BehaviorTree::Status BotController::huntPlayer(const std::shared_ptr<Bot> &bot, BehaviorTree::State &state,
+                                               std::optional<Decision> &decision) const {
+    if (state.pathFailed) {
+        state.pathFailed = false;
+        return BehaviorTree::Failure;
+    }
+    if (state.path.empty()) {
+        // the path is found by the path service over the next ticks
+        if (!state.pathRequest.has_value()) {
+            state.pathWanted = true;
+        }
+        return BehaviorTree::Running;
+    }
+
+    PathService::Position position = positionOf(*bot);
+    auto step = std::find(state.path.begin(), state.path.end(), position);
+    if (step == state.path.end()) {
+        // pushed off the path, a new one has to be found
+        state.path.clear();
+        return BehaviorTree::Failure;
+    }
+    if (step + 1 == state.path.end()) {
+        state.path.clear();
+        return BehaviorTree::Success;
+    }
+
+    PathService::Position next = *(step + 1);
+    Direction direction;
+    if (next.first != position.first) {
+        direction = next.first > position.first ? East : West;
+    } else {
+        direction = next.second > position.second ? South : North;
+    }
+    decision = Decision{bot, bot->getFacing() == direction ? Decision::Move : Decision::Rotate, direction};
+    return BehaviorTree::Running;
+}
+
+void BotController::exchangePaths(const std::shared_ptr<Bot> &bot) {
+    BehaviorTree::State &state = bot->getTreeState();
+    if (state.pathRequest.has_value()) {
+        std::optional<PathService::Result> result = pathService_.takeResult(state.pathRequest.value());
+        if (result.has_value()) {
+            state.pathRequest.reset();
+            state.path = std::move(result->path);
+            state.pathFailed = !result->found;
+        }
+    }
+
+    if (state.pathWanted) {
+        state.pathWanted = false;
+        std::shared_ptr<PlayerTank> player = board_ != nullptr ? board_->getPlayerTank() : nullptr;
+        if (player == nullptr) {
+            state.pathFailed = true;
+            return;
+        }
+        state.pathRequest = pathService_.requestPath(positionOf(*bot), positionOf(*player));
+    }
+}
+
+std::optional<BotController::Decision> BotController::aimAtTarget(const std::shared_ptr<Bot> &bot) const {
+    std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(bot);
+    if (board_ == nullptr || tank == nullptr) {
+        return std::nullopt;
+    }
+    const Board &board = *board_;
+
+    if (board.findTargetInSight(tank, bot->getFacing()).has_value()) {
+        return Decision{bot, Decision::Fire, bot->getFacing()};
+    }
+
+    for (Direction direction: {North, West, South, East}) {
+        if (direction != bot->getFacing() && board.findTargetInSight(tank, direction).has_value()) {
+            return Decision{bot, Decision::Rotate, direction};
+        }
+    }
+    return std::nullopt;
+}
+
+BotController::Decision BotController::makeRandomDecision(const std::shared_ptr<Bot>& bot, unsigned int roll) const {
     enum action : unsigned int {
         MoveForward = 0,
         RotateLeft,
@@ -33,10 +549,9 @@ void BotController::makeBotDecision(const std::shared_ptr<Bot>& bot) {
         Fire
     };
 
-    std::default_random_engine generator;
-    std::vector<int> distribution {4, 1, 1, 2};
-    auto pick = std::rand() % 8;
-    for (int i = 0; i < distribution.size(); i++) {
+    static constexpr int distribution[4] = {4, 1, 1, 2};
+    int pick = static_cast<int>(roll % 8);
+    for (int i = 0; i < 4; i++) {
         pick -= distribution[i];
         if (pick < 0) {
             pick = i;
@@ -44,41 +559,188 @@ void BotController::makeBotDecision(const std::shared_ptr<Bot>& bot) {
         }
     }
 
-    // auto pick = static_cast<action>(distribution(generator));
-
     switch (pick) {
-        case MoveForward:{
-            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotMoveDecision, bot, true));
+        case RotateLeft:
+            return {bot, Decision::Rotate, turnedLeft(bot->getFacing())};
+        case RotateRight:
+            return {bot, Decision::Rotate, turnedRight(bot->getFacing())};
+        case Fire:
+            // with a known board, targets in sight have already been checked (see aimAtTarget)
+            if (board_ == nullptr) {
+                return {bot, Decision::Fire, bot->getFacing()};
+            }
+            [[fallthrough]];
+        default:
+            return {bot, Decision::Move, bot->getFacing()};
+    }
+}
+
+void BotController::applyDecision(const Decision &decision) {
+    std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(decision.bot);
+    if (board_ == nullptr || tank == nullptr) {
+        queueDecision(decision);
+        return;
+    }
+
+    switch (decision.action) {
+        case Decision::Move:
+            board_->setTankMoving(tank, true);
             break;
-        }
-        case RotateLeft:{
-            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotRotateDecision, bot, static_cast<int>((bot->getFacing()-1)%4)));
+        case Decision::Rotate:
+            board_->setTankDirection(tank, decision.direction);
             break;
-        }
-        case RotateRight:{
-            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotRotateDecision, bot, static_cast<int>((bot->getFacing()+1)%4)));
+        case Decision::Fire:
+            board_->fireTank(tank);
             break;
-        }
-        case Fire:{
-            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotFireDecision, bot));
+    }
+}
+
+void BotController::queueDecision(const Decision &decision) {
+    switch (decision.action) {
+        case Decision::Move:
+            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotMoveDecision, decision.bot, true));
             break;
+        case Decision::Rotate:
+            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotRotateDecision, decision.bot,
+                                                               static_cast<int>(decision.direction)));
+            break;
+        case Decision::Fire:
+            eventQueue_->registerEvent(std::make_unique<Event>(Event::BotFireDecision, decision.bot));
+            break;
+    }
+}
+
+void BotController::setDecisionBudget(unsigned int budget) {
+    decisionBudget_ = budget;
+}
+
+std::size_t BotController::getDeferredBotCount() const {
+    return deferredBots_.size();
+}
+
+void BotController::setBehaviorTree(Tank::TankType type, std::shared_ptr<const BehaviorTree> tree) {
+    if (tree == nullptr) {
+        trees_.erase(type);
+    } else {
+        trees_[type] = std::move(tree);
+    }
+}
+
+std::shared_ptr<const BehaviorTree> BotController::getBehaviorTree(Tank::TankType type) const {
+    auto tree = trees_.find(type);
+    return tree != trees_.end() ? tree->second : defaultTree_;
+}
+
+void BotController::loadBehaviorTrees(const std::string &directory) {
+    static const std::map<Tank::TankType, std::string> filenames{
+            {Tank::BasicTank, "basic.txt"},
+            {Tank::FastTank,  "fast.txt"},
+            {Tank::PowerTank, "power.txt"},
+            {Tank::ArmorTank, "armor.txt"}
+    };
+
+    std::string errors;
+    for (const auto &[type, filename]: filenames) {
+        try {
+            std::shared_ptr<const BehaviorTree> tree = BehaviorTree::load(directory + "/" + filename, Leaves);
+            if (tree != nullptr) {
+                setBehaviorTree(type, tree);
+            }
+        } catch (const InvalidBehaviorTreeFile &e) {
+            // the other files are still loaded
+            errors += errors.empty() ? e.what() : std::string("\n") + e.what();
         }
-        default: {};
     }
+    if (!errors.empty()) {
+        throw InvalidBehaviorTreeFile(errors);
+    }
+}
+
+void BotController::setPolicy(Tank::TankType type, std::shared_ptr<const NeuralPolicy> policy) {
+    if (policy != nullptr &&
+        (policy->getInputSize() != ObservationSize || policy->getOutputSize() != PolicyActionCount)) {
+        throw InvalidPolicyFile("A policy has to take " + std::to_string(ObservationSize) + " inputs and score " +
+                                std::to_string(PolicyActionCount) + " actions");
+    }
+
+    // batches point to policies, so they are dropped with them
+    policyBatches_.clear();
+    if (policy == nullptr) {
+        policies_.erase(type);
+    } else {
+        policies_[type] = std::move(policy);
+    }
+}
+
+std::shared_ptr<const NeuralPolicy> BotController::getPolicy(Tank::TankType type) const {
+    auto policy = policies_.find(type);
+    return policy != policies_.end() ? policy->second : nullptr;
+}
+
+void BotController::setLookahead(Tank::TankType type, bool lookahead) {
+    if (lookahead) {
+        lookaheadTypes_.insert(type);
+    } else {
+        lookaheadTypes_.erase(type);
+    }
+}
 
+bool BotController::isLookahead(Tank::TankType type) const {
+    return lookaheadTypes_.count(type) != 0;
+}
 
-    // if (rotateRoll == 0) {
-    //     eventQueue_->registerEvent(
-    //             std::make_unique<Event>(Event::BotRotateDecision, bot, static_cast<int>((bot->getFacing() - 1) % 4)));
+void BotController::setLookaheadBudget(std::size_t budget) {
+    planner_->setRolloutBudget(budget);
+}
 
-    // } else if (rotateRoll == 1) {
-    //     eventQueue_->registerEvent(
-    //             std::make_unique<Event>(Event::BotRotateDecision, bot, static_cast<int>((bot->getFacing() + 1) % 4)));
+LookaheadPlanner &BotController::getLookaheadPlanner() {
+    return *planner_;
+}
 
-    // }
+void BotController::loadPolicies(const std::string &directory) {
+    static const std::map<Tank::TankType, std::string> filenames{
+            {Tank::BasicTank, "basic.mlp"},
+            {Tank::FastTank,  "fast.mlp"},
+            {Tank::PowerTank, "power.mlp"},
+            {Tank::ArmorTank, "armor.mlp"}
+    };
 
+    std::string errors;
+    for (const auto &[type, filename]: filenames) {
+        std::string path = directory + "/" + filename;
+        try {
+            std::shared_ptr<const NeuralPolicy> policy = NeuralPolicy::load(path);
+            if (policy != nullptr) {
+                setPolicy(type, policy);
+            }
+        } catch (const InvalidPolicyFile &e) {
+            // errors of setPolicy do not name the file
+            std::string message = e.what();
+            if (message.rfind(path, 0) != 0) {
+                message = path + ": " + message;
+            }
+            errors += errors.empty() ? message : "\n" + message;
+        }
+    }
+    if (!errors.empty()) {
+        throw InvalidPolicyFile(errors);
+    }
+}
 
+void BotController::setTickRate(unsigned int referenceTickRate, unsigned int ticksPerSecond) {
+    auto scale = [referenceTickRate, ticksPerSecond](unsigned int ticks) {
+        return std::max(1u, (ticks * ticksPerSecond + referenceTickRate / 2) / referenceTickRate);
+    };
+    unsigned int previousMaxSpawnCooldown = maxSpawnCooldown;
+    maxSpawnCooldown = scale(referenceSpawnCooldown_);
+    // the part of the cooldown left keeps it's share
+    spawnCooldown = previousMaxSpawnCooldown == 0 ? maxSpawnCooldown :
+                    std::max(1u, spawnCooldown * maxSpawnCooldown / previousMaxSpawnCooldown);
+    decisionCooldown_ = scale(DefaultDecisionCooldown);
+}
 
+unsigned int BotController::getDecisionCooldown() const {
+    return decisionCooldown_;
 }
 
 void BotController::registerBot() {
@@ -145,7 +807,7 @@ void BotController::requestSpawnBot() {
             spawnpoints_.end(),
             std::back_inserter(out),
             1,
-            std::mt19937{std::random_device{}()}
+            random_
     );
     std::pair<unsigned int, unsigned int> spawnpoint = out.front();
 
@@ -160,6 +822,100 @@ void BotController::setTypes(const std::queue<Tank::TankType> &types) {
     types_ = types;
 }
 
+void BotController::setSeed(std::uint32_t seed) {
+    random_.seed(seed);
+}
+
+
+void BotController::saveState(SnapshotWriter &writer) const {
+    writer.write(static_cast<std::uint32_t>(spawnpoints_.size()));
+    for (const std::pair<unsigned int, unsigned int> &spawnpoint: spawnpoints_) {
+        writer.write(static_cast<std::uint32_t>(spawnpoint.first));
+        writer.write(static_cast<std::uint32_t>(spawnpoint.second));
+    }
+
+    std::vector<std::uint8_t> types;
+    for (std::queue<Tank::TankType> remaining = types_; !remaining.empty(); remaining.pop()) {
+        types.push_back(static_cast<std::uint8_t>(remaining.front()));
+    }
+    writer.writeVector(types);
+
+    std::ostringstream random;
+    random << random_;
+    writer.write(static_cast<std::uint32_t>(std::stoul(random.str())));
+    writer.write(static_cast<std::uint32_t>(maxSpawnCooldown));
+    writer.write(static_cast<std::uint32_t>(spawnCooldown));
+    writer.write(static_cast<std::uint32_t>(maxRegisteredBots_));
+    writer.write(static_cast<std::uint32_t>(registeredBots_));
+}
+
+void BotController::loadState(SnapshotReader &reader) {
+    auto spawnpointCount = reader.read<std::uint32_t>();
+    if (spawnpointCount > reader.getRemaining() / (2 * sizeof(std::uint32_t))) {
+        throw InvalidSnapshot(std::to_string(spawnpointCount) + " spawnpoints in a snapshot");
+    }
+    std::vector<std::pair<unsigned int, unsigned int>> spawnpoints(spawnpointCount);
+    for (std::pair<unsigned int, unsigned int> &spawnpoint: spawnpoints) {
+        spawnpoint.first = reader.read<std::uint32_t>();
+        spawnpoint.second = reader.read<std::uint32_t>();
+    }
+
+    std::vector<std::uint8_t> types = reader.readVector<std::uint8_t>(reader.getRemaining());
+    std::queue<Tank::TankType> typesQueue;
+    for (std::uint8_t type: types) {
+        if (type > Tank::ArmorTank) {
+            throw InvalidSnapshot("Unknown tank type in a snapshot");
+        }
+        typesQueue.push(static_cast<Tank::TankType>(type));
+    }
+
+    auto randomState = reader.read<std::uint32_t>();
+    if (randomState == 0 || randomState >= std::minstd_rand::modulus) {
+        throw InvalidSnapshot("Broken random generator state in a snapshot");
+    }
+    auto maxCooldown = reader.read<std::uint32_t>();
+    auto cooldown = reader.read<std::uint32_t>();
+    auto maxBots = reader.read<std::uint32_t>();
+    auto bots = reader.read<std::uint32_t>();
+
+    spawnpoints_ = std::move(spawnpoints);
+    types_ = std::move(typesQueue);
+    std::istringstream random(std::to_string(randomState));
+    random >> random_;
+    maxSpawnCooldown = maxCooldown;
+    spawnCooldown = cooldown;
+    maxRegisteredBots_ = maxBots;
+    registeredBots_ = bots;
+    // bots waiting for decisions were replaced with the entities
+    dueBots_.clear();
+    deferredBots_.clear();
+    pathService_.invalidate();
+}
+
+void BotController::setFlowField(std::shared_ptr<const FlowField> flowField) {
+    flowField_ = std::move(flowField);
+}
+
+void BotController::setBoard(Board *board) {
+    board_ = board;
+}
+
+Board *BotController::getBoard() const {
+    return board_;
+}
+
+PathService &BotController::getPathService() {
+    return pathService_;
+}
+
+ScriptScheduler &BotController::getScriptScheduler() {
+    return *scriptScheduler_;
+}
+
+PathService::Position BotController::positionOf(const Entity &entity) {
+    return {static_cast<unsigned int>(std::max(0, FixedPoint::floorToTile(entity.getFixedX() + FixedPoint::One / 2))),
+            static_cast<unsigned int>(std::max(0, FixedPoint::floorToTile(entity.getFixedY() + FixedPoint::One / 2)))};
+}
 
 void BotController::setCounting(bool nCounting) {
     counting = nCounting;
@@ -0,0 +1,107 @@
+#include <utility>
+
+#include "include/BotScript.h"
+#include "include/Bot.h"
+#include "../core-lib/include/FramePool.h"
+
+BotScript BotScript::promise_type::get_return_object() {
+    return BotScript(Handle::from_promise(*this));
+}
+
+void BotScript::promise_type::unhandled_exception() {
+    exception = std::current_exception();
+}
+
+void *BotScript::promise_type::operator new(std::size_t size) {
+    return FramePool::instance().allocate(size);
+}
+
+void BotScript::promise_type::operator delete(void *pointer, std::size_t size) {
+    FramePool::instance().deallocate(pointer, size);
+}
+
+PathService::Result BotScript::PathAwaiter::await_resume() const {
+    std::optional<PathService::Result> &result = handle.promise().pathResult;
+    PathService::Result path = result.has_value() ? std::move(result.value()) : PathService::Result{false, {}, 0};
+    result.reset();
+    return path;
+}
+
+bool BotScript::SightAwaiter::await_resume() const {
+    return handle.promise().sawTarget;
+}
+
+std::shared_ptr<Bot> BotScript::SelfAwaiter::await_resume() const {
+    return handle.promise().bot.lock();
+}
+
+BotScript::WaitAwaiter BotScript::waitTicks(unsigned int ticks) {
+    Wait wait;
+    wait.kind = Wait::Ticks;
+    wait.ticks = std::max(ticks, 1u);
+    return {wait};
+}
+
+BotScript::WaitAwaiter BotScript::move() {
+    Wait wait;
+    wait.kind = Wait::Action;
+    wait.action = BotController::Decision::Move;
+    return {wait};
+}
+
+BotScript::WaitAwaiter BotScript::rotate(Direction direction) {
+    Wait wait;
+    wait.kind = Wait::Action;
+    wait.action = BotController::Decision::Rotate;
+    wait.direction = direction;
+    return {wait};
+}
+
+BotScript::WaitAwaiter BotScript::fire() {
+    Wait wait;
+    wait.kind = Wait::Action;
+    wait.action = BotController::Decision::Fire;
+    return {wait};
+}
+
+BotScript::PathAwaiter BotScript::pathTo(PathService::Position goal) {
+    Wait wait;
+    wait.kind = Wait::Path;
+    wait.goal = goal;
+    return {wait, nullptr};
+}
+
+BotScript::SightAwaiter BotScript::targetInSight(unsigned int timeout) {
+    Wait wait;
+    wait.kind = Wait::Sight;
+    wait.ticks = timeout;
+    return {wait, nullptr};
+}
+
+BotScript::SelfAwaiter BotScript::self() {
+    return {nullptr};
+}
+
+BotScript::BotScript(Handle handle) : handle_(handle) {}
+
+BotScript::BotScript(BotScript &&other) noexcept: handle_(std::exchange(other.handle_, nullptr)) {}
+
+BotScript &BotScript::operator=(BotScript &&other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+
+BotScript::~BotScript() {
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+BotScript::Handle BotScript::release() {
+    return std::exchange(handle_, nullptr);
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "include/LookaheadPlanner.h"
+#include "../core-lib/include/Event.h"
+#include "../core-lib/include/WorkerPool.h"
+#include "../board-lib/include/Board.h"
+#include "../board-lib/include/FlowField.h"
+
+LookaheadPlanner::LookaheadPlanner() = default;
+
+LookaheadPlanner::~LookaheadPlanner() = default;
+
+void LookaheadPlanner::setRolloutTicks(unsigned int ticks) {
+    rolloutTicks_ = ticks;
+}
+
+void LookaheadPlanner::setRolloutBudget(std::size_t budget) {
+    rolloutBudget_ = budget;
+}
+
+std::size_t LookaheadPlanner::getRolloutBudget() const {
+    return rolloutBudget_;
+}
+
+void LookaheadPlanner::capture(Board &board, const FlowField *flowField) {
+    world_.capture(board);
+    flowField_ = flowField;
+}
+
+void LookaheadPlanner::plan(const std::vector<const Entity *> &bots, WorkerPool *pool, std::vector<Scores> &scores) {
+    // the budget is given out up front, so it does not depend on how bots are spread across threads
+    const SimulatedWorld::Entities &captured = world_.getEntities();
+    std::size_t remaining = rolloutBudget_ > 0 ? rolloutBudget_ : SIZE_MAX;
+    roots_.resize(bots.size());
+    allowances_.assign(bots.size(), 0);
+    for (std::size_t i = 0; i < bots.size(); i++) {
+        roots_[i] = world_.indexOf(bots[i]);
+        if (!roots_[i].has_value()) {
+            continue;
+        }
+        std::size_t candidates = 0;
+        for (unsigned int action = Move; action < ActionCount; action++) {
+            candidates += isCandidate(captured, roots_[i].value(), action) ? 1 : 0;
+        }
+        allowances_[i] = std::min(candidates, remaining);
+        remaining -= allowances_[i];
+    }
+
+    Scores notScored;
+    notScored.fill(NotScored);
+    scores.assign(bots.size(), notScored);
+    rollouts_ = 0;
+    abandoned_ = 0;
+
+    auto planRange = [&](std::size_t begin, std::size_t end) {
+        std::unique_ptr<Scratch> scratch = takeScratch();
+        std::size_t rollouts = 0;
+        std::size_t abandoned = 0;
+        for (std::size_t i = begin; i < end; i++) {
+            if (roots_[i].has_value()) {
+                auto [finished, dropped] = planBot(roots_[i].value(), *scratch, allowances_[i], scores[i]);
+                rollouts += finished;
+                abandoned += dropped;
+            }
+        }
+
+        returnScratch(std::move(scratch));
+        std::lock_guard<std::mutex> lock(mutex_);
+        rollouts_ += rollouts;
+        abandoned_ += abandoned;
+    };
+
+    // rollouts are long, so every bot can be a chunk of it's own
+    if (pool != nullptr) {
+        pool->parallelFor(bots.size(), 1, planRange);
+    } else {
+        planRange(0, bots.size());
+    }
+}
+
+std::pair<std::size_t, std::size_t> LookaheadPlanner::planBot(std::uint32_t root, Scratch &scratch,
+                                                             std::size_t allowance, Scores &scores) {
+    SimulatedWorld &local = scratch.local;
+    local.fork(world_, root, FixedPoint::fromTiles(ForkRadius));
+
+    // the bot is at index 0 of forks
+    const SimulatedWorld::Entities &start = local.getEntities();
+    std::vector<std::uint32_t> &players = scratch.players;
+    players.clear();
+    std::uint32_t eagle = SimulatedWorld::None;
+    for (std::uint32_t i = 0; i < local.size(); i++) {
+        if (start.kind[i] == SimulatedWorld::PlayerTank) {
+            players.push_back(i);
+        } else if (start.kind[i] == SimulatedWorld::Eagle) {
+            eagle = i;
+        }
+    }
+    std::optional<float> startDistance = distanceOf(local, 0);
+
+    std::size_t started = 0;
+    std::size_t finished = 0;
+    std::size_t abandoned = 0;
+    for (unsigned int action = Move; action < ActionCount; action++) {
+        scores[action] = NotScored;
+        if (!isCandidate(start, 0, action)) {
+            continue;
+        }
+        if (started == allowance) {
+            abandoned++;
+            continue;
+        }
+        started++;
+
+        bool rotation = action >= RotateNorth && action <= RotateEast;
+
+        SimulatedWorld &world = scratch.rollout;
+        world.copyFrom(local);
+        if (rotation && !world.rotate(0, static_cast<Direction>(action - RotateNorth))) {
+            continue;
+        }
+        if (action == Fire) {
+            world.fire(0);
+        } else {
+            world.setMoving(0, true);
+        }
+
+        const SimulatedWorld::Entities &entities = world.getEntities();
+        float score = 0.0f;
+        for (unsigned int tick = 0; tick < rolloutTicks_; tick++) {
+            unsigned int livesBefore = 0;
+            for (std::uint32_t player: players) {
+                livesBefore += entities.lives[player];
+            }
+            bool eagleBefore = eagle != SimulatedWorld::None && entities.alive[eagle];
+
+            world.step();
+
+            // sooner is better, events at the end of the rollout count half
+            float weight = static_cast<float>(2 * rolloutTicks_ - tick) / static_cast<float>(2 * rolloutTicks_);
+            unsigned int livesAfter = 0;
+            for (std::uint32_t player: players) {
+                livesAfter += entities.lives[player];
+            }
+            score += PlayerHitScore * weight * static_cast<float>(livesBefore - livesAfter);
+            if (eagleBefore && !entities.alive[eagle]) {
+                score += EagleScore * weight;
+            }
+            if (!entities.alive[0]) {
+                score += DeathScore * weight;
+                break;
+            }
+            world.setMoving(0, true);
+            world.fire(0);
+        }
+
+        std::optional<float> endDistance = distanceOf(world, 0);
+        if (startDistance.has_value() && endDistance.has_value()) {
+            score += ProgressScore * (startDistance.value() - endDistance.value());
+        }
+        scores[action] = score;
+        finished++;
+    }
+    return {finished, abandoned};
+}
+
+bool LookaheadPlanner::isCandidate(const SimulatedWorld::Entities &entities, std::uint32_t tank, unsigned int action) {
+    if (action >= RotateNorth && action <= RotateEast) {
+        return action - RotateNorth != entities.facing[tank];
+    }
+    return action != Fire || entities.link[tank] == SimulatedWorld::None;
+}
+
+std::optional<float> LookaheadPlanner::distanceOf(const SimulatedWorld &world, std::uint32_t tank) const {
+    if (flowField_ == nullptr) {
+        return std::nullopt;
+    }
+
+    // the position the tank is mostly standing on, like BotController::positionOf
+    const SimulatedWorld::Entities &entities = world.getEntities();
+    int x = std::max(0, FixedPoint::floorToTile(entities.x[tank] + FixedPoint::One / 2));
+    int y = std::max(0, FixedPoint::floorToTile(entities.y[tank] + FixedPoint::One / 2));
+    std::uint16_t distance = flowField_->getDistance(x, y);
+    if (distance == FlowField::Unreachable) {
+        return std::nullopt;
+    }
+    return static_cast<float>(distance);
+}
+
+std::unique_ptr<LookaheadPlanner::Scratch> LookaheadPlanner::takeScratch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (scratch_.empty()) {
+        return std::make_unique<Scratch>();
+    }
+    std::unique_ptr<Scratch> scratch = std::move(scratch_.back());
+    scratch_.pop_back();
+    return scratch;
+}
+
+void LookaheadPlanner::returnScratch(std::unique_ptr<Scratch> scratch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    scratch_.push_back(std::move(scratch));
+}
+
+std::size_t LookaheadPlanner::getLastRolloutCount() const {
+    return rollouts_;
+}
+
+std::size_t LookaheadPlanner::getLastAbandonedCount() const {
+    return abandoned_;
+}
@@ -0,0 +1,281 @@
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+
+#include "include/NeuralPolicy.h"
+
+#if defined(__GNUC__)
+#define TANKS_UNROLL _Pragma("GCC unroll 8")
+#else
+#define TANKS_UNROLL
+#endif
+
+namespace {
+    constexpr std::size_t Lanes = NeuralPolicy::Lanes;
+
+    /**
+     * Rows of a batch evaluated together, so that every loaded weight is used this many times
+     */
+    constexpr std::size_t RowBlock = 4;
+
+    /**
+     * Rows taken through all layers before the next ones, so that activations stay in the cache
+     */
+    constexpr std::size_t RowTile = 32;
+
+    /**
+     * Maximum number of layers and maximum layer size accepted from files
+     */
+    constexpr std::uint32_t MaxLayers = 16;
+    constexpr std::uint32_t MaxLayerSize = 4096;
+
+    std::size_t padded(std::size_t size) {
+        return (size + Lanes - 1) / Lanes * Lanes;
+    }
+
+    /**
+     * out[r][o] = bias[o] + sum over i of in[r][i] * weights[i][o], for Rows rows; products are added in the order of
+     * inputs in every kernel. Loops over rows have to be unrolled for accumulators to stay in registers
+     */
+    template<std::size_t Rows>
+    void denseRows(const float *in, std::size_t inStride, std::size_t inputs, const float *weights,
+                   const float *biases, std::size_t outStride, float *out, bool relu) {
+        for (std::size_t o = 0; o < outStride; o += Lanes) {
+#if defined(__AVX2__)
+            __m256 acc[Rows];
+            TANKS_UNROLL
+            for (std::size_t r = 0; r < Rows; r++) {
+                acc[r] = _mm256_loadu_ps(biases + o);
+            }
+            for (std::size_t i = 0; i < inputs; i++) {
+                __m256 w = _mm256_loadu_ps(weights + i * outStride + o);
+                TANKS_UNROLL
+                for (std::size_t r = 0; r < Rows; r++) {
+                    acc[r] = _mm256_add_ps(acc[r], _mm256_mul_ps(_mm256_set1_ps(in[r * inStride + i]), w));
+                }
+            }
+            TANKS_UNROLL
+            for (std::size_t r = 0; r < Rows; r++) {
+                if (relu) {
+                    acc[r] = _mm256_max_ps(acc[r], _mm256_setzero_ps());
+                }
+                _mm256_storeu_ps(out + r * outStride + o, acc[r]);
+            }
+#elif defined(__SSE2__)
+            __m128 low[Rows];
+            __m128 high[Rows];
+            TANKS_UNROLL
+            for (std::size_t r = 0; r < Rows; r++) {
+                low[r] = _mm_loadu_ps(biases + o);
+                high[r] = _mm_loadu_ps(biases + o + 4);
+            }
+            for (std::size_t i = 0; i < inputs; i++) {
+                __m128 wLow = _mm_loadu_ps(weights + i * outStride + o);
+                __m128 wHigh = _mm_loadu_ps(weights + i * outStride + o + 4);
+                TANKS_UNROLL
+                for (std::size_t r = 0; r < Rows; r++) {
+                    __m128 x = _mm_set1_ps(in[r * inStride + i]);
+                    low[r] = _mm_add_ps(low[r], _mm_mul_ps(x, wLow));
+                    high[r] = _mm_add_ps(high[r], _mm_mul_ps(x, wHigh));
+                }
+            }
+            TANKS_UNROLL
+            for (std::size_t r = 0; r < Rows; r++) {
+                if (relu) {
+                    low[r] = _mm_max_ps(low[r], _mm_setzero_ps());
+                    high[r] = _mm_max_ps(high[r], _mm_setzero_ps());
+                }
+                _mm_storeu_ps(out + r * outStride + o, low[r]);
+                _mm_storeu_ps(out + r * outStride + o + 4, high[r]);
+            }
+#else
+            float acc[Rows][Lanes];
+            TANKS_UNROLL
+            for (std::size_t r = 0; r < Rows; r++) {
+                for (std::size_t lane = 0; lane < Lanes; lane++) {
+                    acc[r][lane] = biases[o + lane];
+                }
+            }
+            for (std::size_t i = 0; i < inputs; i++) {
+                const float *w = weights + i * outStride + o;
+                TANKS_UNROLL
+                for (std::size_t r = 0; r < Rows; r++) {
+                    float x = in[r * inStride + i];
+                    for (std::size_t lane = 0; lane < Lanes; lane++) {
+                        acc[r][lane] = acc[r][lane] + x * w[lane];
+                    }
+                }
+            }
+            TANKS_UNROLL
+            for (std::size_t r = 0; r < Rows; r++) {
+                for (std::size_t lane = 0; lane < Lanes; lane++) {
+                    float value = acc[r][lane];
+                    out[r * outStride + o + lane] = relu && !(value > 0.0f) ? 0.0f : value;
+                }
+            }
+#endif
+        }
+    }
+
+    void denseLayer(const float *in, std::size_t inStride, std::size_t inputs, std::size_t count,
+                    const float *weights, const float *biases, std::size_t outStride, float *out, bool relu) {
+        std::size_t row = 0;
+        for (; row + RowBlock <= count; row += RowBlock) {
+            denseRows<RowBlock>(in + row * inStride, inStride, inputs, weights, biases, outStride,
+                                out + row * outStride, relu);
+        }
+        for (; row < count; row++) {
+            denseRows<1>(in + row * inStride, inStride, inputs, weights, biases, outStride, out + row * outStride,
+                         relu);
+        }
+    }
+}
+
+InvalidPolicyFile::InvalidPolicyFile(std::string message) : what_message(std::move(message)) {}
+
+const char *InvalidPolicyFile::what() const noexcept {
+    return what_message.c_str();
+}
+
+NeuralPolicy::NeuralPolicy(const std::vector<Layer> &layers) {
+    if (layers.empty()) {
+        throw InvalidPolicyFile("A policy needs at least one layer");
+    }
+
+    for (std::size_t k = 0; k < layers.size(); k++) {
+        const Layer &layer = layers[k];
+        if (layer.inputs == 0 || layer.outputs == 0 || layer.weights.size() != layer.inputs * layer.outputs ||
+            layer.biases.size() != layer.outputs || (k > 0 && layers[k - 1].outputs != layer.inputs)) {
+            throw InvalidPolicyFile("Layer " + std::to_string(k) + " does not fit");
+        }
+
+        PackedLayer packed{layer.inputs, layer.outputs, padded(layer.inputs), padded(layer.outputs), {}, {}};
+        packed.weights.assign(packed.inputs * packed.outputStride, 0.0f);
+        packed.biases.assign(packed.outputStride, 0.0f);
+        for (std::size_t o = 0; o < layer.outputs; o++) {
+            for (std::size_t i = 0; i < layer.inputs; i++) {
+                packed.weights[i * packed.outputStride + o] = layer.weights[o * layer.inputs + i];
+            }
+            packed.biases[o] = layer.biases[o];
+        }
+        layers_.push_back(std::move(packed));
+    }
+}
+
+std::shared_ptr<const NeuralPolicy> NeuralPolicy::load(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    auto read = [&file, &filename](void *destination, std::size_t bytes) {
+        if (!file.read(static_cast<char *>(destination), static_cast<std::streamsize>(bytes))) {
+            throw InvalidPolicyFile(filename + ": file is too short");
+        }
+    };
+
+    std::uint32_t header[3];
+    read(header, sizeof(header));
+    if (header[0] != Magic || header[1] != FileVersion) {
+        throw InvalidPolicyFile(filename + ": not a policy file");
+    }
+    if (header[2] == 0 || header[2] > MaxLayers) {
+        throw InvalidPolicyFile(filename + ": wrong number of layers");
+    }
+
+    std::vector<std::uint32_t> sizes(header[2] + 1);
+    read(sizes.data(), sizes.size() * sizeof(std::uint32_t));
+    for (std::uint32_t size: sizes) {
+        if (size == 0 || size > MaxLayerSize) {
+            throw InvalidPolicyFile(filename + ": wrong layer size");
+        }
+    }
+
+    std::vector<Layer> layers;
+    for (std::size_t k = 0; k + 1 < sizes.size(); k++) {
+        Layer layer{sizes[k], sizes[k + 1], std::vector<float>(std::size_t{sizes[k]} * sizes[k + 1]),
+                    std::vector<float>(sizes[k + 1])};
+        read(layer.weights.data(), layer.weights.size() * sizeof(float));
+        read(layer.biases.data(), layer.biases.size() * sizeof(float));
+        layers.push_back(std::move(layer));
+    }
+    if (file.peek() != std::ifstream::traits_type::eof()) {
+        throw InvalidPolicyFile(filename + ": unexpected data after the last layer");
+    }
+
+    try {
+        return std::make_shared<const NeuralPolicy>(layers);
+    } catch (const InvalidPolicyFile &e) {
+        throw InvalidPolicyFile(filename + ": " + e.what());
+    }
+}
+
+bool NeuralPolicy::save(const std::string &filename, const std::vector<Layer> &layers) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open() || layers.empty()) {
+        return false;
+    }
+
+    auto write = [&file](const void *source, std::size_t bytes) {
+        file.write(static_cast<const char *>(source), static_cast<std::streamsize>(bytes));
+    };
+    std::uint32_t header[3] = {Magic, FileVersion, static_cast<std::uint32_t>(layers.size())};
+    write(header, sizeof(header));
+    auto inputs = static_cast<std::uint32_t>(layers.front().inputs);
+    write(&inputs, sizeof(inputs));
+    for (const Layer &layer: layers) {
+        auto outputs = static_cast<std::uint32_t>(layer.outputs);
+        write(&outputs, sizeof(outputs));
+    }
+    for (const Layer &layer: layers) {
+        write(layer.weights.data(), layer.weights.size() * sizeof(float));
+        write(layer.biases.data(), layer.biases.size() * sizeof(float));
+    }
+    return static_cast<bool>(file);
+}
+
+std::size_t NeuralPolicy::getInputSize() const {
+    return layers_.front().inputs;
+}
+
+std::size_t NeuralPolicy::getOutputSize() const {
+    return layers_.back().outputs;
+}
+
+std::size_t NeuralPolicy::getInputStride() const {
+    return layers_.front().inputStride;
+}
+
+std::size_t NeuralPolicy::getOutputStride() const {
+    return layers_.back().outputStride;
+}
+
+void NeuralPolicy::evaluate(const float *inputs, std::size_t count, float *outputs, Workspace &workspace) const {
+    std::size_t widest = 0;
+    for (const PackedLayer &layer: layers_) {
+        widest = std::max(widest, layer.outputStride);
+    }
+    workspace.front.resize(std::max(workspace.front.size(), RowTile * widest));
+    workspace.back.resize(std::max(workspace.back.size(), RowTile * widest));
+
+    for (std::size_t first = 0; first < count; first += RowTile) {
+        std::size_t rows = std::min(RowTile, count - first);
+        const float *current = inputs + first * getInputStride();
+        std::size_t stride = getInputStride();
+        for (std::size_t k = 0; k < layers_.size(); k++) {
+            const PackedLayer &layer = layers_[k];
+            float *target = outputs + first * getOutputStride();
+            if (k + 1 < layers_.size()) {
+                target = k % 2 == 0 ? workspace.front.data() : workspace.back.data();
+            }
+
+            denseLayer(current, stride, layer.inputs, rows, layer.weights.data(), layer.biases.data(),
+                       layer.outputStride, target, k + 1 < layers_.size());
+            current = target;
+            stride = layer.outputStride;
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "include/PathService.h"
+#include "../board-lib/include/Grid.h"
+#include "../board-lib/include/FlowField.h"
+
+namespace {
+    /**
+     * Unit steps in tiles, indexed by Direction
+     */
+    constexpr int stepX[4] = {0, -1, 0, 1};
+    constexpr int stepY[4] = {-1, 0, 1, 0};
+
+    constexpr std::uint32_t Unvisited = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::uint8_t NoParent = std::numeric_limits<std::uint8_t>::max();
+
+    std::uint32_t manhattan(const PathService::Position &a, const PathService::Position &b) {
+        return (a.first > b.first ? a.first - b.first : b.first - a.first) +
+               (a.second > b.second ? a.second - b.second : b.second - a.second);
+    }
+}
+
+PathService::PathService(unsigned int expansionsPerRequest) : expansionsPerRequest_(expansionsPerRequest) {}
+
+PathService::RequestId PathService::requestPath(Position start, Position goal) {
+    pending_.push_back({nextId_, start, goal});
+    return nextId_++;
+}
+
+void PathService::processRequests(const Grid &grid) {
+    prepare(grid);
+    lastExpansions_ = 0;
+
+    // requests to the same goal are processed together
+    std::stable_sort(pending_.begin(), pending_.end(), [](const Request &a, const Request &b) {
+        return a.goal < b.goal;
+    });
+
+    std::vector<unsigned int> starts;
+    std::size_t kept = 0;
+    for (std::size_t first = 0, last = 0; first < pending_.size(); first = last) {
+        last = first;
+        while (last < pending_.size() && pending_[last].goal == pending_[first].goal) {
+            last++;
+        }
+
+        Position goal = pending_[first].goal;
+        if (!isValid(goal)) {
+            for (std::size_t i = first; i < last; i++) {
+                results_[pending_[i].id] = Result{false, {}, 0};
+            }
+            continue;
+        }
+
+        Search &search = getSearch(indexOf(goal));
+        starts.clear();
+        for (std::size_t i = first; i < last; i++) {
+            if (isValid(pending_[i].start)) {
+                starts.push_back(indexOf(pending_[i].start));
+            }
+        }
+        lastExpansions_ += expand(search, starts, expansionsPerRequest_ * static_cast<unsigned int>(last - first));
+
+        for (std::size_t i = first; i < last; i++) {
+            const Request &request = pending_[i];
+            if (!isValid(request.start)) {
+                results_[request.id] = Result{false, {}, 0};
+            } else if (search.closed[indexOf(request.start)] || search.open.empty()) {
+                results_[request.id] = buildResult(search, indexOf(request.start));
+            } else {
+                pending_[kept++] = request;  // out of budget, continued in the next tick
+            }
+        }
+    }
+    pending_.resize(kept);
+}
+
+std::optional<PathService::Result> PathService::takeResult(RequestId id) {
+    auto it = results_.find(id);
+    if (it == results_.end()) {
+        return std::nullopt;
+    }
+    Result result = std::move(it->second);
+    results_.erase(it);
+    return result;
+}
+
+void PathService::invalidate() {
+    searches_.clear();
+    gridVersion_ = std::nullopt;
+}
+
+std::size_t PathService::getPendingCount() const {
+    return pending_.size();
+}
+
+unsigned int PathService::getLastExpansions() const {
+    return lastExpansions_;
+}
+
+void PathService::prepare(const Grid &grid) {
+    if (gridVersion_ == grid.getVersion()) {
+        return;
+    }
+
+    searches_.clear();
+    sizeX_ = grid.getSizeX() - FlowField::FootprintSize + 1;
+    sizeY_ = grid.getSizeY() - FlowField::FootprintSize + 1;
+    costs_.resize(sizeX_ * sizeY_);
+    for (unsigned int x = 0; x < sizeX_; x++)
+        for (unsigned int y = 0; y < sizeY_; y++) {
+            costs_[indexOf({x, y})] = FlowField::computeCost(grid, x, y);
+        }
+    gridVersion_ = grid.getVersion();
+}
+
+PathService::Search &PathService::getSearch(unsigned int goal) {
+    auto it = searches_.find(goal);
+    if (it != searches_.end()) {
+        return it->second;
+    }
+
+    if (searches_.size() >= MaxCachedSearches) {
+        searches_.clear();
+    }
+
+    Search &search = searches_[goal];
+    search.goal = goal;
+    search.distances.assign(costs_.size(), Unvisited);
+    search.parents.assign(costs_.size(), NoParent);
+    search.closed.assign(costs_.size(), false);
+    search.distances[goal] = 0;
+    search.open.emplace_back(0, goal);
+    return search;
+}
+
+unsigned int PathService::expand(Search &search, const std::vector<unsigned int> &starts, unsigned int budget) {
+    // the search runs backwards, from the goal towards starts that haven't been reached yet
+    std::vector<Position> targets;
+    auto retarget = [&]() {
+        targets.clear();
+        for (unsigned int start: starts) {
+            if (!search.closed[start]) {
+                targets.push_back(positionOf(start));
+            }
+        }
+    };
+    auto heuristic = [&](unsigned int index) {
+        std::uint32_t estimate = Unvisited;
+        for (const Position &target: targets) {
+            estimate = std::min(estimate, manhattan(positionOf(index), target));
+        }
+        return estimate;
+    };
+    auto rekey = [&]() {
+        for (auto &entry: search.open) {
+            entry.first = search.distances[entry.second] + heuristic(entry.second);
+        }
+        std::make_heap(search.open.begin(), search.open.end(), std::greater<>());
+    };
+
+    retarget();
+    if (targets.empty()) {
+        return 0;
+    }
+    rekey();
+
+    unsigned int expansions = 0;
+    while (expansions < budget && !search.open.empty()) {
+        std::pop_heap(search.open.begin(), search.open.end(), std::greater<>());
+        unsigned int index = search.open.back().second;
+        search.open.pop_back();
+        if (search.closed[index]) {
+            continue;  // reached at a lower cost before
+        }
+        search.closed[index] = true;
+        expansions++;
+
+        // positions next to this one reach the goal through it
+        Position position = positionOf(index);
+        for (unsigned int direction = 0; direction < 4; direction++) {
+            int x = static_cast<int>(position.first) - stepX[direction];
+            int y = static_cast<int>(position.second) - stepY[direction];
+            if (x < 0 || y < 0 || x >= static_cast<int>(sizeX_) || y >= static_cast<int>(sizeY_)) {
+                continue;
+            }
+            unsigned int neighbour = indexOf({static_cast<unsigned int>(x), static_cast<unsigned int>(y)});
+            std::uint32_t distance = search.distances[index] + costs_[index];
+            if (costs_[neighbour] == FlowField::Unreachable || search.closed[neighbour] ||
+                distance >= search.distances[neighbour]) {
+                continue;
+            }
+            search.distances[neighbour] = distance;
+            search.parents[neighbour] = static_cast<std::uint8_t>(direction);
+            search.open.emplace_back(distance + heuristic(neighbour), neighbour);
+            std::push_heap(search.open.begin(), search.open.end(), std::greater<>());
+        }
+
+        // once a start is reached, the search heads for the remaining ones
+        if (std::find(starts.begin(), starts.end(), index) != starts.end()) {
+            retarget();
+            if (targets.empty()) {
+                break;
+            }
+            rekey();
+        }
+    }
+    return expansions;
+}
+
+PathService::Result PathService::buildResult(const Search &search, unsigned int start) const {
+    if (!search.closed[start]) {
+        return Result{false, {}, 0};
+    }
+
+    Result result{true, {}, search.distances[start]};
+    for (unsigned int index = start; search.parents[index] != NoParent;) {
+        Position position = positionOf(index);
+        result.path.push_back(position);
+        std::uint8_t direction = search.parents[index];
+        index = indexOf({position.first + stepX[direction], position.second + stepY[direction]});
+    }
+    result.path.push_back(positionOf(search.goal));
+    return result;
+}
+
+bool PathService::isValid(Position position) const {
+    return position.first < sizeX_ && position.second < sizeY_ && costs_[indexOf(position)] != FlowField::Unreachable;
+}
+
+unsigned int PathService::indexOf(Position position) const {
+    return position.first * sizeY_ + position.second;
+}
+
+PathService::Position PathService::positionOf(unsigned int index) const {
+    return {index / sizeY_, index % sizeY_};
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+
+#include "include/ScriptScheduler.h"
+#include "include/Bot.h"
+#include "../board-lib/include/Board.h"
+
+ScriptScheduler::~ScriptScheduler() {
+    stopAll();
+}
+
+void ScriptScheduler::start(const std::shared_ptr<Bot> &bot, BotScript script) {
+    unsigned int botId = bot->getBotId();
+    stop(botId);
+
+    BotScript::Handle handle = script.release();
+    if (!handle) {
+        return;
+    }
+    handle.promise().bot = bot;
+    handle.promise().waitId = nextWaitId_++;
+    scripts_[botId] = Script{handle, bot};
+    timers_.push({tick_ + 1, {botId, handle.promise().waitId}});
+}
+
+void ScriptScheduler::stop(unsigned int botId) {
+    // entries left in the queues are skipped, as their wait ids are no longer known
+    destroy(botId);
+}
+
+void ScriptScheduler::stopAll() {
+    for (auto &[botId, script]: scripts_) {
+        script.handle.destroy();
+    }
+    scripts_.clear();
+}
+
+bool ScriptScheduler::hasScript(unsigned int botId) const {
+    return scripts_.count(botId) != 0;
+}
+
+std::size_t ScriptScheduler::getScriptCount() const {
+    return scripts_.size();
+}
+
+std::size_t ScriptScheduler::getLastResumeCount() const {
+    return lastResumeCount_;
+}
+
+void ScriptScheduler::update(BotController &controller) {
+    tick_++;
+    woken_.clear();
+    lastResumeCount_ = 0;
+
+    while (!timers_.empty() && timers_.top().first <= tick_) {
+        Waiting waiting = timers_.top().second;
+        timers_.pop();
+        if (find(waiting) != nullptr) {
+            woken_.push_back(waiting.first);
+        }
+    }
+
+    PathService &pathService = controller.getPathService();
+    std::erase_if(pathWaits_, [&](const std::pair<Waiting, PathService::RequestId> &pathWait) {
+        // results are taken even for stopped scripts, so that the service can forget them
+        std::optional<PathService::Result> result = pathService.takeResult(pathWait.second);
+        if (!result.has_value()) {
+            return false;
+        }
+        Script *script = find(pathWait.first);
+        if (script != nullptr) {
+            script->handle.promise().pathResult = std::move(result);
+            woken_.push_back(pathWait.first.first);
+        }
+        return true;
+    });
+
+    Board *board = controller.getBoard();
+    std::erase_if(sightWaits_, [&](const std::pair<Waiting, unsigned int> &sightWait) {
+        Script *script = find(sightWait.first);
+        if (script == nullptr) {
+            return true;
+        }
+        std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(script->bot.lock());
+        bool sawTarget = false;
+        for (Direction direction: {North, West, South, East}) {
+            if (board != nullptr && tank != nullptr && !sawTarget) {
+                sawTarget = board->findTargetInSight(tank, direction).has_value();
+            }
+        }
+        if (!sawTarget && (sightWait.second == 0 || sightWait.second > tick_)) {
+            return false;
+        }
+        script->handle.promise().sawTarget = sawTarget;
+        woken_.push_back(sightWait.first.first);
+        return true;
+    });
+
+    std::sort(woken_.begin(), woken_.end());
+    std::exception_ptr exception;
+    for (unsigned int botId: woken_) {
+        auto script = scripts_.find(botId);
+        if (script == scripts_.end()) {
+            continue;
+        }
+        if (script->second.bot.expired()) {
+            destroy(botId);
+            continue;
+        }
+
+        BotScript::Handle handle = script->second.handle;
+        handle.resume();
+        lastResumeCount_++;
+
+        // the script may have started scripts of other bots
+        script = scripts_.find(botId);
+        if (handle.done()) {
+            if (handle.promise().exception) {
+                exception = handle.promise().exception;
+            }
+            destroy(botId);
+        } else {
+            file(botId, script->second, controller);
+        }
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+ScriptScheduler::Script *ScriptScheduler::find(const Waiting &waiting) {
+    auto script = scripts_.find(waiting.first);
+    if (script == scripts_.end() || script->second.handle.promise().waitId != waiting.second) {
+        return nullptr;
+    }
+    return &script->second;
+}
+
+void ScriptScheduler::file(unsigned int botId, Script &script, BotController &controller) {
+    BotScript::promise_type &promise = script.handle.promise();
+    promise.waitId = nextWaitId_++;
+    Waiting waiting{botId, promise.waitId};
+    const BotScript::Wait &wait = promise.wait;
+    std::shared_ptr<Bot> bot = script.bot.lock();
+
+    switch (wait.kind) {
+        case BotScript::Wait::Ticks:
+            timers_.push({tick_ + wait.ticks, waiting});
+            break;
+        case BotScript::Wait::Action:
+            if (bot != nullptr) {
+                Direction direction = wait.action == BotController::Decision::Rotate ? wait.direction
+                                                                                       : bot->getFacing();
+                controller.applyDecision({bot, wait.action, direction});
+            }
+            timers_.push({tick_ + 1, waiting});
+            break;
+        case BotScript::Wait::Path:
+            if (bot != nullptr) {
+                pathWaits_.emplace_back(waiting, controller.getPathService().requestPath(
+                        BotController::positionOf(*bot), wait.goal));
+            } else {
+                timers_.push({tick_ + 1, waiting});
+            }
+            break;
+        case BotScript::Wait::Sight:
+            sightWaits_.emplace_back(waiting, wait.ticks != 0 ? tick_ + wait.ticks : 0);
+            break;
+    }
+}
+
+void ScriptScheduler::destroy(unsigned int botId) {
+    auto script = scripts_.find(botId);
+    if (script != scripts_.end()) {
+        script->second.handle.destroy();
+        scripts_.erase(script);
+    }
+}
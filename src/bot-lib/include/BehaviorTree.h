@@ -0,0 +1,191 @@
+#ifndef PROI_PROJEKT_BEHAVIORTREE_H
+#define PROI_PROJEKT_BEHAVIORTREE_H
+
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Exception thrown when a behavior tree description can not be parsed
+ */
+class InvalidBehaviorTreeFile : public std::exception {
+public:
+    explicit InvalidBehaviorTreeFile(std::string message);
+
+    [[nodiscard]] const char *what() const noexcept override;
+
+private:
+    std::string what_message;
+};
+
+/**
+ * \brief Data-driven bot brain
+ *
+ * A tree is described in a text file, one node per line, children indented by two spaces more than their parent.
+ * Empty lines and lines starting with '#' are ignored. Nodes:
+ *  - 'sequence' - runs children in order until one of them fails; resumes at the child that was running
+ *  - 'selector' - runs children in order until one of them succeeds; starts from the first child every time, so
+ *  higher priority children can take over from a running one
+ *  - 'inverter' - swaps success and failure of it's only child
+ *  - 'succeeder' - turns failure of it's only child into success
+ *  - 'chance <percent>' - runs it's only child with the given chance, fails otherwise
+ *  - any other word - a leaf, run by the Executor (see BotController for the leaves bots understand)
+ *
+ * Trees are immutable and can be shared by any number of bots: everything a bot has to remember between ticks is
+ * kept in it's State. Ticking is cooperative: every node costs some budget to run, and a tree that runs out of budget
+ * stops with Running, so the next tick resumes where it stopped.
+ */
+class BehaviorTree {
+public:
+    enum Status {
+        Success,
+        Failure,
+        Running
+    };
+
+    enum NodeType {
+        Sequence,
+        Selector,
+        Inverter,
+        Succeeder,
+        Chance,
+        Leaf
+    };
+
+    /**
+     * A node, stored in pre-order: node's first child directly follows it, and it's subtree takes size nodes
+     */
+    struct Node {
+        NodeType type;
+
+        /**
+         * Leaf's position on the list of leaves the tree was parsed with (for leaves only)
+         */
+        unsigned int leaf;
+
+        /**
+         * Chance in percent (for Chance nodes only)
+         */
+        unsigned int param;
+
+        /**
+         * Number of nodes in the subtree, including the node itself
+         */
+        unsigned int size;
+    };
+
+    /**
+     * What a single bot remembers between ticks of it's tree
+     */
+    struct State {
+        /**
+         * The tree the state belongs to; the state is reset when a different tree ticks it
+         */
+        const BehaviorTree *tree = nullptr;
+
+        /**
+         * Per node: position of the running child of composites (counting from 1), 1 if the child of a decorator is
+         * running, 0 otherwise
+         */
+        std::vector<unsigned int> memory;
+
+        /**
+         * Whether the last tick ran out of budget
+         */
+        bool yielded = false;
+
+        /**
+         * Blackboard: path the bot is following, as tank positions (see PathService)
+         */
+        std::vector<std::pair<unsigned int, unsigned int>> path;
+
+        /**
+         * Blackboard: id of the path request the bot is waiting for
+         */
+        std::optional<unsigned int> pathRequest;
+
+        /**
+         * Blackboard: whether the bot wants a path to be requested for it
+         */
+        bool pathWanted = false;
+
+        /**
+         * Blackboard: whether the last path request found no path
+         */
+        bool pathFailed = false;
+    };
+
+    /**
+     * Runs leaves of a tree for a single bot
+     */
+    class Executor {
+    public:
+        virtual ~Executor() = default;
+
+        /**
+         * Runs a leaf
+         * @param leaf Leaf's position on the list of leaves the tree was parsed with
+         * @param state State of the bot
+         * @return Leaf's status
+         */
+        virtual Status runLeaf(unsigned int leaf, State &state) = 0;
+
+        /**
+         * Returns cost of running a leaf, in budget units
+         * @param leaf Leaf's position on the list of leaves the tree was parsed with
+         */
+        [[nodiscard]] virtual unsigned int getLeafCost(unsigned int leaf) const;
+
+        /**
+         * Returns a random number, used by Chance nodes
+         */
+        virtual unsigned int roll() = 0;
+    };
+
+    /**
+     * Parses a tree
+     * @param input Tree description (see the class description)
+     * @param knownLeaves Names of leaves that may appear in the tree
+     * @throws InvalidBehaviorTreeFile
+     */
+    static std::shared_ptr<const BehaviorTree> parse(std::istream &input, const std::vector<std::string> &knownLeaves);
+
+    /**
+     * Parses a tree from a file
+     * @param filename Path to the file
+     * @param knownLeaves Names of leaves that may appear in the tree
+     * @return The tree, or nullptr if the file could not be opened
+     * @throws InvalidBehaviorTreeFile
+     */
+    static std::shared_ptr<const BehaviorTree> load(const std::string &filename,
+                                                    const std::vector<std::string> &knownLeaves);
+
+    /**
+     * Ticks the tree for a single bot, resuming where the previous tick stopped
+     * @param state State of the bot
+     * @param executor Runs leaves for the bot
+     * @param budget Budget left for the bot; decreased by costs of nodes run. Composite and decorator nodes cost 1
+     * @return Status of the root. Running if the tree is still running, or it ran out of budget (state.yielded is set)
+     */
+    Status tick(State &state, Executor &executor, unsigned int &budget) const;
+
+    [[nodiscard]] const std::vector<Node> &getNodes() const;
+
+protected:
+    BehaviorTree() = default;
+
+    Status tickNode(unsigned int index, State &state, Executor &executor, unsigned int &budget) const;
+
+    /**
+     * Forgets running children of all nodes in a subtree
+     */
+    void resetSubtree(unsigned int index, State &state) const;
+
+    std::vector<Node> nodes_;
+};
+
+
+#endif //PROI_PROJEKT_BEHAVIORTREE_H
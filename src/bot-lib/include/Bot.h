@@ -7,6 +7,7 @@
 
 #include "../../tank-lib/include/Entity.h"
 #include "../../core-lib/include/SimpleSubscriber.h"
+#include "BehaviorTree.h"
 
 class BotController;
 
@@ -18,19 +19,45 @@ public:
     ~Bot() override;
 
     /**
-     * Decreases decision cooldown by 1; queues Event::BotDecisionRequest and re-sets the cooldown after reaching 0
+     * Decreases decision cooldown by 1; requests a decision and re-sets the cooldown after reaching 0
      * @param pub
      */
     void notify(SimplePublisher *pub) override;
 
     /**
-     * Queues an Event::BotDecisionRequest
+     * Schedules a decision for the bot, made during BotController's next decision phase
      */
     void requestDecision();
+
+    /**
+     * Returns bot's id. Ids are given out in the order bots are created, and decide the order in which decisions of
+     * bots are applied
+     * @return
+     */
+    [[nodiscard]] unsigned int getBotId() const;
+
+    /**
+     * Returns what the bot remembers between ticks of it's behavior tree. Only used by BotController
+     * @return
+     */
+    BehaviorTree::State &getTreeState();
+
+    /**
+     * Returns the number of ticks left until the bot requests a decision
+     * @return
+     */
+    [[nodiscard]] unsigned int getDecisionCooldown() const;
+
+    /**
+     * Sets the number of ticks left until the bot requests a decision, used when restoring snapshots
+     * @param cooldown
+     */
+    void setDecisionCooldown(unsigned int cooldown);
 protected:
     Bot()=default;
     /**
-     * Upon creation, subscribes to Clock and increments BotController's bot counter
+     * Upon creation, subscribes to Clock and increments BotController's bot counter. The decision cooldown is taken
+     * from BotController::getDecisionCooldown()
      * @param x
      * @param y
      * @param sizeX
@@ -42,6 +69,10 @@ protected:
     unsigned int maxDecisionCooldown;
     unsigned int decisionCooldown;
     BotController* botController;
+    unsigned int botId_ = nextBotId_++;
+    BehaviorTree::State treeState_;
+
+    static unsigned int nextBotId_;
 };
 
 
@@ -5,15 +5,32 @@
 #ifndef PROI_PROJEKT_BOTCONTROLLER_H
 #define PROI_PROJEKT_BOTCONTROLLER_H
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
 #include <vector>
 #include <queue>
 
 #include "../../core-lib/include/SimpleSubscriber.h"
 #include "../../core-lib/include/EventQueue.h"
 #include "../../core-lib/include/Event.h"
+#include "PathService.h"
+#include "BehaviorTree.h"
+#include "NeuralPolicy.h"
+#include "LookaheadPlanner.h"
 
 class Bot;
+class Entity;
+class ScriptScheduler;
+class WorkerPool;
+class Board;
+class FlowField;
+class SnapshotReader;
+class SnapshotWriter;
 
 /**
  * Exception thrown when trying to spawn a bot, but no spawnpoints were given
@@ -24,21 +41,298 @@ class NoSpawnpointException : public std::exception {
 
 /**
  * Manages Bot objects
+ *
+ * Bots request decisions when their cooldown runs out (requestDecision). All of the requested decisions are made at
+ * once during the decision phase of a tick (makeDueDecisions): the board is frozen while decisions are made (it's only
+ * read through it's const methods), so they can be split between threads of a worker pool. Decisions are then applied
+ * to the board directly, in the order of bot ids, so the outcome does not depend on the number of threads.
+ *
+ * Decisions are made by behavior trees (see BehaviorTree), one per TankType, loaded from files (loadBehaviorTrees).
+ * Leaves bots understand:
+ *  - 'target_in_sight' - succeeds if the player or the eagle is in sight, in any direction
+ *  - 'aim' - fires at a target in sight (turning towards it first if needed), fails if there is none
+ *  - 'follow_flow_field' - follows the flow field towards the eagle, shooting bricks on the way down; fails if there is
+ *  no flow field or the eagle can not be reached
+ *  - 'hunt_player' - follows a path to the player, found by the PathService over the next ticks; running while the
+ *  path is followed, succeeds when it's end is reached, fails if there is no path
+ *  - 'move_forward', 'turn_left', 'turn_right', 'fire' - always succeed
+ *  - 'random' - makes a random decision
+ * A bot gets at most one decision per decision phase: actions that come after the first one in the same phase return
+ * Running, so they are done during the next phase.
+ *
+ * Types can be given learned policies (see NeuralPolicy) instead of trees. Policies see an observation of
+ * ObservationSize values built from the grid around the bot (a window of ObservationWindow x ObservationWindow tiles,
+ * every second tile, 0 for free tiles, 0.5 for bricks and 1 for other obstacles and tiles off the grid), bot's facing
+ * (one-hot), and positions of the player (whether there is one, and it's offset) and of the eagle relative to the bot
+ * (in grid sizes). They score the PolicyActions, and the best one is taken. All bots deciding with the same policy
+ * are evaluated together, in a single batch per decision phase.
+ *
+ * Types can also plan ahead (setLookahead): their bots score the PolicyActions by simulating them a number of ticks
+ * ahead on forks of the board (see LookaheadPlanner). Simulations have their own budget of rollouts
+ * (setLookaheadBudget), bots whose actions were not simulated within it decide with their behavior tree. Lookahead
+ * takes precedence over policies.
+ *
+ * Bots can also run scripts (see BotScript and ScriptScheduler) instead of their trees. Scripts are resumed at the
+ * start of the decision phase.
+ *
+ * Decision phases have a budget shared by all bots (setDecisionBudget), so many bots deciding at once do not cause a
+ * spike: every bot gets a share of it (at least MinBudgetPerBot), and bots that do not fit in the budget, or run out
+ * of their share before making a decision, are deferred to the next phase (before bots that ask later).
  */
 class BotController : public SimpleSubscriber {
 public:
+    /**
+     * A decision made for a bot
+     */
+    struct Decision {
+        enum Action {
+            Move,
+            Rotate,
+            Fire
+        };
+
+        std::shared_ptr<Bot> bot;
+        Action action;
+
+        /**
+         * Direction to rotate to (for Rotate decisions)
+         */
+        Direction direction;
+    };
+
+    /**
+     * Leaves of behavior trees bots understand, in the order of their names in Leaves
+     */
+    enum TreeLeaf : unsigned int {
+        TargetInSight,
+        Aim,
+        FollowFlowField,
+        HuntPlayer,
+        MoveForward,
+        TurnLeft,
+        TurnRight,
+        Fire,
+        RandomAction
+    };
+
+    /**
+     * Names of leaves, as used in behavior tree files
+     */
+    static const std::vector<std::string> Leaves;
+
+    /**
+     * Tree used for types that have no tree of their own: shoot at targets in sight, otherwise follow the flow field
+     * towards the eagle, otherwise move randomly
+     */
+    static const char *const DefaultTree;
+
+    /**
+     * Actions scored by policies
+     */
+    enum PolicyAction : unsigned int {
+        PolicyMove,
+        PolicyRotateNorth,
+        PolicyRotateWest,
+        PolicyRotateSouth,
+        PolicyRotateEast,
+        PolicyFire,
+        PolicyActionCount
+    };
+
+    static constexpr std::size_t ObservationWindow = 9;
+
+    /**
+     * Window, facing, player (presence, X and Y offset), eagle (X and Y offset)
+     */
+    static constexpr std::size_t ObservationSize = ObservationWindow * ObservationWindow + 4 + 3 + 2;
+
+    /**
+     * Minimum share of the decision budget a bot is given in a decision phase
+     */
+    static constexpr unsigned int MinBudgetPerBot = 16;
+
+    /**
+     * Maximum share of the decision budget a bot is given in a decision phase
+     */
+    static constexpr unsigned int MaxBudgetPerBot = 64;
+
+    /**
+     * Default budget of a decision phase
+     */
+    static constexpr unsigned int DefaultDecisionBudget = 2048;
+
+    /**
+     * Default number of rollouts of bots planning ahead per decision phase, enough for every action of 4 bots
+     */
+    static constexpr std::size_t DefaultLookaheadBudget = 24;
+
+    /**
+     * Number of ticks between decisions of a bot, at the tick rate of the spawn cooldown given to ::initialize()
+     */
+    static constexpr unsigned int DefaultDecisionCooldown = 12;
+
     BotController()=delete;
 
     BotController& operator=(const BotController &other)=delete;
 
+    ~BotController();
+
     /**
-     * Analyzes bot's state and makes a decision about what should it do
+     * Analyzes bot's state and makes a decision about what should it do, by ticking the behavior tree of it's type
+     * with MaxBudgetPerBot budget. With the default tree, bots shoot when the player or the eagle is in sight (turning
+     * towards them if needed), otherwise they follow the flow field towards the eagle (turning when needed, and
+     * shooting bricks on their way down), and make random decisions when there is no flow field or the eagle can not
+     * be reached. Bots never shoot blindly if they know the board
      *
-     * Queues Event::BotMove/Rotate/FireDecision
+     * Queues Event::BotMove/Rotate/FireDecision, if a decision is made
      * @param bot
      */
     void makeBotDecision(const std::shared_ptr<Bot>& bot);
 
+    /**
+     * Schedules a decision for a bot, made during the next decision phase (see makeDueDecisions)
+     * @param bot
+     */
+    void requestDecision(const std::shared_ptr<Bot>& bot);
+
+    /**
+     * Returns the number of bots waiting for a decision
+     * @return
+     */
+    [[nodiscard]] std::size_t getDueBotCount() const;
+
+    /**
+     * Runs the decision phase: makes decisions for bots that requested them (see makeBotDecision), within the
+     * decision budget, and applies them to the board (or queues them like makeBotDecision, if the board is unknown or
+     * the bot is not a tank). Bots deferred from earlier phases go first, then the rest in the order of bot ids
+     *
+     * Should be called once per tick, after the clock ticks. Decisions requested while the controller is not counting
+     * (the game is not running) are dropped
+     */
+    void makeDueDecisions();
+
+    /**
+     * Returns the decisions made during the last decision phase, in the order they were applied
+     * @return
+     */
+    [[nodiscard]] const std::vector<Decision>& getLastDecisions() const;
+
+    /**
+     * Sets the number of threads decisions are made on during the decision phase, starting a worker pool if needed
+     * @param threads Number of threads, 1 (the default) makes decisions on the calling thread only
+     */
+    void setDecisionThreads(unsigned int threads);
+
+    /**
+     * Minimum number of bots worth handing over to another thread during the decision phase
+     */
+    static constexpr std::size_t MinBotsPerChunk = 16;
+
+    /**
+     * Sets the budget of a decision phase, in behavior tree cost units (see BehaviorTree::tick)
+     * @param budget Budget, 0 for no limit (every bot gets MaxBudgetPerBot)
+     */
+    void setDecisionBudget(unsigned int budget);
+
+    /**
+     * Returns the number of bots deferred to the next decision phase
+     * @return
+     */
+    [[nodiscard]] std::size_t getDeferredBotCount() const;
+
+    /**
+     * Sets the behavior tree bots of a type decide with
+     * @param type Type of the bots
+     * @param tree The tree, or nullptr to use DefaultTree
+     */
+    void setBehaviorTree(Tank::TankType type, std::shared_ptr<const BehaviorTree> tree);
+
+    /**
+     * Returns the behavior tree bots of a type decide with
+     * @param type Type of the bots
+     * @return
+     */
+    [[nodiscard]] std::shared_ptr<const BehaviorTree> getBehaviorTree(Tank::TankType type) const;
+
+    /**
+     * Loads behavior trees from files <directory>/basic.txt, fast.txt, power.txt and armor.txt. Types without a file,
+     * or with an invalid one, keep their current tree
+     * @param directory Directory with the files
+     * @throws InvalidBehaviorTreeFile after loading the other files, if any file was invalid
+     */
+    void loadBehaviorTrees(const std::string &directory);
+
+    /**
+     * Sets the policy bots of a type decide with, instead of their behavior tree
+     * @param type Type of the bots
+     * @param policy The policy, taking ObservationSize inputs and scoring PolicyActionCount actions, or nullptr to
+     * decide with the behavior tree
+     * @throws InvalidPolicyFile if the policy has a wrong number of inputs or outputs
+     */
+    void setPolicy(Tank::TankType type, std::shared_ptr<const NeuralPolicy> policy);
+
+    /**
+     * Returns the policy bots of a type decide with
+     * @param type Type of the bots
+     * @return The policy, or nullptr if they decide with their behavior tree
+     */
+    [[nodiscard]] std::shared_ptr<const NeuralPolicy> getPolicy(Tank::TankType type) const;
+
+    /**
+     * Loads policies from files <directory>/basic.mlp, fast.mlp, power.mlp and armor.mlp. Types without a file, or
+     * with an invalid one, keep their current policy (or their tree)
+     * @param directory Directory with the files
+     * @throws InvalidPolicyFile after loading the other files, if any file was invalid
+     */
+    void loadPolicies(const std::string &directory);
+
+    /**
+     * Sets whether bots of a type plan ahead with simulations, instead of deciding with their policy or tree
+     * @param type Type of the bots
+     * @param lookahead
+     */
+    void setLookahead(Tank::TankType type, bool lookahead);
+
+    /**
+     * Returns whether bots of a type plan ahead with simulations
+     * @param type Type of the bots
+     * @return
+     */
+    [[nodiscard]] bool isLookahead(Tank::TankType type) const;
+
+    /**
+     * Sets the number of rollouts bots planning ahead may simulate during a decision phase
+     * @param budget The budget, 0 for no limit
+     */
+    void setLookaheadBudget(std::size_t budget);
+
+    /**
+     * Returns the planner simulating actions of bots planning ahead
+     * @return
+     */
+    LookaheadPlanner& getLookaheadPlanner();
+
+    /**
+     * Builds the observation a policy sees for a bot
+     * @param bot
+     * @param observation ObservationSize floats
+     */
+    void buildObservation(const std::shared_ptr<Bot>& bot, float *observation) const;
+
+    /**
+     * Scales the spawn cooldown and the decision cooldown of bots, both counted in ticks at a reference tick rate, so
+     * that they take as long at another tick rate. Bots created earlier keep their decision cooldown
+     * @param referenceTickRate Tick rate the cooldowns were given for
+     * @param ticksPerSecond
+     */
+    void setTickRate(unsigned int referenceTickRate, unsigned int ticksPerSecond);
+
+    /**
+     * Returns the number of ticks between decisions of bots created from now on
+     * @return
+     */
+    [[nodiscard]] unsigned int getDecisionCooldown() const;
+
     /**
      * Increments internal bot counter
      */
@@ -91,9 +385,71 @@ public:
      */
     void setTypes(const std::queue<Tank::TankType> &types);
 
+    /**
+     * Seeds the random generator of decisions and spawnpoints, so a match can be told apart by it's seed
+     * @param seed
+     */
+    void setSeed(std::uint32_t seed);
+
+    /**
+     * Writes spawnpoints, the remaining TankType sequence, the spawn cooldown, the bot counter and the state of the
+     * random generator to a snapshot (see GameSnapshot). Bots waiting for a decision and the state of their behavior
+     * trees and scripts are not saved, restored bots start over
+     * @param writer Snapshot being written
+     */
+    void saveState(SnapshotWriter &writer) const;
+
+    /**
+     * Restores the state written by saveState. Should be called after Board::loadState, as restored bots increment
+     * the bot counter
+     * @param reader Snapshot being read
+     * @throws InvalidSnapshot if the snapshot is broken, the controller is left as it was then
+     */
+    void loadState(SnapshotReader &reader);
+
+    /**
+     * Sets the flow field bots follow towards the eagle
+     * @param flowField Flow field, or nullptr to make random decisions only
+     */
+    void setFlowField(std::shared_ptr<const FlowField> flowField);
+
+    /**
+     * Sets the board bots look for targets on
+     * @param board Board, or nullptr if targets are unknown
+     */
+    void setBoard(Board *board);
+
+    /**
+     * Returns the board bots look for targets on
+     * @return Board pointer, or nullptr
+     */
+    [[nodiscard]] Board *getBoard() const;
+
+    /**
+     * Returns the service bots use to find paths to goals other than the eagle (like the player or cover positions)
+     * Requests are processed once per tick by the game loop
+     * @return Path service
+     */
+    PathService& getPathService();
+
+    /**
+     * Returns the scheduler running scripts of bots
+     * @return
+     */
+    ScriptScheduler& getScriptScheduler();
+
+    /**
+     * Returns the tank position (see PathService) an entity is (mostly) standing on
+     * @param entity
+     * @return
+     */
+    static PathService::Position positionOf(const Entity &entity);
+
     void setCounting(bool counting);
 
 protected:
+    friend class ScriptScheduler;
+
     /**
      * Upon creation, subscribes to Clock
      * @param n_maxRegisteredBots
@@ -105,11 +461,171 @@ protected:
      * If spawnpoints and TankTypes are available, constructs and queues Event::BotSpawnDecision
      */
     void requestSpawnBot();
+
+    /**
+     * Runs leaves of behavior trees for a single bot (defined in BotController.cpp)
+     */
+    class TreeExecutor;
+
+    /**
+     * Makes a decision for a bot by ticking it's behavior tree, only reading the board and the flow field (and
+     * writing bot's tree state)
+     * @param bot
+     * @param roll A random number, used if random choices have to be made
+     * @param budget Budget of the tick
+     * @return The decision, or std::nullopt if the tree made none (check bot's tree state to see if it yielded)
+     */
+    [[nodiscard]] std::optional<Decision> decide(const std::shared_ptr<Bot>& bot, unsigned int roll,
+                                                 unsigned int budget) const;
+
+    /**
+     * Makes decisions for bots from batch_, in the range [begin, end)
+     * @param budget Budget of every bot
+     */
+    void decideRange(std::size_t begin, std::size_t end, unsigned int budget);
+
+    /**
+     * Makes a random decision
+     * @param bot
+     * @param roll A random number, picks moving forward for 0-3 (mod 8), turning left for 4, right for 5 and firing
+     * for 6-7
+     * @return
+     */
+    [[nodiscard]] Decision makeRandomDecision(const std::shared_ptr<Bot>& bot, unsigned int roll) const;
+
+    /**
+     * If a target is in sight of a bot, decides to shoot at it (or to turn towards it first)
+     * @param bot
+     * @return The decision, or std::nullopt if no target is in sight
+     */
+    [[nodiscard]] std::optional<Decision> aimAtTarget(const std::shared_ptr<Bot>& bot) const;
+
+    /**
+     * Assigns admitted bots of batch_ deciding with policies to rows of policy batches, and remembers positions of
+     * the player and the eagle for their observations
+     * @param admitted Number of admitted bots
+     */
+    void preparePolicyBatches(std::size_t admitted);
+
+    /**
+     * Evaluates policy batches and turns their scores into decisions
+     */
+    void evaluatePolicyBatches();
+
+    /**
+     * Simulates actions of admitted bots planning ahead and turns their scores into decisions. Bots none of whose
+     * actions were simulated in time decide with their tree
+     * @param budget Budget of every bot, for the trees
+     */
+    void planLookahead(unsigned int budget);
+
+    /**
+     * Takes the best scored PolicyAction (the first one of equally scored). Rotating to the direction the bot is
+     * facing means moving forward
+     * @param bot
+     * @param scores PolicyActionCount scores
+     * @return
+     */
+    [[nodiscard]] static Decision policyDecision(const std::shared_ptr<Bot>& bot, const float *scores);
+
+    /**
+     * Bots deciding with the same policy during a decision phase
+     */
+    struct PolicyBatch {
+        const NeuralPolicy *policy;
+
+        /**
+         * Positions of the bots in batch_
+         */
+        std::vector<std::size_t> members;
+        std::vector<float> inputs;
+        std::vector<float> outputs;
+        NeuralPolicy::Workspace workspace;
+    };
+
+    /**
+     * Decides how to follow the flow field towards the eagle
+     * @param bot
+     * @return The decision, or std::nullopt if there is no flow field or the eagle can not be reached
+     */
+    [[nodiscard]] std::optional<Decision> followFlowField(const std::shared_ptr<Bot>& bot) const;
+
+    /**
+     * Decides how to follow the path to the player from bot's tree state, or asks for such a path
+     * @param bot
+     * @param state Bot's tree state
+     * @param decision Set to the decision, if one is made
+     * @return Status of the 'hunt_player' leaf
+     */
+    BehaviorTree::Status huntPlayer(const std::shared_ptr<Bot>& bot, BehaviorTree::State &state,
+                                    std::optional<Decision> &decision) const;
+
+    /**
+     * Collects the result of bot's path request (if it's ready), and requests a path to the player if the bot wants
+     * one. Not thread-safe, called before and after decisions are made
+     * @param bot
+     */
+    void exchangePaths(const std::shared_ptr<Bot>& bot);
+
+    /**
+     * Applies a decision to the board
+     */
+    void applyDecision(const Decision &decision);
+
+    /**
+     * Queues Event::BotMove/Rotate/FireDecision for a decision
+     */
+    void queueDecision(const Decision &decision);
+
     std::vector<std::pair<unsigned int, unsigned int>> spawnpoints_;
     std::queue<Tank::TankType> types_{};
+    std::shared_ptr<const FlowField> flowField_;
+    Board *board_ = nullptr;
+
+    std::shared_ptr<const BehaviorTree> defaultTree_;
+    std::map<Tank::TankType, std::shared_ptr<const BehaviorTree>> trees_;
+    std::map<Tank::TankType, std::shared_ptr<const NeuralPolicy>> policies_;
+    std::vector<PolicyBatch> policyBatches_;
+
+    /**
+     * Marks of admitted bots in policyRows_ that do not decide with a policy
+     */
+    static constexpr int TreeBatch = -1;
+    static constexpr int LookaheadBatch = -2;
+
+    /**
+     * Per admitted bot: it's policy batch (or TreeBatch, LookaheadBatch) and row in the batch
+     */
+    std::vector<std::pair<int, std::size_t>> policyRows_;
+    std::optional<PathService::Position> observedPlayer_;
+    PathService::Position observedEagle_;
+
+    std::set<Tank::TankType> lookaheadTypes_;
+    std::unique_ptr<LookaheadPlanner> planner_;
+
+    /**
+     * Positions of admitted bots planning ahead in batch_, their entities and scores of their actions
+     */
+    std::vector<std::size_t> lookaheadMembers_;
+    std::vector<const Entity *> lookaheadBots_;
+    std::vector<LookaheadPlanner::Scores> lookaheadScores_;
+
+    std::vector<std::weak_ptr<Bot>> dueBots_;
+    std::vector<std::weak_ptr<Bot>> deferredBots_;
+    std::vector<std::shared_ptr<Bot>> batch_;
+    std::vector<unsigned int> rolls_;
+    std::vector<std::optional<Decision>> results_;
+    std::vector<Decision> decisions_;
+    unsigned int decisionBudget_ = DefaultDecisionBudget;
+    std::unique_ptr<WorkerPool> workerPool_;
+    std::unique_ptr<ScriptScheduler> scriptScheduler_;
+    std::minstd_rand random_;
+    PathService pathService_;
 
+    unsigned int referenceSpawnCooldown_;
     unsigned int maxSpawnCooldown;
     unsigned int spawnCooldown;
+    unsigned int decisionCooldown_ = DefaultDecisionCooldown;
     unsigned int maxRegisteredBots_;
     unsigned int registeredBots_;
 
@@ -0,0 +1,250 @@
+#ifndef PROI_PROJEKT_BOTSCRIPT_H
+#define PROI_PROJEKT_BOTSCRIPT_H
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+
+#include "BotController.h"
+#include "PathService.h"
+
+class Bot;
+
+/**
+ * \brief Scripted bot behaviour, written as a coroutine
+ *
+ * A script is a coroutine returning BotScript, started for a bot with ScriptScheduler::start. Scripts co_await the
+ * awaitables below; the scheduler resumes a script only when the condition it waits for is met, so a waiting script
+ * costs nothing until then:
+ * <pre>
+ * BotScript guard(PathService::Position post) {
+ *     co_await BotScript::pathTo(post);
+ *     while (true) {
+ *         if (co_await BotScript::targetInSight(120)) {
+ *             co_await BotScript::fire();
+ *         } else {
+ *             co_await BotScript::rotate(South);
+ *         }
+ *     }
+ * }
+ * </pre>
+ * Frames of scripts are allocated from FramePool::instance(), so scripts should only be created on the main thread.
+ */
+class BotScript {
+public:
+    /**
+     * What a suspended script waits for
+     */
+    struct Wait {
+        enum Kind {
+            /**
+             * A number of ticks (ticks)
+             */
+            Ticks,
+
+            /**
+             * A decision to be applied (action, direction), the script is resumed on the next tick
+             */
+            Action,
+
+            /**
+             * A path to be found (goal)
+             */
+            Path,
+
+            /**
+             * A target to come into sight, or a number of ticks to pass (ticks, 0 for no limit)
+             */
+            Sight
+        };
+
+        Kind kind = Ticks;
+        unsigned int ticks = 1;
+        BotController::Decision::Action action = BotController::Decision::Move;
+        Direction direction = North;
+        PathService::Position goal;
+    };
+
+    struct promise_type {
+        BotScript get_return_object();
+
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception();
+
+        static void *operator new(std::size_t size);
+
+        static void operator delete(void *pointer, std::size_t size);
+
+        /**
+         * The bot running the script, set by the scheduler
+         */
+        std::weak_ptr<Bot> bot;
+
+        Wait wait;
+
+        /**
+         * Identifies the current wait, so the scheduler can skip outdated entries
+         */
+        std::uint64_t waitId = 0;
+
+        std::optional<PathService::Result> pathResult;
+        bool sawTarget = false;
+        std::exception_ptr exception;
+    };
+
+    typedef std::coroutine_handle<promise_type> Handle;
+
+    /**
+     * Awaitable suspending the script with a wait, returning nothing
+     */
+    struct WaitAwaiter {
+        Wait wait;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(Handle handle) const noexcept {
+            handle.promise().wait = wait;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * Awaitable waiting for a path, returning it
+     */
+    struct PathAwaiter {
+        Wait wait;
+        Handle handle;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(Handle n_handle) noexcept {
+            handle = n_handle;
+            handle.promise().wait = wait;
+        }
+
+        PathService::Result await_resume() const;
+    };
+
+    /**
+     * Awaitable waiting for a target to come into sight, returning whether one did before the time ran out
+     */
+    struct SightAwaiter {
+        Wait wait;
+        Handle handle;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(Handle n_handle) noexcept {
+            handle = n_handle;
+            handle.promise().wait = wait;
+        }
+
+        [[nodiscard]] bool await_resume() const;
+    };
+
+    /**
+     * Awaitable returning the bot running the script, without suspending it
+     */
+    struct SelfAwaiter {
+        Handle handle;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(Handle n_handle) noexcept {
+            handle = n_handle;
+            return false;
+        }
+
+        [[nodiscard]] std::shared_ptr<Bot> await_resume() const;
+    };
+
+    /**
+     * Waits a number of ticks
+     * @param ticks Number of ticks, at least 1
+     */
+    static WaitAwaiter waitTicks(unsigned int ticks);
+
+    /**
+     * Makes the bot move forward, resumes on the next tick
+     */
+    static WaitAwaiter move();
+
+    /**
+     * Makes the bot rotate, resumes on the next tick
+     * @param direction Direction to rotate to
+     */
+    static WaitAwaiter rotate(Direction direction);
+
+    /**
+     * Makes the bot fire, resumes on the next tick
+     */
+    static WaitAwaiter fire();
+
+    /**
+     * Asks the PathService for a path from bot's current position, resumes when it's found (in a later tick)
+     * @param goal Goal tank position
+     * @return The path
+     */
+    static PathAwaiter pathTo(PathService::Position goal);
+
+    /**
+     * Waits until a target (see Board::findTargetInSight) is in sight of the bot, in any direction
+     * @param timeout Maximum number of ticks to wait, 0 for no limit
+     * @return Whether a target came into sight
+     */
+    static SightAwaiter targetInSight(unsigned int timeout = 0);
+
+    /**
+     * Returns the bot running the script
+     */
+    static SelfAwaiter self();
+
+    BotScript() = default;
+
+    explicit BotScript(Handle handle);
+
+    BotScript(const BotScript &other) = delete;
+
+    BotScript &operator=(const BotScript &other) = delete;
+
+    BotScript(BotScript &&other) noexcept;
+
+    BotScript &operator=(BotScript &&other) noexcept;
+
+    /**
+     * Destroys the coroutine frame, if still owned
+     */
+    ~BotScript();
+
+    /**
+     * Gives up ownership of the coroutine frame
+     * @return Coroutine's handle
+     */
+    Handle release();
+
+private:
+    Handle handle_;
+};
+
+
+#endif //PROI_PROJEKT_BOTSCRIPT_H
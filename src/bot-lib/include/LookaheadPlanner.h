@@ -0,0 +1,162 @@
+#ifndef PROI_PROJEKT_LOOKAHEADPLANNER_H
+#define PROI_PROJEKT_LOOKAHEADPLANNER_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "../../board-lib/include/SimulatedWorld.h"
+
+class Board;
+class Entity;
+class FlowField;
+class WorkerPool;
+
+/**
+ * \brief Chooses actions of bots by simulating their outcomes (Monte-Carlo lookahead)
+ *
+ * Once per decision phase, the board is captured into a SimulatedWorld. For every bot, the part of the world around it
+ * is forked, and every candidate action is rolled out for a number of ticks: the bot takes the action, then keeps
+ * driving forwards and firing whenever it can, while everything else keeps doing what it was doing. Outcomes are scored from the bot's point of
+ * view (see the scores below), events that happen sooner counting more.
+ *
+ * Bots are spread across a WorkerPool. Planning has a budget of rollouts, given out to bots in their order before any
+ * of them is planned: actions of bots past the budget are not rolled out, and are left without a score. Scores do not
+ * depend on the speed of the machine or the number of threads, so replays of a match stay the same.
+ */
+class LookaheadPlanner {
+public:
+    /**
+     * Candidate actions, in the order of BotController::PolicyAction
+     */
+    enum Action : unsigned int {
+        Move,
+        RotateNorth,
+        RotateWest,
+        RotateSouth,
+        RotateEast,
+        Fire,
+        ActionCount
+    };
+
+    /**
+     * Scores of actions of a bot, NotScored for actions that were not rolled out
+     */
+    typedef std::array<float, ActionCount> Scores;
+
+    static constexpr float NotScored = -1e30f;
+
+    static constexpr unsigned int DefaultRolloutTicks = 40;
+
+    /**
+     * Entities further from the bot (in tiles) are left out of it's rollouts, except for the player and the eagle
+     */
+    static constexpr int ForkRadius = 16;
+
+    static constexpr float EagleScore = 1000.0f;
+    static constexpr float PlayerHitScore = 500.0f;
+    static constexpr float DeathScore = -800.0f;
+
+    /**
+     * Score of getting a unit of flow field distance closer to the eagle
+     */
+    static constexpr float ProgressScore = 2.0f;
+
+    LookaheadPlanner();
+
+    ~LookaheadPlanner();
+
+    /**
+     * Sets the number of ticks every action is rolled out for
+     * @param ticks
+     */
+    void setRolloutTicks(unsigned int ticks);
+
+    /**
+     * Sets the number of rollouts plan may run
+     * @param budget The budget, or 0 for no limit
+     */
+    void setRolloutBudget(std::size_t budget);
+
+    [[nodiscard]] std::size_t getRolloutBudget() const;
+
+    /**
+     * Captures the board rollouts start from. The board must not change until plan returns
+     * @param board The board
+     * @param flowField Flow field measuring progress towards the eagle, may be nullptr
+     */
+    void capture(Board &board, const FlowField *flowField);
+
+    /**
+     * Scores candidate actions of bots
+     * @param bots Entities of the bots, captured with the board
+     * @param pool Workers to spread bots across, or nullptr to plan on the calling thread
+     * @param scores Set to scores of every bot (all NotScored for bots that were not captured)
+     */
+    void plan(const std::vector<const Entity *> &bots, WorkerPool *pool, std::vector<Scores> &scores);
+
+    /**
+     * Returns the number of rollouts finished during the last call to plan
+     */
+    [[nodiscard]] std::size_t getLastRolloutCount() const;
+
+    /**
+     * Returns the number of rollouts not started during the last call to plan, as the budget ran out
+     */
+    [[nodiscard]] std::size_t getLastAbandonedCount() const;
+
+protected:
+    /**
+     * Worlds used by a worker
+     */
+    struct Scratch {
+        SimulatedWorld local;
+        SimulatedWorld rollout;
+        std::vector<std::uint32_t> players;
+    };
+
+    /**
+     * Scores actions of a single bot
+     * @param root Index of the bot in the captured world
+     * @param scratch Worlds to use
+     * @param allowance Number of actions that may be rolled out
+     * @param scores Set to the scores
+     * @return Numbers of finished and abandoned rollouts
+     */
+    std::pair<std::size_t, std::size_t> planBot(std::uint32_t root, Scratch &scratch, std::size_t allowance,
+                                                Scores &scores);
+
+    /**
+     * Returns whether an action of a tank is worth rolling out: turning to the direction it is facing is the same as
+     * moving, and it can not fire while it's bullet is flying
+     */
+    static bool isCandidate(const SimulatedWorld::Entities &entities, std::uint32_t tank, unsigned int action);
+
+    /**
+     * Returns the flow field distance from a tank's position to the eagle, or std::nullopt if it is unknown
+     */
+    [[nodiscard]] std::optional<float> distanceOf(const SimulatedWorld &world, std::uint32_t tank) const;
+
+    std::unique_ptr<Scratch> takeScratch();
+
+    void returnScratch(std::unique_ptr<Scratch> scratch);
+
+    SimulatedWorld world_;
+    const FlowField *flowField_ = nullptr;
+    unsigned int rolloutTicks_ = DefaultRolloutTicks;
+    std::size_t rolloutBudget_ = 0;
+    std::vector<std::optional<std::uint32_t>> roots_;
+    std::vector<std::size_t> allowances_;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Scratch>> scratch_;
+    std::size_t rollouts_ = 0;
+    std::size_t abandoned_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_LOOKAHEADPLANNER_H
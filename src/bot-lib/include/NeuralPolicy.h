@@ -0,0 +1,131 @@
+#ifndef PROI_PROJEKT_NEURALPOLICY_H
+#define PROI_PROJEKT_NEURALPOLICY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Exception thrown when a policy file can not be loaded, or layers of a policy do not fit together
+ */
+class InvalidPolicyFile : public std::exception {
+public:
+    explicit InvalidPolicyFile(std::string message);
+
+    [[nodiscard]] const char *what() const noexcept override;
+
+private:
+    std::string what_message;
+};
+
+/**
+ * \brief Learned bot policy: a small multi-layer perceptron evaluated on the CPU
+ *
+ * Hidden layers use ReLU, the output layer is linear (one score per action). Policies are evaluated for whole batches
+ * of observations at once (a matrix-matrix product per layer), with kernels vectorized with AVX2 or SSE2 (depending on
+ * the target instruction set), with a scalar fallback. Every kernel adds the products in the same order, so results
+ * are identical regardless of the kernel used.
+ *
+ * Policy files are flat binary files, in the byte order of the machine:
+ *  - uint32 Magic, uint32 FileVersion
+ *  - uint32 number of layers L, followed by L + 1 uint32 layer sizes (inputs first)
+ *  - for every layer: float weights[outputs][inputs], then float biases[outputs]
+ */
+class NeuralPolicy {
+public:
+    /**
+     * "TMLP"
+     */
+    static constexpr std::uint32_t Magic = 0x504c4d54;
+    static constexpr std::uint32_t FileVersion = 1;
+
+    /**
+     * Rows of activations are padded to a multiple of Lanes floats, the width of the widest kernel
+     */
+    static constexpr std::size_t Lanes = 8;
+
+    struct Layer {
+        std::size_t inputs;
+        std::size_t outputs;
+
+        /**
+         * Row-major, outputs x inputs
+         */
+        std::vector<float> weights;
+        std::vector<float> biases;
+    };
+
+    /**
+     * Scratch space used during evaluation, kept between calls to avoid allocations. One workspace per thread
+     */
+    struct Workspace {
+        std::vector<float> front;
+        std::vector<float> back;
+    };
+
+    /**
+     * Builds a policy
+     * @param layers Layers, from the input one; outputs of every layer must match inputs of the next one
+     * @throws InvalidPolicyFile
+     */
+    explicit NeuralPolicy(const std::vector<Layer> &layers);
+
+    /**
+     * Loads a policy from a file
+     * @param filename Path to the file
+     * @return The policy, or nullptr if the file could not be opened
+     * @throws InvalidPolicyFile
+     */
+    static std::shared_ptr<const NeuralPolicy> load(const std::string &filename);
+
+    /**
+     * Saves layers of a policy to a file
+     * @param filename Path to the file
+     * @param layers Layers, like in the constructor
+     * @return Whether the file was written
+     */
+    static bool save(const std::string &filename, const std::vector<Layer> &layers);
+
+    [[nodiscard]] std::size_t getInputSize() const;
+
+    [[nodiscard]] std::size_t getOutputSize() const;
+
+    /**
+     * Returns the distance between rows of inputs passed to evaluate, in floats
+     */
+    [[nodiscard]] std::size_t getInputStride() const;
+
+    /**
+     * Returns the distance between rows of outputs written by evaluate, in floats
+     */
+    [[nodiscard]] std::size_t getOutputStride() const;
+
+    /**
+     * Evaluates the policy for a batch of observations
+     * @param inputs count rows of getInputSize() floats, getInputStride() floats apart (padding is not read)
+     * @param count Number of rows
+     * @param outputs count rows of getOutputSize() scores, written getOutputStride() floats apart
+     * @param workspace Scratch space
+     */
+    void evaluate(const float *inputs, std::size_t count, float *outputs, Workspace &workspace) const;
+
+protected:
+    /**
+     * A layer, with weights transposed (inputs x paddedOutputs) and padded with zeros
+     */
+    struct PackedLayer {
+        std::size_t inputs;
+        std::size_t outputs;
+        std::size_t inputStride;
+        std::size_t outputStride;
+        std::vector<float> weights;
+        std::vector<float> biases;
+    };
+
+    std::vector<PackedLayer> layers_;
+};
+
+
+#endif //PROI_PROJEKT_NEURALPOLICY_H
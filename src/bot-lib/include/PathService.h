@@ -0,0 +1,167 @@
+#ifndef PROI_PROJEKT_PATHSERVICE_H
+#define PROI_PROJEKT_PATHSERVICE_H
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Grid;
+
+/**
+ * \brief Answers batched path queries of bots
+ *
+ * Bots request paths between tank positions (coords of tank's top left tile, like in FlowField) and collect the
+ * results on later ticks. Requests are processed once per tick (processRequests):
+ * - requests leading to the same goal share a single A* search, run backwards from the goal towards all of their
+ * starts at once (the heuristic is the distance to the closest start that has not been reached yet)
+ * - searches are cached per goal, so a later request to the same goal is answered from the cache, or continues the
+ * cached search where it stopped
+ * - every pending request adds expansionsPerRequest node expansions to the budget of it's search, so the time spent
+ * in a tick is bounded even if many bots request paths at once; searches that run out of budget continue on the next
+ * tick
+ *
+ * Positions are weighted the same way as in FlowField. The cache is dropped whenever the grid changes (it is keyed on
+ * grid's version), and can be dropped explicitly with invalidate.
+ */
+class PathService {
+public:
+    typedef std::pair<unsigned int, unsigned int> Position;
+    typedef unsigned int RequestId;
+
+    /**
+     * A path found for a request
+     */
+    struct Result {
+        /**
+         * Whether the goal can be reached from the start
+         */
+        bool found;
+
+        /**
+         * Positions from the start to the goal (both included), empty if no path was found
+         */
+        std::vector<Position> path;
+
+        /**
+         * Cost of the path (see FlowField::getCost)
+         */
+        std::uint32_t cost;
+    };
+
+    /**
+     * Maximum number of goals searches are cached for, the cache is dropped when it's exceeded
+     */
+    static constexpr std::size_t MaxCachedSearches = 32;
+
+    /**
+     * @param expansionsPerRequest Number of search node expansions each pending request may use per tick
+     */
+    explicit PathService(unsigned int expansionsPerRequest = 128);
+
+    /**
+     * Queues a path request, processed during the next call to processRequests
+     * @param start Starting position
+     * @param goal Goal position
+     * @return Request's id, used to collect the result
+     */
+    RequestId requestPath(Position start, Position goal);
+
+    /**
+     * Runs searches for pending requests, within their budget
+     * @param grid The grid paths are searched on
+     */
+    void processRequests(const Grid &grid);
+
+    /**
+     * Returns the result of a request and forgets it. Results that are not ready yet are not affected
+     * @param id Request's id
+     * @return The result, or std::nullopt if the request is still pending (or it's id is unknown)
+     */
+    std::optional<Result> takeResult(RequestId id);
+
+    /**
+     * Drops all cached searches, should be called when the grid changes
+     * Pending requests are kept, and searched for again
+     */
+    void invalidate();
+
+    /**
+     * Returns the number of requests that are still pending
+     */
+    [[nodiscard]] std::size_t getPendingCount() const;
+
+    /**
+     * Returns the number of node expansions made during the last call to processRequests
+     */
+    [[nodiscard]] unsigned int getLastExpansions() const;
+
+protected:
+    struct Request {
+        RequestId id;
+        Position start;
+        Position goal;
+    };
+
+    /**
+     * State of a search from a single goal, kept between ticks
+     */
+    struct Search {
+        unsigned int goal;
+        std::vector<std::uint32_t> distances;
+        std::vector<std::uint8_t> parents;
+        std::vector<bool> closed;
+
+        /**
+         * Min-heap of (estimated total cost, position index) pairs
+         */
+        std::vector<std::pair<std::uint32_t, unsigned int>> open;
+    };
+
+    /**
+     * Drops the cache if the grid changed since it was filled, and computes position costs if needed
+     */
+    void prepare(const Grid &grid);
+
+    /**
+     * Returns the cached search from a goal, creating it if needed
+     */
+    Search &getSearch(unsigned int goal);
+
+    /**
+     * Expands nodes of a search until all starts are reached, or the budget is spent
+     * @return Number of expansions made
+     */
+    unsigned int expand(Search &search, const std::vector<unsigned int> &starts, unsigned int budget);
+
+    /**
+     * Builds the result for a start that has been reached (or can not be reached) by a search
+     */
+    Result buildResult(const Search &search, unsigned int start) const;
+
+    /**
+     * Checks whether a position lies on the grid and can be taken by a tank
+     */
+    [[nodiscard]] bool isValid(Position position) const;
+
+    [[nodiscard]] unsigned int indexOf(Position position) const;
+
+    [[nodiscard]] Position positionOf(unsigned int index) const;
+
+    unsigned int expansionsPerRequest_;
+    unsigned int lastExpansions_ = 0;
+    RequestId nextId_ = 0;
+
+    std::vector<Request> pending_;
+    std::unordered_map<RequestId, Result> results_;
+
+    unsigned int sizeX_ = 0;
+    unsigned int sizeY_ = 0;
+    std::vector<std::uint16_t> costs_;
+    std::unordered_map<unsigned int, Search> searches_;
+    std::optional<unsigned int> gridVersion_;
+};
+
+
+#endif //PROI_PROJEKT_PATHSERVICE_H
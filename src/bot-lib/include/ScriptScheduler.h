@@ -0,0 +1,130 @@
+#ifndef PROI_PROJEKT_SCRIPTSCHEDULER_H
+#define PROI_PROJEKT_SCRIPTSCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BotScript.h"
+
+class Bot;
+class BotController;
+
+/**
+ * \brief Runs BotScripts of bots
+ *
+ * Scripts are resumed once per tick by BotController's decision phase (update), in the order of bot ids, and only
+ * when the condition they wait for is met:
+ * - scripts waiting for ticks (or for an action to be done) sleep in a timer queue, so waiting costs nothing per tick
+ * - scripts waiting for paths are resumed when the PathService has a result for them
+ * - scripts waiting for a target to come into sight are the only ones checked every tick
+ *
+ * Bots running a script do not get decisions from their behavior tree. A script ends when it returns, or when it's
+ * bot is destroyed.
+ */
+class ScriptScheduler {
+public:
+    ScriptScheduler() = default;
+
+    ScriptScheduler(const ScriptScheduler &other) = delete;
+
+    ScriptScheduler &operator=(const ScriptScheduler &other) = delete;
+
+    /**
+     * Destroys all scripts
+     */
+    ~ScriptScheduler();
+
+    /**
+     * Starts a script for a bot, replacing the one it's running. The script is first resumed on the next update
+     * @param bot
+     * @param script
+     */
+    void start(const std::shared_ptr<Bot> &bot, BotScript script);
+
+    /**
+     * Stops the script of a bot
+     * @param botId Bot's id
+     */
+    void stop(unsigned int botId);
+
+    /**
+     * Stops all scripts
+     */
+    void stopAll();
+
+    /**
+     * Checks whether a bot runs a script
+     * @param botId Bot's id
+     */
+    [[nodiscard]] bool hasScript(unsigned int botId) const;
+
+    /**
+     * Returns the number of running scripts
+     */
+    [[nodiscard]] std::size_t getScriptCount() const;
+
+    /**
+     * Returns the number of scripts resumed during the last update
+     */
+    [[nodiscard]] std::size_t getLastResumeCount() const;
+
+    /**
+     * Advances to the next tick, and resumes scripts whose condition is met. Actions of scripts are applied to the
+     * board through the controller. An exception thrown by a script ends it, and is rethrown after the update
+     * @param controller Controller providing the board and the path service
+     */
+    void update(BotController &controller);
+
+protected:
+    struct Script {
+        BotScript::Handle handle;
+        std::weak_ptr<Bot> bot;
+    };
+
+    /**
+     * An entry of a wait queue: bot's id and the id of the wait it was made for
+     */
+    typedef std::pair<unsigned int, std::uint64_t> Waiting;
+
+    /**
+     * Returns the script of a bot, if it still waits for the given wait
+     */
+    Script *find(const Waiting &waiting);
+
+    /**
+     * Files a suspended script in the queue of the condition it waits for
+     */
+    void file(unsigned int botId, Script &script, BotController &controller);
+
+    /**
+     * Destroys the frame of a script and forgets it
+     */
+    void destroy(unsigned int botId);
+
+    std::unordered_map<unsigned int, Script> scripts_;
+
+    /**
+     * Min-heap of (tick, bot's id, wait id)
+     */
+    std::priority_queue<std::pair<unsigned int, Waiting>, std::vector<std::pair<unsigned int, Waiting>>,
+            std::greater<>> timers_;
+    std::vector<std::pair<Waiting, PathService::RequestId>> pathWaits_;
+
+    /**
+     * (bot's id and wait id, deadline tick or 0)
+     */
+    std::vector<std::pair<Waiting, unsigned int>> sightWaits_;
+
+    std::vector<unsigned int> woken_;
+    std::uint64_t nextWaitId_ = 1;
+    unsigned int tick_ = 0;
+    std::size_t lastResumeCount_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_SCRIPTSCHEDULER_H
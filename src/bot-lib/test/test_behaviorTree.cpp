@@ -0,0 +1,244 @@
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/BehaviorTree.h"
+
+namespace {
+    namespace helper {
+        const std::vector<std::string> leaves{"ok", "fail", "wait", "act"};
+
+        /**
+         * Leaves: 'ok' succeeds, 'fail' fails, 'wait' is running until it's run three times, 'act' succeeds;
+         * every run leaf is written down
+         */
+        class TestExecutor : public BehaviorTree::Executor {
+        public:
+            BehaviorTree::Status runLeaf(unsigned int leaf, BehaviorTree::State &state) override {
+                runs.push_back(leaves[leaf]);
+                switch (leaf) {
+                    case 1:
+                        return BehaviorTree::Failure;
+                    case 2:
+                        return ++waits % 3 == 0 ? BehaviorTree::Success : BehaviorTree::Running;
+                    default:
+                        return BehaviorTree::Success;
+                }
+            }
+
+            [[nodiscard]] unsigned int getLeafCost(unsigned int leaf) const override {
+                return leaf == 3 ? 5 : 1;
+            }
+
+            unsigned int roll() override {
+                return nextRoll;
+            }
+
+            std::vector<std::string> runs;
+            unsigned int waits = 0;
+            unsigned int nextRoll = 0;
+        };
+
+        std::shared_ptr<const BehaviorTree> parse(const std::string &description) {
+            std::istringstream input(description);
+            return BehaviorTree::parse(input, leaves);
+        }
+
+        BehaviorTree::Status tick(const std::shared_ptr<const BehaviorTree> &tree, BehaviorTree::State &state,
+                                  TestExecutor &executor, unsigned int budget = 100) {
+            executor.runs.clear();
+            return tree->tick(state, executor, budget);
+        }
+    }
+}
+
+SCENARIO("Parsing behavior trees") {
+    GIVEN("A valid description") {
+        auto tree = helper::parse("# comment\n"
+                                  "selector\n"
+                                  "  sequence\n"
+                                  "    ok\n"
+                                  "\n"
+                                  "    chance 40\n"
+                                  "      act\n"
+                                  "  inverter\n"
+                                  "    fail\n");
+
+        THEN("Nodes should be stored in pre-order, with sizes of their subtrees") {
+            const std::vector<BehaviorTree::Node> &nodes = tree->getNodes();
+            REQUIRE(nodes.size() == 7);
+            REQUIRE(nodes[0].type == BehaviorTree::Selector);
+            REQUIRE(nodes[0].size == 7);
+            REQUIRE(nodes[1].type == BehaviorTree::Sequence);
+            REQUIRE(nodes[1].size == 4);
+            REQUIRE(nodes[2].type == BehaviorTree::Leaf);
+            REQUIRE(nodes[2].leaf == 0);
+            REQUIRE(nodes[3].type == BehaviorTree::Chance);
+            REQUIRE(nodes[3].param == 40);
+            REQUIRE(nodes[4].leaf == 3);
+            REQUIRE(nodes[5].type == BehaviorTree::Inverter);
+            REQUIRE(nodes[5].size == 2);
+            REQUIRE(nodes[6].leaf == 1);
+        }
+    }
+
+    GIVEN("Invalid descriptions") {
+        THEN("An exception should be thrown") {
+            REQUIRE_THROWS_AS(helper::parse(""), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("selector\n  jump\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("selector\n   ok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("selector\n    ok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("ok\nok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("sequence\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("inverter\n  ok\n  ok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("ok\n  ok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("chance\n  ok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("chance 101\n  ok\n"), InvalidBehaviorTreeFile);
+            REQUIRE_THROWS_AS(helper::parse("ok now\n"), InvalidBehaviorTreeFile);
+        }
+
+        THEN("The message should point at the line") {
+            try {
+                helper::parse("selector\n  ok\n  jump\n");
+                FAIL("no exception");
+            } catch (const InvalidBehaviorTreeFile &e) {
+                REQUIRE(std::string(e.what()).find("Line 3") != std::string::npos);
+            }
+        }
+    }
+
+    THEN("Missing files should not be loaded") {
+        REQUIRE(BehaviorTree::load("./no/such/tree.txt", helper::leaves) == nullptr);
+    }
+}
+
+SCENARIO("Ticking behavior trees") {
+    helper::TestExecutor executor;
+    BehaviorTree::State state;
+
+    GIVEN("A sequence with a running child") {
+        auto tree = helper::parse("sequence\n"
+                                  "  ok\n"
+                                  "  wait\n"
+                                  "  act\n");
+
+        WHEN("The tree is ticked") {
+            BehaviorTree::Status status = helper::tick(tree, state, executor);
+
+            THEN("It should stop at the running child") {
+                REQUIRE(status == BehaviorTree::Running);
+                REQUIRE(executor.runs == std::vector<std::string>{"ok", "wait"});
+                REQUIRE_FALSE(state.yielded);
+
+                AND_WHEN("It is ticked again") {
+                    helper::tick(tree, state, executor);
+                    status = helper::tick(tree, state, executor);
+
+                    THEN("It should resume at the running child, and finish after it") {
+                        REQUIRE(executor.runs == std::vector<std::string>{"wait", "act"});
+                        REQUIRE(status == BehaviorTree::Success);
+
+                        AND_THEN("The next tick should start from the beginning") {
+                            helper::tick(tree, state, executor);
+                            REQUIRE(executor.runs.front() == "ok");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("A selector with a running low priority child") {
+        auto tree = helper::parse("selector\n"
+                                  "  chance 50\n"
+                                  "    act\n"
+                                  "  sequence\n"
+                                  "    ok\n"
+                                  "    wait\n"
+                                  "    act\n");
+        executor.nextRoll = 99;
+        REQUIRE(helper::tick(tree, state, executor) == BehaviorTree::Running);
+        REQUIRE(executor.runs == std::vector<std::string>{"ok", "wait"});
+
+        WHEN("The higher priority child succeeds") {
+            executor.nextRoll = 0;
+            BehaviorTree::Status status = helper::tick(tree, state, executor);
+
+            THEN("It should take over, and the running child should be interrupted") {
+                REQUIRE(status == BehaviorTree::Success);
+                REQUIRE(executor.runs == std::vector<std::string>{"act"});
+
+                executor.nextRoll = 99;
+                helper::tick(tree, state, executor);
+                REQUIRE(executor.runs == std::vector<std::string>{"ok", "wait"});
+            }
+        }
+
+        WHEN("The higher priority child fails") {
+            helper::tick(tree, state, executor);
+
+            THEN("The running child should be resumed") {
+                REQUIRE(executor.runs == std::vector<std::string>{"wait"});
+            }
+        }
+    }
+
+    GIVEN("Decorators") {
+        THEN("They should change the status of their child") {
+            REQUIRE(helper::tick(helper::parse("inverter\n  ok\n"), state, executor) == BehaviorTree::Failure);
+            REQUIRE(helper::tick(helper::parse("inverter\n  fail\n"), state, executor) == BehaviorTree::Success);
+            REQUIRE(helper::tick(helper::parse("succeeder\n  fail\n"), state, executor) == BehaviorTree::Success);
+            REQUIRE(helper::tick(helper::parse("inverter\n  wait\n"), state, executor) == BehaviorTree::Running);
+
+            executor.nextRoll = 39;
+            REQUIRE(helper::tick(helper::parse("chance 40\n  ok\n"), state, executor) == BehaviorTree::Success);
+            executor.nextRoll = 40;
+            REQUIRE(helper::tick(helper::parse("chance 40\n  ok\n"), state, executor) == BehaviorTree::Failure);
+            REQUIRE(executor.runs.empty());
+        }
+    }
+
+    GIVEN("A tree more expensive than the budget") {
+        auto tree = helper::parse("sequence\n"
+                                  "  act\n"
+                                  "  act\n"
+                                  "  act\n");
+
+        WHEN("The tree is ticked with a small budget") {
+            unsigned int budget = 8;
+            executor.runs.clear();
+            BehaviorTree::Status status = tree->tick(state, executor, budget);
+
+            THEN("It should stop when the budget runs out") {
+                REQUIRE(status == BehaviorTree::Running);
+                REQUIRE(state.yielded);
+                REQUIRE(executor.runs.size() == 1);
+                REQUIRE(budget == 2);
+
+                AND_WHEN("It is ticked again") {
+                    budget = 12;
+                    status = tree->tick(state, executor, budget);
+
+                    THEN("It should carry on where it stopped") {
+                        REQUIRE(status == BehaviorTree::Success);
+                        REQUIRE_FALSE(state.yielded);
+                        REQUIRE(executor.runs.size() == 3);
+                        REQUIRE(budget == 1);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("A state used by another tree") {
+        helper::tick(helper::parse("sequence\n  ok\n  wait\n"), state, executor);
+
+        THEN("The state should be reset for the new tree") {
+            auto tree = helper::parse("sequence\n  act\n");
+            REQUIRE(helper::tick(tree, state, executor) == BehaviorTree::Success);
+            REQUIRE(state.memory.size() == 2);
+            REQUIRE(state.tree == tree.get());
+        }
+    }
+}
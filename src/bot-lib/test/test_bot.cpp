@@ -17,7 +17,7 @@ namespace {
     namespace helper {
         class TestBot : public Bot {
         public:
-            TestBot() : Bot(1, 1, 1, 1, 1, North) {}
+            TestBot() : Entity(1, 1, 1, 1, 1, North), Bot(1, 1, 1, 1, 1, North) {}
 
             bool move() override {}
 
@@ -85,31 +85,44 @@ SCENARIO("Bot asking the controller for decision") {
         WHEN("A required amount of time passes") {
             for (int i = 0; i < bot->getMaxDecisionCooldown() - 1; ++i) {
                 clock->tick();
-                REQUIRE(eventQueue->isEmpty());
+                REQUIRE(botController->getDueBotCount() == 0);
             }
             clock->tick();
-            THEN("Bot should add an event to the queue") {
-                REQUIRE_FALSE(eventQueue->isEmpty());
-                auto event = eventQueue->pop();
-
-                REQUIRE(event->type == Event::BotDecisionRequest);
-                REQUIRE((event->info.botInfo.bot) == std::static_pointer_cast<Bot>(bot));
-
+            THEN("Bot should be scheduled for a decision, without queueing any events") {
+                REQUIRE(botController->getDueBotCount() == 1);
                 REQUIRE(eventQueue->isEmpty());
 
-                AND_WHEN("The samee amount of time passes again") {
-                    for (int i = 0; i < bot->getMaxDecisionCooldown() - 1; ++i) {
-                        clock->tick();
-                        REQUIRE(eventQueue->isEmpty());
+                AND_WHEN("The decision phase runs") {
+                    botController->setCounting(true);
+                    botController->makeDueDecisions();
+                    botController->setCounting(false);
+
+                    THEN("The decision should be made for the bot") {
+                        REQUIRE(botController->getDueBotCount() == 0);
+                        REQUIRE(botController->getLastDecisions().size() == 1);
+                        REQUIRE(botController->getLastDecisions().front().bot == std::static_pointer_cast<Bot>(bot));
+                        eventQueue->clear();
+
+                        AND_WHEN("The samee amount of time passes again") {
+                            for (int i = 0; i < bot->getMaxDecisionCooldown() - 1; ++i) {
+                                clock->tick();
+                                REQUIRE(botController->getDueBotCount() == 0);
+                            }
+                            clock->tick();
+                            THEN("Bot should be scheduled again") {
+                                REQUIRE(botController->getDueBotCount() == 1);
+                                botController->makeDueDecisions();
+                            }
+                        }
                     }
-                    clock->tick();
-                    THEN("Bot should add an event to the queue") {
-                        REQUIRE_FALSE(eventQueue->isEmpty());
-                        event = eventQueue->pop();
+                }
 
-                        REQUIRE(event->type == Event::BotDecisionRequest);
-                        REQUIRE((event->info.botInfo.bot) == std::static_pointer_cast<Bot>(bot));
+                AND_WHEN("The decision phase runs while the game is not running") {
+                    botController->makeDueDecisions();
 
+                    THEN("The request should be dropped") {
+                        REQUIRE(botController->getDueBotCount() == 0);
+                        REQUIRE(botController->getLastDecisions().empty());
                         REQUIRE(eventQueue->isEmpty());
                     }
                 }
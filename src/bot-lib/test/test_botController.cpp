@@ -2,6 +2,10 @@
 // Created by tomek on 06.06.2022.
 //
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/catch_all.hpp"
 
@@ -10,12 +14,16 @@
 #include "../../core-lib/include/Clock.h"
 #include "../../core-lib/include/EventQueue.h"
 #include "../../core-lib/include/Event.h"
+#include "../../board-lib/include/Grid.h"
+#include "../../board-lib/include/FlowField.h"
+#include "../../board-lib/include/Board.h"
+#include "../../tank-lib/include/Tank.h"
 
 namespace {
     namespace helper {
         class TestBot : public Bot {
         public:
-            TestBot() : Bot(1, 1, 1, 1, 1, North) {}
+            TestBot() : Entity(1, 1, 1, 1, 1, North), Bot(1, 1, 1, 1, 1, North) {}
 
             bool move() override {}
 
@@ -32,6 +40,17 @@ namespace {
             unsigned int getMaxDecisionCooldown() {
                 return maxDecisionCooldown;
             }
+
+            void face(Direction direction) {
+                facing_ = direction;
+            }
+        };
+
+        class TestGrid : public Grid {
+        public:
+            TestGrid() {
+                eagleLocation = {24, 48};
+            }
         };
 
         EventQueue<Event> *getEmptyEventQueue() {
@@ -40,6 +59,13 @@ namespace {
             return eventQueue;
         }
 
+        class TestBotController : public BotController {
+        public:
+            TestBotController() : BotController(4, 240) {}
+
+            using BotController::makeRandomDecision;
+        };
+
         BotController *getEmptyBotController() {
             BotController *botController = BotController::instance();
             botController->deregisterAllBots();
@@ -51,6 +77,33 @@ namespace {
             BotController::initialize(4, 240);
             BotController::instance()->subscribe(Clock::instance());
         }
+
+        /**
+         * Lets a new controller seeded with the seed spawn 8 tanks, on one of 4 spawnpoints each
+         * @return Columns of the spawnpoints, in the order they were picked
+         */
+        std::vector<unsigned int> spawnColumns(std::uint32_t seed) {
+            Clock::initialize(60);
+            BotController::initialize(4, 5);
+            BotController::instance()->subscribe(Clock::instance());
+            BotController::instance()->setCounting(true);
+            BotController::instance()->setSeed(seed);
+            BotController::instance()->setSpawnpoints({{0, 0}, {10, 0}, {20, 0}, {30, 0}});
+            std::deque<Tank::TankType> types(8, Tank::BasicTank);
+            BotController::instance()->setTypes(std::queue<Tank::TankType>(types));
+            EventQueue<Event>::instance()->clear();
+            for (int i = 0; i < 40; i++) {
+                Clock::instance()->tick();
+            }
+            std::vector<unsigned int> columns;
+            while (!EventQueue<Event>::instance()->isEmpty()) {
+                std::unique_ptr<Event> event = EventQueue<Event>::instance()->pop();
+                if (event->type == Event::BotSpawnDecision) {
+                    columns.push_back(event->info.spawnDecisionInfo.x);
+                }
+            }
+            return columns;
+        }
     }
 }
 
@@ -157,13 +210,28 @@ SCENARIO("Requesting to spawn tanks") {
     }
 }
 
+SCENARIO("Seeding the controller") {
+    GIVEN("Controllers seeded with the same seed, and one with another seed") {
+        std::vector<unsigned int> first = helper::spawnColumns(7);
+        std::vector<unsigned int> second = helper::spawnColumns(7);
+        std::vector<unsigned int> other = helper::spawnColumns(8);
+
+        THEN("The same spawnpoints should be picked with the same seed") {
+            REQUIRE(first.size() == 8);
+            REQUIRE(first == second);
+            REQUIRE(first != other);
+        }
+    }
+    helper::initSingletons();
+}
+
 SCENARIO("Making random bot decisions") {
     GIVEN("Some objects") {
         Clock::initialize(60);
         auto clock = Clock::instance();
         auto eventQueue = helper::getEmptyEventQueue();
+        BotController::initialize(4, 2);
         auto botController = helper::getEmptyBotController();
-        botController->initialize(4, 2);
 
         std::shared_ptr<helper::TestBot> bot = std::make_shared<helper::TestBot>();
 
@@ -196,4 +264,456 @@ SCENARIO("Making random bot decisions") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Turning bots at random") {
+    GIVEN("A bot facing North") {
+        helper::initSingletons();
+        helper::TestBotController botController;
+        std::shared_ptr<helper::TestBot> bot = std::make_shared<helper::TestBot>();
+
+        WHEN("It turns left or right at random") {
+            BotController::Decision left = botController.makeRandomDecision(bot, 4);
+            BotController::Decision right = botController.makeRandomDecision(bot, 5);
+
+            THEN("It should turn the same way as with turn_left and turn_right leaves") {
+                REQUIRE(left.action == BotController::Decision::Rotate);
+                REQUIRE(left.direction == West);
+                REQUIRE(right.action == BotController::Decision::Rotate);
+                REQUIRE(right.direction == East);
+            }
+        }
+    }
+}
+
+SCENARIO("Making bot decisions with a flow field") {
+    GIVEN("A bot and a flow field leading towards the eagle") {
+        auto eventQueue = helper::getEmptyEventQueue();
+        auto botController = BotController::instance();
+
+        helper::TestGrid grid{};
+        auto flowField = std::make_shared<FlowField>();
+        flowField->rebuild(grid);
+        botController->setFlowField(flowField);
+
+        std::shared_ptr<helper::TestBot> bot = std::make_shared<helper::TestBot>();
+        eventQueue->clear();
+
+        WHEN("The bot is not facing the direction of the field") {
+            botController->makeBotDecision(bot);
+
+            THEN("It should turn") {
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::BotRotateDecision);
+                REQUIRE(event->info.rotateDecisionInfo.bot == bot);
+                REQUIRE(event->info.rotateDecisionInfo.direction == South);
+            }
+        }
+
+        WHEN("The bot is facing the direction of the field") {
+            bot->face(South);
+            botController->makeBotDecision(bot);
+
+            THEN("It should move forward") {
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::BotMoveDecision);
+                REQUIRE(event->info.moveDecisionInfo.flag == true);
+            }
+        }
+
+        WHEN("There are bricks in front of the bot") {
+            for (unsigned int x = 0; x < 52; x++) {
+                grid.setTile(x, 5, Bricks);
+            }
+            flowField->rebuild(grid);
+            eventQueue->clear();
+
+            bot->face(South);
+            botController->makeBotDecision(bot);
+
+            THEN("It should shoot them") {
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::BotFireDecision);
+                REQUIRE(event->info.fireDecisionInfo.bot == bot);
+            }
+        }
+
+        botController->setFlowField(nullptr);
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Aiming at targets in sight") {
+    helper::initSingletons();
+    GIVEN("A board with a bot and the player") {
+        auto eventQueue = helper::getEmptyEventQueue();
+        auto botController = BotController::instance();
+        Board board{};
+        REQUIRE(botController->getBoard() == &board);
+
+        board.spawnTank(10, 10, Tank::BasicTank, East);
+        std::shared_ptr<Bot> bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+        board.spawnPlayer(30, 10, West);
+        std::shared_ptr<Entity> player = eventQueue->pop()->info.entityInfo.entity;
+        eventQueue->clear();
+
+        WHEN("The bot is facing the player") {
+            botController->makeBotDecision(bot);
+
+            THEN("It should fire") {
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::BotFireDecision);
+                REQUIRE(event->info.fireDecisionInfo.bot == bot);
+            }
+        }
+
+        WHEN("The player is beside the bot") {
+            player->setFixedX(FixedPoint::fromTiles(10));
+            player->setFixedY(FixedPoint::fromTiles(30));
+            board.moveAllEntities();
+            botController->makeBotDecision(bot);
+
+            THEN("It should turn towards the player") {
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::BotRotateDecision);
+                REQUIRE(event->info.rotateDecisionInfo.direction == South);
+            }
+        }
+
+        WHEN("A wall stands between the bot and the player") {
+            for (unsigned int y = 0; y < 52; y++) {
+                board.getGrid()->setTile(20, y, Steel);
+            }
+            eventQueue->clear();
+
+            THEN("It should never fire") {
+                for (int i = 0; i < 30; i++) {
+                    botController->makeBotDecision(bot);
+                    REQUIRE(eventQueue->pop()->type != Event::BotFireDecision);
+                }
+            }
+        }
+
+        eventQueue->clear();
+    }
+
+    THEN("The board should be detached from the controller after it's destroyed") {
+        REQUIRE(BotController::instance()->getBoard() == nullptr);
+    }
+}
+
+SCENARIO("Making due decisions in a batch") {
+    helper::initSingletons();
+    GIVEN("A board with the player and a column of bots, one of them facing the player") {
+        auto eventQueue = helper::getEmptyEventQueue();
+        auto botController = BotController::instance();
+        Board board{};
+
+        board.spawnPlayer(40, 20, West);
+        std::vector<std::shared_ptr<Bot>> bots;
+        for (unsigned int y = 0; y < 48; y += 4) {
+            board.spawnTank(4, y, Tank::BasicTank, East);
+        }
+        while (!eventQueue->isEmpty()) {
+            auto bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+            if (bot != nullptr) {
+                bots.push_back(bot);
+            }
+        }
+        std::shared_ptr<Tank> facingBot = std::dynamic_pointer_cast<Tank>(bots[5]);  // at 4, 20
+
+        for (const std::shared_ptr<Bot> &bot: bots) {
+            botController->requestDecision(bot);
+        }
+        botController->setCounting(true);
+
+        WHEN("Making decisions on a single thread") {
+            botController->makeDueDecisions();
+
+            THEN("Every bot should get a decision, applied to the board right away") {
+                const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                REQUIRE(decisions.size() == bots.size());
+                for (std::size_t i = 0; i < bots.size(); i++) {
+                    REQUIRE(decisions[i].bot == bots[i]);
+                }
+                REQUIRE(decisions[5].action == BotController::Decision::Fire);
+                REQUIRE(facingBot->getBullet().has_value());
+                REQUIRE(botController->getDueBotCount() == 0);
+            }
+        }
+
+        WHEN("Making decisions on many threads") {
+            botController->setDecisionThreads(4);
+            botController->makeDueDecisions();
+            botController->setDecisionThreads(1);
+
+            THEN("Every bot should still get it's decision, in the order they were requested") {
+                const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                REQUIRE(decisions.size() == bots.size());
+                for (std::size_t i = 0; i < bots.size(); i++) {
+                    REQUIRE(decisions[i].bot == bots[i]);
+                    REQUIRE(decisions[i].action != BotController::Decision::Fire || i == 5);
+                }
+                REQUIRE(decisions[5].action == BotController::Decision::Fire);
+                REQUIRE(facingBot->getBullet().has_value());
+            }
+        }
+
+        WHEN("Bots ask for decisions in a different order") {
+            botController->makeDueDecisions();
+            for (auto bot = bots.rbegin(); bot != bots.rend(); bot++) {
+                botController->requestDecision(*bot);
+            }
+            botController->setDecisionThreads(4);
+            botController->makeDueDecisions();
+            botController->setDecisionThreads(1);
+
+            THEN("Decisions should still be made in the order of bot ids") {
+                const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                REQUIRE(decisions.size() == bots.size());
+                for (std::size_t i = 1; i < decisions.size(); i++) {
+                    REQUIRE(decisions[i - 1].bot->getBotId() < decisions[i].bot->getBotId());
+                }
+            }
+        }
+
+        botController->setCounting(false);
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Deciding with behavior trees") {
+    helper::initSingletons();
+    GIVEN("A board with the player and bots of different types") {
+        auto eventQueue = helper::getEmptyEventQueue();
+        auto botController = BotController::instance();
+        Board board{};
+
+        board.spawnPlayer(4, 40, North);
+        board.spawnTank(4, 4, Tank::ArmorTank, North);
+        board.spawnTank(20, 4, Tank::FastTank, East);
+        board.spawnTank(36, 4, Tank::BasicTank, West);
+        std::vector<std::shared_ptr<Bot>> bots;
+        while (!eventQueue->isEmpty()) {
+            auto bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+            if (bot != nullptr) {
+                bots.push_back(bot);
+            }
+        }
+        REQUIRE(bots.size() == 3);
+        std::shared_ptr<Bot> armorBot = bots[0];
+        std::shared_ptr<Bot> fastBot = bots[1];
+        botController->setCounting(true);
+
+        auto setTree = [&](Tank::TankType type, const std::string &description) {
+            std::istringstream input(description);
+            botController->setBehaviorTree(type, BehaviorTree::parse(input, BotController::Leaves));
+        };
+        auto decideFor = [&](const std::shared_ptr<Bot> &bot) {
+            botController->requestDecision(bot);
+            botController->makeDueDecisions();
+            const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+            return decisions.empty() ? std::nullopt : std::optional<BotController::Decision>(decisions.front());
+        };
+
+        WHEN("A type has no tree of it's own") {
+            THEN("The default tree should be used") {
+                REQUIRE(botController->getBehaviorTree(Tank::BasicTank)->getNodes().size() == 4);
+            }
+        }
+
+        WHEN("A tree does more than one action") {
+            setTree(Tank::FastTank, "sequence\n"
+                                    "  turn_left\n"
+                                    "  fire\n");
+
+            THEN("Actions should be spread over consecutive decisions") {
+                std::optional<BotController::Decision> decision = decideFor(fastBot);
+                REQUIRE(decision.has_value());
+                REQUIRE(decision->action == BotController::Decision::Rotate);
+                REQUIRE(decision->direction == North);
+                REQUIRE(fastBot->getFacing() == North);
+
+                decision = decideFor(fastBot);
+                REQUIRE(decision.has_value());
+                REQUIRE(decision->action == BotController::Decision::Fire);
+
+                AND_THEN("Other types should not be affected") {
+                    REQUIRE(botController->getBehaviorTree(Tank::BasicTank)->getNodes().size() == 4);
+                    REQUIRE(decideFor(bots[2]).has_value());
+                }
+            }
+        }
+
+        WHEN("A bot hunts the player") {
+            setTree(Tank::ArmorTank, "hunt_player\n");
+
+            THEN("It should wait for the path to be found first") {
+                REQUIRE_FALSE(decideFor(armorBot).has_value());
+                REQUIRE(armorBot->getTreeState().pathRequest.has_value());
+
+                for (int i = 0; i < 20 && botController->getPathService().getPendingCount() != 0; i++) {
+                    botController->getPathService().processRequests(*board.getGrid());
+                }
+
+                AND_THEN("Follow it towards the player") {
+                    std::optional<BotController::Decision> decision = decideFor(armorBot);
+                    REQUIRE(decision.has_value());
+                    REQUIRE(decision->action == BotController::Decision::Rotate);
+                    REQUIRE(decision->direction == South);
+                    REQUIRE(armorBot->getTreeState().path.back() == std::make_pair(4u, 40u));
+
+                    decision = decideFor(armorBot);
+                    REQUIRE(decision->action == BotController::Decision::Move);
+                    REQUIRE(decision->direction == South);
+                }
+            }
+        }
+
+        WHEN("Trees are loaded from files") {
+            std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_trees";
+            std::filesystem::create_directories(directory);
+            std::ofstream(directory / "fast.txt") << "# always fire\nfire\n";
+            std::ofstream(directory / "armor.txt") << "move_forward\n";
+            botController->loadBehaviorTrees(directory.string());
+
+            THEN("Types with a file should use it") {
+                REQUIRE(decideFor(fastBot)->action == BotController::Decision::Fire);
+                REQUIRE(decideFor(armorBot)->action == BotController::Decision::Move);
+                REQUIRE(botController->getBehaviorTree(Tank::PowerTank)->getNodes().size() == 4);
+            }
+
+            AND_WHEN("A file is invalid") {
+                std::ofstream(directory / "power.txt") << "selector\n";
+
+                THEN("An exception should be thrown") {
+                    REQUIRE_THROWS_AS(botController->loadBehaviorTrees(directory.string()), InvalidBehaviorTreeFile);
+                }
+
+                THEN("The type should keep it's tree, and the other files should still be loaded") {
+                    std::ofstream(directory / "basic.txt") << "fire\n";
+                    REQUIRE_THROWS_AS(botController->loadBehaviorTrees(directory.string()), InvalidBehaviorTreeFile);
+                    REQUIRE(botController->getBehaviorTree(Tank::PowerTank)->getNodes().size() == 4);
+                    REQUIRE(botController->getBehaviorTree(Tank::BasicTank)->getNodes().size() == 1);
+                }
+            }
+            std::filesystem::remove_all(directory);
+        }
+
+        for (Tank::TankType type: {Tank::BasicTank, Tank::FastTank, Tank::PowerTank, Tank::ArmorTank}) {
+            botController->setBehaviorTree(type, nullptr);
+        }
+        botController->setCounting(false);
+        botController->makeDueDecisions();
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Sharing the decision budget") {
+    helper::initSingletons();
+    GIVEN("A board with many bots asking for decisions at once") {
+        auto eventQueue = helper::getEmptyEventQueue();
+        auto botController = BotController::instance();
+        Board board{};
+
+        for (unsigned int y = 0; y < 48; y += 4) {
+            board.spawnTank(4, y, Tank::BasicTank, East);
+        }
+        std::vector<std::shared_ptr<Bot>> bots;
+        while (!eventQueue->isEmpty()) {
+            bots.push_back(std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity));
+        }
+        REQUIRE(bots.size() == 12);
+        botController->setCounting(true);
+        botController->setDecisionBudget(5 * BotController::MinBudgetPerBot);
+
+        WHEN("The budget is too small for all of them") {
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                botController->requestDecision(bot);
+            }
+            botController->makeDueDecisions();
+
+            THEN("Only some of them should decide, the rest should be deferred") {
+                REQUIRE(botController->getLastDecisions().size() == 5);
+                REQUIRE(botController->getLastDecisions().front().bot == bots[0]);
+                REQUIRE(botController->getDeferredBotCount() == 7);
+
+                AND_WHEN("All of them ask again") {
+                    for (const std::shared_ptr<Bot> &bot: bots) {
+                        botController->requestDecision(bot);
+                    }
+                    botController->makeDueDecisions();
+
+                    THEN("Deferred bots should go first") {
+                        const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                        REQUIRE(decisions.size() == 5);
+                        for (std::size_t i = 0; i < decisions.size(); i++) {
+                            REQUIRE(decisions[i].bot == bots[5 + i]);
+                        }
+                        REQUIRE(botController->getDeferredBotCount() == 7);
+                    }
+                }
+            }
+        }
+
+        WHEN("The budget is not limited") {
+            botController->setDecisionBudget(0);
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                botController->requestDecision(bot);
+            }
+            botController->makeDueDecisions();
+
+            THEN("All of them should decide") {
+                REQUIRE(botController->getLastDecisions().size() == 12);
+                REQUIRE(botController->getDeferredBotCount() == 0);
+            }
+        }
+
+        botController->setDecisionBudget(BotController::DefaultDecisionBudget);
+        botController->setCounting(false);
+        botController->makeDueDecisions();
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Benchmarking the decision phase", "[.][benchmark]") {
+    helper::initSingletons();
+    GIVEN("Boards with the player and many bots") {
+        auto eventQueue = helper::getEmptyEventQueue();
+        auto botController = BotController::instance();
+
+        for (unsigned int botCount: {50u, 500u, 5000u}) {
+            Board board{};
+            board.spawnPlayer(24, 40, North);
+            std::vector<std::shared_ptr<Bot>> bots;
+            for (unsigned int i = 0; i < botCount; i++) {
+                board.spawnTank((i * 7) % 48, (i * 13) % 36, Tank::BasicTank, static_cast<Direction>(i % 4));
+            }
+            while (!eventQueue->isEmpty()) {
+                auto bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+                if (bot != nullptr) {
+                    bots.push_back(bot);
+                }
+            }
+            botController->setCounting(true);
+
+            botController->setDecisionBudget(0);
+            for (unsigned int threads: {1u, 2u, 4u, 8u, 16u}) {
+                botController->setDecisionThreads(threads);
+                BENCHMARK(std::to_string(botCount) + " bots, " + std::to_string(threads) + " threads") {
+                    for (const std::shared_ptr<Bot> &bot: bots) {
+                        botController->requestDecision(bot);
+                    }
+                    botController->makeDueDecisions();
+                    eventQueue->clear();
+                    return botController->getLastDecisions().size();
+                };
+            }
+
+            botController->setDecisionThreads(1);
+            botController->setDecisionBudget(BotController::DefaultDecisionBudget);
+            botController->setCounting(false);
+            eventQueue->clear();
+        }
+    }
+}
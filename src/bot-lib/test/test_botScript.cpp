@@ -0,0 +1,212 @@
+#include <stdexcept>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Bot.h"
+#include "../include/BotController.h"
+#include "../include/BotScript.h"
+#include "../include/ScriptScheduler.h"
+#include "../../core-lib/include/Clock.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/FramePool.h"
+#include "../../board-lib/include/Board.h"
+#include "../../tank-lib/include/Tank.h"
+
+namespace {
+    namespace helper {
+        BotScript rotateWaitAndFire(int *progress) {
+            co_await BotScript::rotate(East);
+            *progress = 1;
+            co_await BotScript::waitTicks(3);
+            *progress = 2;
+            co_await BotScript::fire();
+            *progress = 3;
+        }
+
+        BotScript sleep(unsigned int ticks) {
+            co_await BotScript::waitTicks(ticks);
+        }
+
+        BotScript findPath(PathService::Position goal, std::optional<PathService::Result> *result) {
+            *result = co_await BotScript::pathTo(goal);
+        }
+
+        BotScript watch(unsigned int timeout, int *seen) {
+            *seen = co_await BotScript::targetInSight(timeout) ? 1 : 0;
+        }
+
+        BotScript whoAmI(std::shared_ptr<Bot> *self) {
+            *self = co_await BotScript::self();
+        }
+
+        BotScript fail() {
+            co_await BotScript::waitTicks(1);
+            throw std::runtime_error("script failed");
+        }
+
+        void initSingletons() {
+            Clock::initialize(60);
+            BotController::initialize(4, 240);
+        }
+
+        std::vector<std::shared_ptr<Bot>> takeSpawnedBots(EventQueue<Event> *eventQueue) {
+            std::vector<std::shared_ptr<Bot>> bots;
+            while (!eventQueue->isEmpty()) {
+                auto bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+                if (bot != nullptr) {
+                    bots.push_back(bot);
+                }
+            }
+            return bots;
+        }
+    }
+}
+
+SCENARIO("Running bot scripts") {
+    helper::initSingletons();
+    GIVEN("A board with the player and two bots, one of them in line with the player") {
+        auto eventQueue = EventQueue<Event>::instance();
+        eventQueue->clear();
+        auto botController = BotController::instance();
+        ScriptScheduler &scheduler = botController->getScriptScheduler();
+        Board board{};
+
+        board.spawnPlayer(30, 10, West);
+        board.spawnTank(10, 10, Tank::BasicTank, North);
+        board.spawnTank(10, 40, Tank::BasicTank, North);
+        std::vector<std::shared_ptr<Bot>> bots = helper::takeSpawnedBots(eventQueue);
+        REQUIRE(bots.size() == 2);
+        std::shared_ptr<Tank> tank = std::dynamic_pointer_cast<Tank>(bots[0]);
+        botController->setCounting(true);
+
+        WHEN("A script with a few steps is started") {
+            int progress = 0;
+            scheduler.start(bots[0], helper::rotateWaitAndFire(&progress));
+            REQUIRE(scheduler.hasScript(bots[0]->getBotId()));
+            REQUIRE(progress == 0);
+
+            THEN("It should do one step at a time, sleeping in between") {
+                botController->makeDueDecisions();
+                REQUIRE(tank->getFacing() == East);
+                REQUIRE(progress == 0);
+
+                botController->makeDueDecisions();
+                REQUIRE(progress == 1);
+
+                botController->makeDueDecisions();
+                botController->makeDueDecisions();
+                REQUIRE(progress == 1);
+                REQUIRE(scheduler.getLastResumeCount() == 0);
+
+                botController->makeDueDecisions();
+                REQUIRE(progress == 2);
+                REQUIRE(tank->getBullet().has_value());
+
+                botController->makeDueDecisions();
+                REQUIRE(progress == 3);
+                REQUIRE_FALSE(scheduler.hasScript(bots[0]->getBotId()));
+            }
+        }
+
+        WHEN("A bot running a script asks for a decision") {
+            scheduler.start(bots[0], helper::sleep(100));
+            botController->requestDecision(bots[0]);
+            botController->requestDecision(bots[1]);
+            botController->makeDueDecisions();
+
+            THEN("Only the other bot should get a decision from it's tree") {
+                REQUIRE(botController->getLastDecisions().size() == 1);
+                REQUIRE(botController->getLastDecisions().front().bot == bots[1]);
+            }
+        }
+
+        WHEN("Scripts wait for a target to come into sight") {
+            int seenFirst = -1;
+            int seenSecond = -1;
+            scheduler.start(bots[0], helper::watch(0, &seenFirst));
+            scheduler.start(bots[1], helper::watch(5, &seenSecond));
+            for (int i = 0; i < 10; i++) {
+                botController->makeDueDecisions();
+            }
+
+            THEN("The one in line with the player should see it, the other one should time out") {
+                REQUIRE(seenFirst == 1);
+                REQUIRE(seenSecond == 0);
+                REQUIRE(scheduler.getScriptCount() == 0);
+            }
+        }
+
+        WHEN("A script waits for a path") {
+            std::optional<PathService::Result> result;
+            scheduler.start(bots[1], helper::findPath({30, 40}, &result));
+            for (int i = 0; i < 20 && scheduler.hasScript(bots[1]->getBotId()); i++) {
+                botController->makeDueDecisions();
+                botController->getPathService().processRequests(*board.getGrid());
+            }
+
+            THEN("It should be resumed with the path") {
+                REQUIRE(result.has_value());
+                REQUIRE(result->found);
+                REQUIRE(result->path.front() == std::make_pair(10u, 40u));
+                REQUIRE(result->path.back() == std::make_pair(30u, 40u));
+            }
+        }
+
+        WHEN("A script asks for it's bot") {
+            std::shared_ptr<Bot> self;
+            scheduler.start(bots[1], helper::whoAmI(&self));
+            botController->makeDueDecisions();
+
+            THEN("It should get it") {
+                REQUIRE(self == bots[1]);
+            }
+        }
+
+        WHEN("A script throws") {
+            scheduler.start(bots[0], helper::fail());
+            botController->makeDueDecisions();
+
+            THEN("The exception should be passed on, and the script should end") {
+                REQUIRE_THROWS_AS(botController->makeDueDecisions(), std::runtime_error);
+                REQUIRE_FALSE(scheduler.hasScript(bots[0]->getBotId()));
+            }
+        }
+
+        WHEN("Many bots sleep") {
+            std::size_t usedBlocks = FramePool::instance().getUsedBlockCount();
+            std::vector<std::shared_ptr<Bot>> sleepers;
+            for (unsigned int i = 0; i < 200; i++) {
+                board.spawnTank((i * 7) % 48, 20 + (i * 13) % 28, Tank::BasicTank, South);
+            }
+            sleepers = helper::takeSpawnedBots(eventQueue);
+            for (const std::shared_ptr<Bot> &sleeper: sleepers) {
+                scheduler.start(sleeper, helper::sleep(1000));
+            }
+            botController->makeDueDecisions();
+            REQUIRE(sleepers.size() > 100);
+            REQUIRE(scheduler.getLastResumeCount() == sleepers.size());
+
+            THEN("Their frames should come from the pool") {
+                REQUIRE(FramePool::instance().getUsedBlockCount() == usedBlocks + sleepers.size());
+            }
+
+            THEN("They should not be resumed until they wake up") {
+                for (int i = 0; i < 10; i++) {
+                    botController->makeDueDecisions();
+                    REQUIRE(scheduler.getLastResumeCount() == 0);
+                }
+                REQUIRE(scheduler.getScriptCount() == sleepers.size());
+            }
+
+            scheduler.stopAll();
+            REQUIRE(FramePool::instance().getUsedBlockCount() == usedBlocks);
+        }
+
+        scheduler.stopAll();
+        botController->setCounting(false);
+        botController->makeDueDecisions();
+        eventQueue->clear();
+    }
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Bot.h"
+#include "../include/BotController.h"
+#include "../include/LookaheadPlanner.h"
+#include "../../core-lib/include/Clock.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Event.h"
+#include "../../core-lib/include/WorkerPool.h"
+#include "../../board-lib/include/Board.h"
+#include "../../tank-lib/include/Tank.h"
+
+namespace {
+    namespace helper {
+        void initSingletons() {
+            Clock::initialize(60);
+            BotController::initialize(4, 240);
+        }
+
+        std::vector<std::shared_ptr<Bot>> takeSpawnedBots(EventQueue<Event> *eventQueue) {
+            std::vector<std::shared_ptr<Bot>> bots;
+            while (!eventQueue->isEmpty()) {
+                auto bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+                if (bot != nullptr) {
+                    bots.push_back(bot);
+                }
+            }
+            return bots;
+        }
+
+        std::vector<const Entity *> entitiesOf(const std::vector<std::shared_ptr<Bot>> &bots) {
+            std::vector<const Entity *> entities;
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                entities.push_back(std::dynamic_pointer_cast<Tank>(bot).get());
+            }
+            return entities;
+        }
+
+        unsigned int bestAction(const LookaheadPlanner::Scores &scores) {
+            return static_cast<unsigned int>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+        }
+    }
+}
+
+SCENARIO("Planning ahead with simulations") {
+    helper::initSingletons();
+    GIVEN("A board with the player, a bot facing the player and a bot facing away from it") {
+        auto eventQueue = EventQueue<Event>::instance();
+        eventQueue->clear();
+        Board board{};
+        board.spawnPlayer(30, 40, North);
+        board.spawnTank(30, 28, Tank::BasicTank, South);
+        board.spawnTank(20, 40, Tank::BasicTank, West);
+        std::vector<std::shared_ptr<Bot>> bots = helper::takeSpawnedBots(eventQueue);
+        REQUIRE(bots.size() == 2);
+
+        LookaheadPlanner planner;
+        std::vector<LookaheadPlanner::Scores> scores;
+        planner.capture(board, nullptr);
+
+        WHEN("Their actions are planned without a limit") {
+            planner.plan(helper::entitiesOf(bots), nullptr, scores);
+
+            THEN("Firing should be the best for the bot facing the player, and the other one should turn towards it") {
+                REQUIRE(scores.size() == 2);
+                REQUIRE(scores[0][LookaheadPlanner::Fire] > 0.0f);
+                REQUIRE(scores[0][helper::bestAction(scores[0])] == scores[0][LookaheadPlanner::Fire]);
+                REQUIRE(helper::bestAction(scores[1]) == LookaheadPlanner::RotateEast);
+                REQUIRE(planner.getLastAbandonedCount() == 0);
+            }
+
+            THEN("Turning to the direction the bot is facing should not be rolled out") {
+                REQUIRE(scores[0][LookaheadPlanner::RotateSouth] == LookaheadPlanner::NotScored);
+                REQUIRE(scores[1][LookaheadPlanner::RotateWest] == LookaheadPlanner::NotScored);
+                REQUIRE(planner.getLastRolloutCount() == 10);
+            }
+
+            THEN("The board should not change") {
+                REQUIRE(eventQueue->isEmpty());
+                REQUIRE(board.getPlayerTank()->getFixedY() == FixedPoint::fromTiles(40));
+            }
+        }
+
+        WHEN("They are planned on a worker pool") {
+            WorkerPool pool(2);
+            std::vector<LookaheadPlanner::Scores> single;
+            planner.plan(helper::entitiesOf(bots), nullptr, single);
+            planner.plan(helper::entitiesOf(bots), &pool, scores);
+
+            THEN("Scores should be the same") {
+                REQUIRE(scores == single);
+            }
+        }
+
+        WHEN("They are planned with a budget of 3 rollouts") {
+            std::vector<LookaheadPlanner::Scores> unlimited;
+            planner.plan(helper::entitiesOf(bots), nullptr, unlimited);
+            planner.setRolloutBudget(3);
+            WorkerPool pool(2);
+            planner.plan(helper::entitiesOf(bots), &pool, scores);
+
+            THEN("Only the first actions of the first bot should be rolled out") {
+                REQUIRE(planner.getLastRolloutCount() == 3);
+                REQUIRE(planner.getLastAbandonedCount() == 7);
+                REQUIRE(scores[0][LookaheadPlanner::Move] == unlimited[0][LookaheadPlanner::Move]);
+                REQUIRE(scores[0][LookaheadPlanner::RotateWest] == unlimited[0][LookaheadPlanner::RotateWest]);
+                REQUIRE(scores[0][LookaheadPlanner::Fire] == LookaheadPlanner::NotScored);
+                REQUIRE(*std::max_element(scores[1].begin(), scores[1].end()) == LookaheadPlanner::NotScored);
+            }
+        }
+
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Bots planning ahead") {
+    helper::initSingletons();
+    GIVEN("A board with the player, a bot facing the player and a bot facing away from it") {
+        auto eventQueue = EventQueue<Event>::instance();
+        eventQueue->clear();
+        auto botController = BotController::instance();
+        Board board{};
+        board.spawnPlayer(30, 40, North);
+        board.spawnTank(30, 28, Tank::BasicTank, South);
+        board.spawnTank(20, 40, Tank::BasicTank, West);
+        std::vector<std::shared_ptr<Bot>> bots = helper::takeSpawnedBots(eventQueue);
+        REQUIRE(bots.size() == 2);
+        botController->setCounting(true);
+
+        WHEN("Basic bots plan ahead") {
+            botController->setLookahead(Tank::BasicTank, true);
+            botController->setLookaheadBudget(0);
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                botController->requestDecision(bot);
+            }
+            botController->makeDueDecisions();
+
+            THEN("The first bot should keep facing the player, and the second one should turn towards it") {
+                REQUIRE(botController->isLookahead(Tank::BasicTank));
+                REQUIRE_FALSE(botController->isLookahead(Tank::FastTank));
+                const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                REQUIRE(decisions.size() == 2);
+                REQUIRE(decisions[0].action != BotController::Decision::Rotate);
+                REQUIRE(decisions[1].action == BotController::Decision::Rotate);
+                REQUIRE(decisions[1].direction == East);
+            }
+        }
+
+        WHEN("Basic bots plan ahead with a budget of a single rollout") {
+            botController->setLookahead(Tank::BasicTank, true);
+            botController->setLookaheadBudget(1);
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                botController->requestDecision(bot);
+            }
+            botController->makeDueDecisions();
+
+            THEN("Every bot should still get a decision") {
+                REQUIRE(botController->getLastDecisions().size() == 2);
+            }
+        }
+
+        botController->setLookahead(Tank::BasicTank, false);
+        botController->setLookaheadBudget(BotController::DefaultLookaheadBudget);
+        botController->setCounting(false);
+        botController->makeDueDecisions();
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Benchmarking lookahead planning", "[.][benchmark]") {
+    helper::initSingletons();
+    GIVEN("A board with the player and 100 bots") {
+        auto eventQueue = EventQueue<Event>::instance();
+        eventQueue->clear();
+        Board board{};
+        board.spawnPlayer(24, 44, North);
+        for (unsigned int i = 0; i < 100; i++) {
+            board.spawnTank((i * 7) % 48, (i * 13) % 36, Tank::BasicTank, static_cast<Direction>(i % 4));
+        }
+        std::vector<std::shared_ptr<Bot>> bots = helper::takeSpawnedBots(eventQueue);
+        std::vector<const Entity *> entities = helper::entitiesOf(bots);
+        LookaheadPlanner planner;
+        std::vector<LookaheadPlanner::Scores> scores;
+
+        BENCHMARK("Planning 100 bots, 40 ticks per rollout") {
+            planner.capture(board, board.getFlowField());
+            planner.plan(entities, nullptr, scores);
+            return planner.getLastRolloutCount();
+        };
+
+        eventQueue->clear();
+    }
+}
@@ -0,0 +1,371 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Bot.h"
+#include "../include/BotController.h"
+#include "../include/NeuralPolicy.h"
+#include "../../core-lib/include/Clock.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Event.h"
+#include "../../board-lib/include/Board.h"
+#include "../../tank-lib/include/Tank.h"
+
+namespace {
+    namespace helper {
+        /**
+         * 2 -> 2 (ReLU) -> 1
+         */
+        std::vector<NeuralPolicy::Layer> tinyLayers() {
+            return {
+                    {2, 2, {1.0f, -1.0f, 2.0f, 1.0f}, {0.0f, -1.0f}},
+                    {2, 1, {1.0f, 1.0f},              {0.5f}}
+            };
+        }
+
+        NeuralPolicy::Layer randomLayer(std::size_t inputs, std::size_t outputs, std::mt19937 &random) {
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+            NeuralPolicy::Layer layer{inputs, outputs, std::vector<float>(inputs * outputs),
+                                      std::vector<float>(outputs)};
+            for (float &weight: layer.weights) {
+                weight = distribution(random);
+            }
+            for (float &bias: layer.biases) {
+                bias = distribution(random);
+            }
+            return layer;
+        }
+
+        std::vector<NeuralPolicy::Layer> botLayers(std::mt19937 &random) {
+            return {randomLayer(BotController::ObservationSize, 64, random), randomLayer(64, 64, random),
+                    randomLayer(64, BotController::PolicyActionCount, random)};
+        }
+
+        /**
+         * A policy ignoring observations, always scoring the action highest
+         */
+        std::shared_ptr<const NeuralPolicy> alwaysPolicy(BotController::PolicyAction action) {
+            NeuralPolicy::Layer layer{BotController::ObservationSize, BotController::PolicyActionCount,
+                                      std::vector<float>(BotController::ObservationSize *
+                                                         BotController::PolicyActionCount, 0.0f),
+                                      std::vector<float>(BotController::PolicyActionCount, 0.0f)};
+            layer.biases[action] = 1.0f;
+            return std::make_shared<const NeuralPolicy>(std::vector<NeuralPolicy::Layer>{layer});
+        }
+
+        std::vector<float> randomInputs(const NeuralPolicy &policy, std::size_t count, std::mt19937 &random) {
+            std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+            std::vector<float> inputs(count * policy.getInputStride(), 0.0f);
+            for (std::size_t row = 0; row < count; row++) {
+                for (std::size_t i = 0; i < policy.getInputSize(); i++) {
+                    inputs[row * policy.getInputStride() + i] = distribution(random);
+                }
+            }
+            return inputs;
+        }
+
+        void writeFile(const std::filesystem::path &path, const std::vector<std::uint32_t> &words) {
+            std::ofstream file(path, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(words.data()),
+                       static_cast<std::streamsize>(words.size() * sizeof(std::uint32_t)));
+        }
+
+        void initSingletons() {
+            Clock::initialize(60);
+            BotController::initialize(4, 240);
+        }
+
+        std::vector<std::shared_ptr<Bot>> takeSpawnedBots(EventQueue<Event> *eventQueue) {
+            std::vector<std::shared_ptr<Bot>> bots;
+            while (!eventQueue->isEmpty()) {
+                auto bot = std::dynamic_pointer_cast<Bot>(eventQueue->pop()->info.entityInfo.entity);
+                if (bot != nullptr) {
+                    bots.push_back(bot);
+                }
+            }
+            return bots;
+        }
+    }
+}
+
+SCENARIO("Evaluating neural policies") {
+    GIVEN("A tiny policy") {
+        NeuralPolicy policy(helper::tinyLayers());
+        NeuralPolicy::Workspace workspace;
+        REQUIRE(policy.getInputSize() == 2);
+        REQUIRE(policy.getOutputSize() == 1);
+        REQUIRE(policy.getInputStride() % NeuralPolicy::Lanes == 0);
+
+        WHEN("It is evaluated for two observations") {
+            std::vector<float> inputs(2 * policy.getInputStride(), 0.0f);
+            inputs[0] = 1.0f;
+            inputs[1] = 2.0f;
+            inputs[policy.getInputStride()] = 3.0f;
+            inputs[policy.getInputStride() + 1] = 1.0f;
+            std::vector<float> outputs(2 * policy.getOutputStride());
+            policy.evaluate(inputs.data(), 2, outputs.data(), workspace);
+
+            THEN("Hidden values below zero should be cut off, and the output should be linear") {
+                REQUIRE(outputs[0] == 3.5f);
+                REQUIRE(outputs[policy.getOutputStride()] == 8.5f);
+            }
+        }
+    }
+
+    GIVEN("A policy of the size used by bots") {
+        std::mt19937 random(7);
+        NeuralPolicy policy(helper::botLayers(random));
+        NeuralPolicy::Workspace workspace;
+        const std::size_t count = 11;
+        std::vector<float> inputs = helper::randomInputs(policy, count, random);
+
+        WHEN("A batch is evaluated at once and row by row") {
+            std::vector<float> batched(count * policy.getOutputStride());
+            policy.evaluate(inputs.data(), count, batched.data(), workspace);
+            std::vector<float> single(count * policy.getOutputStride());
+            for (std::size_t row = 0; row < count; row++) {
+                policy.evaluate(inputs.data() + row * policy.getInputStride(), 1,
+                                single.data() + row * policy.getOutputStride(), workspace);
+            }
+
+            THEN("Results should be identical") {
+                for (std::size_t row = 0; row < count; row++) {
+                    for (std::size_t o = 0; o < policy.getOutputSize(); o++) {
+                        REQUIRE(batched[row * policy.getOutputStride() + o] ==
+                                single[row * policy.getOutputStride() + o]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Loading neural policies") {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_policies";
+    std::filesystem::create_directories(directory);
+
+    GIVEN("A saved policy") {
+        std::mt19937 random(3);
+        std::vector<NeuralPolicy::Layer> layers = helper::botLayers(random);
+        std::filesystem::path path = directory / "policy.mlp";
+        REQUIRE(NeuralPolicy::save(path.string(), layers));
+
+        WHEN("It is loaded") {
+            std::shared_ptr<const NeuralPolicy> loaded = NeuralPolicy::load(path.string());
+
+            THEN("It should score like the original one") {
+                REQUIRE(loaded != nullptr);
+                NeuralPolicy original(layers);
+                NeuralPolicy::Workspace workspace;
+                std::vector<float> inputs = helper::randomInputs(original, 5, random);
+                std::vector<float> expected(5 * original.getOutputStride());
+                std::vector<float> actual(5 * loaded->getOutputStride());
+                original.evaluate(inputs.data(), 5, expected.data(), workspace);
+                loaded->evaluate(inputs.data(), 5, actual.data(), workspace);
+                REQUIRE(actual == expected);
+            }
+        }
+
+        WHEN("The file is cut short") {
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+
+            THEN("Loading should fail") {
+                REQUIRE_THROWS_AS(NeuralPolicy::load(path.string()), InvalidPolicyFile);
+            }
+        }
+
+        WHEN("Something is written after the last layer") {
+            std::ofstream(path, std::ios::binary | std::ios::app) << "x";
+
+            THEN("Loading should fail") {
+                REQUIRE_THROWS_AS(NeuralPolicy::load(path.string()), InvalidPolicyFile);
+            }
+        }
+    }
+
+    GIVEN("Files which are not policies") {
+        std::filesystem::path wrongMagic = directory / "magic.mlp";
+        helper::writeFile(wrongMagic, {0x12345678, NeuralPolicy::FileVersion, 1, 1, 1, 0, 0});
+        std::filesystem::path noLayers = directory / "layers.mlp";
+        helper::writeFile(noLayers, {NeuralPolicy::Magic, NeuralPolicy::FileVersion, 0});
+
+        THEN("Loading them should fail") {
+            REQUIRE_THROWS_AS(NeuralPolicy::load(wrongMagic.string()), InvalidPolicyFile);
+            REQUIRE_THROWS_AS(NeuralPolicy::load(noLayers.string()), InvalidPolicyFile);
+        }
+    }
+
+    GIVEN("A file that does not exist") {
+        THEN("No policy should be loaded") {
+            REQUIRE(NeuralPolicy::load((directory / "missing.mlp").string()) == nullptr);
+        }
+    }
+
+    GIVEN("Layers that do not fit together") {
+        std::vector<NeuralPolicy::Layer> layers = helper::tinyLayers();
+        layers[1].inputs = 3;
+        layers[1].weights.push_back(1.0f);
+
+        THEN("A policy should not be built") {
+            REQUIRE_THROWS_AS(NeuralPolicy{layers}, InvalidPolicyFile);
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+SCENARIO("Deciding with neural policies") {
+    helper::initSingletons();
+    GIVEN("A board with the player, basic bots and a fast bot") {
+        auto eventQueue = EventQueue<Event>::instance();
+        eventQueue->clear();
+        auto botController = BotController::instance();
+        Board board{};
+        board.spawnPlayer(30, 40, North);
+        board.spawnTank(0, 0, Tank::BasicTank, South);
+        board.spawnTank(20, 0, Tank::BasicTank, East);
+        board.spawnTank(40, 0, Tank::FastTank, West);
+        std::vector<std::shared_ptr<Bot>> bots = helper::takeSpawnedBots(eventQueue);
+        REQUIRE(bots.size() == 3);
+        botController->setCounting(true);
+
+        WHEN("A policy with wrong sizes is set") {
+            THEN("It should be rejected") {
+                REQUIRE_THROWS_AS(botController->setPolicy(Tank::BasicTank, std::make_shared<const NeuralPolicy>(
+                        helper::tinyLayers())), InvalidPolicyFile);
+                REQUIRE(botController->getPolicy(Tank::BasicTank) == nullptr);
+            }
+        }
+
+        WHEN("Basic bots are given a policy that always fires") {
+            botController->setPolicy(Tank::BasicTank, helper::alwaysPolicy(BotController::PolicyFire));
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                botController->requestDecision(bot);
+            }
+            botController->makeDueDecisions();
+
+            THEN("Basic bots should fire, and the fast bot should still use it's tree") {
+                const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                REQUIRE(decisions.size() == 3);
+                REQUIRE(decisions[0].action == BotController::Decision::Fire);
+                REQUIRE(decisions[1].action == BotController::Decision::Fire);
+                REQUIRE(decisions[2].bot == bots[2]);
+            }
+        }
+
+        WHEN("Basic bots are given a policy that turns south") {
+            botController->setPolicy(Tank::BasicTank, helper::alwaysPolicy(BotController::PolicyRotateSouth));
+            botController->requestDecision(bots[0]);
+            botController->requestDecision(bots[1]);
+            botController->makeDueDecisions();
+
+            THEN("The bot facing south should move forward, and the other one should turn") {
+                const std::vector<BotController::Decision> &decisions = botController->getLastDecisions();
+                REQUIRE(decisions.size() == 2);
+                REQUIRE(decisions[0].action == BotController::Decision::Move);
+                REQUIRE(decisions[1].action == BotController::Decision::Rotate);
+                REQUIRE(decisions[1].direction == South);
+            }
+        }
+
+        WHEN("An observation is built for the bot in the corner") {
+            botController->setPolicy(Tank::BasicTank, helper::alwaysPolicy(BotController::PolicyMove));
+            botController->requestDecision(bots[0]);
+            botController->makeDueDecisions();
+            std::vector<float> observation(BotController::ObservationSize);
+            botController->buildObservation(bots[0], observation.data());
+            const std::size_t window = BotController::ObservationWindow * BotController::ObservationWindow;
+
+            THEN("Tiles off the grid should be blocked, and positions should be relative to the bot") {
+                REQUIRE(observation[0] == 1.0f);
+                REQUIRE(observation[window - 1] == 0.0f);
+                REQUIRE(observation[window + South] == 1.0f);
+                REQUIRE(observation[window + North] == 0.0f);
+                REQUIRE(observation[window + 4] == 1.0f);
+                REQUIRE(observation[window + 5] == 30.0f / 52.0f);
+                REQUIRE(observation[window + 6] == 40.0f / 52.0f);
+            }
+        }
+
+        WHEN("Policies are loaded from a directory with a truncated and a wrongly sized file") {
+            std::filesystem::path directory = std::filesystem::temp_directory_path() / "tanks_test_bot_policies";
+            std::filesystem::create_directories(directory);
+            std::mt19937 random(5);
+            REQUIRE(NeuralPolicy::save((directory / "basic.mlp").string(), helper::botLayers(random)));
+            REQUIRE(NeuralPolicy::save((directory / "armor.mlp").string(), helper::botLayers(random)));
+            std::filesystem::resize_file(directory / "armor.mlp", 100);
+            REQUIRE(NeuralPolicy::save((directory / "fast.mlp").string(), helper::tinyLayers()));
+
+            THEN("The valid file should be loaded, and the other types should keep their trees") {
+                REQUIRE_THROWS_AS(botController->loadPolicies(directory.string()), InvalidPolicyFile);
+                REQUIRE(botController->getPolicy(Tank::BasicTank) != nullptr);
+                REQUIRE(botController->getPolicy(Tank::FastTank) == nullptr);
+                REQUIRE(botController->getPolicy(Tank::ArmorTank) == nullptr);
+            }
+            std::filesystem::remove_all(directory);
+        }
+
+        botController->setPolicy(Tank::BasicTank, nullptr);
+        botController->setCounting(false);
+        botController->makeDueDecisions();
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Benchmarking policy inference", "[.][benchmark]") {
+    GIVEN("A policy of the size used by bots, and observations of 1000 bots") {
+        std::mt19937 random(11);
+        NeuralPolicy policy(helper::botLayers(random));
+        NeuralPolicy::Workspace workspace;
+        const std::size_t count = 1000;
+        std::vector<float> inputs = helper::randomInputs(policy, count, random);
+        std::vector<float> outputs(count * policy.getOutputStride());
+
+        BENCHMARK("1000 bots in one batch") {
+            policy.evaluate(inputs.data(), count, outputs.data(), workspace);
+            return outputs[0];
+        };
+
+        BENCHMARK("1000 bots one by one") {
+            for (std::size_t row = 0; row < count; row++) {
+                policy.evaluate(inputs.data() + row * policy.getInputStride(), 1,
+                                outputs.data() + row * policy.getOutputStride(), workspace);
+            }
+            return outputs[0];
+        };
+    }
+
+    helper::initSingletons();
+    GIVEN("A board with 1000 bots deciding with a policy") {
+        auto eventQueue = EventQueue<Event>::instance();
+        eventQueue->clear();
+        auto botController = BotController::instance();
+        Board board{};
+        board.spawnPlayer(24, 40, North);
+        for (unsigned int i = 0; i < 1000; i++) {
+            board.spawnTank((i * 7) % 48, (i * 13) % 36, Tank::BasicTank, static_cast<Direction>(i % 4));
+        }
+        std::vector<std::shared_ptr<Bot>> bots = helper::takeSpawnedBots(eventQueue);
+        std::mt19937 random(13);
+        botController->setPolicy(Tank::BasicTank, std::make_shared<const NeuralPolicy>(helper::botLayers(random)));
+        botController->setCounting(true);
+        botController->setDecisionBudget(0);
+
+        BENCHMARK("Decision phase, 1000 bots") {
+            for (const std::shared_ptr<Bot> &bot: bots) {
+                botController->requestDecision(bot);
+            }
+            botController->makeDueDecisions();
+            eventQueue->clear();
+            return botController->getLastDecisions().size();
+        };
+
+        botController->setPolicy(Tank::BasicTank, nullptr);
+        botController->setDecisionBudget(BotController::DefaultDecisionBudget);
+        botController->setCounting(false);
+        eventQueue->clear();
+    }
+}
@@ -0,0 +1,216 @@
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/PathService.h"
+#include "../../board-lib/include/Grid.h"
+#include "../../board-lib/include/FlowField.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Event.h"
+
+namespace {  // anonymous namespace to force internal linkage
+    namespace helper {
+        class TestGrid : public Grid {
+        public:
+            TestGrid() {
+                eagleLocation = {24, 48};
+            }
+
+            void fillColumn(unsigned int x, unsigned int fromY, unsigned int toY, TileType tile) {
+                for (unsigned int y = fromY; y <= toY; y++) {
+                    setTile(x, y, tile);
+                }
+                EventQueue<Event>::instance()->clear();
+            }
+        };
+
+        /**
+         * Processes requests until the given one is ready, returns the number of ticks it took
+         */
+        unsigned int processUntilReady(PathService &pathService, const Grid &grid, PathService::RequestId id,
+                                       std::optional<PathService::Result> &result) {
+            unsigned int ticks = 0;
+            while (!result.has_value() && ticks < 1000) {
+                pathService.processRequests(grid);
+                result = pathService.takeResult(id);
+                ticks++;
+            }
+            return ticks;
+        }
+    }
+}
+
+SCENARIO("Finding paths") {
+    GIVEN("An empty grid") {
+        helper::TestGrid grid{};
+        PathService pathService{};
+
+        WHEN("Requesting a path") {
+            PathService::RequestId id = pathService.requestPath({0, 0}, {10, 0});
+
+            THEN("The result should not be ready before requests are processed") {
+                REQUIRE_FALSE(pathService.takeResult(id).has_value());
+                REQUIRE(pathService.getPendingCount() == 1);
+            }
+
+            AND_WHEN("Processing requests") {
+                pathService.processRequests(grid);
+                std::optional<PathService::Result> result = pathService.takeResult(id);
+
+                THEN("The shortest path should be found") {
+                    REQUIRE(result.has_value());
+                    REQUIRE(result->found);
+                    REQUIRE(result->cost == 10);
+                    REQUIRE(result->path.size() == 11);
+                    REQUIRE(result->path.front() == PathService::Position{0, 0});
+                    REQUIRE(result->path.back() == PathService::Position{10, 0});
+                    REQUIRE(pathService.getPendingCount() == 0);
+                    REQUIRE_FALSE(pathService.takeResult(id).has_value());
+                }
+            }
+        }
+
+        WHEN("Requesting a path to a position that can not be taken") {
+            PathService::RequestId id = pathService.requestPath({0, 0}, {22, 46});  // overlapping the eagle
+            pathService.processRequests(grid);
+
+            THEN("No path should be found right away") {
+                std::optional<PathService::Result> result = pathService.takeResult(id);
+                REQUIRE(result.has_value());
+                REQUIRE_FALSE(result->found);
+                REQUIRE(pathService.getLastExpansions() == 0);
+            }
+        }
+    }
+
+    GIVEN("A grid with a steel wall") {
+        helper::TestGrid grid{};
+        grid.fillColumn(20, 0, 40, Steel);
+        PathService pathService{};
+
+        WHEN("Requesting a path through the wall") {
+            PathService::RequestId id = pathService.requestPath({10, 10}, {30, 10});
+            std::optional<PathService::Result> result;
+            helper::processUntilReady(pathService, grid, id, result);
+
+            THEN("The path should go around it") {
+                REQUIRE(result.has_value());
+                REQUIRE(result->found);
+                REQUIRE(result->cost == 20 + 2 * 31);
+                REQUIRE(result->path.size() == result->cost + 1);
+            }
+        }
+
+        WHEN("The goal is walled off") {
+            grid.fillColumn(20, 41, 51, Steel);
+            PathService::RequestId id = pathService.requestPath({10, 10}, {30, 10});
+            std::optional<PathService::Result> result;
+            helper::processUntilReady(pathService, grid, id, result);
+
+            THEN("No path should be found") {
+                REQUIRE(result.has_value());
+                REQUIRE_FALSE(result->found);
+                REQUIRE(result->path.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Batching and caching path requests") {
+    GIVEN("An empty grid and many requests to the same goal") {
+        helper::TestGrid grid{};
+        PathService pathService{};
+
+        std::vector<PathService::RequestId> ids;
+        for (unsigned int x = 0; x < 40; x += 4) {
+            ids.push_back(pathService.requestPath({x, 0}, {20, 40}));
+        }
+
+        WHEN("Processing requests") {
+            pathService.processRequests(grid);
+
+            THEN("All of them should be answered by a single search") {
+                for (unsigned int i = 0; i < ids.size(); i++) {
+                    std::optional<PathService::Result> result = pathService.takeResult(ids[i]);
+                    REQUIRE(result.has_value());
+                    REQUIRE(result->found);
+                    REQUIRE(result->cost == 40 + (i * 4 > 20 ? i * 4 - 20 : 20 - i * 4));
+                }
+                REQUIRE(pathService.getLastExpansions() < 49 * 49);
+
+                AND_WHEN("Requesting a path to the same goal from a position the search has already reached") {
+                    PathService::RequestId id = pathService.requestPath({20, 20}, {20, 40});
+                    pathService.processRequests(grid);
+
+                    THEN("It should be answered from the cache") {
+                        REQUIRE(pathService.getLastExpansions() == 0);
+                        std::optional<PathService::Result> result = pathService.takeResult(id);
+                        REQUIRE(result.has_value());
+                        REQUIRE(result->cost == 20);
+                    }
+                }
+
+                AND_WHEN("The grid changes") {
+                    for (unsigned int x = 18; x < 26; x++) {
+                        grid.setTile(x, 30, Bricks);
+                    }
+                    EventQueue<Event>::instance()->clear();
+                    PathService::RequestId id = pathService.requestPath({20, 20}, {20, 40});
+                    std::optional<PathService::Result> result;
+                    helper::processUntilReady(pathService, grid, id, result);
+
+                    THEN("The cache should be dropped, and the new path should go around the bricks") {
+                        REQUIRE(result.has_value());
+                        REQUIRE(result->cost == 32);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("A path service with a small budget") {
+        helper::TestGrid grid{};
+        PathService pathService{4};
+        PathService::RequestId id = pathService.requestPath({0, 0}, {48, 48});
+
+        WHEN("Processing requests") {
+            std::optional<PathService::Result> result;
+            unsigned int ticks = helper::processUntilReady(pathService, grid, id, result);
+
+            THEN("The search should be spread over many ticks, within the budget") {
+                REQUIRE(ticks > 1);
+                REQUIRE(pathService.getLastExpansions() <= 4);
+                REQUIRE(result.has_value());
+                REQUIRE(result->found);
+                REQUIRE(result->cost == 96);
+            }
+        }
+    }
+}
+
+SCENARIO("Benchmarking path requests", "[.][benchmark]") {
+    GIVEN("A grid with some walls") {
+        helper::TestGrid grid{};
+        grid.fillColumn(12, 0, 40, Steel);
+        grid.fillColumn(36, 10, 51, Steel);
+
+        THEN("Many bots should be able to replan at once") {
+            BENCHMARK("150 bots requesting paths to the same goal") {
+                PathService pathService{};
+                for (unsigned int i = 0; i < 150; i++) {
+                    pathService.requestPath({(i * 5) % 49, (i * 11) % 49}, {24, 0});
+                }
+                pathService.processRequests(grid);
+                return pathService.getLastExpansions();
+            };
+
+            BENCHMARK("150 bots requesting paths to 10 goals") {
+                PathService pathService{};
+                for (unsigned int i = 0; i < 150; i++) {
+                    pathService.requestPath({(i * 5) % 49, (i * 11) % 49}, {(i % 10) * 4, 0});
+                }
+                pathService.processRequests(grid);
+                return pathService.getLastExpansions();
+            };
+        }
+    }
+}
@@ -7,7 +7,7 @@
 
 #include "include/Clock.h"
 
-Clock::Clock(unsigned int freq) {
+Clock::Clock(unsigned int freq) : frequency_(freq) {
     interval_ = std::chrono::nanoseconds(1000000000) / freq;
 }
 
@@ -21,6 +21,10 @@ void Clock::sleep() {
     std::this_thread::sleep_for(last_tick_ + interval_ - std::chrono::steady_clock::now());
 }
 
+unsigned int Clock::getFrequency() const {
+    return frequency_;
+}
+
 std::unique_ptr<Clock> Clock::self_ = nullptr;
 
 void Clock::initialize(unsigned int freq) {
@@ -113,11 +113,13 @@ Event::Event(EventType e, GameState* new_state) {
     }
 }
 
-Event::Event(EventType e, GameStatistics* statsObject) {
+Event::Event(EventType e, GameStatistics* statsObject) : Event(e, statsObject, ~0u) {}
+
+Event::Event(EventType e, GameStatistics* statsObject, unsigned int changedFields) {
     type = e;
     switch (e) {
         case StatisticsChanged:{
-            info.pointsInfo = {statsObject};
+            info.pointsInfo = {statsObject, changedFields};
             break;
         }
         default:
@@ -0,0 +1,53 @@
+#include <new>
+
+#include "include/FramePool.h"
+
+void *FramePool::allocate(std::size_t size) {
+    if (size == 0 || size > MaxPooledSize) {
+        return ::operator new(size);
+    }
+
+    usedBlocks_++;
+    std::size_t sizeClass = (size - 1) / Granularity;
+    std::vector<void *> &freeList = freeLists_[sizeClass];
+    if (freeList.empty()) {
+        std::size_t blockSize = (sizeClass + 1) * Granularity;
+        slabs_.push_back(std::make_unique<std::byte[]>(blockSize * BlocksPerSlab));
+        std::byte *slab = slabs_.back().get();
+        // handed out from the front of the slab first
+        for (std::size_t i = BlocksPerSlab; i > 0; i--) {
+            freeList.push_back(slab + (i - 1) * blockSize);
+        }
+    }
+
+    void *block = freeList.back();
+    freeList.pop_back();
+    return block;
+}
+
+void FramePool::deallocate(void *pointer, std::size_t size) {
+    if (pointer == nullptr) {
+        return;
+    }
+    if (size == 0 || size > MaxPooledSize) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    usedBlocks_--;
+    freeLists_[(size - 1) / Granularity].push_back(pointer);
+}
+
+std::size_t FramePool::getUsedBlockCount() const {
+    return usedBlocks_;
+}
+
+std::size_t FramePool::getSlabCount() const {
+    return slabs_.size();
+}
+
+FramePool &FramePool::instance() {
+    // never destroyed, so blocks can still be returned while other static objects are destroyed
+    static auto *pool = new FramePool();
+    return *pool;
+}
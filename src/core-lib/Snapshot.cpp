@@ -0,0 +1,47 @@
+#include <utility>
+
+#include "include/Snapshot.h"
+
+InvalidSnapshot::InvalidSnapshot(std::string message) : what_message(std::move(message)) {}
+
+const char *InvalidSnapshot::what() const noexcept {
+    return what_message.c_str();
+}
+
+void SnapshotWriter::writeBytes(const void *data, std::size_t size) {
+    const auto *begin = static_cast<const std::uint8_t *>(data);
+    bytes_.insert(bytes_.end(), begin, begin + size);
+}
+
+void SnapshotWriter::reserve(std::size_t size) {
+    bytes_.reserve(bytes_.size() + size);
+}
+
+const std::vector<std::uint8_t> &SnapshotWriter::getBytes() const {
+    return bytes_;
+}
+
+std::vector<std::uint8_t> SnapshotWriter::takeBytes() {
+    return std::exchange(bytes_, {});
+}
+
+void SnapshotWriter::clear() {
+    bytes_.clear();
+}
+
+SnapshotReader::SnapshotReader(const std::uint8_t *data, std::size_t size) : data_(data), size_(size) {}
+
+void SnapshotReader::readBytes(void *data, std::size_t size) {
+    if (size > size_ - position_) {
+        throw InvalidSnapshot("Snapshot cut short at byte " + std::to_string(size_));
+    }
+    if (size == 0) {
+        return;
+    }
+    std::memcpy(data, data_ + position_, size);
+    position_ += size;
+}
+
+std::size_t SnapshotReader::getRemaining() const {
+    return size_ - position_;
+}
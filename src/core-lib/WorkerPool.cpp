@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "include/WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned int threadCount) {
+    for (unsigned int i = 1; i < threadCount; i++) {
+        workers_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    jobStarted_.notify_all();
+    for (std::thread &worker: workers_) {
+        worker.join();
+    }
+}
+
+void WorkerPool::parallelFor(std::size_t count, std::size_t minChunkSize,
+                             const std::function<void(std::size_t, std::size_t)> &job) {
+    if (count == 0) {
+        chunkCount_ = 0;
+        return;
+    }
+
+    std::size_t minChunk = std::max<std::size_t>(minChunkSize, 1);
+    std::size_t maxChunks = (count + minChunk - 1) / minChunk;
+    std::size_t chunkCount = std::min(maxChunks, getThreadCount() * ChunksPerThread);
+
+    // a single chunk is not worth waking anyone up
+    if (chunkCount <= 1 || workers_.empty()) {
+        chunkCount_ = 1;
+        job(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &job;
+        count_ = count;
+        chunkSize_ = (count + chunkCount - 1) / chunkCount;
+        chunkCount_ = (count + chunkSize_ - 1) / chunkSize_;
+        nextChunk_ = 0;
+        busyWorkers_ = static_cast<unsigned int>(workers_.size());
+        generation_++;
+    }
+    jobStarted_.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    jobFinished_.wait(lock, [this] { return busyWorkers_ == 0; });
+    job_ = nullptr;
+}
+
+unsigned int WorkerPool::getThreadCount() const {
+    return static_cast<unsigned int>(workers_.size()) + 1;
+}
+
+std::size_t WorkerPool::getLastChunkCount() const {
+    return chunkCount_;
+}
+
+void WorkerPool::workerLoop() {
+    std::uint64_t finishedGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobStarted_.wait(lock, [this, finishedGeneration] {
+                return stopping_ || generation_ != finishedGeneration;
+            });
+            if (stopping_) {
+                return;
+            }
+            finishedGeneration = generation_;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busyWorkers_ == 0) {
+            jobFinished_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::runChunks() {
+    for (std::size_t chunk = nextChunk_++; chunk < chunkCount_; chunk = nextChunk_++) {
+        std::size_t begin = chunk * chunkSize_;
+        (*job_)(begin, std::min(count_, begin + chunkSize_));
+    }
+}
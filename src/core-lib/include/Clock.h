@@ -45,6 +45,12 @@ public:
      */
     void sleep();
 
+    /**
+     * Returns the frequency at which clock's ticks happen
+     * @return Ticks per second
+     */
+    [[nodiscard]] unsigned int getFrequency() const;
+
     /**
      * Initializes the clock, must be called before ::instance()
      *
@@ -64,6 +70,7 @@ private:
 
     std::chrono::time_point<std::chrono::steady_clock> last_tick_;
     std::chrono::nanoseconds interval_{};
+    unsigned int frequency_;
 
     static std::unique_ptr<Clock> self_;
 };
@@ -139,6 +139,11 @@ public:
      */
     struct StatsInfo {
         GameStatistics *stats_;
+
+        /**
+         * Mask of the fields changed since the previous event (see GameStatistics::Field)
+         */
+        unsigned int changed_;
     };
 
     /**
@@ -295,8 +300,13 @@ public:
 
     explicit Event(EventType);
 
+    /**
+     * Marks all fields of the statistics as changed
+     */
     Event(EventType e, GameStatistics *statsObject);
 
+    Event(EventType e, GameStatistics *statsObject, unsigned int changedFields);
+
     Event(EventType e, GameState *new_state);
 
     Event(EventType e, Menu *menu, unsigned int new_pos);
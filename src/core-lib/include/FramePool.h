@@ -0,0 +1,65 @@
+#ifndef PROI_PROJEKT_FRAMEPOOL_H
+#define PROI_PROJEKT_FRAMEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief Pooled allocator for small, short-lived blocks of similar sizes (like coroutine frames)
+ *
+ * Sizes are rounded up to a multiple of Granularity, and every rounded size has it's own list of free blocks. Blocks
+ * are carved out of slabs of BlocksPerSlab blocks, and freed blocks are kept for reuse, so the heap is only used when
+ * a list runs dry. Blocks larger than MaxPooledSize come straight from the heap.
+ *
+ * Not thread-safe: a pool should only be used by one thread.
+ */
+class FramePool {
+public:
+    static constexpr std::size_t Granularity = 64;
+    static constexpr std::size_t MaxPooledSize = 1024;
+    static constexpr std::size_t BlocksPerSlab = 32;
+
+    FramePool() = default;
+
+    FramePool(const FramePool &other) = delete;
+
+    FramePool &operator=(const FramePool &other) = delete;
+
+    /**
+     * Allocates a block
+     * @param size Size of the block in bytes
+     * @return Pointer to the block, aligned like ::operator new
+     */
+    void *allocate(std::size_t size);
+
+    /**
+     * Returns a block to the pool
+     * @param pointer Pointer returned by allocate
+     * @param size Size passed to allocate
+     */
+    void deallocate(void *pointer, std::size_t size);
+
+    /**
+     * Returns the number of blocks currently handed out
+     */
+    [[nodiscard]] std::size_t getUsedBlockCount() const;
+
+    /**
+     * Returns the number of slabs taken from the heap
+     */
+    [[nodiscard]] std::size_t getSlabCount() const;
+
+    /**
+     * Returns the pool shared by the main thread
+     */
+    static FramePool &instance();
+
+protected:
+    std::vector<void *> freeLists_[MaxPooledSize / Granularity];
+    std::vector<std::unique_ptr<std::byte[]>> slabs_;
+    std::size_t usedBlocks_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_FRAMEPOOL_H
@@ -0,0 +1,131 @@
+#ifndef PROI_PROJEKT_SNAPSHOT_H
+#define PROI_PROJEKT_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Thrown when a snapshot is cut short or holds values that can not be restored
+ */
+class InvalidSnapshot : public std::exception {
+public:
+    explicit InvalidSnapshot(std::string message = "Invalid snapshot");
+
+    const char *what() const noexcept override;
+
+private:
+    std::string what_message;
+};
+
+/**
+ * \brief Writes the state of objects to a snapshot
+ *
+ * Values are copied as they are in memory, in the byte order of the machine, so snapshots are only meant to be
+ * restored on machines like the one that wrote them. Classes write their own state (saveState) and read it back in the
+ * same order (loadState, see SnapshotReader), GameSnapshot puts them together with a header.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * Writes a value of a trivially copyable type
+     */
+    template<class T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    /**
+     * Writes the number of elements of a vector, and then the elements
+     */
+    template<class T>
+    void writeVector(const std::vector<T> &values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(static_cast<std::uint32_t>(values.size()));
+        writeBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    void writeBytes(const void *data, std::size_t size);
+
+    /**
+     * Reserves space for more bytes, so a large state is written without reallocations
+     */
+    void reserve(std::size_t size);
+
+    [[nodiscard]] const std::vector<std::uint8_t> &getBytes() const;
+
+    /**
+     * Hands over the written bytes, leaving the writer empty
+     */
+    std::vector<std::uint8_t> takeBytes();
+
+    /**
+     * Drops the written bytes, keeping the reserved space for the next state
+     */
+    void clear();
+
+private:
+    std::vector<std::uint8_t> bytes_;
+};
+
+/**
+ * \brief Reads the state of objects from a snapshot written by SnapshotWriter
+ *
+ * The bytes are not copied, so they must outlive the reader.
+ */
+class SnapshotReader {
+public:
+    SnapshotReader(const std::uint8_t *data, std::size_t size);
+
+    /**
+     * Reads a value of a trivially copyable type
+     * @throws InvalidSnapshot if the snapshot ends before the value
+     */
+    template<class T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    /**
+     * Reads a vector written by SnapshotWriter::writeVector
+     * @param maxSize Most elements the vector may have
+     * @throws InvalidSnapshot if the snapshot ends before the vector, or it has more than maxSize elements
+     */
+    template<class T>
+    std::vector<T> readVector(std::size_t maxSize) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto size = read<std::uint32_t>();
+        if (size > maxSize || size > getRemaining() / sizeof(T)) {
+            throw InvalidSnapshot("Vector of " + std::to_string(size) + " elements in a snapshot");
+        }
+        std::vector<T> values(size);
+        readBytes(values.data(), size * sizeof(T));
+        return values;
+    }
+
+    /**
+     * @throws InvalidSnapshot if the snapshot ends before the bytes
+     */
+    void readBytes(void *data, std::size_t size);
+
+    /**
+     * Returns the number of bytes left to read
+     */
+    [[nodiscard]] std::size_t getRemaining() const;
+
+private:
+    const std::uint8_t *data_;
+    std::size_t size_;
+    std::size_t position_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_SNAPSHOT_H
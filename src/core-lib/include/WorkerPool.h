@@ -0,0 +1,100 @@
+#ifndef PROI_PROJEKT_WORKERPOOL_H
+#define PROI_PROJEKT_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Fixed set of threads running data-parallel jobs
+ *
+ * Threads are started once, when the pool is created, and sleep between jobs, so a job can be run every tick without
+ * the cost of starting threads. The thread calling parallelFor takes part in the job too.
+ *
+ * A job is split into chunks of consecutive indices, which threads take one by one until none are left, so threads
+ * that finish early help with the rest of the job.
+ */
+class WorkerPool {
+public:
+    /**
+     * Maximum number of chunks a job is split into per thread
+     */
+    static constexpr std::size_t ChunksPerThread = 4;
+
+    /**
+     * Starts the threads
+     * @param threadCount Number of threads jobs are run on, including the calling thread (so threadCount - 1 threads
+     * are started)
+     */
+    explicit WorkerPool(unsigned int threadCount);
+
+    WorkerPool(const WorkerPool &other)=delete;
+
+    WorkerPool& operator=(const WorkerPool &other)=delete;
+
+    /**
+     * Stops and joins all threads
+     */
+    ~WorkerPool();
+
+    /**
+     * Runs a job over indices [0, count) on all threads of the pool, returns after the whole job is done
+     *
+     * The number of chunks adapts to the size of the job: there are at most ChunksPerThread chunks per thread, but
+     * chunks are never shorter than minChunkSize, so small jobs use fewer threads (or run on the calling thread only)
+     * @param count Number of indices
+     * @param minChunkSize Minimum number of indices in a chunk
+     * @param job Called with the range [begin, end) of every chunk, possibly from many threads at once; must not throw
+     */
+    void parallelFor(std::size_t count, std::size_t minChunkSize,
+                     const std::function<void(std::size_t, std::size_t)> &job);
+
+    /**
+     * Returns the number of threads jobs are run on, including the calling thread
+     * @return
+     */
+    [[nodiscard]] unsigned int getThreadCount() const;
+
+    /**
+     * Returns the number of chunks the last job was split into
+     * @return
+     */
+    [[nodiscard]] std::size_t getLastChunkCount() const;
+
+protected:
+    /**
+     * Waits for jobs and takes part in them, until the pool is stopped
+     */
+    void workerLoop();
+
+    /**
+     * Runs chunks of the current job until there are none left
+     */
+    void runChunks();
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable jobStarted_;
+    std::condition_variable jobFinished_;
+    bool stopping_ = false;
+
+    /**
+     * Incremented for every job, so that workers can tell a new job from the one they have already finished
+     */
+    std::uint64_t generation_ = 0;
+    unsigned int busyWorkers_ = 0;
+
+    const std::function<void(std::size_t, std::size_t)> *job_ = nullptr;
+    std::size_t count_ = 0;
+    std::size_t chunkSize_ = 0;
+    std::size_t chunkCount_ = 0;
+    std::atomic<std::size_t> nextChunk_{0};
+};
+
+
+#endif //PROI_PROJEKT_WORKERPOOL_H
@@ -0,0 +1,76 @@
+#include <cstdint>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/FramePool.h"
+
+SCENARIO("Allocating blocks from a frame pool") {
+    GIVEN("An empty pool") {
+        FramePool pool;
+
+        WHEN("A block is allocated") {
+            void *block = pool.allocate(100);
+
+            THEN("A slab should be taken from the heap") {
+                REQUIRE(block != nullptr);
+                REQUIRE(reinterpret_cast<std::uintptr_t>(block) % alignof(std::max_align_t) == 0);
+                REQUIRE(pool.getSlabCount() == 1);
+                REQUIRE(pool.getUsedBlockCount() == 1);
+            }
+
+            AND_WHEN("It is returned, and a block of a similar size is allocated") {
+                pool.deallocate(block, 100);
+                void *other = pool.allocate(120);
+
+                THEN("The block should be reused") {
+                    REQUIRE(other == block);
+                    REQUIRE(pool.getSlabCount() == 1);
+                    REQUIRE(pool.getUsedBlockCount() == 1);
+                }
+                pool.deallocate(other, 120);
+            }
+        }
+
+        WHEN("Many blocks of the same size are allocated") {
+            std::vector<void *> blocks;
+            for (std::size_t i = 0; i < 3 * FramePool::BlocksPerSlab; i++) {
+                blocks.push_back(pool.allocate(200));
+            }
+
+            THEN("They should be carved out of a few slabs, and not overlap") {
+                REQUIRE(pool.getSlabCount() == 3);
+                std::sort(blocks.begin(), blocks.end());
+                REQUIRE(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+                AND_WHEN("They are returned and allocated again") {
+                    for (void *block: blocks) {
+                        pool.deallocate(block, 200);
+                    }
+                    REQUIRE(pool.getUsedBlockCount() == 0);
+                    for (std::size_t i = 0; i < 3 * FramePool::BlocksPerSlab; i++) {
+                        blocks[i] = pool.allocate(200);
+                    }
+
+                    THEN("No more slabs should be needed") {
+                        REQUIRE(pool.getSlabCount() == 3);
+                    }
+                }
+            }
+            for (void *block: blocks) {
+                pool.deallocate(block, 200);
+            }
+        }
+
+        WHEN("A large block is allocated") {
+            void *block = pool.allocate(FramePool::MaxPooledSize + 1);
+
+            THEN("It should come straight from the heap") {
+                REQUIRE(block != nullptr);
+                REQUIRE(pool.getSlabCount() == 0);
+                REQUIRE(pool.getUsedBlockCount() == 0);
+            }
+            pool.deallocate(block, FramePool::MaxPooledSize + 1);
+        }
+    }
+}
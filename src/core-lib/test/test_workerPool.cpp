@@ -0,0 +1,100 @@
+#include <atomic>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/WorkerPool.h"
+
+SCENARIO("Running jobs on a worker pool") {
+    GIVEN("A pool of 4 threads") {
+        WorkerPool pool{4};
+        REQUIRE(pool.getThreadCount() == 4);
+
+        WHEN("Running a large job") {
+            std::vector<int> visits(1000, 0);
+            std::atomic<unsigned int> chunks{0};
+            pool.parallelFor(visits.size(), 10, [&](std::size_t begin, std::size_t end) {
+                chunks++;
+                for (std::size_t i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            });
+
+            THEN("Every index should be visited exactly once, in at most 4 chunks per thread") {
+                for (int visit: visits) {
+                    REQUIRE(visit == 1);
+                }
+                REQUIRE(chunks == pool.getLastChunkCount());
+                REQUIRE(pool.getLastChunkCount() == 4 * WorkerPool::ChunksPerThread);
+            }
+        }
+
+        WHEN("Running a job smaller than the minimum chunk size") {
+            std::vector<int> visits(10, 0);
+            pool.parallelFor(visits.size(), 16, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            });
+
+            THEN("It should be run as a single chunk") {
+                REQUIRE(pool.getLastChunkCount() == 1);
+                for (int visit: visits) {
+                    REQUIRE(visit == 1);
+                }
+            }
+        }
+
+        WHEN("Running a job that only fills a few chunks") {
+            std::atomic<unsigned int> visited{0};
+            pool.parallelFor(50, 16, [&](std::size_t begin, std::size_t end) {
+                visited += static_cast<unsigned int>(end - begin);
+            });
+
+            THEN("The number of chunks should adapt to the job") {
+                REQUIRE(pool.getLastChunkCount() == 4);
+                REQUIRE(visited == 50);
+            }
+        }
+
+        WHEN("Running many jobs in a row") {
+            std::atomic<unsigned int> visited{0};
+            for (int i = 0; i < 100; i++) {
+                pool.parallelFor(100, 1, [&](std::size_t begin, std::size_t end) {
+                    visited += static_cast<unsigned int>(end - begin);
+                });
+            }
+
+            THEN("All of them should be finished") {
+                REQUIRE(visited == 100 * 100);
+            }
+        }
+
+        WHEN("Running an empty job") {
+            bool called = false;
+            pool.parallelFor(0, 1, [&](std::size_t begin, std::size_t end) {
+                called = true;
+            });
+
+            THEN("Nothing should be run") {
+                REQUIRE_FALSE(called);
+                REQUIRE(pool.getLastChunkCount() == 0);
+            }
+        }
+    }
+
+    GIVEN("A pool of a single thread") {
+        WorkerPool pool{1};
+
+        THEN("Jobs should be run on the calling thread") {
+            std::thread::id caller = std::this_thread::get_id();
+            bool sameThread = false;
+            pool.parallelFor(1000, 1, [&](std::size_t begin, std::size_t end) {
+                sameThread = std::this_thread::get_id() == caller;
+            });
+            REQUIRE(sameThread);
+            REQUIRE(pool.getThreadCount() == 1);
+        }
+    }
+}
@@ -405,6 +405,14 @@ std::unique_ptr<Event> ActiveEventHandler::processEvent(std::unique_ptr<Event> e
            if (event->info.keyInfo.keyCode == 36) {
                game_->setPauseState();
            }
+           // BACKSPACE
+           if (event->info.keyInfo.keyCode == 59) {
+               game_->rewind(1);
+           }
+           // F5
+           if (event->info.keyInfo.keyCode == 89) {
+               game_->quickSave();
+           }
            break;
        }
        case (Event::KeyReleased):{
@@ -438,7 +446,7 @@ std::unique_ptr<Event> ActiveEventHandler::processEvent(std::unique_ptr<Event> e
             break;
         }
         case (Event::BotDecisionRequest): {
-            BotController::instance()->makeBotDecision(event->info.botInfo.bot);
+            BotController::instance()->requestDecision(event->info.botInfo.bot);
             break;
         }
         case (Event::BotFireDecision): {
@@ -476,13 +484,16 @@ std::unique_ptr<Event> ActiveEventHandler::processEvent(std::unique_ptr<Event> e
             game_->setFinishedState();
             break;
         }
+        case (Event::TilePlaced):
+        case (Event::TileChanged):
+        case (Event::TileDeleted): {
+            BotController::instance()->getPathService().invalidate();
+            break;
+        }
         case (Event::EntityMoved):
         case (Event::EntityRemoved):
         case (Event::EntitySpawned):
         case (Event::StateChanged):
-        case (Event::TilePlaced):
-        case (Event::TileChanged):
-        case (Event::TileDeleted):
         case (Event::PlayerSpawned):
         case (Event::TankRotated):
         case (Event::TankHit):
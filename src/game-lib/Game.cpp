@@ -2,6 +2,11 @@
 // Created by tomek on 02.05.2022.
 //
 
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <thread>
+
 #include <SFML/Graphics.hpp>
 
 
@@ -12,8 +17,10 @@
 #include "include/KeyboardController.h"
 #include "include/GameStatistics.h"
 #include "include/GameStatsIO.h"
+#include "include/GameSnapshot.h"
 #include "../board-lib/include/Board.h"
 #include "../board-lib/include/Grid.h"
+#include "../board-lib/include/LevelRepository.h"
 #include "../bot-lib/include/BotController.h"
 
 
@@ -37,6 +44,16 @@ void Game::setup() {
 
     setMenuState();
     running_ = true;
+
+    if (!resumeFilename_.empty()) {
+        try {
+            GameSnapshot::loadFromFile(resumeFilename_, *board_, *BotController::instance(), *gameStats_);
+            setActiveState();
+        } catch (const InvalidSnapshot &exception) {
+            // the menu is shown instead
+            std::cerr << exception.what() << std::endl;
+        }
+    }
 }
 
 void Game::initStates() {
@@ -50,17 +67,52 @@ void Game::initComponents() {
     keyboardController_ = std::make_unique<KeyboardController>(window_->getWindow());
     keyboardController_->subscribe(clock_);
 
-    gameStatsIO_ = std::make_unique<GameStatsIO>("scoreboard.txt");  // dummy, filename is ignored for now
+    gameStatsIO_ = std::make_unique<GameStatsIO>(GameStatsIO::DefaultFilename);
 
     BotController::initialize(4, 420);
+    // decisions of bots are the same on any number of threads
+    BotController::instance()->setDecisionThreads(std::thread::hardware_concurrency());
+    try {
+        BotController::instance()->loadBehaviorTrees("./bots");
+    } catch (const InvalidBehaviorTreeFile &exception) {
+        // bots of these types keep the default tree
+        std::cerr << exception.what() << std::endl;
+    }
+    try {
+        BotController::instance()->loadPolicies("./bots");
+    } catch (const InvalidPolicyFile &exception) {
+        // bots of these types decide with their tree
+        std::cerr << exception.what() << std::endl;
+    }
+
+    if (hard_) {
+        for (Tank::TankType type: {Tank::BasicTank, Tank::FastTank, Tank::PowerTank, Tank::ArmorTank}) {
+            BotController::instance()->setLookahead(type, true);
+        }
+    }
 
     BotController::instance()->subscribe(clock_);
 
+    LevelRepository::initialize({LevelRepository::DefaultDirectory});
     board_ = std::make_unique<Board>();
+    board_->setTickRate(clock_->getFrequency());
+    // built while the menu is shown
+    board_->getLevelPreloader().preload(1);
 }
 
 void Game::initScoreboard() {
-    gameStats_ = std::move(gameStatsIO_->loadScoreboard());
+    try {
+        gameStats_ = gameStatsIO_->loadScoreboard();
+    } catch (const InvalidScoreboardFile &) {
+        // played without a scoreboard, the file is left as it is
+        gameStats_ = std::make_unique<GameStatistics>(0, 1, 3);
+    }
+    if (gameStatsIO_->needsCompaction()) {
+        gameStatsIO_->compact();
+    }
+    if (statsDeltaWriter_ != nullptr) {
+        gameStats_->setDeltaListener(statsDeltaWriter_->getListener());
+    }
 }
 
 void Game::initUI() {
@@ -81,6 +133,10 @@ void Game::setFinishedState() {
 }
 
 void Game::setMenuState() {
+    if (!autosaveFilename_.empty() && state_ == pause_state_.get()) {
+        // the match is left on the board, but can only be continued from the snapshot
+        quickSave();
+    }
     BotController::instance()->setCounting(false);
     state_ = menu_state_.get();
     eventQueue_->registerEvent(std::make_unique<Event>(Event::StateChanged, state_));
@@ -93,7 +149,7 @@ void Game::setPauseState() {
 }
 
 void Game::quit() {
-    gameStatsIO_->saveScoreboard(std::move(gameStats_));
+    gameStatsIO_->saveScoreboard();
     running_ = false;
 }
 
@@ -102,11 +158,40 @@ void Game::run() {
 
     while (running_ == true) {
         clock_->tick();
-        while (!eventQueue_->isEmpty()) {
-            std::unique_ptr<Event> event =  state_->getEventHandler()->handleEvent(std::move(eventQueue_->pop()));
-            graphicEventHandler_->processEvent(std::move(event));
+        BotController::instance()->makeDueDecisions();
+        if (levelWatcher_ != nullptr) {
+            levelWatcher_->applyChanges(*board_);
+            for (const LevelWatcher::Change &change: levelWatcher_->takeRefused()) {
+                std::cerr << change.path << ": " << change.report.describe() << std::endl;
+            }
+        }
+        // changes of the statistics made by the events are published once, and shown in the same tick
+        do {
+            while (!eventQueue_->isEmpty()) {
+                std::unique_ptr<Event> event = state_->getEventHandler()->handleEvent(std::move(eventQueue_->pop()));
+                if (rewindBuffer_ != nullptr && event != nullptr) {
+                    rewindBuffer_->observe(*event);
+                }
+                graphicEventHandler_->processEvent(std::move(event));
+            }
+        } while (gameStats_->publishChanges());
+        if (rewindBuffer_ != nullptr && state_ == active_state_.get()) {
+            if (pendingRewind_ != 0 && rewindBuffer_->getLastTick().has_value()) {
+                std::uint32_t last = rewindBuffer_->getLastTick().value();
+                std::uint32_t ticks = pendingRewind_ * clock_->getFrequency();
+                std::uint32_t tick = std::max(rewindBuffer_->getFirstTick().value(), last >= ticks ? last - ticks : 0);
+                rewindBuffer_->seek(tick, *board_, *BotController::instance(), *gameStats_);
+            }
+            pendingRewind_ = 0;
+            rewindBuffer_->record(*board_, *BotController::instance(), *gameStats_);
+        }
+        if (!autosaveFilename_.empty() && state_ == active_state_.get() &&
+            ++ticksSinceAutosave_ >= AutosaveInterval * clock_->getFrequency()) {
+            ticksSinceAutosave_ = 0;
+            quickSave();
         }
 
+        BotController::instance()->getPathService().processRequests(*board_->getGrid());
         board_->moveAllEntities();
         redrawUI();
 
@@ -124,6 +209,12 @@ GameStatistics *Game::getStats() {
 
 void Game::start() {
     reset();
+    if (rewindBuffer_ != nullptr) {
+        rewindBuffer_->clear();
+    }
+    ticksSinceAutosave_ = 0;
+    seed_ = std::random_device{}();
+    BotController::instance()->setSeed(seed_);
     prepareLevel(1);
     setActiveState();
 }
@@ -139,7 +230,55 @@ void Game::prepareLevel(unsigned int levelNum) {
     board_->spawnPlayer();
 }
 
+void Game::watchLevels() {
+    levelWatcher_ = std::make_unique<LevelWatcher>(std::vector<std::string>{LevelRepository::DefaultDirectory});
+}
+
+void Game::playHard() {
+    hard_ = true;
+}
+
+bool Game::exportStats(const std::string &filename) {
+    auto file = std::make_unique<std::ofstream>(filename, std::ios::binary | std::ios::trunc);
+    if (!file->is_open()) {
+        return false;
+    }
+    statsExport_ = std::move(file);
+    statsDeltaWriter_ = std::make_unique<StatsDeltaWriter>(*statsExport_);
+    return true;
+}
+
+bool Game::saveSnapshot(const std::string &filename) {
+    return GameSnapshot::saveToFile(filename, *board_, *BotController::instance(), *gameStats_);
+}
+
+void Game::autosave(const std::string &filename) {
+    autosaveFilename_ = filename;
+}
+
+bool Game::quickSave() {
+    std::string filename = autosaveFilename_.empty() ? DefaultSnapshotFilename : autosaveFilename_;
+    if (!saveSnapshot(filename)) {
+        std::cerr << "Could not save the match to " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Game::resumeFrom(const std::string &filename) {
+    resumeFilename_ = filename;
+}
+
+void Game::recordHistory(unsigned int seconds) {
+    rewindBuffer_ = std::make_unique<RewindBuffer>(seconds * clock_->getFrequency());
+}
+
+void Game::rewind(unsigned int seconds) {
+    pendingRewind_ = seconds;
+}
+
 void Game::end() {
+    gameStatsIO_->addRecord(*gameStats_, seed_);
     board_->removeAllEntities();
     setFinishedState();
 }
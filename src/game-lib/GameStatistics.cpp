@@ -9,16 +9,18 @@
 
 #include "include/GameStatistics.h"
 #include "include/GameStatsIO.h"
+#include "../core-lib/include/Snapshot.h"
 
 
 void GameStatistics::addPoints(unsigned int pts) {
-    points_ += pts;
-    eventQueue_->registerEvent(std::make_unique<Event>(Event::StatisticsChanged, this));
+    setPoints(points_ + pts);
 }
 
 void GameStatistics::setPoints(unsigned int pts) {
-    points_ = pts;
-    eventQueue_->registerEvent(std::make_unique<Event>(Event::StatisticsChanged, this));
+    if (points_ != pts) {
+        points_ = pts;
+        changed_ |= Points;
+    }
 }
 
 unsigned int GameStatistics::getPoints() const {
@@ -32,15 +34,18 @@ unsigned int GameStatistics::getLevel() const {
 }
 
 void GameStatistics::setLevel(unsigned int level) {
-    level_ = level;
-    eventQueue_->registerEvent(std::make_unique<Event>(Event::StatisticsChanged, this));
+    if (level_ != level) {
+        level_ = level;
+        changed_ |= Level;
+    }
 }
 
 void GameStatistics::resetStats() {
     points_ = 0;
     level_ = 1;
     lives_ = 3;
-    eventQueue_->registerEvent(std::make_unique<Event>(Event::StatisticsChanged, this));
+    changed_ = AllFields;
+    publishChanges();
 }
 
 unsigned int GameStatistics::getLives() const {
@@ -48,14 +53,65 @@ unsigned int GameStatistics::getLives() const {
 }
 
 void GameStatistics::setLives(unsigned int lives) {
-    lives_ = lives;
-    eventQueue_->registerEvent(std::make_unique<Event>(Event::StatisticsChanged, this));
+    if (lives_ != lives) {
+        lives_ = lives;
+        changed_ |= Lives;
+    }
 
     if(lives_ == 0){
+        // the HUD shows the last life lost before the game ends
+        publishChanges();
         eventQueue_->registerEvent(std::make_unique<Event>(Event::GameEnded));
     }
 }
 
+void GameStatistics::saveState(SnapshotWriter &writer) const {
+    writer.write(static_cast<std::uint32_t>(points_));
+    writer.write(static_cast<std::uint32_t>(level_));
+    writer.write(static_cast<std::uint32_t>(lives_));
+}
+
+void GameStatistics::loadState(SnapshotReader &reader) {
+    auto points = reader.read<std::uint32_t>();
+    auto level = reader.read<std::uint32_t>();
+    auto lives = reader.read<std::uint32_t>();
+    points_ = points;
+    level_ = level;
+    lives_ = lives;
+    changed_ = AllFields;
+}
+
+bool GameStatistics::publishChanges() {
+    if (changed_ == 0) {
+        return false;
+    }
+    Delta delta;
+    delta.sequence = nextSequence_++;
+    delta.changed = changed_;
+    delta.points = (changed_ & Points) ? points_ : 0;
+    delta.level = (changed_ & Level) ? level_ : 0;
+    delta.lives = (changed_ & Lives) ? lives_ : 0;
+    changed_ = 0;
+
+    eventQueue_->registerEvent(std::make_unique<Event>(Event::StatisticsChanged, this, delta.changed));
+    if (deltaListener_) {
+        deltaListener_(delta);
+    }
+    return true;
+}
+
+unsigned int GameStatistics::getChangedFields() const {
+    return changed_;
+}
+
+void GameStatistics::setDeltaListener(DeltaListener listener) {
+    deltaListener_ = std::move(listener);
+}
+
+const std::list<unsigned int> &GameStatistics::getScoreboard() const {
+    return scoreboard_;
+}
+
 void GameStatistics::decrementLives(unsigned int deltaLives) {
     setLives(std::max(0u, lives_-deltaLives));
 }
\ No newline at end of file
@@ -2,14 +2,369 @@
 // Created by tomek on 02.06.2022.
 //
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "include/GameStatsIO.h"
 #include "include/GameStatistics.h"
 
+namespace {
+    constexpr std::size_t HeaderSize = 2 * sizeof(std::uint32_t);
+    constexpr std::size_t RecordSize = 4 * sizeof(std::uint32_t) + sizeof(std::int64_t) + sizeof(std::uint64_t);
+
+    /**
+     * A record as stored in the file
+     */
+    struct StoredRecord {
+        std::uint32_t points;
+        std::uint32_t level;
+        std::uint32_t lives;
+        std::uint32_t checksum;
+        std::int64_t timestamp;
+        std::uint64_t seed;
+    };
+
+    static_assert(sizeof(StoredRecord) == RecordSize);
+
+    /**
+     * Start of a checkpoint, followed by topCount records
+     */
+    struct CheckpointHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t recordCount;
+        StoredRecord last;
+        std::uint64_t topCount;
+    };
+
+    /**
+     * Cheap enough to check millions of records at load time, and never 0 for a record of zeros, which is what a
+     * crash usually leaves at the end of a file
+     */
+    std::uint32_t checksumOf(const StoredRecord &stored) {
+        std::uint64_t hash = 0x9e3779b97f4a7c15ull;
+        for (std::uint64_t word: {std::uint64_t{stored.points} | std::uint64_t{stored.level} << 32,
+                                  std::uint64_t{stored.lives}, static_cast<std::uint64_t>(stored.timestamp),
+                                  stored.seed}) {
+            hash = (hash ^ word) * 0xbf58476d1ce4e5b9ull;
+            hash ^= hash >> 31;
+        }
+        return static_cast<std::uint32_t>(hash) | 1;
+    }
+
+    StoredRecord store(const GameStatsIO::Record &record) {
+        StoredRecord stored{record.points, record.level, record.lives, 0, record.timestamp, record.seed};
+        stored.checksum = checksumOf(stored);
+        return stored;
+    }
+
+    bool writeAll(int descriptor, const void *data, std::size_t bytes) {
+        const auto *position = static_cast<const char *>(data);
+        while (bytes > 0) {
+            ssize_t written = write(descriptor, position, bytes);
+            if (written <= 0) {
+                return false;
+            }
+            position += written;
+            bytes -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    bool writeRecords(int descriptor, const std::vector<GameStatsIO::Record> &records) {
+        std::vector<StoredRecord> stored;
+        stored.reserve(records.size());
+        for (const GameStatsIO::Record &record: records) {
+            stored.push_back(store(record));
+        }
+        return writeAll(descriptor, stored.data(), stored.size() * RecordSize);
+    }
+
+    bool isIntact(const StoredRecord &stored) {
+        return stored.checksum == checksumOf(stored);
+    }
+
+    bool isSame(const StoredRecord &a, const StoredRecord &b) {
+        return std::memcmp(&a, &b, RecordSize) == 0;
+    }
+}
+
+InvalidScoreboardFile::InvalidScoreboardFile(std::string message) : what_message(std::move(message)) {}
+
+const char *InvalidScoreboardFile::what() const noexcept {
+    return what_message.c_str();
+}
+
+bool GameStatsIO::Record::isBetterThan(const Record &other) const {
+    if (points != other.points) {
+        return points > other.points;
+    }
+    return timestamp < other.timestamp;
+}
+
+GameStatsIO::GameStatsIO(std::string n_scoreboardFilename) : scoreboardFilename(std::move(n_scoreboardFilename)) {}
+
+GameStatsIO::~GameStatsIO() {
+    saveScoreboard();
+    if (log_ >= 0) {
+        close(log_);
+    }
+}
+
 std::unique_ptr<GameStatistics> GameStatsIO::loadScoreboard() {
-    // dummy
-    return std::make_unique<GameStatistics>(0, 1, 3);
+    if (log_ >= 0) {
+        close(log_);
+        log_ = -1;
+    }
+    scanLog();
+
+    auto stats = std::make_unique<GameStatistics>(0, 1, 3);
+    for (const Record &record: top_) {
+        stats->scoreboard_.push_back(record.points);
+    }
+    return stats;
+}
+
+bool GameStatsIO::saveScoreboard() {
+    if (pending_.empty()) {
+        return true;
+    }
+    if (!openLog()) {
+        return false;
+    }
+    if (!writeRecords(log_, pending_) || fsync(log_) != 0) {
+        // reopened and cut back to the records written before, the next time
+        close(log_);
+        log_ = -1;
+        return false;
+    }
+    recordCount_ += pending_.size();
+    saveCheckpoint(pending_.back());
+    pending_.clear();
+    return true;
 }
 
-void GameStatsIO::saveScoreboard(std::unique_ptr<GameStatistics> gameStats) {
-    // dummy
-}
\ No newline at end of file
+void GameStatsIO::addRecord(const GameStatistics &stats, std::uint64_t seed) {
+    Record record;
+    record.points = stats.getPoints();
+    record.level = stats.getLevel();
+    record.lives = stats.getLives();
+    record.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    record.seed = seed;
+    addRecord(record);
+}
+
+void GameStatsIO::addRecord(const Record &record) {
+    rankRecord(record);
+    pending_.push_back(record);
+    if (pending_.size() >= FlushBatch) {
+        saveScoreboard();
+    }
+}
+
+bool GameStatsIO::compact() {
+    if (!scanned_) {
+        try {
+            scanLog();
+        } catch (const InvalidScoreboardFile &) {
+            return false;
+        }
+    }
+    std::string temporary = scoreboardFilename + ".tmp";
+    int descriptor = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (descriptor < 0) {
+        return false;
+    }
+    const std::uint32_t header[2] = {Magic, FileVersion};
+    bool written = writeAll(descriptor, header, sizeof(header)) && writeRecords(descriptor, top_) &&
+                   fsync(descriptor) == 0;
+    close(descriptor);
+
+    // a checkpoint of the old log must not be matched with the new one
+    std::remove((scoreboardFilename + CheckpointSuffix).c_str());
+    if (!written || std::rename(temporary.c_str(), scoreboardFilename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    // the rename itself is only durable once the directory is synced
+    std::filesystem::path directory = std::filesystem::path(scoreboardFilename).parent_path();
+    int directoryDescriptor = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directoryDescriptor >= 0) {
+        fsync(directoryDescriptor);
+        close(directoryDescriptor);
+    }
+
+    if (log_ >= 0) {
+        close(log_);
+        log_ = -1;
+    }
+    recordCount_ = top_.size();
+    pending_.clear();
+    return true;
+}
+
+const std::vector<GameStatsIO::Record> &GameStatsIO::getTopRecords() const {
+    return top_;
+}
+
+std::size_t GameStatsIO::getRecordCount() const {
+    return recordCount_ + pending_.size();
+}
+
+bool GameStatsIO::needsCompaction() const {
+    return getRecordCount() > ScoreboardSize * CompactionRatio;
+}
+
+void GameStatsIO::scanLog() {
+    top_.clear();
+    recordCount_ = 0;
+    scanned_ = false;
+
+    int descriptor = open(scoreboardFilename.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info{};
+    if (descriptor >= 0 && fstat(descriptor, &info) == 0 && static_cast<std::size_t>(info.st_size) >= HeaderSize) {
+        auto size = static_cast<std::size_t>(info.st_size);
+        // not populated, only the records after the checkpoint are read
+        void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+        if (data == MAP_FAILED) {
+            throw InvalidScoreboardFile(scoreboardFilename + ": could not be mapped");
+        }
+        std::uint32_t header[2];
+        std::memcpy(header, data, sizeof(header));
+        if (header[0] != Magic || header[1] != FileVersion) {
+            munmap(data, size);
+            throw InvalidScoreboardFile(scoreboardFilename + ": not a scoreboard");
+        }
+
+        // most records are only compared with the worst one on the scoreboard
+        const auto *records = reinterpret_cast<const StoredRecord *>(static_cast<const std::uint8_t *>(data) +
+                                                                     HeaderSize);
+        std::size_t count = (size - HeaderSize) / RecordSize;
+        std::size_t checkpointed = loadCheckpoint(records, count);
+        madvise(data, size, MADV_SEQUENTIAL);
+        for (recordCount_ = checkpointed; recordCount_ < count; recordCount_++) {
+            const StoredRecord &stored = records[recordCount_];
+            if (!isIntact(stored)) {
+                break;
+            }
+            if (top_.size() < ScoreboardSize || stored.points >= top_.back().points) {
+                rankRecord({stored.points, stored.level, stored.lives, stored.timestamp, stored.seed});
+            }
+        }
+        if (recordCount_ > checkpointed) {
+            const StoredRecord &last = records[recordCount_ - 1];
+            saveCheckpoint({last.points, last.level, last.lives, last.timestamp, last.seed});
+        }
+        munmap(data, size);
+    } else if (descriptor >= 0) {
+        close(descriptor);
+    }
+
+    for (const Record &record: pending_) {
+        rankRecord(record);
+    }
+    scanned_ = true;
+}
+
+std::size_t GameStatsIO::loadCheckpoint(const void *records, std::size_t count) {
+    const auto *stored = static_cast<const StoredRecord *>(records);
+    std::ifstream file(scoreboardFilename + CheckpointSuffix, std::ios::binary);
+    CheckpointHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != Magic ||
+        header.version != FileVersion || header.recordCount == 0 || header.recordCount > count ||
+        header.topCount > std::min<std::uint64_t>(ScoreboardSize, header.recordCount) ||
+        !isSame(header.last, stored[header.recordCount - 1]) || !isIntact(header.last)) {
+        return 0;
+    }
+
+    std::vector<StoredRecord> top(header.topCount);
+    if (!file.read(reinterpret_cast<char *>(top.data()), static_cast<std::streamsize>(top.size() * RecordSize)) ||
+        !std::all_of(top.begin(), top.end(), isIntact)) {
+        return 0;
+    }
+    for (const StoredRecord &record: top) {
+        top_.push_back({record.points, record.level, record.lives, record.timestamp, record.seed});
+    }
+    return header.recordCount;
+}
+
+void GameStatsIO::saveCheckpoint(const Record &last) {
+    std::string checkpoint = scoreboardFilename + CheckpointSuffix;
+    std::string temporary = checkpoint + ".tmp";
+    CheckpointHeader header{Magic, FileVersion, recordCount_, store(last), top_.size()};
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const Record &record: top_) {
+            StoredRecord stored = store(record);
+            file.write(reinterpret_cast<const char *>(&stored), sizeof(stored));
+        }
+        if (!file) {
+            file.close();
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+    std::rename(temporary.c_str(), checkpoint.c_str());
+}
+
+void GameStatsIO::rankRecord(const Record &record) {
+    if (top_.size() >= ScoreboardSize && !record.isBetterThan(top_.back())) {
+        return;
+    }
+    auto position = std::upper_bound(top_.begin(), top_.end(), record,
+                                     [](const Record &a, const Record &b) { return a.isBetterThan(b); });
+    top_.insert(position, record);
+    if (top_.size() > ScoreboardSize) {
+        top_.pop_back();
+    }
+}
+
+bool GameStatsIO::openLog() {
+    if (log_ >= 0) {
+        return true;
+    }
+    if (!scanned_) {
+        try {
+            scanLog();
+        } catch (const InvalidScoreboardFile &) {
+            return false;
+        }
+    }
+    log_ = open(scoreboardFilename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    struct stat info{};
+    if (log_ < 0 || fstat(log_, &info) != 0) {
+        return false;
+    }
+
+    // a new file gets a header, a broken end of an old one (see scanLog) is cut off
+    auto size = static_cast<std::size_t>(info.st_size);
+    if (size < HeaderSize) {
+        const std::uint32_t header[2] = {Magic, FileVersion};
+        if (ftruncate(log_, 0) != 0 || !writeAll(log_, header, sizeof(header))) {
+            close(log_);
+            log_ = -1;
+            return false;
+        }
+        recordCount_ = 0;
+    } else if (size > HeaderSize + recordCount_ * RecordSize &&
+               ftruncate(log_, static_cast<off_t>(HeaderSize + recordCount_ * RecordSize)) != 0) {
+        close(log_);
+        log_ = -1;
+        return false;
+    }
+    lseek(log_, 0, SEEK_END);
+    return true;
+}
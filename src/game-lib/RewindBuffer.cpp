@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+
+#include "include/RewindBuffer.h"
+#include "include/GameSnapshot.h"
+#include "include/GameStatistics.h"
+#include "../board-lib/include/Board.h"
+#include "../board-lib/include/Grid.h"
+#include "../bot-lib/include/BotController.h"
+#include "../core-lib/include/Event.h"
+#include "../tank-lib/include/Bullet.h"
+
+namespace {
+    constexpr std::uint32_t NoOwner = std::numeric_limits<std::uint32_t>::max();
+}
+
+RewindBuffer::RewindBuffer(unsigned int windowTicks, std::size_t capacity, unsigned int keyframeInterval)
+        : ring_(capacity), windowTicks_(windowTicks), keyframeInterval_(std::max(1u, keyframeInterval)) {}
+
+void RewindBuffer::observe(const Event &event) {
+    switch (event.type) {
+        case Event::EntityRemoved: {
+            auto tracked = tracked_.find(event.info.entityInfo.entity.get());
+            if (tracked != tracked_.end()) {
+                removed_.push_back(tracked->second.id);
+                tracked_.erase(tracked);
+            }
+            break;
+        }
+        case Event::TilePlaced:
+        case Event::TileChanged:
+        case Event::TileDeleted: {
+            changedTiles_.emplace_back(event.info.tileInfo.tile_x, event.info.tileInfo.tile_y);
+            break;
+        }
+        case Event::LevelLoaded: {
+            needsKeyframe_ = true;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+bool RewindBuffer::record(Board &board, const BotController &botController, const GameStatistics &stats) {
+    // ticks after the one rewound to are recorded again
+    while (!frames_.empty() && frames_.back().tick >= nextTick_) {
+        usedBytes_ -= frames_.back().size;
+        keyframeCount_ -= frames_.back().keyframe;
+        frames_.pop_back();
+    }
+
+    bool keyframe = needsKeyframe_ || frames_.empty();
+    if (!keyframe) {
+        auto lastKeyframe = std::find_if(frames_.rbegin(), frames_.rend(), [](const Frame &frame) {
+            return frame.keyframe;
+        });
+        keyframe = nextTick_ - lastKeyframe->tick >= keyframeInterval_;
+    }
+    if (!keyframe) {
+        encodeDelta(board, stats);
+        // a delta can not be kept without the keyframe before it
+        keyframe = !store(false);
+    }
+    if (keyframe) {
+        encodeKeyframe(board, botController, stats);
+        if (!store(true)) {
+            clear();
+            nextTick_++;
+            return false;
+        }
+    }
+    nextTick_++;
+
+    // the oldest keyframe is dropped once the next one can start the window
+    while (keyframeCount_ > 1) {
+        auto second = std::find_if(frames_.begin() + 1, frames_.end(), [](const Frame &frame) {
+            return frame.keyframe;
+        });
+        if (nextTick_ - second->tick < windowTicks_) {
+            break;
+        }
+        dropOldestKeyframe();
+    }
+    return true;
+}
+
+bool RewindBuffer::seek(std::uint32_t tick, Board &board, BotController &botController, GameStatistics &stats) {
+    if (frames_.empty() || tick < frames_.front().tick || tick > frames_.back().tick) {
+        return false;
+    }
+    std::size_t target = tick - frames_.front().tick;
+    std::size_t keyframe = target;
+    while (!frames_[keyframe].keyframe) {
+        keyframe--;
+    }
+
+    const Frame &frame = frames_[keyframe];
+    SnapshotReader reader(ring_.data() + frame.offset, frame.size);
+    std::vector<std::uint32_t> ids = reader.readVector<std::uint32_t>(reader.getRemaining());
+    const std::uint8_t *snapshot = ring_.data() + frame.offset + (frame.size - reader.getRemaining());
+    GameSnapshot::restore(std::vector<std::uint8_t>(snapshot, snapshot + reader.getRemaining()), board, botController,
+                          stats);
+
+    std::unordered_map<std::uint32_t, std::shared_ptr<Entity>> entities;
+    std::vector<std::shared_ptr<Entity>> *restored = board.getEntityController()->getAllEntities();
+    for (std::size_t i = 0; i < ids.size() && i < restored->size(); i++) {
+        entities[ids[i]] = (*restored)[i];
+    }
+    for (std::size_t i = keyframe + 1; i <= target; i++) {
+        applyDelta(frames_[i], board, stats, entities);
+    }
+    // tiles of all deltas are restored before the flow field is rebuilt once
+    board.repairFlowField();
+
+    // the match goes on from the tick, the entities are tracked from a new keyframe
+    nextTick_ = tick;
+    needsKeyframe_ = true;
+    tracked_.clear();
+    removed_.clear();
+    changedTiles_.clear();
+    return true;
+}
+
+void RewindBuffer::clear() {
+    frames_.clear();
+    usedBytes_ = 0;
+    keyframeCount_ = 0;
+    needsKeyframe_ = true;
+    tracked_.clear();
+    removed_.clear();
+    changedTiles_.clear();
+}
+
+std::optional<std::uint32_t> RewindBuffer::getFirstTick() const {
+    if (frames_.empty()) {
+        return std::nullopt;
+    }
+    return frames_.front().tick;
+}
+
+std::optional<std::uint32_t> RewindBuffer::getLastTick() const {
+    if (frames_.empty()) {
+        return std::nullopt;
+    }
+    return frames_.back().tick;
+}
+
+std::size_t RewindBuffer::getFrameCount() const {
+    return frames_.size();
+}
+
+std::size_t RewindBuffer::getKeyframeCount() const {
+    return keyframeCount_;
+}
+
+std::size_t RewindBuffer::getUsedBytes() const {
+    return usedBytes_;
+}
+
+std::size_t RewindBuffer::getMemoryUsage() const {
+    // nodes of the map hold a pointer to the next node and the cached hash besides the entry
+    return ring_.size() + frames_.size() * sizeof(Frame) + scratch_.getBytes().capacity() +
+           tracked_.size() * (sizeof(std::pair<const Entity *const, Tracked>) + 2 * sizeof(void *)) +
+           tracked_.bucket_count() * sizeof(void *);
+}
+
+std::size_t RewindBuffer::getCapacity() const {
+    return ring_.size();
+}
+
+void RewindBuffer::encodeKeyframe(Board &board, const BotController &botController, const GameStatistics &stats) {
+    scratch_.clear();
+    std::vector<std::shared_ptr<Entity>> *entities = board.getEntityController()->getAllEntities();
+
+    // entities keep their ids, the ones that were not tracked get new ones
+    std::unordered_map<const Entity *, Tracked> tracked;
+    tracked.reserve(entities->size());
+    scratch_.write(static_cast<std::uint32_t>(entities->size()));
+    for (const std::shared_ptr<Entity> &entity: *entities) {
+        EntityController::EntityState state = EntityController::stateOf(*entity);
+        auto old = tracked_.find(entity.get());
+        std::uint32_t id = old != tracked_.end() && old->second.state.kind == state.kind ? old->second.id : nextId_++;
+        tracked.emplace(entity.get(), Tracked{id, state});
+        scratch_.write(id);
+    }
+    tracked_ = std::move(tracked);
+
+    std::vector<std::uint8_t> snapshot = GameSnapshot::save(board, botController, stats);
+    scratch_.writeBytes(snapshot.data(), snapshot.size());
+
+    removed_.clear();
+    changedTiles_.clear();
+    rememberStats(stats);
+    needsKeyframe_ = false;
+}
+
+void RewindBuffer::encodeDelta(Board &board, const GameStatistics &stats) {
+    scratch_.clear();
+    std::vector<std::shared_ptr<Entity>> *entities = board.getEntityController()->getAllEntities();
+
+    std::vector<const Entity *> spawned;
+    std::vector<std::pair<std::uint8_t, const Tracked *>> changed;
+    for (const std::shared_ptr<Entity> &entity: *entities) {
+        EntityController::EntityState state = EntityController::stateOf(*entity);
+        auto tracked = tracked_.find(entity.get());
+        if (tracked != tracked_.end() && tracked->second.state.kind != state.kind) {
+            // removed without an event, and another entity was created in it's place
+            removed_.push_back(tracked->second.id);
+            tracked_.erase(tracked);
+            tracked = tracked_.end();
+        }
+        if (tracked == tracked_.end()) {
+            tracked_.emplace(entity.get(), Tracked{nextId_++, state});
+            spawned.push_back(entity.get());
+            continue;
+        }
+
+        const EntityController::EntityState &last = tracked->second.state;
+        std::uint8_t fields = (state.x != last.x ? X : 0) | (state.y != last.y ? Y : 0) |
+                              (state.facing != last.facing ? Facing : 0) | (state.moving != last.moving ? Moving : 0) |
+                              (state.lives != last.lives ? Lives : 0) | (state.cooldown != last.cooldown ? Cooldown : 0);
+        if (fields != 0) {
+            tracked->second.state = state;
+            changed.emplace_back(fields, &tracked->second);
+        }
+    }
+    if (tracked_.size() > entities->size()) {
+        // entities removed without an event
+        std::unordered_set<const Entity *> present;
+        for (const std::shared_ptr<Entity> &entity: *entities) {
+            present.insert(entity.get());
+        }
+        for (auto tracked = tracked_.begin(); tracked != tracked_.end();) {
+            if (present.count(tracked->first) == 0) {
+                removed_.push_back(tracked->second.id);
+                tracked = tracked_.erase(tracked);
+            } else {
+                tracked++;
+            }
+        }
+    }
+
+    scratch_.writeVector(removed_);
+    removed_.clear();
+
+    std::unordered_map<const Bullet *, std::uint32_t> owners;
+    bool bulletSpawned = std::any_of(spawned.begin(), spawned.end(), [this](const Entity *entity) {
+        return tracked_.at(entity).state.kind == EntityController::BulletKind;
+    });
+    if (bulletSpawned) {
+        // bullets only know their tanks as subscribers
+        for (const std::shared_ptr<Entity> &entity: *entities) {
+            if (auto *tank = dynamic_cast<Tank *>(entity.get())) {
+                if (std::optional<Bullet *> bullet = tank->getBullet(); bullet.has_value()) {
+                    owners[bullet.value()] = tracked_.at(entity.get()).id;
+                }
+            }
+        }
+    }
+    scratch_.write(static_cast<std::uint32_t>(spawned.size()));
+    for (const Entity *entity: spawned) {
+        const Tracked &tracked = tracked_.at(entity);
+        scratch_.write(tracked.id);
+        EntityController::writeState(scratch_, tracked.state);
+        if (tracked.state.kind == EntityController::BulletKind) {
+            auto owner = owners.find(dynamic_cast<const Bullet *>(entity));
+            scratch_.write(owner != owners.end() ? owner->second : NoOwner);
+        }
+    }
+
+    scratch_.write(static_cast<std::uint32_t>(changed.size()));
+    for (const auto &[fields, tracked]: changed) {
+        scratch_.write(tracked->id);
+        scratch_.write(fields);
+        if (fields & X) {
+            scratch_.write(tracked->state.x);
+        }
+        if (fields & Y) {
+            scratch_.write(tracked->state.y);
+        }
+        if (fields & Facing) {
+            scratch_.write(static_cast<std::uint8_t>(tracked->state.facing));
+        }
+        if (fields & Moving) {
+            scratch_.write(static_cast<std::uint8_t>(tracked->state.moving));
+        }
+        if (fields & Lives) {
+            scratch_.write(static_cast<std::uint32_t>(tracked->state.lives));
+        }
+        if (fields & Cooldown) {
+            scratch_.write(static_cast<std::uint32_t>(tracked->state.cooldown));
+        }
+    }
+
+    std::sort(changedTiles_.begin(), changedTiles_.end());
+    changedTiles_.erase(std::unique(changedTiles_.begin(), changedTiles_.end()), changedTiles_.end());
+    scratch_.write(static_cast<std::uint32_t>(changedTiles_.size()));
+    for (const std::pair<unsigned int, unsigned int> &tile: changedTiles_) {
+        scratch_.write(static_cast<std::uint8_t>(tile.first));
+        scratch_.write(static_cast<std::uint8_t>(tile.second));
+        scratch_.write(static_cast<std::uint8_t>(board.getGrid()->getTileAtPosition(tile.first, tile.second)));
+    }
+    changedTiles_.clear();
+
+    std::array<std::uint32_t, 3> last = stats_;
+    rememberStats(stats);
+    scratch_.write(static_cast<std::uint8_t>(stats_ != last));
+    if (stats_ != last) {
+        for (std::uint32_t value: stats_) {
+            scratch_.write(value);
+        }
+    }
+}
+
+void RewindBuffer::applyDelta(const Frame &frame, Board &board, GameStatistics &stats,
+                              std::unordered_map<std::uint32_t, std::shared_ptr<Entity>> &entities) const {
+    SnapshotReader reader(ring_.data() + frame.offset, frame.size);
+
+    for (std::uint32_t id: reader.readVector<std::uint32_t>(reader.getRemaining())) {
+        auto entity = entities.find(id);
+        if (entity != entities.end()) {
+            board.removeEntity(entity->second);
+            entities.erase(entity);
+        }
+    }
+
+    auto spawnedCount = reader.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < spawnedCount; i++) {
+        auto id = reader.read<std::uint32_t>();
+        EntityController::EntityState state = EntityController::readState(reader);
+        std::shared_ptr<Tank> owner;
+        if (state.kind == EntityController::BulletKind) {
+            auto ownerEntity = entities.find(reader.read<std::uint32_t>());
+            if (ownerEntity != entities.end()) {
+                owner = std::dynamic_pointer_cast<Tank>(ownerEntity->second);
+            }
+        }
+        entities[id] = board.restoreEntity(state, owner);
+    }
+
+    auto changedCount = reader.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < changedCount; i++) {
+        auto entity = entities.find(reader.read<std::uint32_t>());
+        auto fields = reader.read<std::uint8_t>();
+        EntityController::EntityState state;
+        if (entity != entities.end()) {
+            state = EntityController::stateOf(*entity->second);
+        }
+        if (fields & X) {
+            state.x = reader.read<FixedPoint::Value>();
+        }
+        if (fields & Y) {
+            state.y = reader.read<FixedPoint::Value>();
+        }
+        if (fields & Facing) {
+            state.facing = static_cast<Direction>(reader.read<std::uint8_t>() & 3);
+        }
+        if (fields & Moving) {
+            state.moving = reader.read<std::uint8_t>() != 0;
+        }
+        if (fields & Lives) {
+            state.lives = reader.read<std::uint32_t>();
+        }
+        if (fields & Cooldown) {
+            state.cooldown = reader.read<std::uint32_t>();
+        }
+        if (entity != entities.end()) {
+            board.restoreEntityState(entity->second, state);
+        }
+    }
+
+    auto tileCount = reader.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < tileCount; i++) {
+        auto x = reader.read<std::uint8_t>();
+        auto y = reader.read<std::uint8_t>();
+        auto tile = reader.read<std::uint8_t>();
+        board.restoreTile(x, y, static_cast<TileType>(tile));
+    }
+
+    if (reader.read<std::uint8_t>() != 0) {
+        // written in the order of GameStatistics::saveState, restored without ending the game on the last life
+        stats.loadState(reader);
+    }
+}
+
+bool RewindBuffer::store(bool keyframe) {
+    const std::vector<std::uint8_t> &bytes = scratch_.getBytes();
+    if (bytes.size() > ring_.size()) {
+        return false;
+    }
+    std::size_t offset;
+    while (true) {
+        if (frames_.empty()) {
+            if (!keyframe) {
+                return false;
+            }
+            offset = 0;
+            break;
+        }
+        std::size_t head = frames_.back().offset + frames_.back().size;
+        std::size_t tail = frames_.front().offset;
+        if (frames_.back().offset >= tail) {
+            // frames run from the tail to the head, the space around them is free
+            if (head + bytes.size() <= ring_.size()) {
+                offset = head;
+                break;
+            }
+            if (bytes.size() <= tail) {
+                offset = 0;
+                break;
+            }
+        } else if (head + bytes.size() <= tail) {
+            // frames wrapped around, the space between the head and the tail is free
+            offset = head;
+            break;
+        }
+        dropOldestKeyframe();
+    }
+
+    std::memcpy(ring_.data() + offset, bytes.data(), bytes.size());
+    frames_.push_back(Frame{nextTick_, offset, bytes.size(), keyframe});
+    usedBytes_ += bytes.size();
+    keyframeCount_ += keyframe;
+    return true;
+}
+
+void RewindBuffer::dropOldestKeyframe() {
+    do {
+        usedBytes_ -= frames_.front().size;
+        keyframeCount_ -= frames_.front().keyframe;
+        frames_.pop_front();
+    } while (!frames_.empty() && !frames_.front().keyframe);
+}
+
+void RewindBuffer::rememberStats(const GameStatistics &stats) {
+    stats_ = {stats.getPoints(), stats.getLevel(), stats.getLives()};
+}
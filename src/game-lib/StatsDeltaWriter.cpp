@@ -0,0 +1,82 @@
+#include <optional>
+#include <utility>
+
+#include "include/StatsDeltaWriter.h"
+
+namespace {
+    std::optional<unsigned int> readVarint(std::istream &input) {
+        unsigned int value = 0;
+        for (unsigned int shift = 0; shift < 35; shift += 7) {
+            int byte = input.get();
+            if (byte == std::istream::traits_type::eof()) {
+                return std::nullopt;
+            }
+            value |= static_cast<unsigned int>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+}
+
+StatsDeltaWriter::StatsDeltaWriter(std::ostream &output) : output_(output) {}
+
+void StatsDeltaWriter::write(const GameStatistics::Delta &delta) {
+    writeVarint(delta.sequence);
+    output_.put(static_cast<char>(delta.changed & GameStatistics::AllFields));
+    bytesWritten_++;
+    if (delta.changed & GameStatistics::Points) {
+        writeVarint(delta.points);
+    }
+    if (delta.changed & GameStatistics::Level) {
+        writeVarint(delta.level);
+    }
+    if (delta.changed & GameStatistics::Lives) {
+        writeVarint(delta.lives);
+    }
+}
+
+GameStatistics::DeltaListener StatsDeltaWriter::getListener() {
+    return [this](const GameStatistics::Delta &delta) { write(delta); };
+}
+
+std::size_t StatsDeltaWriter::getBytesWritten() const {
+    return bytesWritten_;
+}
+
+std::vector<GameStatistics::Delta> StatsDeltaWriter::read(std::istream &input) {
+    std::vector<GameStatistics::Delta> deltas;
+    while (true) {
+        GameStatistics::Delta delta;
+        std::optional<unsigned int> sequence = readVarint(input);
+        int changed = input.get();
+        if (!sequence || changed == std::istream::traits_type::eof()) {
+            return deltas;
+        }
+        delta.sequence = *sequence;
+        delta.changed = static_cast<unsigned int>(changed) & GameStatistics::AllFields;
+        for (auto [field, value]: {std::pair{GameStatistics::Points, &delta.points},
+                                   std::pair{GameStatistics::Level, &delta.level},
+                                   std::pair{GameStatistics::Lives, &delta.lives}}) {
+            if (delta.changed & field) {
+                std::optional<unsigned int> read = readVarint(input);
+                if (!read) {
+                    return deltas;
+                }
+                *value = *read;
+            }
+        }
+        deltas.push_back(delta);
+    }
+}
+
+void StatsDeltaWriter::writeVarint(unsigned int value) {
+    while (value >= 0x80) {
+        output_.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+        bytesWritten_++;
+    }
+    output_.put(static_cast<char>(value));
+    bytesWritten_++;
+}
@@ -5,13 +5,19 @@
 #ifndef PROI_PROJEKT_GAME_H
 #define PROI_PROJEKT_GAME_H
 
+#include <cstdint>
+#include <fstream>
 #include <memory>
+#include <string>
 
 #include "GameState.h"
 #include "KeyboardController.h"
 #include "Menu.h"
 #include "GameStatsIO.h"
+#include "StatsDeltaWriter.h"
+#include "RewindBuffer.h"
 #include "../../board-lib/include/Board.h"
+#include "../../board-lib/include/LevelWatcher.h"
 #include "../../graphic-lib/include/Window.h"
 #include "../../graphic-lib/include/GraphicEventHandler.h"
 
@@ -36,6 +42,16 @@ class BotController;
  */
 class Game {
 public:
+    /**
+     * File matches are saved to by ::quickSave() when they are not autosaved
+     */
+    static constexpr const char *DefaultSnapshotFilename = "./snapshot.dat";
+
+    /**
+     * Seconds between autosaves, see ::autosave()
+     */
+    static constexpr unsigned int AutosaveInterval = 30;
+
     Game() = delete;
 
     /**
@@ -78,7 +94,7 @@ public:
     void setMenuState();
 
     /**
-     * Quits the game
+     * Quits the game, writing the recorded games to the scoreboard file
      */
     void quit();
 
@@ -108,12 +124,72 @@ public:
     void start();
 
     /**
-     * Ends the game and clears the board
+     * Ends the game, records it on the scoreboard and clears the board
      *
      * Possibly queues multiple instances of Event::EntityRemoved, always queues Event::StateChanged
      */
     void end();
 
+    /**
+     * Reloads levels when their files change, for tuning maps (see LevelWatcher). Should be called before ::run()
+     */
+    void watchLevels();
+
+    /**
+     * Makes bots of every type plan ahead with simulations (see BotController::setLookahead), for a harder game.
+     * Should be called before ::run()
+     */
+    void playHard();
+
+    /**
+     * Writes changes of the statistics to a file, for telemetry (see StatsDeltaWriter). Should be called before ::run()
+     * @param filename
+     * @return Whether the file was opened
+     */
+    bool exportStats(const std::string &filename);
+
+    /**
+     * Saves the state of the match being played, so it can be resumed with ::resumeFrom() (see GameSnapshot)
+     * @param filename
+     * @return Whether the file was written
+     */
+    bool saveSnapshot(const std::string &filename);
+
+    /**
+     * Saves the match being played every AutosaveInterval seconds, and when it is left for the menu. ::quickSave()
+     * saves to the same file. Should be called before ::run()
+     * @param filename
+     */
+    void autosave(const std::string &filename);
+
+    /**
+     * Saves the match being played to the autosave file, or to DefaultSnapshotFilename when it is not autosaved.
+     * Failures are reported on the standard error
+     * @return Whether the file was written
+     */
+    bool quickSave();
+
+    /**
+     * Resumes a match from a snapshot once the game is set up, instead of starting in the menu. Should be called
+     * before ::run()
+     * @param filename
+     */
+    void resumeFrom(const std::string &filename);
+
+    /**
+     * Keeps the last seconds of every match, so it can be rewound (see RewindBuffer). Should be called before ::run()
+     * @param seconds
+     */
+    void recordHistory(unsigned int seconds);
+
+    /**
+     * Rewinds the match being played by a number of seconds, or to the oldest tick kept if it is not as old.
+     * The match is rewound once the events of the tick are handled, as they refer to the entities being replaced.
+     * Does nothing if no history is kept
+     * @param seconds
+     */
+    void rewind(unsigned int seconds);
+
 protected:
     /**
      * Called right before starting the event loop. Sets all remaining attrs, creates the render window,
@@ -184,6 +260,41 @@ protected:
 
     std::unique_ptr<GraphicEventHandler> graphicEventHandler_;
 
+    /**
+     * Only set in development, see ::watchLevels()
+     */
+    std::unique_ptr<LevelWatcher> levelWatcher_;
+
+    bool hard_ = false;
+
+    /**
+     * Seed of the bots' random generator in the current match, recorded on the scoreboard. 0 for resumed matches
+     */
+    std::uint32_t seed_ = 0;
+
+    /**
+     * Only set when exporting, see ::exportStats()
+     */
+    std::unique_ptr<std::ofstream> statsExport_;
+    std::unique_ptr<StatsDeltaWriter> statsDeltaWriter_;
+
+    /**
+     * Only set when recording history, see ::recordHistory()
+     */
+    std::unique_ptr<RewindBuffer> rewindBuffer_;
+    unsigned int pendingRewind_ = 0;
+
+    /**
+     * Only set when autosaving, see ::autosave()
+     */
+    std::string autosaveFilename_;
+    unsigned int ticksSinceAutosave_ = 0;
+
+    /**
+     * Only set when resuming, see ::resumeFrom()
+     */
+    std::string resumeFilename_;
+
 };
 
 
@@ -0,0 +1,78 @@
+#ifndef PROI_PROJEKT_GAMESNAPSHOT_H
+#define PROI_PROJEKT_GAMESNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../core-lib/include/Snapshot.h"
+
+class Board;
+class BotController;
+class GameStatistics;
+
+/**
+ * \brief Saves the state of a match, so it can be resumed from the same tick
+ *
+ * A snapshot is a header followed by the states of the board (the grid and all entities), of BotController and of
+ * GameStatistics, in the byte order of the machine (see SnapshotWriter):
+ *  - header: uint32 Magic, uint32 Version, uint32 size of the states, uint32 checksum of the states
+ *  - the states, as written by their saveState methods
+ * A 52x52 match with a few dozen entities takes a few kilobytes and is saved or restored in microseconds, so a
+ * snapshot can be taken every tick for crash recovery, or to bisect a bug by resuming from the ticks before it.
+ *
+ * Behavior trees, scripts and decisions of bots are not saved, restored bots start deciding over. The level preloader
+ * and the scoreboard are not a part of the match.
+ *
+ * Class does not provide a constructor and all of it's methods are static, like GridBuilder.
+ */
+class GameSnapshot {
+public:
+    /**
+     * "TSNP"
+     */
+    static constexpr std::uint32_t Magic = 0x504e5354;
+    static constexpr std::uint32_t Version = 1;
+
+    static constexpr std::size_t HeaderSize = 4 * sizeof(std::uint32_t);
+
+    /**
+     * Saves the state of a match
+     * @return The snapshot
+     */
+    static std::vector<std::uint8_t> save(const Board &board, const BotController &botController,
+                                          const GameStatistics &stats);
+
+    /**
+     * Restores the state of a match. The header and the checksum are checked before anything is restored, so a
+     * snapshot that is cut short or damaged leaves the match as it was
+     *
+     * Queues the events of Board::loadState
+     * @param snapshot Snapshot written by save
+     * @throws InvalidSnapshot if the snapshot can not be restored
+     */
+    static void restore(const std::vector<std::uint8_t> &snapshot, Board &board, BotController &botController,
+                        GameStatistics &stats);
+
+    /**
+     * Saves the state of a match to a file. The file is replaced atomically, so either the old or the new snapshot is
+     * found after a crash
+     * @return Whether the file was written
+     */
+    static bool saveToFile(const std::string &filename, const Board &board, const BotController &botController,
+                           const GameStatistics &stats);
+
+    /**
+     * Restores the state of a match from a file written by saveToFile
+     * @throws InvalidSnapshot if the file can not be read or restored
+     */
+    static void loadFromFile(const std::string &filename, Board &board, BotController &botController,
+                             GameStatistics &stats);
+
+private:
+    GameSnapshot() = default;
+};
+
+
+#endif //PROI_PROJEKT_GAMESNAPSHOT_H
@@ -5,18 +5,64 @@
 #ifndef PROI_PROJEKT_GAMESTATISTICS_H
 #define PROI_PROJEKT_GAMESTATISTICS_H
 
+#include <cstdint>
+#include <functional>
 #include <list>
 
 #include "../../core-lib/include/EventQueue.h"
 #include "../../core-lib/include/Event.h"
 
 class GameStatsIO;
+class SnapshotReader;
+class SnapshotWriter;
 
 /**
  * Class representing point system in the game
+ *
+ * Setters only mark the fields they change. The changes are published once per tick by ::publishChanges(), as a single
+ * Event::StatisticsChanged with the changed fields and as a Delta passed to the delta listener (see StatsDeltaWriter).
  */
 class GameStatistics {
 public:
+    /**
+     * Flags of fields, used in masks of changed fields
+     */
+    enum Field : unsigned int {
+        Points = 1,
+        Level = 2,
+        Lives = 4,
+        AllFields = Points | Level | Lives
+    };
+
+    /**
+     * Changes published at once
+     */
+    struct Delta {
+        /**
+         * Number of the delta, counted from 0
+         */
+        std::uint32_t sequence = 0;
+
+        /**
+         * Mask of the changed fields
+         */
+        unsigned int changed = 0;
+
+        /**
+         * Values of the changed fields, 0 for the others
+         */
+        unsigned int points = 0;
+        unsigned int level = 0;
+        unsigned int lives = 0;
+
+        bool operator==(const Delta &other) const = default;
+    };
+
+    /**
+     * Called with every published delta
+     */
+    using DeltaListener = std::function<void(const Delta &)>;
+
     /**
      * Creates point system
      * @param startPoints
@@ -32,7 +78,7 @@ public:
     /**
      * Sets points
      *
-     * Queues Event::StatisticsChanged
+     * Marks GameStatistics::Points as changed
      * @param points
      */
     void setPoints(unsigned int pts);
@@ -40,7 +86,7 @@ public:
     /**
      * Adds points to current points
      *
-     * Queues Event::StatisticsChanged
+     * Marks GameStatistics::Points as changed
      * @param points
      */
     void addPoints(unsigned int pts);
@@ -54,7 +100,7 @@ public:
     /**
      * Sets the current level
      *
-     * Queues Event::StatisticsChanged
+     * Marks GameStatistics::Level as changed
      * @param level
      */
     void setLevel(unsigned int level);
@@ -68,7 +114,8 @@ public:
     /**
      * Sets the number of remaining lives
      *
-     * Queues Event::StatisticsChanged
+     * Marks GameStatistics::Lives as changed. When no lives are left, publishes the changes at once and queues
+     * Event::GameEnded after them
      * @param lives
      */
     void setLives(unsigned int lives);
@@ -81,11 +128,51 @@ public:
      * Level = 1
      * Lives = 3
      *
-     * Queues Event::StatisticsChanged
+     * Publishes all fields at once, as the start of a new game
      */
     void resetStats();
 
-    friend class ScoreboardIO;
+    /**
+     * Publishes the fields changed since the last call, should be called once per tick
+     *
+     * Queues Event::StatisticsChanged if any field changed
+     * @return Whether any field changed
+     */
+    bool publishChanges();
+
+    /**
+     * Returns the mask of fields changed since the changes were last published
+     * @return
+     */
+    [[nodiscard]] unsigned int getChangedFields() const;
+
+    /**
+     * Sets the function called with every published delta, for exporting them
+     * @param listener
+     */
+    void setDeltaListener(DeltaListener listener);
+
+    /**
+     * Writes points, level and lives to a snapshot (see GameSnapshot). The scoreboard is not a part of the game
+     * @param writer Snapshot being written
+     */
+    void saveState(SnapshotWriter &writer) const;
+
+    /**
+     * Restores points, level and lives written by saveState and marks all of them as changed, so they are published
+     * with the next changes
+     * @param reader Snapshot being read
+     * @throws InvalidSnapshot if the snapshot ends before the stats
+     */
+    void loadState(SnapshotReader &reader);
+
+    /**
+     * Returns the points of the best games, the best one first (see GameStatsIO::loadScoreboard)
+     * @return
+     */
+    [[nodiscard]] const std::list<unsigned int> &getScoreboard() const;
+
+    friend class GameStatsIO;
 
 private:
     unsigned int points_;
@@ -94,6 +181,10 @@ private:
 
     std::list<unsigned int> scoreboard_;
 
+    unsigned int changed_ = 0;
+    std::uint32_t nextSequence_ = 0;
+    DeltaListener deltaListener_;
+
     EventQueue<Event> *eventQueue_ = EventQueue<Event>::instance();
 };
 
@@ -5,43 +5,217 @@
 #ifndef PROI_PROJEKT_GAMESTATSIO_H
 #define PROI_PROJEKT_GAMESTATSIO_H
 
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 class GameStatistics;
 
+class InvalidScoreboardFile : public std::exception {
+public:
+    explicit InvalidScoreboardFile(std::string message = "Invalid scoreboard file");
+
+    const char *what() const noexcept override;
+
+private:
+    std::string what_message;
+};
+
 /**
  * Used for loading and saving scoreboards
+ *
+ * The scoreboard file is an append-only log of finished games, in the byte order of the machine:
+ *  - header: uint32 Magic, uint32 FileVersion
+ *  - records of 32 bytes: uint32 points, level, lives, checksum of the record, int64 timestamp, uint64 seed
+ *
+ * Records are buffered and written FlushBatch at a time, followed by a single fsync. A crash can only cut the last
+ * write short, so loading stops at the first record that is cut or does not match it's checksum, and the log is
+ * truncated to the records before it when it is next written to.
+ *
+ * Only the best ScoreboardSize records are kept in memory. They are found by streaming the mapped log once, when the
+ * scoreboard is loaded. ::compact() drops all other records, by writing the best ones to a new file and renaming it
+ * over the log.
+ *
+ * Streaming millions of records takes longer than loading should, so after every write the best records are also
+ * saved in a checkpoint next to the log (scoreboard file + CheckpointSuffix), with the number of records they were
+ * picked from and a copy of the last of them. Loading only streams the records after the checkpoint, and falls back to
+ * the whole log when the checkpoint is missing, broken or does not match the log. The checkpoint is just a cache, it
+ * is written without fsync.
  */
 class GameStatsIO {
 public:
+    /**
+     * "TSCB"
+     */
+    static constexpr std::uint32_t Magic = 0x42435354;
+    static constexpr std::uint32_t FileVersion = 1;
+
+    static constexpr const char *DefaultFilename = "./scoreboard.dat";
+    static constexpr const char *CheckpointSuffix = ".top";
+
+    /**
+     * Number of records on the scoreboard
+     */
+    static constexpr std::size_t ScoreboardSize = 10;
+
+    /**
+     * Number of records written to the log at once
+     */
+    static constexpr std::size_t FlushBatch = 64;
+
+    /**
+     * Records in the file per record on the scoreboard, above which the file should be compacted
+     */
+    static constexpr std::size_t CompactionRatio = 100;
+
+    /**
+     * A finished game
+     */
+    struct Record {
+        unsigned int points = 0;
+        unsigned int level = 0;
+        unsigned int lives = 0;
+
+        /**
+         * Seconds since the epoch, when the game was recorded
+         */
+        std::int64_t timestamp = 0;
+
+        /**
+         * Seed the bots of the game were played with (see BotController::setSeed), 0 if it is not known
+         */
+        std::uint64_t seed = 0;
+
+        /**
+         * Orders records the way the scoreboard shows them: more points first, older records first on ties
+         */
+        [[nodiscard]] bool isBetterThan(const Record &other) const;
+    };
+
     GameStatsIO() = delete;
 
+    GameStatsIO(const GameStatsIO &) = delete;
+
+    GameStatsIO &operator=(const GameStatsIO &) = delete;
+
     /**
      * Inits class GameStatsIO
      * @param n_scoreboardFilename Path to scoreboard file
      */
-    explicit GameStatsIO(std::string n_scoreboardFilename) : scoreboardFilename(std::move(n_scoreboardFilename)) {};
+    explicit GameStatsIO(std::string n_scoreboardFilename);
+
+    /**
+     * Flushes the records left in the buffer
+     */
+    ~GameStatsIO();
 
     /**
-     * Loads the scoreboard from the given file and returns a GameStatistics instance with scoreboard field filled
-     *
-     * DOES NOTHING - PLACEHOLDER
+     * Loads the scoreboard from the given file and returns a GameStatistics instance with scoreboard field filled.
+     * A missing file is an empty scoreboard
      * @return A new scoreboard
+     * @throws InvalidScoreboardFile if the file is not a scoreboard
      */
     std::unique_ptr<GameStatistics> loadScoreboard();
 
     /**
-     * Extracts and saves the gameStats to given file
-     *
-     * DOES NOTHING - PLACEHOLDER
-     * @param gameStats Stats object containing the scoreboard that should be saved
+     * Writes all records added so far to the file
+     * @return Whether they were written
+     */
+    bool saveScoreboard();
+
+    /**
+     * Records a finished game. Records are written to the file FlushBatch at a time
+     * @param stats Stats at the end of the game
+     * @param seed Seed the bots of the game were played with
      */
-    void saveScoreboard(std::unique_ptr<GameStatistics> gameStats);
+    void addRecord(const GameStatistics &stats, std::uint64_t seed = 0);
+
+    /**
+     * Records a finished game. Records are written to the file FlushBatch at a time
+     * @param record The game, with it's timestamp already set
+     */
+    void addRecord(const Record &record);
+
+    /**
+     * Replaces the file with one holding only the records on the scoreboard. The file is replaced atomically, so
+     * either the old or the new one is found after a crash
+     * @return Whether the file was replaced
+     */
+    bool compact();
+
+    /**
+     * Returns the best records, the best one first
+     * @return
+     */
+    [[nodiscard]] const std::vector<Record> &getTopRecords() const;
+
+    /**
+     * Returns the number of records in the file and in the buffer
+     * @return
+     */
+    [[nodiscard]] std::size_t getRecordCount() const;
+
+    /**
+     * Returns whether the file holds far more records than the scoreboard, see CompactionRatio
+     * @return
+     */
+    [[nodiscard]] bool needsCompaction() const;
 
 private:
+    /**
+     * Streams the file, counting it's records up to the first broken one and putting the best ones on the scoreboard
+     * @throws InvalidScoreboardFile if the file is not a scoreboard
+     */
+    void scanLog();
+
+    /**
+     * Takes the scoreboard from the checkpoint, if it matches the mapped log
+     * @param records Records of the log
+     * @param count Number of them
+     * @return Number of records the checkpoint was made from, 0 if it was not used
+     */
+    std::size_t loadCheckpoint(const void *records, std::size_t count);
+
+    /**
+     * Saves the scoreboard of the records in the file, ignoring failures
+     * @param last The last record in the file
+     */
+    void saveCheckpoint(const Record &last);
+
+    /**
+     * Puts a record on the scoreboard, if it is good enough
+     */
+    void rankRecord(const Record &record);
+
+    /**
+     * Opens the file for appending, creating it or cutting a broken end off it
+     * @return Whether the file is open, false also if it is not a scoreboard
+     */
+    bool openLog();
+
     std::string scoreboardFilename;
+
+    std::vector<Record> top_;
+    std::vector<Record> pending_;
+
+    /**
+     * Records in the file, not counting the buffered ones
+     */
+    std::size_t recordCount_ = 0;
+
+    /**
+     * Whether the file has been streamed, so the number of it's records is known
+     */
+    bool scanned_ = false;
+
+    /**
+     * Descriptor of the file opened for appending, or -1
+     */
+    int log_ = -1;
 };
 
 
@@ -0,0 +1,194 @@
+#ifndef PROI_PROJEKT_REWINDBUFFER_H
+#define PROI_PROJEKT_REWINDBUFFER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../core-lib/include/Snapshot.h"
+#include "../../tank-lib/include/EntityController.h"
+
+class Board;
+class BotController;
+class Entity;
+class Event;
+class GameStatistics;
+
+/**
+ * \brief Keeps the last ticks of a match, so it can be rewound to any of them
+ *
+ * Every tick is recorded as a frame in a ring of a fixed size, allocated up front. Every KeyframeInterval ticks (and
+ * after a level is loaded) the frame is a keyframe: a GameSnapshot of the match, with the ids of the entities in it.
+ * Other frames are deltas from the tick before, built from the events of the tick (see ::observe()):
+ *  - ids of entities removed (Event::EntityRemoved)
+ *  - states of entities spawned, with the tanks that fired spawned bullets
+ *  - changed fields of the other entities (position, direction, moving flag, lives, decision cooldown), which are
+ *  compared for every entity as moving flags and cooldowns change without events
+ *  - tiles placed, changed or deleted (Event::TilePlaced, Event::TileChanged, Event::TileDeleted)
+ *  - the statistics, if they changed
+ * so a tick in which a few tanks moved takes a few dozen bytes. Seeking restores the keyframe before the tick and
+ * applies the deltas after it, which takes about as long as restoring a snapshot.
+ *
+ * The ring keeps at least the ticks of the window: a keyframe and it's deltas are dropped together, once the next
+ * keyframe is old enough to start the window, or when the ring is full. BotController is only saved in keyframes, so
+ * a tick between them is restored with the spawn cooldown, tank types and random generator of the keyframe before it.
+ */
+class RewindBuffer {
+public:
+    static constexpr std::size_t DefaultCapacity = 4 * 1024 * 1024;
+    static constexpr unsigned int DefaultKeyframeInterval = 60;
+
+    /**
+     * @param windowTicks Number of the last ticks that can be rewound to
+     * @param capacity Size of the ring in bytes, the memory used by frames never grows past it
+     * @param keyframeInterval Number of ticks between keyframes
+     */
+    explicit RewindBuffer(unsigned int windowTicks, std::size_t capacity = DefaultCapacity,
+                          unsigned int keyframeInterval = DefaultKeyframeInterval);
+
+    /**
+     * Notes the changes named by an event, should be called for every event handled since the last recorded tick
+     * @param event
+     */
+    void observe(const Event &event);
+
+    /**
+     * Records the next tick. Frames after the tick last rewound to are dropped first
+     * @return Whether the tick was recorded, false if a keyframe does not fit in the ring
+     */
+    bool record(Board &board, const BotController &botController, const GameStatistics &stats);
+
+    /**
+     * Restores the match to a recorded tick. The frames after it are kept, so the match can be replayed by seeking
+     * forwards, until the next tick is recorded
+     *
+     * Queues the events of GameSnapshot::restore, and events of the changes after the keyframe
+     * @param tick A tick between ::getFirstTick() and ::getLastTick()
+     * @return Whether the tick was restored, false if it is not in the ring
+     */
+    bool seek(std::uint32_t tick, Board &board, BotController &botController, GameStatistics &stats);
+
+    /**
+     * Drops all frames, the next tick recorded is a keyframe
+     */
+    void clear();
+
+    /**
+     * Returns the oldest tick that can be restored
+     * @return The tick, or std::nullopt if no tick was recorded
+     */
+    [[nodiscard]] std::optional<std::uint32_t> getFirstTick() const;
+
+    /**
+     * Returns the last tick recorded
+     * @return The tick, or std::nullopt if no tick was recorded
+     */
+    [[nodiscard]] std::optional<std::uint32_t> getLastTick() const;
+
+    /**
+     * Returns the number of ticks that can be restored
+     * @return
+     */
+    [[nodiscard]] std::size_t getFrameCount() const;
+
+    [[nodiscard]] std::size_t getKeyframeCount() const;
+
+    /**
+     * Returns the number of bytes taken by frames in the ring
+     * @return
+     */
+    [[nodiscard]] std::size_t getUsedBytes() const;
+
+    /**
+     * Returns the memory held by the buffer: the ring, the index of frames and the entities tracked between ticks
+     * @return Bytes
+     */
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+
+    [[nodiscard]] std::size_t getCapacity() const;
+
+private:
+    /**
+     * Fields of an entity that changed, in a delta
+     */
+    enum ChangedField : std::uint8_t {
+        X = 1,
+        Y = 2,
+        Facing = 4,
+        Moving = 8,
+        Lives = 16,
+        Cooldown = 32
+    };
+
+    struct Frame {
+        std::uint32_t tick;
+        std::size_t offset;
+        std::size_t size;
+        bool keyframe;
+    };
+
+    /**
+     * An entity as it was in the last recorded tick
+     */
+    struct Tracked {
+        std::uint32_t id;
+        EntityController::EntityState state;
+    };
+
+    /**
+     * Writes a keyframe of the match to scratch_, and starts tracking the entities again
+     */
+    void encodeKeyframe(Board &board, const BotController &botController, const GameStatistics &stats);
+
+    /**
+     * Writes a delta from the last recorded tick to scratch_
+     */
+    void encodeDelta(Board &board, const GameStatistics &stats);
+
+    /**
+     * Applies a delta to the match
+     * @param entities Entities of the match by their ids
+     */
+    void applyDelta(const Frame &frame, Board &board, GameStatistics &stats,
+                    std::unordered_map<std::uint32_t, std::shared_ptr<Entity>> &entities) const;
+
+    /**
+     * Copies scratch_ to the ring as the next frame, dropping the oldest frames to make space
+     * @return Whether the frame was stored, false if it is a delta and the frames before it had to be dropped too
+     */
+    bool store(bool keyframe);
+
+    /**
+     * Drops the oldest keyframe and it's deltas
+     */
+    void dropOldestKeyframe();
+
+    void rememberStats(const GameStatistics &stats);
+
+    std::vector<std::uint8_t> ring_;
+    std::deque<Frame> frames_;
+    std::size_t usedBytes_ = 0;
+    std::size_t keyframeCount_ = 0;
+
+    unsigned int windowTicks_;
+    unsigned int keyframeInterval_;
+
+    std::uint32_t nextTick_ = 0;
+    bool needsKeyframe_ = true;
+    SnapshotWriter scratch_;
+
+    std::unordered_map<const Entity *, Tracked> tracked_;
+    std::uint32_t nextId_ = 0;
+    std::vector<std::uint32_t> removed_;
+    std::vector<std::pair<unsigned int, unsigned int>> changedTiles_;
+    std::array<std::uint32_t, 3> stats_{};
+};
+
+
+#endif //PROI_PROJEKT_REWINDBUFFER_H
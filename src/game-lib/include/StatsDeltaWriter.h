@@ -0,0 +1,61 @@
+#ifndef PROI_PROJEKT_STATSDELTAWRITER_H
+#define PROI_PROJEKT_STATSDELTAWRITER_H
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "GameStatistics.h"
+
+/**
+ * \brief Exports the delta stream of GameStatistics, for telemetry
+ *
+ * A delta is written as:
+ *  - it's sequence number, as a varint (7 bits per byte, lowest first, the high bit set on all bytes but the last)
+ *  - a byte with the mask of changed fields
+ *  - the values of the changed fields, in the order of GameStatistics::Field, as varints
+ * so a tick in which a tank was killed takes a few bytes. Nothing is written for ticks without changes, gaps in
+ * sequence numbers show lost deltas.
+ */
+class StatsDeltaWriter {
+public:
+    /**
+     * @param output Stream the deltas are written to, must outlive the writer
+     */
+    explicit StatsDeltaWriter(std::ostream &output);
+
+    /**
+     * Writes a delta, flushing it only with the stream's own buffering
+     * @param delta
+     */
+    void write(const GameStatistics::Delta &delta);
+
+    /**
+     * Returns a listener writing deltas with this writer (see GameStatistics::setDeltaListener)
+     * @return
+     */
+    GameStatistics::DeltaListener getListener();
+
+    /**
+     * Returns the number of bytes written so far
+     * @return
+     */
+    [[nodiscard]] std::size_t getBytesWritten() const;
+
+    /**
+     * Reads deltas written by a writer, up to the end of the stream or the first one cut short
+     * @param input
+     * @return
+     */
+    static std::vector<GameStatistics::Delta> read(std::istream &input);
+
+private:
+    void writeVarint(unsigned int value);
+
+    std::ostream &output_;
+    std::size_t bytesWritten_ = 0;
+};
+
+
+#endif //PROI_PROJEKT_STATSDELTAWRITER_H
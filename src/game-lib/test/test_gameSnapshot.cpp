@@ -0,0 +1,231 @@
+#include <filesystem>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/GameSnapshot.h"
+#include "../include/GameStatistics.h"
+
+#include "../../board-lib/include/Board.h"
+#include "../../board-lib/include/Grid.h"
+#include "../../tank-lib/include/Bullet.h"
+#include "../../tank-lib/include/EntityController.h"
+#include "../../bot-lib/include/Bot.h"
+#include "../../bot-lib/include/BotController.h"
+#include "../../core-lib/include/Clock.h"
+#include "../../core-lib/include/EventQueue.h"
+#include "../../core-lib/include/Snapshot.h"
+
+namespace {
+    namespace helper {
+        void initSingletons() {
+            Clock::initialize(60);
+            BotController::initialize(4, 240);
+        }
+
+        /**
+         * A level with bricks and steel, a player who has fired a bullet and bots, one of them with a bullet too
+         */
+        void prepareMatch(Board &board, GameStatistics &stats, unsigned int botCount = 3) {
+            for (unsigned int x = 0; x < 52; x += 5) {
+                board.getGrid()->setTile(x, 20, x % 2 == 0 ? Bricks : Steel);
+            }
+            board.getGrid()->setTile(30, 30, Water);
+            board.spawnPlayer(24, 44, North);
+            board.fireTank(board.getPlayerTank());
+            for (unsigned int i = 0; i < botCount; i++) {
+                board.spawnTank(2 + (i % 8) * 6, 2 + (i / 8 % 3) * 6, static_cast<Tank::TankType>(1 + i % 4), South);
+            }
+            auto bot = std::dynamic_pointer_cast<Bot>(board.getEntityController()->getAllEntities()->back());
+            bot->setDecisionCooldown(17);
+            board.fireTank(std::dynamic_pointer_cast<Tank>(bot));
+
+            BotController::instance()->setSpawnpoints({{2, 2}, {24, 2}, {46, 2}});
+            BotController::instance()->setTypes(std::queue<Tank::TankType>({Tank::FastTank, Tank::ArmorTank}));
+            stats.setPoints(1200);
+            stats.setLevel(3);
+            stats.setLives(2);
+            stats.publishChanges();
+            EventQueue<Event>::instance()->clear();
+        }
+
+        void messUpMatch(Board &board, GameStatistics &stats) {
+            board.removeAllEntities();
+            board.deleteTile(0, 20);
+            board.spawnTank(10, 10, Tank::BasicTank);
+            BotController::instance()->setTypes({});
+            stats.setPoints(5);
+            EventQueue<Event>::instance()->clear();
+        }
+    }
+}
+
+SCENARIO("Restoring a match from a snapshot") {
+    helper::initSingletons();
+    GIVEN("A match in progress") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board, stats);
+        std::vector<std::uint8_t> snapshot = GameSnapshot::save(board, *BotController::instance(), stats);
+
+        WHEN("The match changes and is restored") {
+            helper::messUpMatch(board, stats);
+            GameSnapshot::restore(snapshot, board, *BotController::instance(), stats);
+
+            THEN("Saving it again should give the same snapshot") {
+                REQUIRE(GameSnapshot::save(board, *BotController::instance(), stats) == snapshot);
+            }
+
+            THEN("Tiles, entities and stats should be restored") {
+                REQUIRE(board.getGrid()->getTileAtPosition(0, 20) == Bricks);
+                REQUIRE(board.getGrid()->getTileAtPosition(5, 20) == Steel);
+                REQUIRE(board.getGrid()->getTileAtPosition(30, 30) == Water);
+
+                std::vector<std::shared_ptr<Entity>> *entities = board.getEntityController()->getAllEntities();
+                REQUIRE(entities->size() == 6);
+                REQUIRE(board.getPlayerTank() != nullptr);
+                REQUIRE(board.getPlayerTank()->getX() == 24);
+                REQUIRE(stats.getPoints() == 1200);
+                REQUIRE(stats.getLevel() == 3);
+                REQUIRE(stats.getLives() == 2);
+                REQUIRE(stats.getChangedFields() == GameStatistics::AllFields);
+            }
+
+            THEN("Bullets should be linked to the tanks that fired them") {
+                std::vector<std::shared_ptr<Entity>> *entities = board.getEntityController()->getAllEntities();
+                REQUIRE(board.getPlayerTank()->getBullet().has_value());
+                REQUIRE(board.getPlayerTank()->getBullet().value() == dynamic_cast<Bullet *>((*entities)[1].get()));
+                REQUIRE(board.getPlayerTank()->getBullet().value()->isFriendly());
+
+                auto bot = std::dynamic_pointer_cast<Bot>((*entities)[4]);
+                REQUIRE(bot->getDecisionCooldown() == 17);
+                REQUIRE(std::dynamic_pointer_cast<Tank>(bot)->getBullet().value() ==
+                        dynamic_cast<Bullet *>((*entities)[5].get()));
+            }
+
+            THEN("The bot counter should count the restored bots") {
+                REQUIRE(BotController::instance()->getRegisteredBotsCount() == 3);
+            }
+
+            THEN("The level and the restored entities should be announced") {
+                EventQueue<Event> *eventQueue = EventQueue<Event>::instance();
+                std::unique_ptr<Event> event = eventQueue->pop();
+                while (event->type == Event::EntityRemoved) {
+                    event = eventQueue->pop();
+                }
+                REQUIRE(event->type == Event::LevelLoaded);
+                REQUIRE(eventQueue->pop()->type == Event::PlayerSpawned);
+                REQUIRE(eventQueue->pop()->type == Event::EntitySpawned);
+            }
+        }
+
+        WHEN("The snapshot is saved to a file and loaded") {
+            std::filesystem::path path = std::filesystem::temp_directory_path() / "tanks_test_snapshot.dat";
+            REQUIRE(GameSnapshot::saveToFile(path.string(), board, *BotController::instance(), stats));
+            helper::messUpMatch(board, stats);
+            GameSnapshot::loadFromFile(path.string(), board, *BotController::instance(), stats);
+            std::filesystem::remove(path);
+
+            THEN("The match should be restored") {
+                REQUIRE(GameSnapshot::save(board, *BotController::instance(), stats) == snapshot);
+            }
+        }
+    }
+}
+
+SCENARIO("Restoring broken snapshots") {
+    helper::initSingletons();
+    GIVEN("A match and it's snapshot") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board, stats);
+        std::vector<std::uint8_t> snapshot = GameSnapshot::save(board, *BotController::instance(), stats);
+        helper::messUpMatch(board, stats);
+        std::vector<std::uint8_t> changed = GameSnapshot::save(board, *BotController::instance(), stats);
+
+        WHEN("The snapshot is cut short") {
+            snapshot.resize(snapshot.size() - 1);
+
+            THEN("It should not be restored, and the match should be left as it was") {
+                REQUIRE_THROWS_AS(GameSnapshot::restore(snapshot, board, *BotController::instance(), stats),
+                                  InvalidSnapshot);
+                REQUIRE(GameSnapshot::save(board, *BotController::instance(), stats) == changed);
+            }
+        }
+
+        WHEN("A byte of the snapshot is damaged") {
+            snapshot[snapshot.size() / 2] ^= 0x40;
+
+            THEN("It should not be restored") {
+                REQUIRE_THROWS_AS(GameSnapshot::restore(snapshot, board, *BotController::instance(), stats),
+                                  InvalidSnapshot);
+                REQUIRE(GameSnapshot::save(board, *BotController::instance(), stats) == changed);
+            }
+        }
+
+        WHEN("The snapshot has another version") {
+            snapshot[4]++;
+
+            THEN("It should not be restored") {
+                REQUIRE_THROWS_AS(GameSnapshot::restore(snapshot, board, *BotController::instance(), stats),
+                                  InvalidSnapshot);
+            }
+        }
+
+        WHEN("The board's state holds an unknown entity") {
+            SnapshotWriter writer;
+            board.saveState(writer);
+            std::vector<std::uint8_t> state = writer.takeBytes();
+            // the kind of the last entity, the bot spawned by messUpMatch
+            state[state.size() - 2 * sizeof(std::uint32_t) - 2 - 2 * sizeof(FixedPoint::Value) - 1] = 42;
+            SnapshotReader reader(state.data(), state.size());
+
+            THEN("The board should be left as it was") {
+                REQUIRE_THROWS_AS(board.loadState(reader), InvalidSnapshot);
+                REQUIRE(GameSnapshot::save(board, *BotController::instance(), stats) == changed);
+            }
+        }
+    }
+}
+
+SCENARIO("Benchmarking snapshots", "[.][benchmark]") {
+    helper::initSingletons();
+    GIVEN("A 52x52 match") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board, stats, 20);
+        std::vector<std::uint8_t> snapshot = GameSnapshot::save(board, *BotController::instance(), stats);
+
+        THEN("It should be saved and restored well under a millisecond") {
+            BENCHMARK("Saving") {
+                return GameSnapshot::save(board, *BotController::instance(), stats).size();
+            };
+            BENCHMARK("Restoring") {
+                GameSnapshot::restore(snapshot, board, *BotController::instance(), stats);
+                EventQueue<Event>::instance()->clear();
+                return board.getEntityController()->getAllEntities()->size();
+            };
+        }
+    }
+
+    GIVEN("A match with thousands of entities") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board, stats, 5000);
+        std::vector<std::uint8_t> snapshot = GameSnapshot::save(board, *BotController::instance(), stats);
+
+        THEN("It should be saved and restored in a few milliseconds") {
+            BENCHMARK("Saving") {
+                return GameSnapshot::save(board, *BotController::instance(), stats).size();
+            };
+            BENCHMARK("Restoring") {
+                GameSnapshot::restore(snapshot, board, *BotController::instance(), stats);
+                EventQueue<Event>::instance()->clear();
+                return board.getEntityController()->getAllEntities()->size();
+            };
+        }
+    }
+}
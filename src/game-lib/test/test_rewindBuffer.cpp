@@ -0,0 +1,276 @@
+#include <memory>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/RewindBuffer.h"
+#include "../include/GameSnapshot.h"
+#include "../include/GameStatistics.h"
+
+#include "../../board-lib/include/Board.h"
+#include "../../board-lib/include/FlowField.h"
+#include "../../board-lib/include/Grid.h"
+#include "../../tank-lib/include/EntityController.h"
+#include "../../bot-lib/include/Bot.h"
+#include "../../bot-lib/include/BotController.h"
+#include "../../core-lib/include/Clock.h"
+#include "../../core-lib/include/EventQueue.h"
+
+namespace {
+    namespace helper {
+        void initSingletons() {
+            Clock::initialize(60);
+            BotController::initialize(4, 240);
+        }
+
+        std::vector<std::shared_ptr<Tank>> getTanks(Board &board) {
+            std::vector<std::shared_ptr<Tank>> tanks;
+            for (const std::shared_ptr<Entity> &entity: *board.getEntityController()->getAllEntities()) {
+                if (auto tank = std::dynamic_pointer_cast<Tank>(entity)) {
+                    tanks.push_back(tank);
+                }
+            }
+            return tanks;
+        }
+
+        /**
+         * A player and moving bots, between bricks
+         */
+        void prepareMatch(Board &board, unsigned int botCount = 4) {
+            for (unsigned int x = 0; x < 52; x += 5) {
+                board.getGrid()->setTile(x, 20, Bricks);
+            }
+            board.spawnPlayer(24, 44, North);
+            for (unsigned int i = 0; i < botCount; i++) {
+                board.spawnTank(1 + (i % 8) * 6, 1 + (i / 8 % 3) * 6, static_cast<Tank::TankType>(1 + i % 4), South);
+            }
+            for (const std::shared_ptr<Tank> &tank: getTanks(board)) {
+                board.setTankMoving(tank, true);
+            }
+        }
+
+        /**
+         * Changes the match the way a tick of the game does
+         */
+        void playTick(Board &board, GameStatistics &stats, unsigned int tick) {
+            std::vector<std::shared_ptr<Tank>> tanks = getTanks(board);
+            if (tick % 9 == 3) {
+                board.fireTank(tanks[tick % tanks.size()]);
+            }
+            if (tick % 13 == 7) {
+                board.deleteTile(tick % 11 * 5, 20);
+            }
+            if (tick % 17 == 12 && tanks.size() > 2) {
+                board.removeEntity(tanks.back());
+            }
+            if (tick % 17 == 15) {
+                board.spawnTank(44, 30, Tank::FastTank, West);
+                board.setTankMoving(getTanks(board).back(), true);
+            }
+            if (tick % 11 == 5) {
+                board.setTankDirection(board.getPlayerTank(), static_cast<Direction>(tick % 4));
+            }
+            if (tick % 5 == 2) {
+                stats.addPoints(100);
+                std::dynamic_pointer_cast<Bot>(tanks.back())->setDecisionCooldown(tick);
+            }
+            board.moveAllEntities();
+        }
+
+        void recordTick(RewindBuffer &buffer, Board &board, GameStatistics &stats) {
+            EventQueue<Event> *eventQueue = EventQueue<Event>::instance();
+            stats.publishChanges();
+            while (!eventQueue->isEmpty()) {
+                buffer.observe(*eventQueue->pop());
+            }
+            buffer.record(board, *BotController::instance(), stats);
+        }
+
+        /**
+         * Plays and records ticks, returning snapshots of the recorded ones
+         */
+        std::vector<std::vector<std::uint8_t>> playTicks(RewindBuffer &buffer, Board &board, GameStatistics &stats,
+                                                         unsigned int count) {
+            std::vector<std::vector<std::uint8_t>> snapshots;
+            for (unsigned int tick = 0; tick < count; tick++) {
+                recordTick(buffer, board, stats);
+                snapshots.push_back(GameSnapshot::save(board, *BotController::instance(), stats));
+                playTick(board, stats, tick);
+            }
+            return snapshots;
+        }
+
+        std::vector<std::uint8_t> seek(RewindBuffer &buffer, Board &board, GameStatistics &stats, std::uint32_t tick) {
+            REQUIRE(buffer.seek(tick, board, *BotController::instance(), stats));
+            EventQueue<Event>::instance()->clear();
+            return GameSnapshot::save(board, *BotController::instance(), stats);
+        }
+    }
+}
+
+SCENARIO("Rewinding a match") {
+    helper::initSingletons();
+    GIVEN("A match recorded for 100 ticks, with a keyframe every 10 ticks") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board);
+        RewindBuffer buffer(1000, RewindBuffer::DefaultCapacity, 10);
+        std::vector<std::vector<std::uint8_t>> snapshots = helper::playTicks(buffer, board, stats, 100);
+
+        THEN("Every tick should be kept, with a keyframe every 10 of them") {
+            REQUIRE(buffer.getFirstTick() == 0);
+            REQUIRE(buffer.getLastTick() == 99);
+            REQUIRE(buffer.getFrameCount() == 100);
+            REQUIRE(buffer.getKeyframeCount() == 10);
+        }
+
+        THEN("Deltas should take much less than keyframes") {
+            REQUIRE(buffer.getUsedBytes() < 3 * snapshots.back().size() * buffer.getKeyframeCount());
+        }
+
+        WHEN("The match is rewound to any tick") {
+            THEN("It should be the same as it was in that tick") {
+                for (std::uint32_t tick: {99u, 0u, 10u, 37u, 38u, 55u, 89u, 12u, 64u}) {
+                    INFO("Tick " << tick);
+                    REQUIRE(helper::seek(buffer, board, stats, tick) == snapshots[tick]);
+                }
+            }
+        }
+
+        WHEN("The match is rewound and goes on") {
+            helper::seek(buffer, board, stats, 45);
+            helper::recordTick(buffer, board, stats);
+
+            THEN("Ticks after the one rewound to should be recorded again") {
+                REQUIRE(buffer.getLastTick() == 45);
+                REQUIRE(buffer.getFrameCount() == 46);
+                REQUIRE(helper::seek(buffer, board, stats, 45) == snapshots[45]);
+                REQUIRE(helper::seek(buffer, board, stats, 44) == snapshots[44]);
+            }
+        }
+
+        WHEN("The match is rewound to a tick after bricks were shot") {
+            helper::seek(buffer, board, stats, 38);
+
+            THEN("The flow field should be rebuilt for the restored tiles") {
+                REQUIRE(board.getFlowField()->getGridVersion() == board.getGrid()->getVersion());
+            }
+        }
+
+        WHEN("Seeking outside of the recorded ticks") {
+            THEN("The match should not change") {
+                REQUIRE_FALSE(buffer.seek(100, board, *BotController::instance(), stats));
+            }
+        }
+    }
+}
+
+SCENARIO("Rewinding to the tick the last life was lost") {
+    helper::initSingletons();
+    GIVEN("A match recorded until the player lost the last life") {
+        auto eventQueue = EventQueue<Event>::instance();
+        Board board;
+        GameStatistics stats(0, 1, 1);
+        helper::prepareMatch(board);
+        RewindBuffer buffer(1000, RewindBuffer::DefaultCapacity, 10);
+        helper::playTicks(buffer, board, stats, 5);
+        stats.setLives(0);
+        helper::recordTick(buffer, board, stats);
+
+        WHEN("The match is rewound to that tick") {
+            REQUIRE(buffer.seek(5, board, *BotController::instance(), stats));
+
+            THEN("The lives should be restored without ending the game again") {
+                REQUIRE(stats.getLives() == 0);
+                bool ended = false;
+                while (!eventQueue->isEmpty()) {
+                    ended |= eventQueue->pop()->type == Event::GameEnded;
+                }
+                REQUIRE_FALSE(ended);
+            }
+        }
+        eventQueue->clear();
+    }
+}
+
+SCENARIO("Keeping the history in fixed memory") {
+    helper::initSingletons();
+    GIVEN("A buffer keeping 30 ticks") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board);
+        RewindBuffer buffer(30, RewindBuffer::DefaultCapacity, 10);
+        std::vector<std::vector<std::uint8_t>> snapshots = helper::playTicks(buffer, board, stats, 100);
+
+        THEN("Only keyframes older than the window should be dropped") {
+            REQUIRE(buffer.getLastTick() == 99);
+            REQUIRE(buffer.getFrameCount() >= 30);
+            REQUIRE(buffer.getFrameCount() < 40);
+            REQUIRE(helper::seek(buffer, board, stats, buffer.getFirstTick().value()) ==
+                    snapshots[buffer.getFirstTick().value()]);
+            REQUIRE_FALSE(buffer.seek(buffer.getFirstTick().value() - 1, board, *BotController::instance(), stats));
+        }
+    }
+
+    GIVEN("A buffer smaller than the window") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board);
+        std::size_t capacity = 4 * GameSnapshot::save(board, *BotController::instance(), stats).size();
+        RewindBuffer buffer(1000, capacity, 10);
+        std::vector<std::vector<std::uint8_t>> snapshots = helper::playTicks(buffer, board, stats, 200);
+
+        THEN("The oldest ticks should be dropped to stay within it's capacity") {
+            REQUIRE(buffer.getCapacity() == capacity);
+            REQUIRE(buffer.getUsedBytes() <= capacity);
+            REQUIRE(buffer.getMemoryUsage() >= capacity);
+            REQUIRE(buffer.getFirstTick() > 100u);
+            REQUIRE(buffer.getLastTick() == 199);
+            REQUIRE(helper::seek(buffer, board, stats, 199) == snapshots[199]);
+            REQUIRE(helper::seek(buffer, board, stats, buffer.getFirstTick().value()) ==
+                    snapshots[buffer.getFirstTick().value()]);
+        }
+    }
+
+    GIVEN("A buffer too small for a keyframe") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board);
+        RewindBuffer buffer(1000, 64, 10);
+
+        THEN("Nothing should be recorded") {
+            REQUIRE_FALSE(buffer.record(board, *BotController::instance(), stats));
+            REQUIRE(buffer.getFrameCount() == 0);
+            REQUIRE_FALSE(buffer.getLastTick().has_value());
+        }
+    }
+}
+
+SCENARIO("Benchmarking the rewind buffer", "[.][benchmark]") {
+    helper::initSingletons();
+    GIVEN("Ten seconds of a match with 20 bots") {
+        Board board;
+        GameStatistics stats(0, 1, 3);
+        helper::prepareMatch(board, 20);
+        RewindBuffer buffer(600);
+        helper::playTicks(buffer, board, stats, 600);
+        WARN("Frames: " << buffer.getFrameCount() << ", bytes used: " << buffer.getUsedBytes()
+                        << ", memory: " << buffer.getMemoryUsage());
+
+        THEN("Ticks should be recorded and sought quickly") {
+            unsigned int tick = 600;
+            BENCHMARK("Recording a tick") {
+                helper::playTick(board, stats, tick++);
+                helper::recordTick(buffer, board, stats);
+                return buffer.getUsedBytes();
+            };
+            BENCHMARK("Seeking to the middle of a keyframe interval") {
+                std::uint32_t target = buffer.getLastTick().value() - 90;
+                buffer.seek(target, board, *BotController::instance(), stats);
+                EventQueue<Event>::instance()->clear();
+                return target;
+            };
+        }
+    }
+}
@@ -12,6 +12,7 @@
 #include "../../tank-lib/include/Bullet.h"
 #include "../../tank-lib/include/Entity.h"
 #include "../include/GameStatistics.h"
+#include "../include/GameSnapshot.h"
 #include "../include/ActiveEventHandler.h"
 #include "../include/FinishedEventHandler.h"
 #include "../include/MenuEventHandler.h"
@@ -228,6 +229,35 @@ SCENARIO("Active to Pause") {
     }
 }
 
+SCENARIO("Saving the match") {
+    EventQueue<Event> * eq = helper::getEmptyEventQueue();
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "tanks_test_autosave.dat";
+    std::filesystem::remove(path);
+    std::unique_ptr<helper::TestGame> game = std::make_unique<helper::TestGame>(60);
+    game->testSetup();
+    game->autosave(path.string());
+    game->testStart();
+    ActiveGameState* state = dynamic_cast<ActiveGameState*>(game->getState());
+    ActiveEventHandler* handler = dynamic_cast<ActiveEventHandler*>(state->getEventHandler());
+    WHEN("F5 clicked") {
+        handler->handleEvent(std::make_unique<Event>(Event::EventType::KeyPressed, 89));
+        THEN("The match should be saved to the autosave file, and resumable") {
+            REQUIRE(std::filesystem::exists(path));
+            REQUIRE_NOTHROW(GameSnapshot::loadFromFile(path.string(), *game->getBoard(), *BotController::instance(),
+                                                       *game->getStats()));
+            REQUIRE(game->getBoard()->getPlayerTank() != nullptr);
+        }
+    }
+    WHEN("The paused match is left for the menu") {
+        game->setPauseState();
+        game->setMenuState();
+        THEN("The match should be saved to the autosave file") {
+            REQUIRE(std::filesystem::exists(path));
+        }
+    }
+    std::filesystem::remove(path);
+}
+
 SCENARIO("Player tank is killed") {
     EventQueue<Event> * eq = helper::getEmptyEventQueue();
     std::unique_ptr<helper::TestGame> game = std::make_unique<helper::TestGame>(60);
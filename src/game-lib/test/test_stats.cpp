@@ -2,6 +2,8 @@
 // Created by tomek on 07.06.2022.
 //
 
+#include <vector>
+
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/catch_all.hpp"
 
@@ -47,4 +49,79 @@ SCENARIO("Player was killed"){
 
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Changing statistics several times in one tick") {
+    GIVEN("A gamestats object") {
+        GameStatistics stats(0, 1, 3);
+        std::vector<GameStatistics::Delta> deltas;
+        stats.setDeltaListener([&deltas](const GameStatistics::Delta &delta) { deltas.push_back(delta); });
+
+        auto eventQueue = helper::getEmptyEventQueue();
+
+        WHEN("Several tanks are killed and a life is lost") {
+            stats.addPoints(100);
+            stats.addPoints(200);
+            stats.addPoints(100);
+            stats.decrementLives(1);
+
+            THEN("Nothing should be queued before the changes are published") {
+                REQUIRE(eventQueue->isEmpty());
+                REQUIRE(stats.getChangedFields() == (GameStatistics::Points | GameStatistics::Lives));
+            }
+
+            THEN("A single event and delta with the changed fields should be published") {
+                REQUIRE(stats.publishChanges());
+
+                REQUIRE_FALSE(eventQueue->isEmpty());
+                auto event = eventQueue->pop();
+                REQUIRE(event->type == Event::StatisticsChanged);
+                REQUIRE(event->info.pointsInfo.stats_ == &stats);
+                REQUIRE(event->info.pointsInfo.changed_ == (GameStatistics::Points | GameStatistics::Lives));
+                REQUIRE(eventQueue->isEmpty());
+
+                REQUIRE(deltas.size() == 1);
+                REQUIRE(deltas[0].sequence == 0);
+                REQUIRE(deltas[0].points == 400);
+                REQUIRE(deltas[0].lives == 2);
+                REQUIRE(deltas[0].level == 0);
+                REQUIRE(stats.getChangedFields() == 0);
+            }
+
+            THEN("Publishing again should publish nothing") {
+                REQUIRE(stats.publishChanges());
+                eventQueue->clear();
+
+                REQUIRE_FALSE(stats.publishChanges());
+                REQUIRE(eventQueue->isEmpty());
+                REQUIRE(deltas.size() == 1);
+            }
+        }
+
+        WHEN("Fields are set to the values they already have") {
+            stats.setPoints(0);
+            stats.setLevel(1);
+            stats.addPoints(0);
+
+            THEN("Nothing should be published") {
+                REQUIRE_FALSE(stats.publishChanges());
+                REQUIRE(eventQueue->isEmpty());
+                REQUIRE(deltas.empty());
+            }
+        }
+
+        WHEN("The stats are reset") {
+            stats.setLevel(5);
+            stats.resetStats();
+
+            THEN("All fields should be published at once") {
+                REQUIRE(deltas.size() == 1);
+                REQUIRE(deltas[0].changed == GameStatistics::AllFields);
+                REQUIRE(deltas[0].level == 1);
+                REQUIRE(deltas[0].lives == 3);
+                REQUIRE(eventQueue->pop()->info.pointsInfo.changed_ == GameStatistics::AllFields);
+                REQUIRE(eventQueue->isEmpty());
+            }
+        }
+    }
+}
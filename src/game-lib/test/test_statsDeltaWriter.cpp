@@ -0,0 +1,52 @@
+#include <sstream>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/GameStatistics.h"
+#include "../include/StatsDeltaWriter.h"
+#include "../../core-lib/include/EventQueue.h"
+
+
+SCENARIO("Exporting changes of statistics") {
+    GIVEN("Statistics exported to a stream") {
+        EventQueue<Event>::instance()->clear();
+        std::stringstream stream;
+        StatsDeltaWriter writer(stream);
+        GameStatistics stats(0, 1, 3);
+        stats.setDeltaListener(writer.getListener());
+
+        WHEN("They change over a few ticks") {
+            stats.resetStats();
+            stats.addPoints(100);
+            stats.addPoints(300);
+            stats.publishChanges();
+            stats.publishChanges();
+            stats.setLevel(2);
+            stats.decrementLives(1);
+            stats.addPoints(100000);
+            stats.publishChanges();
+
+            THEN("Only the changed fields should be written, a delta per tick with changes") {
+                REQUIRE(writer.getBytesWritten() == stream.str().size());
+                // all fields, then 400 points in 2 bytes, then all fields with 100400 points in 3 bytes
+                REQUIRE(writer.getBytesWritten() == 5 + 4 + 7);
+            }
+
+            THEN("They should be read back") {
+                std::vector<GameStatistics::Delta> deltas = StatsDeltaWriter::read(stream);
+                REQUIRE(deltas.size() == 3);
+                REQUIRE(deltas[0] == GameStatistics::Delta{0, GameStatistics::AllFields, 0, 1, 3});
+                REQUIRE(deltas[1] == GameStatistics::Delta{1, GameStatistics::Points, 400, 0, 0});
+                REQUIRE(deltas[2] == GameStatistics::Delta{2, GameStatistics::AllFields, 100400, 2, 2});
+            }
+
+            THEN("A delta cut short should not be read") {
+                std::string bytes = stream.str();
+                std::istringstream cut(bytes.substr(0, bytes.size() - 1));
+                REQUIRE(StatsDeltaWriter::read(cut).size() == 2);
+            }
+        }
+        EventQueue<Event>::instance()->clear();
+    }
+}
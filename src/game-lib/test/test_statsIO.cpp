@@ -0,0 +1,352 @@
+#include <filesystem>
+#include <fstream>
+#include <list>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/GameStatistics.h"
+#include "../include/GameStatsIO.h"
+
+
+namespace {
+    namespace helper {
+        void removeScoreboard(const std::filesystem::path &path) {
+            std::string checkpoint = path.string() + GameStatsIO::CheckpointSuffix;
+            for (const std::string &file: {path.string(), path.string() + ".tmp", checkpoint, checkpoint + ".tmp"}) {
+                std::filesystem::remove(file);
+            }
+        }
+
+        std::filesystem::path getEmptyScoreboardPath(const std::string &name) {
+            std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+            removeScoreboard(path);
+            return path;
+        }
+
+        GameStatsIO::Record makeRecord(unsigned int points, std::int64_t timestamp) {
+            GameStatsIO::Record record;
+            record.points = points;
+            record.level = points % 7 + 1;
+            record.lives = points % 3;
+            record.timestamp = timestamp;
+            record.seed = points * 31u;
+            return record;
+        }
+
+        /**
+         * Writes records with points 0, 1, ..., count - 1, older records first
+         */
+        void writeRecords(const std::filesystem::path &path, unsigned int count) {
+            GameStatsIO io(path.string());
+            for (unsigned int i = 0; i < count; i++) {
+                io.addRecord(makeRecord(i, i));
+            }
+            REQUIRE(io.saveScoreboard());
+        }
+    }
+}
+
+SCENARIO("Loading a scoreboard that was never saved") {
+    GIVEN("A path to a missing file") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_missing.dat");
+        GameStatsIO io(path.string());
+
+        THEN("The scoreboard should be empty and no file should be created") {
+            std::unique_ptr<GameStatistics> stats = io.loadScoreboard();
+            REQUIRE(stats->getScoreboard().empty());
+            REQUIRE(io.getRecordCount() == 0);
+            REQUIRE(io.saveScoreboard());
+            REQUIRE_FALSE(std::filesystem::exists(path));
+        }
+    }
+}
+
+SCENARIO("Saving finished games") {
+    GIVEN("A scoreboard with more games than fit on it") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_scoreboard.dat");
+        helper::writeRecords(path, 25);
+
+        WHEN("It is loaded again") {
+            GameStatsIO io(path.string());
+            std::unique_ptr<GameStatistics> stats = io.loadScoreboard();
+
+            THEN("Only the best games should be on it, the best one first") {
+                REQUIRE(io.getRecordCount() == 25);
+                REQUIRE(stats->getScoreboard().size() == GameStatsIO::ScoreboardSize);
+                REQUIRE(stats->getScoreboard().front() == 24);
+                REQUIRE(stats->getScoreboard().back() == 15);
+
+                const GameStatsIO::Record &best = io.getTopRecords().front();
+                REQUIRE(best.level == 24 % 7 + 1);
+                REQUIRE(best.lives == 24 % 3);
+                REQUIRE(best.timestamp == 24);
+                REQUIRE(best.seed == 24 * 31u);
+            }
+        }
+
+        WHEN("A game ties with one on the scoreboard") {
+            {
+                GameStatsIO io(path.string());
+                io.addRecord(helper::makeRecord(20, 100));
+            }
+            GameStatsIO io(path.string());
+            io.loadScoreboard();
+
+            THEN("The older one should be placed higher") {
+                REQUIRE(io.getTopRecords()[4].points == 20);
+                REQUIRE(io.getTopRecords()[4].timestamp == 20);
+                REQUIRE(io.getTopRecords()[5].points == 20);
+                REQUIRE(io.getTopRecords()[5].timestamp == 100);
+            }
+        }
+
+        WHEN("Games are added without saving") {
+            GameStatsIO io(path.string());
+            io.loadScoreboard();
+            for (unsigned int i = 0; i < GameStatsIO::FlushBatch; i++) {
+                io.addRecord(helper::makeRecord(100 + i, 100 + i));
+            }
+
+            THEN("They should be written a batch at a time") {
+                REQUIRE(std::filesystem::file_size(path) == 8 + 32 * (25 + GameStatsIO::FlushBatch));
+                io.addRecord(helper::makeRecord(1000, 1000));
+                REQUIRE(std::filesystem::file_size(path) == 8 + 32 * (25 + GameStatsIO::FlushBatch));
+                REQUIRE(io.getRecordCount() == 25 + GameStatsIO::FlushBatch + 1);
+                REQUIRE(io.getTopRecords().front().points == 1000);
+            }
+        }
+
+        helper::removeScoreboard(path);
+    }
+
+    GIVEN("Statistics of a finished game") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_statistics.dat");
+        GameStatistics finished(1500, 4, 2);
+
+        WHEN("They are recorded and the game is closed") {
+            {
+                GameStatsIO io(path.string());
+                io.addRecord(finished, 77);
+            }
+
+            THEN("They should be loaded with the time they were recorded at") {
+                GameStatsIO io(path.string());
+                REQUIRE(io.loadScoreboard()->getScoreboard() == std::list<unsigned int>{1500});
+                const GameStatsIO::Record &record = io.getTopRecords().front();
+                REQUIRE(record.level == 4);
+                REQUIRE(record.lives == 2);
+                REQUIRE(record.seed == 77);
+                REQUIRE(record.timestamp > 0);
+            }
+        }
+
+        helper::removeScoreboard(path);
+    }
+}
+
+SCENARIO("Recovering a scoreboard after a crash") {
+    GIVEN("A scoreboard with a record cut short at it's end") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_torn.dat");
+        helper::writeRecords(path, 12);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+
+        THEN("The records before it should be loaded") {
+            GameStatsIO io(path.string());
+            REQUIRE(io.loadScoreboard()->getScoreboard().front() == 10);
+            REQUIRE(io.getRecordCount() == 11);
+        }
+
+        WHEN("A record is added to it") {
+            {
+                GameStatsIO io(path.string());
+                io.addRecord(helper::makeRecord(50, 50));
+            }
+
+            THEN("The broken record should be cut off first") {
+                REQUIRE(std::filesystem::file_size(path) == 8 + 32 * 12);
+                GameStatsIO io(path.string());
+                REQUIRE(io.loadScoreboard()->getScoreboard().front() == 50);
+                REQUIRE(io.getRecordCount() == 12);
+            }
+        }
+
+        helper::removeScoreboard(path);
+    }
+
+    GIVEN("A scoreboard with garbage written after it's records") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_garbage.dat");
+        helper::writeRecords(path, 3);
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            std::string garbage(32 * 2, '\0');
+            file.write(garbage.data(), static_cast<std::streamsize>(garbage.size()));
+        }
+
+        THEN("The garbage should not be loaded as records") {
+            GameStatsIO io(path.string());
+            REQUIRE(io.loadScoreboard()->getScoreboard() == std::list<unsigned int>{2, 1, 0});
+            REQUIRE(io.getRecordCount() == 3);
+        }
+
+        helper::removeScoreboard(path);
+    }
+
+    GIVEN("A file that is not a scoreboard") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_not_scoreboard.dat");
+        std::ofstream(path) << "1000 900 800\n";
+
+        THEN("It should not be loaded nor written to") {
+            GameStatsIO io(path.string());
+            REQUIRE_THROWS_AS(io.loadScoreboard(), InvalidScoreboardFile);
+            io.addRecord(helper::makeRecord(10, 10));
+            REQUIRE_FALSE(io.saveScoreboard());
+            REQUIRE(std::filesystem::file_size(path) == 13);
+        }
+
+        helper::removeScoreboard(path);
+    }
+}
+
+SCENARIO("Loading a scoreboard from a checkpoint") {
+    GIVEN("A scoreboard saved with a checkpoint") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_checkpoint.dat");
+        std::filesystem::path checkpoint = path.string() + GameStatsIO::CheckpointSuffix;
+        helper::writeRecords(path, 30);
+        REQUIRE(std::filesystem::exists(checkpoint));
+
+        WHEN("A record before the checkpoint is overwritten") {
+            {
+                std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+                file.seekp(8 + 32 * 2);
+                std::string zeros(32, '\0');
+                file.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+            }
+
+            THEN("Records before the checkpoint should not be streamed again") {
+                GameStatsIO io(path.string());
+                REQUIRE(io.loadScoreboard()->getScoreboard().front() == 29);
+                REQUIRE(io.getRecordCount() == 30);
+            }
+
+            THEN("Without the checkpoint, the log should be streamed up to the broken record") {
+                std::filesystem::remove(checkpoint);
+                GameStatsIO io(path.string());
+                REQUIRE(io.loadScoreboard()->getScoreboard().front() == 1);
+                REQUIRE(io.getRecordCount() == 2);
+            }
+        }
+
+        WHEN("Records are added after the checkpoint") {
+            std::filesystem::path copy = checkpoint.string() + ".copy";
+            std::filesystem::copy_file(checkpoint, copy, std::filesystem::copy_options::overwrite_existing);
+            {
+                GameStatsIO io(path.string());
+                io.loadScoreboard();
+                io.addRecord(helper::makeRecord(5, 100));
+                io.addRecord(helper::makeRecord(28, 100));
+            }
+            std::filesystem::rename(copy, checkpoint);
+
+            THEN("They should be ranked with the records from the checkpoint") {
+                GameStatsIO io(path.string());
+                REQUIRE(io.loadScoreboard()->getScoreboard() ==
+                        std::list<unsigned int>{29, 28, 28, 27, 26, 25, 24, 23, 22, 21});
+                REQUIRE(io.getRecordCount() == 32);
+            }
+        }
+
+        WHEN("The log is replaced by one with as many records") {
+            std::filesystem::path copy = checkpoint.string() + ".copy";
+            std::filesystem::copy_file(checkpoint, copy, std::filesystem::copy_options::overwrite_existing);
+            {
+                std::filesystem::remove(path);
+                GameStatsIO io(path.string());
+                for (unsigned int i = 0; i < 30; i++) {
+                    io.addRecord(helper::makeRecord(100 + i, i));
+                }
+            }
+            std::filesystem::rename(copy, checkpoint);
+
+            THEN("The old checkpoint should not be used") {
+                GameStatsIO io(path.string());
+                REQUIRE(io.loadScoreboard()->getScoreboard().front() == 129);
+                REQUIRE(io.getRecordCount() == 30);
+            }
+        }
+
+        helper::removeScoreboard(path);
+    }
+}
+
+SCENARIO("Compacting a scoreboard") {
+    GIVEN("A scoreboard with more games than fit on it") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_compact.dat");
+        helper::writeRecords(path, 40);
+
+        WHEN("It is compacted") {
+            GameStatsIO io(path.string());
+            io.addRecord(helper::makeRecord(35, 100));
+            REQUIRE(io.compact());
+
+            THEN("Only the games on the scoreboard should be left in the file") {
+                REQUIRE_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+                REQUIRE_FALSE(std::filesystem::exists(path.string() + GameStatsIO::CheckpointSuffix));
+                REQUIRE(std::filesystem::file_size(path) == 8 + 32 * GameStatsIO::ScoreboardSize);
+                REQUIRE(io.getRecordCount() == GameStatsIO::ScoreboardSize);
+
+                GameStatsIO reloaded(path.string());
+                REQUIRE(reloaded.loadScoreboard()->getScoreboard() ==
+                        std::list<unsigned int>{39, 38, 37, 36, 35, 35, 34, 33, 32, 31});
+            }
+
+            THEN("Games should still be appended to it") {
+                io.addRecord(helper::makeRecord(80, 200));
+                REQUIRE(io.saveScoreboard());
+                GameStatsIO reloaded(path.string());
+                REQUIRE(reloaded.loadScoreboard()->getScoreboard().front() == 80);
+                REQUIRE(reloaded.getRecordCount() == GameStatsIO::ScoreboardSize + 1);
+            }
+        }
+
+        WHEN("It is loaded") {
+            GameStatsIO io(path.string());
+            io.loadScoreboard();
+
+            THEN("It should not need to be compacted yet") {
+                REQUIRE_FALSE(io.needsCompaction());
+            }
+        }
+
+        helper::removeScoreboard(path);
+    }
+
+    GIVEN("A scoreboard with far more games than fit on it") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_compact_many.dat");
+        helper::writeRecords(path, GameStatsIO::ScoreboardSize * GameStatsIO::CompactionRatio + 1);
+        GameStatsIO io(path.string());
+        io.loadScoreboard();
+
+        THEN("It should need to be compacted, until it is") {
+            REQUIRE(io.needsCompaction());
+            REQUIRE(io.compact());
+            REQUIRE_FALSE(io.needsCompaction());
+        }
+
+        helper::removeScoreboard(path);
+    }
+}
+
+SCENARIO("Benchmarking loading a scoreboard", "[.][benchmark]") {
+    GIVEN("A scoreboard with two million games") {
+        std::filesystem::path path = helper::getEmptyScoreboardPath("tanks_test_large.dat");
+        helper::writeRecords(path, 2000000);
+        GameStatsIO io(path.string());
+
+        BENCHMARK("Loading the scoreboard") {
+            return io.loadScoreboard()->getScoreboard().size();
+        };
+
+        helper::removeScoreboard(path);
+    }
+}
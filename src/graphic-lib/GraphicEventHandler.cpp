@@ -59,6 +59,10 @@ void GraphicEventHandler::processEvent(std::unique_ptr<Event> event)
     }
     case(Event::StatisticsChanged):
     {
+        // the level is shown from Event::LevelLoaded
+        if ((event->info.pointsInfo.changed_ & (GameStatistics::Points | GameStatistics::Lives)) == 0) {
+            break;
+        }
         int playerLives = event->info.pointsInfo.stats_->getLives();
         int points = event->info.pointsInfo.stats_->getPoints();
         window->loadStats(playerLives, points);
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../board-lib/include/GridBuilder.h"
+#include "../board-lib/include/LevelPack.h"
+#include "../board-lib/include/LevelValidator.h"
+
+/**
+ * Converts text levels into a level pack:
+ *  levelpack [--packed] <pack> <level.txt>...
+ * Files named lvl<N>.txt become level N, other files are numbered after the highest of them, in the order given.
+ * Problems found in the levels are printed, but the levels are packed anyway
+ */
+int main(int argc, char **argv) {
+    int first = 1;
+    LevelPack::TileEncoding encoding = LevelPack::ByteTiles;
+    if (argc > 1 && std::strcmp(argv[1], "--packed") == 0) {
+        encoding = LevelPack::PackedTiles;
+        first++;
+    }
+    if (argc - first < 2) {
+        std::cerr << "usage: " << argv[0] << " [--packed] <pack> <level.txt>..." << std::endl;
+        return 2;
+    }
+
+    std::vector<std::filesystem::path> paths(argv + first + 1, argv + argc);
+    std::vector<std::optional<unsigned int>> numbers;
+    unsigned int highest = 0;
+    for (const std::filesystem::path &path: paths) {
+        std::string stem = path.stem().string();
+        std::optional<unsigned int> number;
+        if (stem.size() > 3 && stem.compare(0, 3, "lvl") == 0 &&
+            std::all_of(stem.begin() + 3, stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            number = static_cast<unsigned int>(std::stoul(stem.substr(3)));
+            highest = std::max(highest, number.value());
+        }
+        numbers.push_back(number);
+    }
+
+    std::vector<LevelPack::Level> levels;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        std::ifstream file(paths[i]);
+        if (!file.is_open()) {
+            std::cerr << paths[i].string() << ": could not be opened" << std::endl;
+            return 1;
+        }
+        unsigned int number = numbers[i].has_value() ? numbers[i].value() : ++highest;
+        levels.push_back(LevelPack::parseText(file, number));
+        std::cout << paths[i].string() << " -> level " << number << " (" << levels.back().sizeX << "x"
+                  << levels.back().sizeY << ")" << std::endl;
+        LevelValidator::Report report = LevelValidator::validate(levels.back());
+        if (!report.problems.empty()) {
+            std::cerr << paths[i].string() << ": " << (report.isValid() ? "warning: " : "error: ")
+                      << report.describe() << std::endl;
+        }
+    }
+
+    std::string output = argv[first];
+    if (!LevelPack::save(output, levels, encoding)) {
+        std::cerr << output << ": could not be written (are level numbers distinct?)" << std::endl;
+        return 1;
+    }
+
+    // read the pack back, so a broken one is never left behind silently
+    try {
+        std::unique_ptr<LevelPack> pack = LevelPack::open(output);
+        if (pack == nullptr) {
+            std::cerr << output << ": could not be read back" << std::endl;
+            return 1;
+        }
+        std::cout << output << ": " << pack->getLevelCount() << " levels" << std::endl;
+    } catch (const InvalidLevelFile &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
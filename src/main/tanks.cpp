@@ -2,12 +2,47 @@
 // Created by tomek on 26.04.2022.
 //
 
+#include <iostream>
+#include <string>
+
 #include "../game-lib/include/Game.h"
 
-int main(){
+int main(int argc, char **argv){
 
     Game game = Game(60);
 
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        // reloads changed levels while playing, for tuning maps
+        if (argument == "--watch-levels") {
+            game.watchLevels();
+        } else if (argument == "--hard") {
+            // bots plan ahead with simulations
+            game.playHard();
+        } else if (argument == "--export-stats" && i + 1 < argc) {
+            if (!game.exportStats(argv[++i])) {
+                std::cerr << "Could not open " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (argument == "--rewind" && i + 1 < argc) {
+            // keeps the last seconds of matches, backspace rewinds by one
+            unsigned long seconds;
+            try {
+                seconds = std::stoul(argv[++i]);
+            } catch (const std::exception &) {
+                std::cerr << "Not a number of seconds: " << argv[i] << std::endl;
+                return 1;
+            }
+            game.recordHistory(seconds);
+        } else if (argument == "--autosave" && i + 1 < argc) {
+            // saves the match every half a minute and when it is left, F5 saves it at once
+            game.autosave(argv[++i]);
+        } else if (argument == "--resume" && i + 1 < argc) {
+            // continues a match saved with --autosave or F5
+            game.resumeFrom(argv[++i]);
+        }
+    }
+
     game.run();
 
     return 0;
@@ -0,0 +1,133 @@
+#include <limits>
+#include <algorithm>
+
+#include "include/Broadphase.h"
+
+Broadphase::Broadphase(unsigned int cellSizeLog2) : cellShift_(FixedPoint::Shift + cellSizeLog2) {}
+
+void Broadphase::rebuild(const std::vector<std::shared_ptr<Entity>> &entities) {
+    entities_ = entities;
+    bounds_.clear();
+    for (const std::shared_ptr<Entity> &entity: entities_) {
+        bounds_.push_back(Sweep::boxOf(*entity));
+    }
+    rebuildBuckets();
+}
+
+void Broadphase::rebuild(const std::vector<std::shared_ptr<Entity>> &entities, const std::vector<Sweep::Box> &bounds) {
+    entities_ = entities;
+    bounds_ = bounds;
+    rebuildBuckets();
+}
+
+void Broadphase::rebuildBuckets() {
+    spans_.clear();
+    visited_.assign(entities_.size(), 0);
+    query_ = 0;
+
+    // twice as many buckets as entities (power of 2, so hashing is just a mask)
+    std::size_t bucketCount = 16;
+    while (bucketCount < entities_.size() * 2) {
+        bucketCount <<= 1;
+    }
+    bucketMask_ = bucketCount - 1;
+    bucketStart_.assign(bucketCount + 1, 0);
+
+    // counting pass
+    for (const Sweep::Box &box: bounds_) {
+        CellSpan span = spanOf(box);
+        spans_.push_back(span);
+        for (int cx = span.minX; cx <= span.maxX; cx++)
+            for (int cy = span.minY; cy <= span.maxY; cy++)
+                bucketStart_[bucketOf(cx, cy) + 1]++;
+    }
+
+    for (std::size_t i = 1; i <= bucketCount; i++) {
+        bucketStart_[i] += bucketStart_[i - 1];
+    }
+
+    // filling pass (entries within a bucket keep the insertion order)
+    bucketEntries_.resize(bucketStart_[bucketCount]);
+    cursor_.assign(bucketStart_.begin(), bucketStart_.end() - 1);
+    for (std::uint32_t idx = 0; idx < entities_.size(); idx++) {
+        const CellSpan &span = spans_[idx];
+        for (int cx = span.minX; cx <= span.maxX; cx++)
+            for (int cy = span.minY; cy <= span.maxY; cy++)
+                bucketEntries_[cursor_[bucketOf(cx, cy)]++] = idx;
+    }
+}
+
+std::optional<std::shared_ptr<Entity>> Broadphase::findOverlap(const std::shared_ptr<Entity> &target) const {
+    if (entities_.empty()) {
+        return std::nullopt;
+    }
+
+    Sweep::Box box = Sweep::boxOf(*target);
+    CellSpan span = spanOf(box);
+
+    std::uint32_t found = std::numeric_limits<std::uint32_t>::max();
+
+    for (int cx = span.minX; cx <= span.maxX; cx++)
+        for (int cy = span.minY; cy <= span.maxY; cy++) {
+            std::size_t bucket = bucketOf(cx, cy);
+            for (std::uint32_t i = bucketStart_[bucket]; i < bucketStart_[bucket + 1]; i++) {
+                std::uint32_t idx = bucketEntries_[i];
+                if (idx >= found || entities_[idx] == target) {
+                    continue;
+                }
+                if (Sweep::overlaps(box, bounds_[idx])) {
+                    found = idx;
+                }
+            }
+        }
+
+    if (found == std::numeric_limits<std::uint32_t>::max()) {
+        return std::nullopt;
+    }
+    return entities_[found];
+}
+
+const std::vector<std::uint32_t> &Broadphase::findCandidates(const Sweep::Box &box) {
+    candidates_.clear();
+    if (entities_.empty()) {
+        return candidates_;
+    }
+
+    // entities spanning multiple cells are reported once, thanks to per-query stamps
+    query_++;
+    CellSpan span = spanOf(box);
+    for (int cx = span.minX; cx <= span.maxX; cx++)
+        for (int cy = span.minY; cy <= span.maxY; cy++) {
+            std::size_t bucket = bucketOf(cx, cy);
+            for (std::uint32_t i = bucketStart_[bucket]; i < bucketStart_[bucket + 1]; i++) {
+                std::uint32_t idx = bucketEntries_[i];
+                if (visited_[idx] == query_) {
+                    continue;
+                }
+                visited_[idx] = query_;
+                if (Sweep::overlaps(box, bounds_[idx])) {
+                    candidates_.push_back(idx);
+                }
+            }
+        }
+
+    std::sort(candidates_.begin(), candidates_.end());
+    return candidates_;
+}
+
+std::size_t Broadphase::size() const {
+    return entities_.size();
+}
+
+std::size_t Broadphase::bucketOf(int cellX, int cellY) const {
+    auto hash = static_cast<std::uint32_t>(cellX) * 73856093u ^ static_cast<std::uint32_t>(cellY) * 19349663u;
+    return hash & bucketMask_;
+}
+
+Broadphase::CellSpan Broadphase::spanOf(const Sweep::Box &box) const {
+    // arithmetic shift rounds towards negative infinity, so entities out of map are bucketed correctly
+    return {box.x >> cellShift_,
+            box.y >> cellShift_,
+            (box.x + box.sizeX) >> cellShift_,
+            (box.y + box.sizeY) >> cellShift_};
+}
@@ -7,7 +7,9 @@
 
 #include "include/Bullet.h"
 
-Bullet::Bullet(float x, float y, Direction direction, float speed, BulletType type) : Entity(x, y, 0.4, 0.4, speed, direction), type_(type) {}
+Bullet::Bullet(float x, float y, Direction direction, float speed, BulletType type) : Entity(x, y, 0.4, 0.4, speed, direction), type_(type) {
+    moving_ = true;
+}
 
 bool Bullet::move() {
     offsetInCurrentDirection(speed_);
@@ -16,9 +18,10 @@ bool Bullet::move() {
 
 bool Bullet::moveBack() {
     offsetInCurrentDirection(-speed_);
+    return true;
 };
 
-void Bullet::offsetInCurrentDirection(float offset) {
+void Bullet::offsetInCurrentDirection(FixedPoint::Value offset) {
     switch (facing_) {
         case North:
             y_ -= offset;
@@ -35,7 +38,7 @@ void Bullet::offsetInCurrentDirection(float offset) {
     }
 }
 
-bool Bullet::isFriendly() {
+bool Bullet::isFriendly() const {
     return static_cast<bool>(type_);
 }
 
@@ -44,4 +47,38 @@ void Bullet::unlink() {
         return;
     }
     subscribers_.front()->unsubscribe(this);
-}
\ No newline at end of file
+}
+
+void Bullet::setImpact(FixedPoint::Value impact, unsigned int gridVersion) {
+    impact_ = impact;
+    impactGridVersion_ = gridVersion;
+}
+
+bool Bullet::isImpactValid(unsigned int gridVersion) const {
+    return impactGridVersion_.has_value() && impactGridVersion_.value() == gridVersion;
+}
+
+bool Bullet::hasReachedImpact() const {
+    switch (facing_) {
+        case North:
+            return y_ <= impact_;
+        case East:
+            return x_ >= impact_;
+        case South:
+            return y_ >= impact_;
+        case West:
+            return x_ <= impact_;
+    }
+    return false;
+}
+
+void Bullet::clampToImpact() {
+    if (!hasReachedImpact()) {
+        return;
+    }
+    if (facing_ == East || facing_ == West) {
+        x_ = impact_;
+    } else {
+        y_ = impact_;
+    }
+}
@@ -6,15 +6,15 @@
 
 
 float Entity::getX() const {
-    return x_;
+    return FixedPoint::toFloat(x_);
 }
 
 float Entity::getY() const {
-    return y_;
+    return FixedPoint::toFloat(y_);
 }
 
 float Entity::getSpeed() const {
-    return speed_;
+    return FixedPoint::toFloat(speed_);
 }
 
 Direction Entity::getFacing() const {
@@ -22,15 +22,57 @@ Direction Entity::getFacing() const {
 }
 
 float Entity::getSizeX() const {
-    return size_x_;
+    return FixedPoint::toFloat(size_x_);
 }
 
 float Entity::getSizeY() const {
+    return FixedPoint::toFloat(size_y_);
+}
+
+bool Entity::isMoving() const {
+    return moving_;
+}
+
+void Entity::setX(float x) {
+    x_ = FixedPoint::fromFloat(x);
+}
+
+void Entity::setY(float y) {
+    y_ = FixedPoint::fromFloat(y);
+}
+
+FixedPoint::Value Entity::getFixedX() const {
+    return x_;
+}
+
+FixedPoint::Value Entity::getFixedY() const {
+    return y_;
+}
+
+FixedPoint::Value Entity::getFixedSpeed() const {
+    return speed_;
+}
+
+FixedPoint::Value Entity::getFixedSizeX() const {
+    return size_x_;
+}
+
+FixedPoint::Value Entity::getFixedSizeY() const {
     return size_y_;
 }
 
-Entity::Entity(float x, float y, float sizeX, float sizeY, float speed, Direction facing) : x_(x), y_(y),
-                                                                                            size_x_(sizeX),
-                                                                                            size_y_(sizeY),
-                                                                                            speed_(speed),
-                                                                                            facing_(facing) {}
+void Entity::setFixedX(FixedPoint::Value x) {
+    x_ = x;
+}
+
+void Entity::setFixedY(FixedPoint::Value y) {
+    y_ = y;
+}
+
+Entity::Entity(float x, float y, float sizeX, float sizeY, float speed, Direction facing)
+        : x_(FixedPoint::fromFloat(x)),
+          y_(FixedPoint::fromFloat(y)),
+          size_x_(FixedPoint::fromFloat(sizeX)),
+          size_y_(FixedPoint::fromFloat(sizeY)),
+          speed_(FixedPoint::fromFloat(speed)),
+          facing_(facing) {}
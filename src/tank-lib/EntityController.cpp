@@ -4,6 +4,8 @@
 
 #include <string>
 #include <memory>
+#include <limits>
+#include <unordered_map>
 
 #include "include/EntityController.h"
 
@@ -13,11 +15,16 @@
 #include "../core-lib/include/EventQueue.h"
 #include "../core-lib/include/Event.h"
 #include "../core-lib/include/Clock.h"
+#include "../core-lib/include/Snapshot.h"
 #include "../bot-lib/include/BotController.h"
 
+namespace {
+    constexpr std::uint32_t NoOwner = std::numeric_limits<std::uint32_t>::max();
 
-const char *EntityDoesNotExistException::what() {
-    return "Trying to access a non-existent tank";
+    /**
+     * Smallest number of bytes an entity takes in a snapshot (kind, coords, direction and moving flag)
+     */
+    constexpr std::size_t MinStoredSize = 1 + 2 * sizeof(FixedPoint::Value) + 2;
 }
 
 EntityController::EntityController() {
@@ -139,10 +146,10 @@ std::shared_ptr<PlayerTank> EntityController::getPlayer() {
 
 std::optional<std::shared_ptr<Entity>> EntityController::checkEntityCollisions(const std::shared_ptr<Entity> &target) {
     for (std::shared_ptr<Entity> entity: entities_) {
-        if (target->getX() >= entity->getX() + entity->getSizeX() ||
-            target->getX() + target->getSizeX() <= entity->getX() ||
-            target->getY() >= entity->getY() + entity->getSizeY() ||
-            target->getY() + target->getSizeY() <= entity->getY()) {
+        if (target->getFixedX() >= entity->getFixedX() + entity->getFixedSizeX() ||
+            target->getFixedX() + target->getFixedSizeX() <= entity->getFixedX() ||
+            target->getFixedY() >= entity->getFixedY() + entity->getFixedSizeY() ||
+            target->getFixedY() + target->getFixedSizeY() <= entity->getFixedY()) {
             continue;  // no collision
         } else if (target != entity) {
 
@@ -182,4 +189,155 @@ void EntityController::clear() {
         eventQueue_->registerEvent(std::make_unique<Event>(Event::EntityRemoved, *iter));
         entities_.erase(iter.base());
     }
-}
\ No newline at end of file
+}
+
+void EntityController::saveState(SnapshotWriter &writer) const {
+    // bullets only know their tanks as subscribers
+    std::unordered_map<const Bullet *, std::uint32_t> owners;
+    for (std::size_t i = 0; i < entities_.size(); i++) {
+        if (auto *tank = dynamic_cast<Tank *>(entities_[i].get())) {
+            if (std::optional<Bullet *> bullet = tank->getBullet(); bullet.has_value()) {
+                owners[bullet.value()] = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+
+    writer.reserve(entities_.size() * (MinStoredSize + 2 * sizeof(std::uint32_t)));
+    writer.write(static_cast<std::uint32_t>(entities_.size()));
+    for (const std::shared_ptr<Entity> &entity: entities_) {
+        EntityState state = stateOf(*entity);
+        writeState(writer, state);
+        if (state.kind == BulletKind) {
+            auto owner = owners.find(dynamic_cast<const Bullet *>(entity.get()));
+            writer.write(owner != owners.end() ? owner->second : NoOwner);
+        }
+    }
+}
+
+void EntityController::loadState(SnapshotReader &reader, const EntityFactory &makeOther) {
+    auto count = reader.read<std::uint32_t>();
+    if (count > reader.getRemaining() / MinStoredSize) {
+        throw InvalidSnapshot(std::to_string(count) + " entities in a snapshot");
+    }
+
+    std::vector<EntityState> states(count);
+    std::vector<std::uint32_t> owners(count, NoOwner);
+    for (std::size_t i = 0; i < count; i++) {
+        states[i] = readState(reader);
+        if (states[i].kind == BulletKind) {
+            owners[i] = reader.read<std::uint32_t>();
+        }
+    }
+    std::vector<bool> armed(count, false);
+    for (std::uint32_t owner: owners) {
+        if (owner == NoOwner) {
+            continue;
+        }
+        if (owner >= count || states[owner].kind > Tank::ArmorTank || armed[owner]) {
+            throw InvalidSnapshot("Bullet linked to an entity that is not a tank in a snapshot");
+        }
+        armed[owner] = true;
+    }
+
+    clear();
+    player_ = nullptr;
+    entities_.reserve(count);
+    for (const EntityState &state: states) {
+        restoreEntity(state, makeOther);
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        if (owners[i] != NoOwner) {
+            std::dynamic_pointer_cast<Tank>(entities_[owners[i]])->subscribe(
+                    dynamic_cast<Bullet *>(entities_[i].get()));
+        }
+    }
+}
+
+EntityController::EntityState EntityController::stateOf(const Entity &entity) {
+    EntityState state;
+    state.x = entity.getFixedX();
+    state.y = entity.getFixedY();
+    state.facing = entity.getFacing();
+    state.moving = entity.isMoving();
+    if (const auto *tank = dynamic_cast<const Tank *>(&entity)) {
+        const auto *bot = dynamic_cast<const Bot *>(&entity);
+        state.kind = static_cast<std::uint8_t>(tank->getType());
+        state.lives = tank->getLives();
+        state.cooldown = bot != nullptr ? bot->getDecisionCooldown() : 0;
+    } else if (const auto *bullet = dynamic_cast<const Bullet *>(&entity)) {
+        state.kind = BulletKind;
+        state.speed = bullet->getFixedSpeed();
+        state.friendly = bullet->isFriendly();
+    }
+    return state;
+}
+
+void EntityController::applyState(Entity &entity, const EntityState &state) {
+    entity.setFixedX(state.x);
+    entity.setFixedY(state.y);
+    if (auto *tank = dynamic_cast<Tank *>(&entity)) {
+        tank->setFacing(state.facing);
+        tank->setMoving(state.moving);
+        tank->deltaLives(static_cast<int>(state.lives) - static_cast<int>(tank->getLives()));
+        if (auto *bot = dynamic_cast<Bot *>(&entity)) {
+            bot->setDecisionCooldown(state.cooldown);
+        }
+    }
+}
+
+void EntityController::writeState(SnapshotWriter &writer, const EntityState &state) {
+    writer.write(state.kind);
+    writer.write(state.x);
+    writer.write(state.y);
+    writer.write(static_cast<std::uint8_t>(state.facing));
+    writer.write(static_cast<std::uint8_t>(state.moving));
+    if (state.kind <= Tank::ArmorTank) {
+        writer.write(static_cast<std::uint32_t>(state.lives));
+        writer.write(static_cast<std::uint32_t>(state.cooldown));
+    } else if (state.kind == BulletKind) {
+        writer.write(state.speed);
+        writer.write(static_cast<std::uint8_t>(state.friendly));
+    }
+}
+
+EntityController::EntityState EntityController::readState(SnapshotReader &reader) {
+    EntityState state;
+    state.kind = reader.read<std::uint8_t>();
+    state.x = reader.read<FixedPoint::Value>();
+    state.y = reader.read<FixedPoint::Value>();
+    auto facing = reader.read<std::uint8_t>();
+    state.moving = reader.read<std::uint8_t>() != 0;
+    if (state.kind > OtherKind || facing > East) {
+        throw InvalidSnapshot("Broken entity in a snapshot");
+    }
+    state.facing = static_cast<Direction>(facing);
+    if (state.kind <= Tank::ArmorTank) {
+        state.lives = reader.read<std::uint32_t>();
+        state.cooldown = reader.read<std::uint32_t>();
+    } else if (state.kind == BulletKind) {
+        state.speed = reader.read<FixedPoint::Value>();
+        state.friendly = reader.read<std::uint8_t>() != 0;
+    }
+    return state;
+}
+
+std::shared_ptr<Entity> EntityController::restoreEntity(const EntityState &state, const EntityFactory &makeOther) {
+    std::shared_ptr<Entity> entity;
+    if (state.kind <= Tank::ArmorTank) {
+        std::shared_ptr<Tank> tank = createTank(0, 0, static_cast<Tank::TankType>(state.kind), state.facing);
+        if (tank->getType() == Tank::PlayerTank) {
+            addEntity(std::dynamic_pointer_cast<PlayerTank>(tank));
+        } else {
+            addEntity(tank);
+        }
+        entity = tank;
+    } else if (state.kind == BulletKind) {
+        entity = addEntity(std::make_shared<Bullet>(0, 0, state.facing, FixedPoint::toFloat(state.speed),
+                                                    static_cast<Bullet::BulletType>(state.friendly)));
+    } else {
+        entity = addEntity(makeOther(static_cast<unsigned int>(std::max(0, FixedPoint::floorToTile(state.x))),
+                                     static_cast<unsigned int>(std::max(0, FixedPoint::floorToTile(state.y)))));
+    }
+    applyState(*entity, state);
+    return entity;
+}
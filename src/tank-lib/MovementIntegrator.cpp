@@ -0,0 +1,106 @@
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "include/MovementIntegrator.h"
+
+void MovementIntegrator::setStepScale(unsigned int numerator, unsigned int denominator) {
+    stepNumerator_ = static_cast<FixedPoint::Value>(numerator);
+    stepDenominator_ = static_cast<FixedPoint::Value>(denominator);
+}
+
+FixedPoint::Value MovementIntegrator::getStep(const Entity &entity) const {
+    return getStep(entity.getFixedSpeed());
+}
+
+FixedPoint::Value MovementIntegrator::getStep(FixedPoint::Value speed) const {
+    return speed * stepNumerator_ / stepDenominator_;
+}
+
+const std::vector<std::shared_ptr<Entity>> &
+MovementIntegrator::advance(const std::vector<std::shared_ptr<Entity>> &entities) {
+    moved_.clear();
+    x_.clear();
+    y_.clear();
+    speed_.clear();
+    facing_.clear();
+
+    // gather
+    for (const std::shared_ptr<Entity> &entity: entities) {
+        if (!entity->isMoving()) {
+            continue;
+        }
+        moved_.push_back(entity);
+        x_.push_back(entity->getFixedX());
+        y_.push_back(entity->getFixedY());
+        speed_.push_back(getStep(*entity));
+        facing_.push_back(entity->getFacing());
+    }
+
+    integrate(x_.data(), y_.data(), speed_.data(), facing_.data(), moved_.size());
+
+    // scatter
+    for (std::size_t i = 0; i < moved_.size(); i++) {
+        moved_[i]->setFixedX(x_[i]);
+        moved_[i]->setFixedY(y_[i]);
+    }
+
+    return moved_;
+}
+
+void MovementIntegrator::integrate(FixedPoint::Value *x, FixedPoint::Value *y, const FixedPoint::Value *speed,
+                                   const unsigned int *facing, std::size_t count) {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i tableX = _mm256_setr_epi32(directionX[0], directionX[1], directionX[2], directionX[3],
+                                             directionX[0], directionX[1], directionX[2], directionX[3]);
+    const __m256i tableY = _mm256_setr_epi32(directionY[0], directionY[1], directionY[2], directionY[3],
+                                             directionY[0], directionY[1], directionY[2], directionY[3]);
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i dir = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(facing + i));
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(speed + i));
+
+        // per-lane table lookup
+        __m256i dx = _mm256_mullo_epi32(_mm256_permutevar8x32_epi32(tableX, dir), s);
+        __m256i dy = _mm256_mullo_epi32(_mm256_permutevar8x32_epi32(tableY, dir), s);
+
+        __m256i *px = reinterpret_cast<__m256i *>(x + i);
+        __m256i *py = reinterpret_cast<__m256i *>(y + i);
+        _mm256_storeu_si256(px, _mm256_add_epi32(_mm256_loadu_si256(px), dx));
+        _mm256_storeu_si256(py, _mm256_add_epi32(_mm256_loadu_si256(py), dy));
+    }
+#elif defined(__SSE2__)
+    // SSE2 has no variable permute, so the table lookup is done with direction masks
+    const __m128i north = _mm_set1_epi32(North);
+    const __m128i west = _mm_set1_epi32(West);
+    const __m128i south = _mm_set1_epi32(South);
+    const __m128i east = _mm_set1_epi32(East);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i dir = _mm_loadu_si128(reinterpret_cast<const __m128i *>(facing + i));
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(speed + i));
+
+        __m128i dx = _mm_sub_epi32(_mm_and_si128(_mm_cmpeq_epi32(dir, east), s),
+                                   _mm_and_si128(_mm_cmpeq_epi32(dir, west), s));
+        __m128i dy = _mm_sub_epi32(_mm_and_si128(_mm_cmpeq_epi32(dir, south), s),
+                                   _mm_and_si128(_mm_cmpeq_epi32(dir, north), s));
+
+        __m128i *px = reinterpret_cast<__m128i *>(x + i);
+        __m128i *py = reinterpret_cast<__m128i *>(y + i);
+        _mm_storeu_si128(px, _mm_add_epi32(_mm_loadu_si128(px), dx));
+        _mm_storeu_si128(py, _mm_add_epi32(_mm_loadu_si128(py), dy));
+    }
+#endif
+
+    integrateScalar(x + i, y + i, speed + i, facing + i, count - i);
+}
+
+void MovementIntegrator::integrateScalar(FixedPoint::Value *x, FixedPoint::Value *y, const FixedPoint::Value *speed,
+                                         const unsigned int *facing, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        x[i] += directionX[facing[i]] * speed[i];
+        y[i] += directionY[facing[i]] * speed[i];
+    }
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "include/Sweep.h"
+
+namespace {
+    /**
+     * Moment of a tick as an exact fraction, den is always positive
+     */
+    struct Time {
+        std::int64_t num;
+        std::int64_t den;
+    };
+
+    bool earlier(const Time &a, const Time &b) {
+        return a.num * b.den < b.num * a.den;
+    }
+
+    /**
+     * Open interval of time in which projections of two boxes on a single axis overlap
+     */
+    struct Interval {
+        Time enter;
+        Time exit;
+        bool empty;
+        bool unbounded;
+    };
+
+    Interval axisInterval(std::int64_t a, std::int64_t sizeA, std::int64_t da,
+                          std::int64_t b, std::int64_t sizeB, std::int64_t db) {
+        // position of a relative to b is r + v * t, projections overlap while -sizeA < r + v * t < sizeB
+        std::int64_t r = a - b;
+        std::int64_t v = da - db;
+
+        if (v == 0) {
+            bool overlapping = -sizeA < r && r < sizeB;
+            return {{0, 1}, {0, 1}, !overlapping, overlapping};
+        }
+        if (v > 0) {
+            return {{-sizeA - r, v}, {sizeB - r, v}, false, false};
+        }
+        return {{r - sizeB, -v}, {r + sizeA, -v}, false, false};
+    }
+}
+
+Sweep::Box Sweep::boxOf(const Entity &entity) {
+    return {entity.getFixedX(), entity.getFixedY(), entity.getFixedSizeX(), entity.getFixedSizeY()};
+}
+
+Sweep::Box Sweep::sweptBox(const Motion &motion) {
+    return {std::min(motion.start.x, motion.start.x + motion.dx),
+            std::min(motion.start.y, motion.start.y + motion.dy),
+            motion.start.sizeX + (motion.dx < 0 ? -motion.dx : motion.dx),
+            motion.start.sizeY + (motion.dy < 0 ? -motion.dy : motion.dy)};
+}
+
+bool Sweep::overlaps(const Box &a, const Box &b) {
+    return !(a.x >= b.x + b.sizeX ||
+             a.x + a.sizeX <= b.x ||
+             a.y >= b.y + b.sizeY ||
+             a.y + a.sizeY <= b.y);
+}
+
+std::optional<FixedPoint::Value> Sweep::timeOfImpact(const Motion &a, const Motion &b) {
+    Time from{0, 1};
+    Time to{1, 1};
+
+    for (const Interval &interval: {
+            axisInterval(a.start.x, a.start.sizeX, a.dx, b.start.x, b.start.sizeX, b.dx),
+            axisInterval(a.start.y, a.start.sizeY, a.dy, b.start.y, b.start.sizeY, b.dy)}) {
+        if (interval.empty) {
+            return std::nullopt;
+        }
+        if (interval.unbounded) {
+            continue;
+        }
+        if (earlier(from, interval.enter)) {
+            from = interval.enter;
+        }
+        if (earlier(interval.exit, to)) {
+            to = interval.exit;
+        }
+    }
+
+    if (!earlier(from, to)) {
+        return std::nullopt;
+    }
+
+    return static_cast<FixedPoint::Value>(from.num * FixedPoint::One / from.den);
+}
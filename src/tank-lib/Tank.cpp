@@ -8,6 +8,8 @@
 #include "include/Tank.h"
 #include "include/Bullet.h"
 
+const FixedPoint::Value Tank::BulletSize = FixedPoint::fromFloat(0.4);
+
 
 void Tank::setFacing(Direction direction) {
     facing_ = direction;
@@ -46,27 +48,19 @@ void Tank::setMoving(bool movingFlag) {
     moving_ = movingFlag;
 }
 
-bool Tank::isMoving() const {
-    return moving_;
-}
-
 unsigned int Tank::getPoints() const {
     return points_;
 }
 
-Tank::TankType Tank::getType() const {
-    return type_;
-}
-
-void Tank::setX(float x) {
-    x_ = x;
+float Tank::getBulletSpeed() const {
+    return bulletSpeed_;
 }
 
-void Tank::setY(float y) {
-    y_ = y;
+Tank::TankType Tank::getType() const {
+    return type_;
 }
 
-void Tank::offsetInCurrentDirection(float offset) {
+void Tank::offsetInCurrentDirection(FixedPoint::Value offset) {
     switch (facing_) {
         case North:
             y_ -= offset;
@@ -91,36 +85,37 @@ std::optional<std::shared_ptr<Bullet>> Tank::createBullet() {
 //        return std::nullopt;
 //    }
 
-    float bulletSizeX = 0.4;
-    float bulletSizeY = 0.4;
+    const FixedPoint::Value bulletSizeX = BulletSize;
+    const FixedPoint::Value bulletSizeY = BulletSize;
 
     auto bulletType = static_cast<Bullet::BulletType>(type_ == TankType::PlayerTank);
 
-    std::shared_ptr<Bullet> bullet;
+    FixedPoint::Value bulletX = x_;
+    FixedPoint::Value bulletY = y_;
 
     switch (facing_) {
-        case North: {
-            bullet = std::make_shared<Bullet>(x_ + (size_x_ - bulletSizeX) / 2, y_ - bulletSizeY, facing_, bulletSpeed_,
-                                              bulletType);
+        case North:
+            bulletX = x_ + (size_x_ - bulletSizeX) / 2;
+            bulletY = y_ - bulletSizeY;
             break;
-        }
-        case East: {
-            bullet = std::make_shared<Bullet>(x_ + size_x_, y_ + (size_y_ - bulletSizeY) / 2, facing_, bulletSpeed_,
-                                              bulletType);
+        case East:
+            bulletX = x_ + size_x_;
+            bulletY = y_ + (size_y_ - bulletSizeY) / 2;
             break;
-        }
-        case South: {
-            bullet = std::make_shared<Bullet>(x_ + (size_x_ - bulletSizeX) / 2, y_ + size_y_, facing_, bulletSpeed_,
-                                              bulletType);
+        case South:
+            bulletX = x_ + (size_x_ - bulletSizeX) / 2;
+            bulletY = y_ + size_y_;
             break;
-        }
-        case West: {
-            bullet = std::make_shared<Bullet>(x_ - bulletSizeX, y_ + (size_y_ - bulletSizeY) / 2, facing_, bulletSpeed_,
-                                              bulletType);
+        case West:
+            bulletX = x_ - bulletSizeX;
+            bulletY = y_ + (size_y_ - bulletSizeY) / 2;
             break;
-        }
     }
 
+    // fixed-point values convert to floats (and back) exactly
+    std::shared_ptr<Bullet> bullet = std::make_shared<Bullet>(FixedPoint::toFloat(bulletX), FixedPoint::toFloat(bulletY),
+                                                              facing_, bulletSpeed_, bulletType);
+
     subscribe(bullet.get());
 
     return std::move(bullet);
@@ -139,7 +134,7 @@ void Tank::notify(SimplePublisher *pub) {}
 Tank::Tank(TankType type, float x, float y, float speed, float bulletSpeed, unsigned int lives, Direction direction,
            unsigned int points)
         : Entity(x, y, 4, 4, speed, direction),
-          bulletSpeed_(bulletSpeed), lives_(lives), type_(type), points_(points), moving_(false) {}
+          bulletSpeed_(bulletSpeed), lives_(lives), type_(type), points_(points) {}
 
 
 // ##############################
@@ -0,0 +1,127 @@
+#ifndef PROI_PROJEKT_BROADPHASE_H
+#define PROI_PROJEKT_BROADPHASE_H
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <cstdint>
+
+#include "Entity.h"
+#include "Sweep.h"
+
+/**
+ * \brief Spatial hash of entity bounding boxes used for batched collision detection
+ *
+ * Entities are bucketed into square cells (a cell can hold entities overlapping it only partially). The hash is
+ * rebuilt once per tick from scratch and must not be queried after any entity was moved, added or removed.
+ * The hash can also be built from arbitrary bounds of entities (e.g. boxes swept by entities during a tick).
+ * Buckets are stored in a single flat array, so rebuilding does not allocate once the hash has warmed up.
+ */
+class Broadphase {
+public:
+    /**
+     * Inits class Broadphase
+     * @param cellSizeLog2 Binary logarithm of cell edge length in tiles (defaults to 2, so cells are tank sized)
+     */
+    explicit Broadphase(unsigned int cellSizeLog2 = 2);
+
+    /**
+     * Rebuilds the hash using the current positions of given entities
+     * @param entities Entities to insert
+     */
+    void rebuild(const std::vector<std::shared_ptr<Entity>> &entities);
+
+    /**
+     * Rebuilds the hash using given bounds of entities
+     * @param entities Entities to insert
+     * @param bounds Bounds of each entity (same length as entities)
+     */
+    void rebuild(const std::vector<std::shared_ptr<Entity>> &entities, const std::vector<Sweep::Box> &bounds);
+
+    /**
+     * Checks if an entity overlaps with any other entity inserted in the hash
+     * If multiple entities overlap, returns the one that was inserted the earliest (same as EntityController)
+     *
+     * @param target An entity to check
+     * @return The overlapping entity, or std::nullopt if none was found
+     */
+    [[nodiscard]] std::optional<std::shared_ptr<Entity>> findOverlap(const std::shared_ptr<Entity> &target) const;
+
+    /**
+     * Finds all entities whose bounds overlap a given box
+     * @param box A box to check
+     * @return Indices of found entities (in the order of insertion), valid until the next call
+     */
+    const std::vector<std::uint32_t> &findCandidates(const Sweep::Box &box);
+
+    /**
+     * Visits all entities whose bounds overlap a given box, without modifying the hash, so it can be called from many
+     * threads at once (as long as the hash is not rebuilt). An entity spanning multiple cells may be visited more
+     * than once
+     * @param box A box to check
+     * @param visitor Called with the index of every found entity, the search stops as soon as it returns true
+     * @return Whether the search was stopped by the visitor
+     */
+    template<typename Visitor>
+    bool visitCandidates(const Sweep::Box &box, Visitor visitor) const {
+        if (entities_.empty()) {
+            return false;
+        }
+        CellSpan span = spanOf(box);
+        for (int cx = span.minX; cx <= span.maxX; cx++)
+            for (int cy = span.minY; cy <= span.maxY; cy++) {
+                std::size_t bucket = bucketOf(cx, cy);
+                for (std::uint32_t i = bucketStart_[bucket]; i < bucketStart_[bucket + 1]; i++) {
+                    std::uint32_t idx = bucketEntries_[i];
+                    if (Sweep::overlaps(box, bounds_[idx]) && visitor(idx)) {
+                        return true;
+                    }
+                }
+            }
+        return false;
+    }
+
+    /**
+     * Returns the number of entities inserted during the last rebuild
+     * @return
+     */
+    [[nodiscard]] std::size_t size() const;
+
+protected:
+    /**
+     * Buckets entities_ using bounds_
+     */
+    void rebuildBuckets();
+
+    /**
+     * Returns the index of the bucket the given cell belongs to
+     */
+    [[nodiscard]] std::size_t bucketOf(int cellX, int cellY) const;
+
+    unsigned int cellShift_;
+
+    std::vector<std::shared_ptr<Entity>> entities_;
+    std::vector<Sweep::Box> bounds_;
+
+    std::vector<std::uint32_t> bucketStart_;
+    std::vector<std::uint32_t> bucketEntries_;
+    std::vector<std::uint32_t> cursor_;
+    std::size_t bucketMask_ = 0;
+
+    struct CellSpan {
+        int minX, minY, maxX, maxY;
+    };
+    std::vector<CellSpan> spans_;
+
+    std::vector<std::uint32_t> candidates_;
+    std::vector<std::uint32_t> visited_;
+    std::uint32_t query_ = 0;
+
+    /**
+     * Returns the range of cells covered by a box
+     */
+    [[nodiscard]] CellSpan spanOf(const Sweep::Box &box) const;
+};
+
+
+#endif //PROI_PROJEKT_BROADPHASE_H
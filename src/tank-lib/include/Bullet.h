@@ -5,6 +5,8 @@
 #ifndef PROI_PROJEKT_BULLET_H
 #define PROI_PROJEKT_BULLET_H
 
+#include <optional>
+
 #include "../../core-lib/include/SimplePublisher.h"
 
 #include "Entity.h"
@@ -13,6 +15,9 @@
  * An Entity derived class representing a tank bullet
  * In addition to Entity's attrs, Bullets can be characterized by their friendliness.
  * Bullet's are SimplePublishers and can be subscribed to by Tank objects.
+ *
+ * Since bullets fly in a straight line, the point at which a bullet hits a tile (its impact) can be computed once
+ * and stored with the version of the grid it was computed for; see Board::moveAllEntities
  */
 class Bullet : public Entity, public SimplePublisher {
 public:
@@ -52,18 +57,46 @@ public:
      * Returns whether the bullet was fired by the player
      * @return Bullet's friendliness
      */
-    bool isFriendly();
+    [[nodiscard]] bool isFriendly() const;
 
     void unlink();
 
+    /**
+     * Stores the coord at which the bullet will hit the first collidable tile in its way (or leave the grid)
+     * @param impact X coord (when flying horizontally) or Y coord (when flying vertically) in fixed-point units
+     * @param gridVersion Version of the grid the impact was computed for
+     */
+    void setImpact(FixedPoint::Value impact, unsigned int gridVersion);
+
+    /**
+     * Checks whether the stored impact was computed for a given grid version
+     * @param gridVersion Current version of the grid
+     * @return False if no impact was stored, or it was computed for another grid version
+     */
+    [[nodiscard]] bool isImpactValid(unsigned int gridVersion) const;
+
+    /**
+     * Checks whether the bullet has reached (or flown past) it's impact coord
+     * @return True if the bullet reached it's impact
+     */
+    [[nodiscard]] bool hasReachedImpact() const;
+
+    /**
+     * Moves the bullet back to it's impact coord if it has flown past it, so that it can not pass through tiles
+     */
+    void clampToImpact();
+
 protected:
     /**
      * Offsets the bullet in the direction it is faced
      * @param offset Offset value
      */
-    void offsetInCurrentDirection(float offset);
+    void offsetInCurrentDirection(FixedPoint::Value offset);
 
     BulletType type_;
+
+    FixedPoint::Value impact_ = 0;
+    std::optional<unsigned int> impactGridVersion_;
 };
 
 
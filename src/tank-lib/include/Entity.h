@@ -5,6 +5,8 @@
 #ifndef PROI_PROJEKT_ENTITY_H
 #define PROI_PROJEKT_ENTITY_H
 
+#include "FixedPoint.h"
+
 /**
  * Represents a direction in which an entity can be pointed at
  * Assume positive x is East, positive y in South
@@ -19,6 +21,8 @@ enum Direction: unsigned int{
 /**
  * Base class for creating objects representing in game
  * Entities are characterized by their position, size, the direction they're pointed at, and their movement speed.
+ * Position, size and speed are stored in fixed-point units (see FixedPoint); float accessors are provided for
+ * convenience (e.g. drawing) and are exact.
  * Entities can be moved forwards and backwards (methods are required to be overloaded in derived classes)
  */
 class Entity {
@@ -73,15 +77,76 @@ public:
      */
     [[nodiscard]] float getSizeY() const;
 
+    /**
+     * Returns entity's X coord in fixed-point units
+     * @return Entity's X coord
+     */
+    [[nodiscard]] FixedPoint::Value getFixedX() const;
+
+    /**
+     * Returns entity's Y coord in fixed-point units
+     * @return Entity's Y coord
+     */
+    [[nodiscard]] FixedPoint::Value getFixedY() const;
+
+    /**
+     * Returns entity's speed in fixed-point units per tick
+     * @return Entity's speed
+     */
+    [[nodiscard]] FixedPoint::Value getFixedSpeed() const;
+
+    /**
+     * Returns entity's size in X axis in fixed-point units
+     * @return Entity's X axis size
+     */
+    [[nodiscard]] FixedPoint::Value getFixedSizeX() const;
+
+    /**
+     * Returns entity's size in Y axis in fixed-point units
+     * @return Entity's Y axis size
+     */
+    [[nodiscard]] FixedPoint::Value getFixedSizeY() const;
+
+    /**
+     * Checks whether the entity moves in the current tick
+     * @return True if moving_ flag is set
+     */
+    [[nodiscard]] bool isMoving() const;
+
+    /**
+     * Sets entity's X coord
+     * @param x New X coord value
+     */
+    void setX(float x);
+
+    /**
+     * Sets entity's Y coord
+     * @param y New Y coord value
+     */
+    void setY(float y);
+
+    /**
+     * Sets entity's X coord
+     * @param x New X coord value in fixed-point units
+     */
+    void setFixedX(FixedPoint::Value x);
+
+    /**
+     * Sets entity's Y coord
+     * @param y New Y coord value in fixed-point units
+     */
+    void setFixedY(FixedPoint::Value y);
+
 protected:
     Entity()=default;
 
-    float x_;
-    float y_;
-    float size_x_;
-    float size_y_;
-    float speed_;
+    FixedPoint::Value x_;
+    FixedPoint::Value y_;
+    FixedPoint::Value size_x_;
+    FixedPoint::Value size_y_;
+    FixedPoint::Value speed_;
     Direction facing_;
+    bool moving_ = false;
 
     /**
      * Inits class Entity
@@ -5,6 +5,8 @@
 #ifndef PROI_PROJEKT_ENTITYCONTROLLER_H
 #define PROI_PROJEKT_ENTITYCONTROLLER_H
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <optional>
@@ -16,6 +18,10 @@ class Event;
 template<class E>
 class EventQueue;
 
+class SnapshotReader;
+
+class SnapshotWriter;
+
 /**
  * Exception thrown when trying to remove an entity that's not located in a controller
  */
@@ -31,6 +37,45 @@ public:
  */
 class EntityController {
 public:
+    /**
+     * Creates entities other than tanks and bullets (like the eagle) when restoring a snapshot, from their tile coords
+     */
+    using EntityFactory = std::function<std::shared_ptr<Entity>(unsigned int, unsigned int)>;
+
+    /**
+     * Kinds of entities in snapshots, after the tank types
+     */
+    static constexpr std::uint8_t BulletKind = Tank::ArmorTank + 1;
+    static constexpr std::uint8_t OtherKind = BulletKind + 1;
+
+    /**
+     * \brief State of an entity, as saved in snapshots and rewind history
+     */
+    struct EntityState {
+        /**
+         * A Tank::TankType, BulletKind or OtherKind
+         */
+        std::uint8_t kind = OtherKind;
+        FixedPoint::Value x = 0;
+        FixedPoint::Value y = 0;
+        Direction facing = North;
+        bool moving = false;
+
+        /**
+         * Only set for tanks, the cooldown only for bots
+         */
+        unsigned int lives = 0;
+        unsigned int cooldown = 0;
+
+        /**
+         * Only set for bullets
+         */
+        FixedPoint::Value speed = 0;
+        bool friendly = false;
+
+        bool operator==(const EntityState &other) const = default;
+    };
+
     /**
      * Inits class EntityController
      */
@@ -177,6 +222,58 @@ public:
      */
     void clear();
 
+    /**
+     * Writes all entities to a snapshot, in their order: their types, positions, directions, moving flags, lives and
+     * decision cooldowns of tanks, and speeds, sides and tanks of bullets (see GameSnapshot)
+     * @param writer
+     */
+    void saveState(SnapshotWriter &writer) const;
+
+    /**
+     * Replaces all entities with ones written by saveState. Tanks are linked to their bullets again, bots start with
+     * an empty tree state and new ids (given out in the order of the entities)
+     *
+     * Possibly queues multiple instances of Event::EntityRemoved, for the entities that are replaced
+     * @param reader
+     * @param makeOther Creates entities other than tanks and bullets
+     * @throws InvalidSnapshot if the state is cut short or broken, before any entity is replaced
+     */
+    void loadState(SnapshotReader &reader, const EntityFactory &makeOther);
+
+    /**
+     * Returns the state of an entity
+     * @param entity
+     * @return
+     */
+    static EntityState stateOf(const Entity &entity);
+
+    /**
+     * Moves an entity to the position of a state and sets the rest of it's changing fields: the direction and the
+     * moving flag of a tank, it's lives and the decision cooldown of a bot. Does not queue events
+     * @param entity An entity of the state's kind
+     * @param state
+     */
+    static void applyState(Entity &entity, const EntityState &state);
+
+    /**
+     * Writes a state, leaving out the fields it's kind does not have
+     */
+    static void writeState(SnapshotWriter &writer, const EntityState &state);
+
+    /**
+     * Reads a state written by writeState
+     * @throws InvalidSnapshot if the state is cut short or it's kind or direction do not exist
+     */
+    static EntityState readState(SnapshotReader &reader);
+
+    /**
+     * Creates an entity of a state and adds it to the controller. Does not queue events
+     * @param state
+     * @param makeOther Creates entities other than tanks and bullets
+     * @return The entity
+     */
+    std::shared_ptr<Entity> restoreEntity(const EntityState &state, const EntityFactory &makeOther);
+
 protected:
 
     EventQueue<Event> *eventQueue_;
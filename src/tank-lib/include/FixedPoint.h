@@ -0,0 +1,104 @@
+#ifndef PROI_PROJEKT_FIXEDPOINT_H
+#define PROI_PROJEKT_FIXEDPOINT_H
+
+#include <cstdint>
+#include <cmath>
+
+/**
+ * \brief Helpers for sub-tile fixed-point coordinates
+ *
+ * Entity positions, sizes and speeds are stored as signed integers counted in 1/256 of a tile (Q8 format). Integer
+ * arithmetic gives the same results with every compiler and instruction set, which keeps replays and lockstep
+ * simulation deterministic, and tile lookup or snapping is reduced to shifts and masks.
+ *
+ * 1/256 was chosen over coarser units, since entity speeds (like 0.1 tile per tick) need to be represented with
+ * an error small enough not to change the gameplay.
+ */
+class FixedPoint {
+public:
+    /**
+     * Underlying integer type of fixed-point values
+     */
+    typedef std::int32_t Value;
+
+    /**
+     * Number of fractional bits
+     */
+    static constexpr unsigned int Shift = 8;
+
+    /**
+     * A single tile in fixed-point units
+     */
+    static constexpr Value One = Value{1} << Shift;
+
+    /**
+     * Mask selecting the fractional part of a value
+     */
+    static constexpr Value FractionMask = One - 1;
+
+    /**
+     * Converts a distance in tiles to fixed-point units, rounding to the nearest unit
+     * @param value Distance in tiles
+     * @return Distance in fixed-point units
+     */
+    static Value fromFloat(float value) {
+        return static_cast<Value>(std::lround(value * One));
+    }
+
+    /**
+     * Converts a distance in fixed-point units to tiles (exact for all values used in game)
+     * @param value Distance in fixed-point units
+     * @return Distance in tiles
+     */
+    static constexpr float toFloat(Value value) {
+        return static_cast<float>(value) / One;
+    }
+
+    /**
+     * Converts a whole number of tiles to fixed-point units
+     * @param tiles Number of tiles
+     * @return Distance in fixed-point units
+     */
+    static constexpr Value fromTiles(std::int32_t tiles) {
+        return tiles * One;
+    }
+
+    /**
+     * Returns the index of the tile containing the given coordinate (rounds towards negative infinity)
+     * @param value Coordinate in fixed-point units
+     * @return Tile index
+     */
+    static constexpr std::int32_t floorToTile(Value value) {
+        return value >> Shift;
+    }
+
+    /**
+     * Returns the coordinate rounded up to the nearest tile, in tiles
+     * @param value Coordinate in fixed-point units
+     * @return Tile index
+     */
+    static constexpr std::int32_t ceilToTile(Value value) {
+        return (value + FractionMask) >> Shift;
+    }
+
+    /**
+     * Rounds the coordinate down to the nearest tile boundary
+     * @param value Coordinate in fixed-point units
+     * @return Snapped coordinate in fixed-point units
+     */
+    static constexpr Value snapDown(Value value) {
+        return value & ~FractionMask;
+    }
+
+    /**
+     * Rounds the coordinate up to the nearest tile boundary
+     * @param value Coordinate in fixed-point units
+     * @return Snapped coordinate in fixed-point units
+     */
+    static constexpr Value snapUp(Value value) {
+        return (value + FractionMask) & ~FractionMask;
+    }
+};
+
+
+#endif //PROI_PROJEKT_FIXEDPOINT_H
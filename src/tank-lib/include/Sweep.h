@@ -0,0 +1,69 @@
+#ifndef PROI_PROJEKT_SWEEP_H
+#define PROI_PROJEKT_SWEEP_H
+
+#include <optional>
+
+#include "FixedPoint.h"
+#include "Entity.h"
+
+/**
+ * \brief Continuous (swept) collision tests for axis-aligned bounding boxes
+ *
+ * All computations are done on fixed-point integers, so they give the same results on every platform.
+ * Used by Board to detect collisions that happen in the middle of a tick, when entities move by more than their own
+ * size in a single tick.
+ */
+class Sweep {
+public:
+    /**
+     * Axis-aligned bounding box in fixed-point units
+     */
+    struct Box {
+        FixedPoint::Value x;
+        FixedPoint::Value y;
+        FixedPoint::Value sizeX;
+        FixedPoint::Value sizeY;
+    };
+
+    /**
+     * Movement of a box during a single tick
+     */
+    struct Motion {
+        Box start;
+        FixedPoint::Value dx;
+        FixedPoint::Value dy;
+    };
+
+    /**
+     * Returns entity's current bounding box
+     * @param entity An entity
+     * @return Entity's bounding box
+     */
+    static Box boxOf(const Entity &entity);
+
+    /**
+     * Returns the smallest box containing a moving box during the whole tick
+     * @param motion Box's movement
+     * @return Bounding box of the movement
+     */
+    static Box sweptBox(const Motion &motion);
+
+    /**
+     * Checks whether two boxes overlap (touching edges do not count as an overlap)
+     */
+    static bool overlaps(const Box &a, const Box &b);
+
+    /**
+     * Computes the moment two moving boxes start overlapping during a tick
+     * Boxes overlapping at the beginning of the tick collide at the moment 0
+     *
+     * @param a Movement of the first box
+     * @param b Movement of the second box
+     * @return Fraction of the tick (in fixed-point units, 0 to FixedPoint::One) at which the boxes start overlapping,
+     * or std::nullopt if they don't overlap at any moment of the tick
+     */
+    static std::optional<FixedPoint::Value> timeOfImpact(const Motion &a, const Motion &b);
+};
+
+
+#endif //PROI_PROJEKT_SWEEP_H
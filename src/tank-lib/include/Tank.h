@@ -37,6 +37,11 @@ public:
         ArmorTank
     };
 
+    /**
+     * Edge length of bullets fired by tanks, in fixed-point units
+     */
+    static const FixedPoint::Value BulletSize;
+
     /**
      * Changes the direction in which the tank is faced
      * @param direction Target direction
@@ -80,12 +85,6 @@ public:
      */
     void setMoving(bool isMoving);
 
-    /**
-     * Checks whether the tank is moving or not
-     * @return True is moving_ flag is set
-     */
-    [[nodiscard]] bool isMoving() const;
-
     /**
      * Returns the number of points that the player gets for killing the tank
      * @return Point reward value for killing the tank
@@ -93,22 +92,16 @@ public:
     [[nodiscard]] unsigned int getPoints() const;
 
     /**
-     * Sets tank's X coord
-     * @param x New X coord value
-     */
-    void setX(float x);
-
-    /**
-     * Sets tank's Y coord
-     * @param y New Y coord value
+     * Returns the speed of bullets fired by the tank
+     * @return Bullet's distance per tick
      */
-    void setY(float y);
+    [[nodiscard]] float getBulletSpeed() const;
 
     /**
      * Moves the tank by a given distance in direction in which it is faced
      * @param offset Offset value
      */
-    void offsetInCurrentDirection(float offset);
+    void offsetInCurrentDirection(FixedPoint::Value offset);
 
     /**
      * Creates a bullet located right in front of the tank and faced in the same direction as the tank.
@@ -143,7 +136,6 @@ protected:
     TankType type_;
 
     unsigned int lives_;
-    bool moving_;
     unsigned int points_;
 
     float bulletSpeed_;
@@ -0,0 +1,68 @@
+#include <memory>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Broadphase.h"
+#include "../include/Tank.h"
+#include "../include/Bullet.h"
+
+SCENARIO("Finding overlapping entities with the spatial hash") {
+    GIVEN("A broadphase built from some entities") {
+        auto tank1 = std::make_shared<PlayerTank>(10, 10);
+        auto tank2 = std::make_shared<PlayerTank>(12, 12);
+        auto tank3 = std::make_shared<PlayerTank>(11, 13);
+        auto lonelyTank = std::make_shared<PlayerTank>(40, 40);
+        auto bullet = std::make_shared<Bullet>(44.1, 41, West, 0.3, Bullet::Enemy);
+
+        Broadphase broadphase{};
+        broadphase.rebuild({tank1, tank2, tank3, lonelyTank, bullet});
+
+        REQUIRE(broadphase.size() == 5);
+
+        WHEN("Checking an entity that overlaps with multiple entities") {
+            auto found = broadphase.findOverlap(tank3);
+
+            THEN("The entity that was inserted the earliest should be returned") {
+                REQUIRE(found.has_value());
+                REQUIRE(found.value() == tank1);
+            }
+        }
+
+        WHEN("Checking an entity that does not overlap with anything") {
+            THEN("Nothing should be found") {
+                REQUIRE_FALSE(broadphase.findOverlap(lonelyTank).has_value());
+                REQUIRE_FALSE(broadphase.findOverlap(bullet).has_value());
+            }
+        }
+
+        WHEN("Checking an entity touching another one with an edge") {
+            auto touchingTank = std::make_shared<PlayerTank>(36, 40);
+
+            THEN("No overlap should be found") {
+                REQUIRE_FALSE(broadphase.findOverlap(touchingTank).has_value());
+            }
+        }
+
+        WHEN("Looking for all entities overlapping a box") {
+            Sweep::Box box{FixedPoint::fromTiles(11), FixedPoint::fromTiles(11), FixedPoint::fromTiles(30),
+                           FixedPoint::fromTiles(2)};
+            const std::vector<std::uint32_t> &found = broadphase.findCandidates(box);
+
+            THEN("Each of them should be returned once, in the order of insertion") {
+                REQUIRE(found.size() == 2);
+                REQUIRE(found[0] == 0);
+                REQUIRE(found[1] == 1);
+            }
+        }
+
+        WHEN("Checking an entity placed out of map") {
+            auto outOfMapTank = std::make_shared<PlayerTank>(-3, -2);
+
+            THEN("Entities should still be checked") {
+                REQUIRE_FALSE(broadphase.findOverlap(outOfMapTank).has_value());
+            }
+        }
+    }
+}
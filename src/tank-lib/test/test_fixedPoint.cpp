@@ -0,0 +1,86 @@
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/FixedPoint.h"
+#include "../include/Tank.h"
+#include "../../bot-lib/include/BotController.h"
+#include "../../core-lib/include/Clock.h"
+#include "../../core-lib/include/EventQueue.h"
+
+SCENARIO("Converting coordinates to fixed-point units") {
+    GIVEN("Some distances in tiles") {
+        WHEN("Converting whole and dyadic values") {
+            THEN("Conversion should be exact both ways") {
+                REQUIRE(FixedPoint::fromFloat(1) == FixedPoint::One);
+                REQUIRE(FixedPoint::fromFloat(0.5) == FixedPoint::One / 2);
+                REQUIRE(FixedPoint::fromFloat(-3.25) == -3 * FixedPoint::One - FixedPoint::One / 4);
+                REQUIRE(FixedPoint::toFloat(FixedPoint::fromFloat(17.75f)) == 17.75f);
+                REQUIRE(FixedPoint::fromTiles(52) == FixedPoint::fromFloat(52));
+            }
+        }
+
+        WHEN("Converting values that are not representable") {
+            THEN("They should be rounded to the nearest unit") {
+                REQUIRE(FixedPoint::fromFloat(0.1f) == 26);
+                REQUIRE(FixedPoint::fromFloat(0.4f) == 102);
+            }
+        }
+    }
+}
+
+SCENARIO("Rounding fixed-point coordinates to tiles") {
+    GIVEN("A coordinate between two tiles") {
+        FixedPoint::Value value = FixedPoint::fromFloat(9.25);
+
+        THEN("Tile lookup and snapping should round in the right direction") {
+            REQUIRE(FixedPoint::floorToTile(value) == 9);
+            REQUIRE(FixedPoint::ceilToTile(value) == 10);
+            REQUIRE(FixedPoint::snapDown(value) == FixedPoint::fromTiles(9));
+            REQUIRE(FixedPoint::snapUp(value) == FixedPoint::fromTiles(10));
+        }
+    }
+
+    GIVEN("A coordinate on a tile boundary") {
+        FixedPoint::Value value = FixedPoint::fromTiles(9);
+
+        THEN("It should not be changed by rounding") {
+            REQUIRE(FixedPoint::floorToTile(value) == 9);
+            REQUIRE(FixedPoint::ceilToTile(value) == 9);
+            REQUIRE(FixedPoint::snapDown(value) == value);
+            REQUIRE(FixedPoint::snapUp(value) == value);
+        }
+    }
+
+    GIVEN("A negative coordinate") {
+        FixedPoint::Value value = FixedPoint::fromFloat(-0.5);
+
+        THEN("Tile lookup should round towards negative infinity") {
+            REQUIRE(FixedPoint::floorToTile(value) == -1);
+            REQUIRE(FixedPoint::ceilToTile(value) == 0);
+        }
+    }
+}
+
+SCENARIO("Moving an entity many times") {
+    Clock::initialize(60);
+    BotController::initialize(4, 240);
+    EventQueue<Event>::instance()->clear();
+    GIVEN("A tank with a fractional speed") {
+        BasicTank tank{10, 40, North};
+        tank.setMoving(true);
+
+        WHEN("Moving the tank forwards and back the same number of times") {
+            for (int i = 0; i < 1000; i++) {
+                tank.move();
+            }
+            for (int i = 0; i < 1000; i++) {
+                tank.moveBack();
+            }
+
+            THEN("The tank should end up exactly where it started") {
+                REQUIRE(tank.getFixedY() == FixedPoint::fromTiles(40));
+                REQUIRE(tank.getY() == 40);
+            }
+        }
+    }
+}
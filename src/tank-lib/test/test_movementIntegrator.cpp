@@ -0,0 +1,76 @@
+#include <memory>
+#include <vector>
+#include <random>
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/MovementIntegrator.h"
+#include "../include/Tank.h"
+#include "../include/Bullet.h"
+
+SCENARIO("Advancing entities in a single pass") {
+    GIVEN("Some tanks and bullets") {
+        MovementIntegrator integrator{};
+
+        auto movingTank = std::make_shared<PlayerTank>(10, 10, East);
+        movingTank->setMoving(true);
+        auto idleTank = std::make_shared<PlayerTank>(20, 20, North);
+        auto bullet = std::make_shared<Bullet>(30, 30, North, 0.5, Bullet::Friendly);
+
+        std::vector<std::shared_ptr<Entity>> entities{movingTank, idleTank, bullet};
+
+        WHEN("Advancing all entities") {
+            const std::vector<std::shared_ptr<Entity>> &moved = integrator.advance(entities);
+
+            THEN("Only moving entities should be moved, in the direction they are faced") {
+                REQUIRE(movingTank->getX() == 10 + movingTank->getSpeed());
+                REQUIRE(movingTank->getY() == 10);
+
+                REQUIRE(idleTank->getX() == 20);
+                REQUIRE(idleTank->getY() == 20);
+
+                REQUIRE(bullet->getX() == 30);
+                REQUIRE(bullet->getY() == 29.5f);
+
+                AND_THEN("Moved entities should be returned in their original order") {
+                    REQUIRE(moved.size() == 2);
+                    REQUIRE(moved[0] == movingTank);
+                    REQUIRE(moved[1] == bullet);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Vectorized kernel matches the scalar implementation") {
+    GIVEN("Position arrays of a length that is not a multiple of the vector width") {
+        const std::size_t count = 1003;
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<FixedPoint::Value> coords(0, FixedPoint::fromTiles(52));
+        std::uniform_int_distribution<FixedPoint::Value> speeds(0, FixedPoint::One);
+        std::uniform_int_distribution<unsigned int> directions(North, East);
+
+        std::vector<FixedPoint::Value> x(count), y(count), speed(count);
+        std::vector<unsigned int> facing(count);
+        for (std::size_t i = 0; i < count; i++) {
+            x[i] = coords(generator);
+            y[i] = coords(generator);
+            speed[i] = speeds(generator);
+            facing[i] = directions(generator);
+        }
+
+        std::vector<FixedPoint::Value> expectedX = x, expectedY = y;
+
+        WHEN("Integrating with both kernels") {
+            MovementIntegrator::integrate(x.data(), y.data(), speed.data(), facing.data(), count);
+            MovementIntegrator::integrateScalar(expectedX.data(), expectedY.data(), speed.data(), facing.data(),
+                                                count);
+
+            THEN("Results should be identical") {
+                REQUIRE(x == expectedX);
+                REQUIRE(y == expectedY);
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_all.hpp"
+
+#include "../include/Sweep.h"
+
+namespace {  // anonymous namespace to force internal linkage
+    namespace helper {
+        Sweep::Motion motion(float x, float y, float size, float dx, float dy) {
+            return {{FixedPoint::fromFloat(x), FixedPoint::fromFloat(y), FixedPoint::fromFloat(size),
+                     FixedPoint::fromFloat(size)},
+                    FixedPoint::fromFloat(dx), FixedPoint::fromFloat(dy)};
+        }
+    }
+}
+
+SCENARIO("Computing the time of impact of moving boxes") {
+    GIVEN("Two boxes moving towards each other") {
+        Sweep::Motion a = helper::motion(0, 0, 1, 4, 0);
+        Sweep::Motion b = helper::motion(5, 0, 1, -4, 0);
+
+        THEN("They should collide in the middle of the tick, even though they pass each other") {
+            REQUIRE(Sweep::timeOfImpact(a, b) == FixedPoint::One / 2);
+            REQUIRE(Sweep::timeOfImpact(b, a) == FixedPoint::One / 2);
+        }
+    }
+
+    GIVEN("A box moving towards a stationary box it does not reach") {
+        Sweep::Motion a = helper::motion(0, 0, 1, 2, 0);
+        Sweep::Motion b = helper::motion(4, 0, 1, 0, 0);
+
+        THEN("They should not collide") {
+            REQUIRE_FALSE(Sweep::timeOfImpact(a, b).has_value());
+        }
+    }
+
+    GIVEN("A box that ends the tick touching another box with an edge") {
+        Sweep::Motion a = helper::motion(0, 0, 1, 3, 0);
+        Sweep::Motion b = helper::motion(4, 0, 1, 0, 0);
+
+        THEN("They should not collide") {
+            REQUIRE_FALSE(Sweep::timeOfImpact(a, b).has_value());
+        }
+    }
+
+    GIVEN("Boxes moving in perpendicular directions") {
+        Sweep::Motion a = helper::motion(0, 2, 1, 4, 0);
+        Sweep::Motion b = helper::motion(2, 0, 1, 0, 4);
+
+        THEN("They should collide when both axes overlap") {
+            REQUIRE(Sweep::timeOfImpact(a, b) == FixedPoint::One / 4);
+        }
+    }
+
+    GIVEN("Boxes moving side by side") {
+        Sweep::Motion a = helper::motion(0, 0, 1, 4, 0);
+        Sweep::Motion b = helper::motion(0, 1, 1, 4, 0);
+
+        THEN("They should not collide") {
+            REQUIRE_FALSE(Sweep::timeOfImpact(a, b).has_value());
+        }
+    }
+
+    GIVEN("Boxes overlapping at the beginning of the tick") {
+        Sweep::Motion a = helper::motion(0, 0, 2, 1, 0);
+        Sweep::Motion b = helper::motion(1, 1, 2, 0, 0);
+
+        THEN("They should collide immediately") {
+            REQUIRE(Sweep::timeOfImpact(a, b) == 0);
+        }
+    }
+}
+
+SCENARIO("Computing the box swept by a moving box") {
+    GIVEN("A box moving backwards along an axis") {
+        Sweep::Motion a = helper::motion(5, 5, 1, -3, 0);
+
+        THEN("The swept box should cover the whole way") {
+            Sweep::Box box = Sweep::sweptBox(a);
+            REQUIRE(box.x == FixedPoint::fromTiles(2));
+            REQUIRE(box.y == FixedPoint::fromTiles(5));
+            REQUIRE(box.sizeX == FixedPoint::fromTiles(4));
+            REQUIRE(box.sizeY == FixedPoint::fromTiles(1));
+        }
+    }
+}